@@ -0,0 +1,605 @@
+#include "oc/batching.hpp"
+#include "oc/bench/traffic_generator.hpp"
+#include "oc/capture.hpp"
+#include "oc/checksum.hpp"
+#include "oc/flight_recorder.hpp"
+#include "oc/oc_adapters/copy_adapter.hpp"
+#include "oc/oc_adapters/emulated_adapter.hpp"
+#include "oc/oc_adapters/shared_memory_adapter.hpp"
+#include "oc/oc_adapters/tcp_loopback_adapter.hpp"
+#include "oc/pipe.hpp"
+#include "oc/pipe_tuner.hpp"
+#include "oc/stats_page.hpp"
+#include "oc/trace.hpp"
+#include "utils/histogram.hpp"
+#include "utils/tsc_clock.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exec/inline_scheduler.hpp>
+#include <exec/task.hpp>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <stdexec/execution.hpp>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <vector>
+
+// Open-loop pipeline benchmark: a traffic generator offers messages to the
+// source ring of a single pipe, the pipeline forwards them over the selected
+// adapter and a consumer drains the destination ring. Everything runs on one
+// thread so the numbers reflect the pipe and adapter, not scheduling noise.
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct bench_config {
+  std::string adapter = "copy";
+  std::string size_spec = "fixed:4096";
+  std::string rate_spec = "max";
+  std::size_t ring_bytes = 1 << 22;
+  uint64_t messages = 0; // 0: run for duration
+  std::chrono::milliseconds duration{2000};
+  uint64_t seed = 1;
+  uint32_t trace_every = 0; // 0: no per-hop tracing
+  std::string stats_path;   // empty: no live stats file
+  std::string flight_path;  // empty: no flight recorder
+  std::string capture_path; // empty: no stream capture
+  std::string replay_path;  // empty: traffic from the generator
+  double replay_speed = 1;  // 0: as fast as the pipe accepts
+  bool autotune = false;
+  std::chrono::microseconds latency_target{0}; // for the tuner; 0: none
+  oc::batch_policy batching;                   // min_bytes 0: no batching
+  bool checksum = false; // CRC32C trailer on every message
+  oc::oc_adapters::emulated_link_config link;
+};
+
+// every message starts with this header; sizes include it
+struct message_header {
+  uint32_t bytes;
+  uint32_t sequence;
+  int64_t due_ns;
+};
+
+void ring_write(std::span<std::byte> ring, uint32_t position, const void *data,
+                std::size_t len) {
+  auto *bytes = static_cast<const std::byte *>(data);
+  oc::for_each_ring_piece(ring.size(), position, len,
+                          [&](std::size_t offset, std::size_t piece) {
+                            std::memcpy(ring.data() + offset, bytes, piece);
+                            bytes += piece;
+                          });
+}
+
+void ring_read(std::span<const std::byte> ring, uint32_t position, void *out,
+               std::size_t len) {
+  auto *bytes = static_cast<std::byte *>(out);
+  oc::for_each_ring_piece(ring.size(), position, len,
+                          [&](std::size_t offset, std::size_t piece) {
+                            std::memcpy(bytes, ring.data() + offset, piece);
+                            bytes += piece;
+                          });
+}
+
+double cpu_seconds() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  auto seconds = [](timeval tv) {
+    return static_cast<double>(tv.tv_sec) +
+           static_cast<double>(tv.tv_usec) / 1e6;
+  };
+  return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+struct bench_result {
+  uint64_t messages = 0;
+  uint64_t bytes = 0;
+  double wall_seconds = 0;
+  double cpu_seconds = 0;
+  oc::utils::Histogram latency_ns;          // scheduled arrival to delivery
+  oc::utils::Histogram transfer_latency_ns; // per adapter transfer
+  std::optional<oc::PipeTracer::breakdown> trace;
+  std::optional<oc::tuner_metrics> tuning;
+  uint64_t checksum_verified = 0;
+  uint64_t checksum_mismatches = 0;
+};
+
+class bench_driver {
+public:
+  bench_driver(const bench_config &config, std::span<std::byte> src_ring,
+               std::span<const std::byte> dst_ring,
+               oc::PipeTracer *tracer = nullptr,
+               const oc::StreamCapture *replay = nullptr,
+               oc::StreamRecorder *capture = nullptr)
+      : config_(config), src_ring_(src_ring), dst_ring_(dst_ring),
+        tracer_(tracer), capture_(capture), sealer_(config.checksum),
+        verifier_(config.checksum), start_(clock_type::now()),
+        generator_(oc::bench::size_distribution::parse(config.size_spec),
+                   oc::bench::arrival_process::parse(config.rate_spec), start_,
+                   config.seed) {
+    if (replay) {
+      replay_.emplace(*replay, config.replay_speed, start_);
+    }
+  }
+
+  // offer every message that is due and fits into the source ring
+  void produce(oc::PipeBase &pipe, clock_type::time_point now) {
+    while (!stop_producing(now) &&
+           (replay_ ? replay_->ready(now) : generator_.ready(now))) {
+      auto [offered, due] = replay_ ? std::pair(replay_->peek().bytes,
+                                                replay_->peek().due)
+                                    : std::pair(generator_.peek().bytes,
+                                                generator_.peek().due);
+      auto bytes =
+          static_cast<uint32_t>(std::max(offered, sizeof(message_header))) +
+          sealer_.overhead();
+      if (pipe.src_capacity - (pipe.src_tail - pipe.src_head) < bytes) {
+        return; // back-pressure; the message stays due and accrues latency
+      }
+
+      if (max_rate()) {
+        due = now;
+      }
+      if (replay_) {
+        // a captured payload is replayed behind the bench header
+        auto payload = replay_->peek().payload;
+        if (payload.size() > sizeof(message_header)) {
+          ring_write(src_ring_, pipe.src_tail + sizeof(message_header),
+                     payload.data() + sizeof(message_header),
+                     payload.size() - sizeof(message_header));
+        }
+      }
+      message_header header{
+          bytes, static_cast<uint32_t>(sent_),
+          std::chrono::duration_cast<std::chrono::nanoseconds>(due - start_)
+              .count()};
+      ring_write(src_ring_, pipe.src_tail, &header, sizeof(header));
+      sealer_.seal(src_ring_, pipe.src_tail, bytes - sealer_.overhead());
+
+      if (capture_) {
+        tee(pipe.src_tail, bytes);
+      }
+      if (tracer_) {
+        tracer_->produced(pipe.src_tail + bytes);
+      }
+      pipe.src_tail += bytes;
+      ++sent_;
+      if (replay_) {
+        replay_->pop();
+      } else {
+        generator_.pop();
+      }
+    }
+  }
+
+  // drain every complete message that reached the destination ring
+  void consume(oc::PipeBase &pipe) {
+    if (pipe.dst_head == pipe.dst_tail) {
+      return;
+    }
+
+    auto now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      clock_type::now() - start_)
+                      .count();
+    while (pipe.dst_tail - pipe.dst_head >= sizeof(message_header)) {
+      message_header header;
+      ring_read(dst_ring_, pipe.dst_head, &header, sizeof(header));
+      if (pipe.dst_tail - pipe.dst_head < header.bytes) {
+        break; // tail of the message is still in flight
+      }
+
+      if (!verifier_.verify(dst_ring_, pipe.dst_head,
+                            header.bytes - verifier_.overhead())) {
+        std::cerr << "pipe-bench: checksum mismatch in message "
+                  << result_.messages << "\n";
+      }
+      if (header.sequence != static_cast<uint32_t>(result_.messages)) {
+        std::cerr << "pipe-bench: out of order message " << header.sequence
+                  << ", expected " << result_.messages << "\n";
+        std::exit(1);
+      }
+
+      result_.latency_ns.record(static_cast<uint64_t>(now_ns - header.due_ns));
+      result_.bytes += header.bytes;
+      ++result_.messages;
+      pipe.dst_head += header.bytes;
+    }
+    if (tracer_) {
+      tracer_->consumed(pipe.dst_head);
+    }
+  }
+
+  [[nodiscard]] bool stop_producing(clock_type::time_point now) const {
+    if (config_.messages > 0 && sent_ >= config_.messages) {
+      return true;
+    }
+    if (replay_) {
+      return replay_->done(); // a replay runs to the end of its capture
+    }
+    return config_.messages == 0 && now - start_ >= config_.duration;
+  }
+
+  [[nodiscard]] bool done(clock_type::time_point now) const {
+    return stop_producing(now) && result_.messages == sent_;
+  }
+
+  bench_result finish() {
+    result_.checksum_verified = verifier_.verified();
+    result_.checksum_mismatches = verifier_.mismatches();
+    result_.wall_seconds =
+        std::chrono::duration<double>(clock_type::now() - start_).count();
+    return std::move(result_);
+  }
+
+private:
+  [[nodiscard]] bool max_rate() const {
+    return replay_ ? config_.replay_speed == 0
+                   : generator_.arrivals().type ==
+                         oc::bench::arrival_process::kind::max;
+  }
+
+  // record the message as it sits in the source ring
+  void tee(uint32_t position, uint32_t bytes) {
+    auto offset = position & (src_ring_.size() - 1);
+    auto first = std::min<std::size_t>(bytes, src_ring_.size() - offset);
+    capture_->record(src_ring_.subspan(offset, first),
+                     src_ring_.first(bytes - first));
+  }
+
+  const bench_config &config_;
+  std::span<std::byte> src_ring_;
+  std::span<const std::byte> dst_ring_;
+  oc::PipeTracer *tracer_;
+  oc::StreamRecorder *capture_;
+  oc::ChunkChecksum sealer_;
+  oc::ChunkChecksum verifier_;
+  clock_type::time_point start_;
+  oc::bench::traffic_generator<clock_type> generator_;
+  std::optional<oc::replay_source<clock_type>> replay_;
+  uint64_t sent_ = 0;
+  bench_result result_;
+};
+
+exec::task<void> drive(bench_driver &driver, oc::PipeLine &pipe_line,
+                       oc::PipeBase &pipe) {
+  while (true) {
+    auto now = clock_type::now();
+    if (driver.done(now)) {
+      co_return;
+    }
+    driver.produce(pipe, now);
+    co_await pipe_line.progress(exec::inline_scheduler{});
+    driver.consume(pipe);
+  }
+}
+
+template <typename Adapter>
+bench_result run_pipe(const bench_config &config, Adapter adapter,
+                      std::span<std::byte> src_ring,
+                      std::span<std::byte> dst_ring) {
+  using pipe_type = oc::Pipe<Adapter, Adapter, Adapter>;
+  // outlives the pipe, which holds a recorder into it
+  oc::utils::ConcurrentHistogram transfer_latency;
+  auto pipe = std::make_shared<pipe_type>(
+      adapter, typename Adapter::local_buf_t(src_ring),
+      typename Adapter::remote_buf_t(dst_ring));
+
+  oc::PipeLine pipe_line;
+  pipe_line.push_pipe(pipe);
+
+  pipe->record_transfer_latency(transfer_latency);
+
+  std::optional<oc::PipeTracer> tracer;
+  if (config.trace_every > 0) {
+    tracer.emplace(config.trace_every, 1);
+    pipe_line.trace(*tracer);
+  }
+
+  // left in place after the run so pipe-top can show the final counters
+  std::optional<oc::StatsFile> stats;
+  if (!config.stats_path.empty()) {
+    stats.emplace(oc::StatsFile::create(config.stats_path, 1));
+    pipe_line.publish_stats(*stats);
+  }
+
+  std::optional<oc::PipeTuner> tuner;
+  if (config.autotune) {
+    oc::tuner_options options;
+    options.latency_target = config.latency_target;
+    tuner.emplace(options);
+    pipe->tune(*tuner);
+  }
+
+  if (config.batching.min_bytes > 0) {
+    pipe->batch(config.batching);
+  }
+
+  std::optional<oc::FlightRecorder> flight;
+  if (!config.flight_path.empty()) {
+    flight.emplace();
+    flight->dump_on_fatal_signal(config.flight_path.c_str());
+    pipe_line.record_flight(*flight);
+  }
+
+  std::optional<oc::StreamCapture> replay;
+  if (!config.replay_path.empty()) {
+    replay.emplace(oc::StreamCapture::load(config.replay_path));
+    for (const auto &entry : replay->records()) {
+      auto trailer = config.checksum ? sizeof(oc::ChunkTrailer) : 0;
+      if (entry.bytes + trailer > config.ring_bytes) {
+        throw std::invalid_argument(
+            "a captured message does not fit in the ring");
+      }
+    }
+  }
+
+  std::optional<oc::StreamRecorder> capture;
+  if (!config.capture_path.empty()) {
+    capture.emplace(config.capture_path);
+  }
+
+  bench_driver driver(config, src_ring, dst_ring, tracer ? &*tracer : nullptr,
+                      replay ? &*replay : nullptr,
+                      capture ? &*capture : nullptr);
+  auto cpu_before = cpu_seconds();
+  stdexec::sync_wait(drive(driver, pipe_line, *pipe));
+  auto cpu_after = cpu_seconds();
+
+  if (capture) {
+    capture->close();
+    if (capture->dropped() > 0) {
+      std::cerr << "pipe-bench: capture dropped " << capture->dropped()
+                << " messages\n";
+    }
+  }
+
+  auto result = driver.finish();
+  result.cpu_seconds = cpu_after - cpu_before;
+  result.transfer_latency_ns =
+      transfer_latency.snapshot().rescaled(oc::utils::tsc_clock::ns_per_tick());
+  if (tracer) {
+    result.trace = tracer->snapshot();
+  }
+  if (tuner) {
+    result.tuning = tuner->metrics();
+  }
+  if (flight) {
+    flight->dump(config.flight_path.c_str());
+  }
+  return result;
+}
+
+bench_result run(const bench_config &config) {
+  std::vector<std::byte> src(config.ring_bytes);
+  std::vector<std::byte> dst(config.ring_bytes);
+
+  if (config.adapter == "shm") {
+    // one ring seen from both ends
+    return run_pipe(config, oc::oc_adapters::shared_memory_adapter<std::byte>(src),
+                    src, src);
+  } else if (config.adapter == "copy") {
+    return run_pipe(config, oc::oc_adapters::copy_adapter<std::byte>(), src,
+                    dst);
+  } else if (config.adapter == "tcp") {
+    return run_pipe(config, oc::oc_adapters::tcp_loopback_adapter<std::byte>(),
+                    src, dst);
+  } else if (config.adapter == "emulated") {
+    return run_pipe(
+        config, oc::oc_adapters::emulated_adapter<std::byte>(config.link), src,
+        dst);
+  }
+  throw std::invalid_argument("unknown adapter '" + config.adapter + "'");
+}
+
+void print_latency(const char *name, const oc::utils::Histogram &histogram) {
+  std::printf("  \"%s\": {\"p50\": %lu, \"p99\": %lu, \"p99.9\": %lu, "
+              "\"max\": %lu, \"mean\": %.1f},\n",
+              name, histogram.percentile(50), histogram.percentile(99),
+              histogram.percentile(99.9), histogram.max(), histogram.mean());
+}
+
+void print_trace(const oc::PipeTracer::breakdown &trace) {
+  std::printf("  \"trace\": {\n");
+  std::printf("    \"traced\": %lu,\n", trace.traced);
+  std::printf("    \"dropped\": %lu,\n", trace.dropped);
+  std::printf("    \"hops\": [\n");
+  for (std::size_t hop = 0; hop < trace.wait.size(); ++hop) {
+    const auto &wait = trace.wait[hop];
+    const auto &transfer = trace.transfer[hop];
+    std::printf("      {\"wait_ns\": {\"p50\": %lu, \"p99\": %lu, "
+                "\"max\": %lu}, \"transfer_ns\": {\"p50\": %lu, "
+                "\"p99\": %lu, \"max\": %lu}}%s\n",
+                wait.percentile(50), wait.percentile(99), wait.max(),
+                transfer.percentile(50), transfer.percentile(99),
+                transfer.max(), hop + 1 < trace.wait.size() ? "," : "");
+  }
+  std::printf("    ],\n");
+  std::printf("    \"delivery_ns\": {\"p50\": %lu, \"p99\": %lu, "
+              "\"max\": %lu}\n",
+              trace.delivery.percentile(50), trace.delivery.percentile(99),
+              trace.delivery.max());
+  std::printf("  },\n");
+}
+
+void print_tuning(const oc::tuner_metrics &tuning) {
+  std::printf("  \"tuner\": {\"chunk_bytes\": %u, \"depth\": %u, "
+              "\"window_gbit_per_sec\": %.3f, \"transfer_latency_ns\": %.0f, "
+              "\"windows\": %lu, \"steps\": %lu, \"back_offs\": %lu},\n",
+              tuning.current.chunk_bytes, tuning.current.depth,
+              tuning.throughput_bytes_per_sec * 8 / 1e9,
+              tuning.transfer_latency_ns, tuning.windows, tuning.steps,
+              tuning.back_offs);
+}
+
+void print_json(const bench_config &config, const bench_result &result) {
+  auto gigabytes = static_cast<double>(result.bytes) / 1e9;
+  auto seconds = std::max(result.wall_seconds, 1e-9);
+
+  std::printf("{\n");
+  std::printf("  \"adapter\": \"%s\",\n", config.adapter.c_str());
+  std::printf("  \"size\": \"%s\",\n", config.size_spec.c_str());
+  std::printf("  \"rate\": \"%s\",\n", config.rate_spec.c_str());
+  std::printf("  \"ring_bytes\": %zu,\n", config.ring_bytes);
+  std::printf("  \"messages\": %lu,\n", result.messages);
+  std::printf("  \"bytes\": %lu,\n", result.bytes);
+  std::printf("  \"wall_seconds\": %.6f,\n", result.wall_seconds);
+  std::printf("  \"throughput_msgs_per_sec\": %.1f,\n",
+              static_cast<double>(result.messages) / seconds);
+  std::printf("  \"throughput_gbit_per_sec\": %.3f,\n",
+              gigabytes * 8 / seconds);
+  print_latency("latency_ns", result.latency_ns);
+  print_latency("transfer_latency_ns", result.transfer_latency_ns);
+  if (result.trace) {
+    print_trace(*result.trace);
+  }
+  if (result.tuning) {
+    print_tuning(*result.tuning);
+  }
+  if (config.checksum) {
+    std::printf("  \"checksum\": {\"accelerated\": %s, \"verified\": %lu, "
+                "\"mismatches\": %lu},\n",
+                oc::crc32c_accelerated() ? "true" : "false",
+                result.checksum_verified, result.checksum_mismatches);
+  }
+  std::printf("  \"cpu_seconds\": %.6f,\n", result.cpu_seconds);
+  std::printf("  \"cpu_seconds_per_gb\": %.6f\n",
+              gigabytes > 0 ? result.cpu_seconds / gigabytes : 0.0);
+  std::printf("}\n");
+}
+
+void usage(const char *argv0) {
+  std::cerr
+      << "usage: " << argv0 << " [options]\n"
+      << "  --adapter=shm|copy|tcp|emulated    transport (default copy)\n"
+      << "  --size=fixed:N | uniform:MIN:MAX | pareto:MIN:MAX:ALPHA\n"
+      << "  --rate=max | constant:R | poisson:R | bursty:R:ON_US:OFF_US\n"
+      << "                                     R in messages per second\n"
+      << "  --messages=N                       stop after N messages\n"
+      << "  --duration-ms=N                    stop after N ms (default 2000)\n"
+      << "  --ring-bytes=N                     ring size, power of two\n"
+      << "  --latency-ns=N                     emulated link latency\n"
+      << "  --bandwidth-gbps=N                 emulated link bandwidth\n"
+      << "  --seed=N                           traffic generator seed\n"
+      << "  --trace-every=N                    trace one message in N\n"
+      << "  --stats=PATH                       publish live counters for\n"
+      << "                                     pipe-top (e.g. /dev/shm/pb)\n"
+      << "  --flight-dump=PATH                 write the last events as a\n"
+      << "                                     Chrome trace at exit or crash\n"
+      << "  --capture=PATH                     record the offered stream\n"
+      << "  --replay=PATH                      offer a recorded stream instead\n"
+      << "                                     of --size/--rate, to its end\n"
+      << "  --replay-speed=X | max             1 keeps the recorded pace\n"
+      << "  --autotune=0|1                     let a PipeTuner pick transfer\n"
+      << "                                     size and depth\n"
+      << "  --latency-target-us=N              tuner backs off above this\n"
+      << "  --batch-bytes=N                    hold forwarding until N bytes\n"
+      << "                                     wait...\n"
+      << "  --batch-us=N                       ...or the oldest is N us old\n"
+      << "  --checksum=0|1                     CRC32C trailer on every message,\n"
+      << "                                     verified on arrival\n";
+}
+
+bench_config parse_args(int argc, char **argv) {
+  bench_config config;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    auto eq = arg.find('=');
+    if (!arg.starts_with("--") || eq == std::string_view::npos) {
+      throw std::invalid_argument("unexpected argument '" + std::string(arg) +
+                                  "'");
+    }
+    auto key = arg.substr(2, eq - 2);
+    auto value = std::string(arg.substr(eq + 1));
+
+    if (key == "adapter") {
+      config.adapter = value;
+    } else if (key == "size") {
+      config.size_spec = value;
+    } else if (key == "rate") {
+      config.rate_spec = value;
+    } else if (key == "messages") {
+      config.messages = std::stoull(value);
+    } else if (key == "duration-ms") {
+      config.duration = std::chrono::milliseconds(std::stoll(value));
+    } else if (key == "ring-bytes") {
+      config.ring_bytes = std::stoull(value);
+    } else if (key == "latency-ns") {
+      config.link.latency = std::chrono::nanoseconds(std::stoll(value));
+    } else if (key == "bandwidth-gbps") {
+      config.link.bandwidth_bytes_per_ns = std::stod(value) / 8;
+    } else if (key == "seed") {
+      config.seed = std::stoull(value);
+    } else if (key == "trace-every") {
+      config.trace_every = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "stats") {
+      config.stats_path = value;
+    } else if (key == "flight-dump") {
+      config.flight_path = value;
+    } else if (key == "capture") {
+      config.capture_path = value;
+    } else if (key == "replay") {
+      config.replay_path = value;
+    } else if (key == "autotune") {
+      config.autotune = value == "1";
+    } else if (key == "latency-target-us") {
+      config.latency_target = std::chrono::microseconds(std::stoll(value));
+    } else if (key == "checksum") {
+      config.checksum = value == "1";
+    } else if (key == "batch-bytes") {
+      config.batching.min_bytes = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "batch-us") {
+      config.batching.deadline = std::chrono::microseconds(std::stoll(value));
+    } else if (key == "replay-speed") {
+      config.replay_speed = value == "max" ? 0 : std::stod(value);
+      if (config.replay_speed < 0) {
+        throw std::invalid_argument("--replay-speed must not be negative");
+      }
+    } else {
+      throw std::invalid_argument("unknown option '--" + std::string(key) +
+                                  "'");
+    }
+  }
+
+  // ring positions are free-running 32-bit counters, so the capacity must
+  // divide 2^32 for offsets to stay continuous across counter wrap
+  if (!std::has_single_bit(config.ring_bytes) ||
+      config.ring_bytes > (std::size_t{1} << 31)) {
+    throw std::invalid_argument("--ring-bytes must be a power of two <= 2^31");
+  }
+  auto trailer = config.checksum ? sizeof(oc::ChunkTrailer) : 0;
+  if (oc::bench::size_distribution::parse(config.size_spec).max_bytes +
+          trailer >
+      config.ring_bytes) {
+    throw std::invalid_argument("largest message does not fit in the ring");
+  }
+  oc::bench::arrival_process::parse(config.rate_spec);
+  return config;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  bench_config config;
+  try {
+    config = parse_args(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << "pipe-bench: " << e.what() << "\n";
+    usage(argv[0]);
+    return 2;
+  }
+
+  try {
+    auto result = run(config);
+    print_json(config, result);
+  } catch (const std::exception &e) {
+    std::cerr << "pipe-bench: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,207 @@
+#include "oc/sim/pipeline_sim.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Predict throughput, latency and the bottleneck hop of a pipeline before
+// deploying it. Each --hop describes one pipe; hops are listed from the
+// producer to the consumer. Runs entirely offline in simulated time.
+
+namespace {
+
+using oc::sim::hop_model;
+using oc::sim::pipeline_model;
+
+std::chrono::nanoseconds nanoseconds(const std::string &value) {
+  return std::chrono::nanoseconds(std::stoll(value));
+}
+
+// key=value[,key=value...]
+hop_model parse_hop(std::string_view spec) {
+  hop_model hop;
+  while (!spec.empty()) {
+    auto comma = spec.find(',');
+    auto field = spec.substr(0, comma);
+    spec = comma == std::string_view::npos ? std::string_view{}
+                                           : spec.substr(comma + 1);
+
+    auto eq = field.find('=');
+    if (eq == std::string_view::npos) {
+      throw std::invalid_argument("hop field '" + std::string(field) +
+                                  "' is not key=value");
+    }
+    auto key = field.substr(0, eq);
+    auto value = std::string(field.substr(eq + 1));
+
+    if (key == "ring-bytes") {
+      hop.dst_capacity = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "depth") {
+      hop.max_in_flight = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "batch-bytes") {
+      hop.max_batch_bytes = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "sg") {
+      hop.scatter_gather = value != "0";
+    } else if (key == "latency-ns") {
+      hop.link.latency = nanoseconds(value);
+    } else if (key == "bandwidth-gbps") {
+      hop.link.bandwidth_bytes_per_ns = std::stod(value) / 8;
+    } else if (key == "per-transfer-ns") {
+      hop.link.per_transfer = nanoseconds(value);
+    } else if (key == "jitter-ns") {
+      hop.link.jitter = nanoseconds(value);
+    } else if (key == "md-latency-ns") {
+      hop.metadata_link.latency = nanoseconds(value);
+    } else if (key == "md-bandwidth-gbps") {
+      hop.metadata_link.bandwidth_bytes_per_ns = std::stod(value) / 8;
+    } else if (key == "metadata") {
+      hop.metadata = oc::sim::metadata_policy::parse(value);
+    } else if (key == "coalesce-bytes") {
+      hop.batching.min_bytes = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "coalesce-ns") {
+      hop.batching.deadline = nanoseconds(value);
+    } else if (key == "round-ns") {
+      hop.round_overhead = nanoseconds(value);
+    } else {
+      throw std::invalid_argument("unknown hop field '" + std::string(key) +
+                                  "'");
+    }
+  }
+  if (!std::has_single_bit(hop.dst_capacity) ||
+      hop.dst_capacity > (uint32_t{1} << 31)) {
+    throw std::invalid_argument("hop ring-bytes must be a power of two <= 2^31");
+  }
+  return hop;
+}
+
+void print_json(const pipeline_model &model, const oc::sim::sim_report &r) {
+  const auto &latency = r.latency_ns;
+  std::printf("{\n");
+  std::printf("  \"messages\": %lu,\n", r.messages);
+  std::printf("  \"bytes\": %lu,\n", r.bytes);
+  std::printf("  \"simulated_seconds\": %.6f,\n",
+              static_cast<double>(r.elapsed.count()) / 1e9);
+  std::printf("  \"throughput_msgs_per_sec\": %.1f,\n",
+              r.messages_per_second());
+  std::printf("  \"throughput_gbit_per_sec\": %.3f,\n", r.gbit_per_second());
+  std::printf("  \"latency_ns\": {\"p50\": %lu, \"p90\": %lu, \"p99\": %lu, "
+              "\"p99.9\": %lu, \"max\": %lu, \"mean\": %.1f},\n",
+              latency.percentile(50), latency.percentile(90),
+              latency.percentile(99), latency.percentile(99.9), latency.max(),
+              latency.mean());
+  std::printf("  \"bottleneck_hop\": %zu,\n", r.bottleneck);
+  std::printf("  \"hops\": [\n");
+  for (std::size_t i = 0; i < r.hops.size(); ++i) {
+    const auto &hop = r.hops[i];
+    auto share = [&](std::chrono::nanoseconds part) {
+      return r.elapsed.count() > 0 ? static_cast<double>(part.count()) /
+                                         static_cast<double>(r.elapsed.count())
+                                   : 0.0;
+    };
+    std::printf("    {\"utilization\": %.3f, \"transferring\": %.3f, "
+                "\"metadata\": %.3f, \"overhead\": %.3f, "
+                "\"stalled_source\": %.3f, \"stalled_destination\": %.3f, "
+                "\"held_batching\": %.3f, \"transfers\": %lu, \"rounds\": %lu, "
+                "\"metadata_stores\": %lu, \"ring_bytes\": %u}%s\n",
+                hop.utilization(r.elapsed), share(hop.transferring),
+                share(hop.metadata), share(hop.overhead),
+                share(hop.stalled_source), share(hop.stalled_destination),
+                share(hop.held_batching), hop.transfers, hop.rounds, hop.metadata_stores,
+                model.hops[i].dst_capacity, i + 1 < r.hops.size() ? "," : "");
+  }
+  std::printf("  ],\n");
+  std::printf("  \"events\": %lu\n", r.events);
+  std::printf("}\n");
+}
+
+void usage(const char *argv0) {
+  std::cerr
+      << "usage: " << argv0 << " --hop=SPEC [--hop=SPEC ...] [options]\n"
+      << "  --hop=K=V[,K=V...]                 one pipe, producer first:\n"
+      << "      ring-bytes=N depth=N batch-bytes=N sg=0|1 round-ns=N\n"
+      << "      latency-ns=N bandwidth-gbps=N per-transfer-ns=N jitter-ns=N\n"
+      << "      md-latency-ns=N md-bandwidth-gbps=N\n"
+      << "      metadata=round|every:N|bytes:N\n"
+      << "      coalesce-bytes=N coalesce-ns=N   hold small records back\n"
+      << "  --hops=N                           N copies of the last --hop\n"
+      << "  --size=fixed:N | uniform:MIN:MAX | pareto:MIN:MAX:ALPHA\n"
+      << "  --rate=max | constant:R | poisson:R | bursty:R:ON_US:OFF_US\n"
+      << "  --source-bytes=N                   producer ring size\n"
+      << "  --messages=N                       stop after N messages\n"
+      << "  --duration-ms=N                    offer load for N simulated ms\n"
+      << "  --consumer-ns=N                    consumer cost per message\n"
+      << "  --seed=N                           traffic and jitter seed\n";
+}
+
+pipeline_model parse_args(int argc, char **argv) {
+  pipeline_model model;
+  model.sizes = oc::bench::size_distribution::parse("fixed:4096");
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    auto eq = arg.find('=');
+    if (!arg.starts_with("--") || eq == std::string_view::npos) {
+      throw std::invalid_argument("unexpected argument '" + std::string(arg) +
+                                  "'");
+    }
+    auto key = arg.substr(2, eq - 2);
+    auto value = std::string(arg.substr(eq + 1));
+
+    if (key == "hop") {
+      model.hops.push_back(parse_hop(value));
+    } else if (key == "hops") {
+      auto count = std::stoul(value);
+      auto hop = model.hops.empty() ? hop_model{} : model.hops.back();
+      model.hops.resize(std::max<std::size_t>(count, 1), hop);
+    } else if (key == "size") {
+      model.sizes = oc::bench::size_distribution::parse(value);
+    } else if (key == "rate") {
+      model.arrivals = oc::bench::arrival_process::parse(value);
+    } else if (key == "source-bytes") {
+      model.source_capacity = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "messages") {
+      model.messages = std::stoull(value);
+    } else if (key == "duration-ms") {
+      model.duration = std::chrono::milliseconds(std::stoll(value));
+      model.messages = 0;
+    } else if (key == "consumer-ns") {
+      model.consumer_cost = nanoseconds(value);
+    } else if (key == "seed") {
+      model.seed = std::stoull(value);
+    } else {
+      throw std::invalid_argument("unknown option '--" + std::string(key) +
+                                  "'");
+    }
+  }
+  if (model.hops.empty()) {
+    model.hops.emplace_back();
+  }
+  if (!std::has_single_bit(model.source_capacity)) {
+    throw std::invalid_argument("--source-bytes must be a power of two");
+  }
+  return model;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  pipeline_model model;
+  try {
+    model = parse_args(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << "pipe-sim: " << e.what() << "\n";
+    usage(argv[0]);
+    return 2;
+  }
+
+  try {
+    print_json(model, oc::sim::simulate(model));
+  } catch (const std::exception &e) {
+    std::cerr << "pipe-sim: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
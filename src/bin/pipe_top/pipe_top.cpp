@@ -0,0 +1,167 @@
+#include "oc/stats_page.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Attach to a pipeline's stats file and print per-pipe rates every interval,
+// like top. The file is mapped read-only and slots are read through their
+// seqlock, so watching a pipeline never slows it down.
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct top_config {
+  std::string path;
+  std::chrono::milliseconds interval{1000};
+  uint64_t iterations = 0; // 0: until interrupted
+};
+
+struct sample {
+  clock_type::time_point when;
+  std::vector<std::optional<oc::PipeStats>> pipes;
+};
+
+sample take_sample(const oc::StatsFile &file) {
+  sample result{clock_type::now(), {}};
+  for (uint32_t pipe = 0; pipe < file.num_pipes(); ++pipe) {
+    result.pipes.push_back(file.slot(pipe).read());
+  }
+  return result;
+}
+
+double per_second(uint64_t now, uint64_t before, double seconds) {
+  return now >= before ? static_cast<double>(now - before) / seconds : 0.0;
+}
+
+void print_rates(const oc::StatsFile &file, const sample &before,
+                 const sample &now) {
+  auto seconds = std::max(
+      std::chrono::duration<double>(now.when - before.when).count(), 1e-9);
+  auto ns_per_tick = file.header().ns_per_tick;
+
+  std::printf("%-4s %10s %10s %5s %12s %12s %12s %12s %9s %9s %9s %9s "
+              "%10s %10s %9s %9s %5s\n",
+              "PIPE", "MB/s", "XFER/s", "INFL", "SRC_HEAD", "SRC_TAIL",
+              "DST_HEAD", "DST_TAIL", "EMPTY/s", "FULL/s", "META/s",
+              "ROUND/s", "ROUND_us", "MAX_us", "HOLD/s", "CHUNK_KB", "DEPTH");
+  for (uint32_t pipe = 0; pipe < file.num_pipes(); ++pipe) {
+    const auto &a = before.pipes[pipe];
+    const auto &b = now.pipes[pipe];
+    if (!a || !b) {
+      std::printf("%-4u %10s\n", pipe, "(busy)");
+      continue;
+    }
+    auto rounds = b->rounds - a->rounds;
+    auto mean_round_us =
+        rounds > 0 ? static_cast<double>(b->round_ticks_total -
+                                         a->round_ticks_total) /
+                         static_cast<double>(rounds) * ns_per_tick / 1e3
+                   : 0.0;
+    std::printf("%-4u %10.1f %10.0f %5lu %12lu %12lu %12lu %12lu %9.0f %9.0f "
+                "%9.0f %9.0f %10.2f %10.2f %9.0f ",
+                pipe,
+                per_second(b->bytes_issued, a->bytes_issued, seconds) / 1e6,
+                per_second(b->transfers_issued, a->transfers_issued, seconds),
+                b->in_flight, b->src_head, b->src_tail, b->dst_head,
+                b->dst_tail,
+                per_second(b->stall_source_empty, a->stall_source_empty,
+                           seconds),
+                per_second(b->stall_destination_full,
+                           a->stall_destination_full, seconds),
+                per_second(b->stall_metadata, a->stall_metadata, seconds),
+                per_second(b->rounds, a->rounds, seconds), mean_round_us,
+                static_cast<double>(b->round_ticks_max) * ns_per_tick / 1e3,
+                per_second(b->held_batching, a->held_batching, seconds));
+    if (b->depth_limit > 0) {
+      std::printf("%9lu %5lu\n", b->chunk_limit >> 10, b->depth_limit);
+    } else {
+      std::printf("%9s %5s\n", "-", "-"); // untuned
+    }
+  }
+  std::fflush(stdout);
+}
+
+void usage(const char *argv0) {
+  std::cerr << "usage: " << argv0 << " --file=PATH [options]\n"
+            << "  --file=PATH          stats file of the pipeline to watch\n"
+            << "  --interval-ms=N      refresh interval (default 1000)\n"
+            << "  --iterations=N       exit after N refreshes\n";
+}
+
+top_config parse_args(int argc, char **argv) {
+  top_config config;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    auto eq = arg.find('=');
+    if (!arg.starts_with("--") || eq == std::string_view::npos) {
+      throw std::invalid_argument("unexpected argument '" + std::string(arg) +
+                                  "'");
+    }
+    auto key = arg.substr(2, eq - 2);
+    auto value = std::string(arg.substr(eq + 1));
+
+    if (key == "file") {
+      config.path = value;
+    } else if (key == "interval-ms") {
+      config.interval = std::chrono::milliseconds(std::stoll(value));
+    } else if (key == "iterations") {
+      config.iterations = std::stoull(value);
+    } else {
+      throw std::invalid_argument("unknown option '--" + std::string(key) +
+                                  "'");
+    }
+  }
+  if (config.path.empty()) {
+    throw std::invalid_argument("--file is required");
+  }
+  if (config.interval.count() <= 0) {
+    throw std::invalid_argument("--interval-ms must be positive");
+  }
+  return config;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  top_config config;
+  try {
+    config = parse_args(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << "pipe-top: " << e.what() << "\n";
+    usage(argv[0]);
+    return 2;
+  }
+
+  try {
+    auto file = oc::StatsFile::attach(config.path);
+    bool clear = ::isatty(STDOUT_FILENO);
+
+    auto before = take_sample(file);
+    for (uint64_t i = 0; config.iterations == 0 || i < config.iterations;
+         ++i) {
+      std::this_thread::sleep_for(config.interval);
+      auto now = take_sample(file);
+      if (clear) {
+        std::printf("\033[H\033[2J");
+      }
+      std::printf("%s  pid %d  %u pipes\n", file.path().c_str(),
+                  file.header().pid, file.num_pipes());
+      print_rates(file, before, now);
+      before = std::move(now);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "pipe-top: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,927 @@
+#include "oc/bench/cpu_topology.hpp"
+#include "oc/bench/perf_counters.hpp"
+#include "oc/codec.hpp"
+#include "oc/rb/basic_rb.hpp"
+#include "oc/rb/columnar_rb.hpp"
+#include "oc/rb/pod_rb.hpp"
+#include "utils/histogram.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Ring buffer microbenchmarks. Every ring type, overflow policy and access
+// mode is run with the producer and consumer pinned to a chosen CPU pair, and
+// each run is printed as one JSON object per line.
+//
+//   throughput  producer streams --elements items in batches, consumer
+//               drains and checks ordering
+//   pingpong    one item bounces between two rings, round trip percentiles
+//   codec       encode and decode --elements numeric records on one core,
+//               against a plain copy of the same bytes
+//   columns     scan one field of --elements 64-byte records through a
+//               PodRingBuffer and through a ColumnarRingBuffer, on one core
+//
+// Overwrite rings pop from the producer side when full, which is not safe
+// with a concurrent consumer, so they are measured on a single thread.
+
+using namespace oc::rb;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+template <std::size_t Bytes> struct element {
+  uint64_t seq;
+  std::byte pad[Bytes - sizeof(uint64_t)];
+};
+
+template <> struct element<sizeof(uint64_t)> {
+  uint64_t seq;
+};
+
+enum class access_mode { single, bulk, zero_copy };
+
+const char *to_string(access_mode mode) {
+  switch (mode) {
+  case access_mode::single:
+    return "single";
+  case access_mode::bulk:
+    return "bulk";
+  case access_mode::zero_copy:
+    return "zero-copy";
+  }
+  return "unknown";
+}
+
+const char *to_string(OverflowPolicy policy) {
+  switch (policy) {
+  case OverflowPolicy::Block:
+    return "block";
+  case OverflowPolicy::Drop:
+    return "drop";
+  case OverflowPolicy::Overwrite:
+    return "overwrite";
+  }
+  return "unknown";
+}
+
+struct bench_config {
+  std::vector<std::string> tests = {"throughput", "pingpong"};
+  std::vector<std::string> rings = {"basic", "pod"};
+  std::vector<std::string> policies = {"block", "drop", "overwrite"};
+  std::vector<std::string> modes = {"single", "bulk", "zero-copy"};
+  std::vector<std::size_t> sizes = {8, 64, 256};
+  std::vector<std::size_t> batches = {1, 16, 256};
+  std::vector<oc::bench::placement> placements = {
+      oc::bench::placement::same_core, oc::bench::placement::smt_sibling,
+      oc::bench::placement::same_socket, oc::bench::placement::cross_socket};
+  std::optional<std::pair<int, int>> cpus; // overrides placements
+  std::size_t capacity = 4096;
+  uint64_t elements = 1 << 20;
+  uint64_t iterations = 20000;
+  bool perf = false;
+
+  template <typename T>
+  static bool contains(const std::vector<T> &list, const T &value) {
+    return std::find(list.begin(), list.end(), value) != list.end();
+  }
+};
+
+// A CPU pair to run on, with the label it is reported under.
+struct cpu_pair {
+  std::string label;
+  int producer;
+  int consumer;
+};
+
+std::vector<cpu_pair> resolve_cpu_pairs(const bench_config &config) {
+  if (config.cpus) {
+    return {{"custom", config.cpus->first, config.cpus->second}};
+  }
+
+  auto cpus = oc::bench::allowed_cpus();
+  std::vector<cpu_pair> pairs;
+  for (auto p : config.placements) {
+    if (auto pair = oc::bench::resolve_placement(p, cpus)) {
+      pairs.push_back({oc::bench::to_string(p), pair->first, pair->second});
+    } else {
+      std::cerr << "rb-bench: no CPU pair for placement "
+                << oc::bench::to_string(p) << ", skipping\n";
+    }
+  }
+  return pairs;
+}
+
+// Spin wait that gives the CPU away when both sides share one; otherwise a
+// spinning thread would starve the peer it is waiting on.
+struct idle_strategy {
+  bool yield;
+
+  void operator()() const {
+    if (yield) {
+      std::this_thread::yield();
+    }
+  }
+};
+
+template <access_mode Mode, typename Ring, typename T>
+std::size_t push_batch(Ring &ring, std::span<const T> items) {
+  if constexpr (Mode == access_mode::single) {
+    std::size_t pushed = 0;
+    for (const auto &item : items) {
+      if (!ring.try_push(item)) {
+        break;
+      }
+      ++pushed;
+    }
+    return pushed;
+  } else if constexpr (Mode == access_mode::bulk) {
+    return ring.try_push_bulk(items);
+  } else {
+    auto view = ring.get_write_view(items.size());
+    auto written = view.write(items);
+    view.commit(written);
+    return written;
+  }
+}
+
+// Hand up to scratch.size() items to f(const T&) in order; returns how many.
+template <access_mode Mode, typename Ring, typename T, typename F>
+std::size_t consume_batch(Ring &ring, std::span<T> scratch, F &&f) {
+  if constexpr (Mode == access_mode::single) {
+    std::size_t popped = 0;
+    while (popped < scratch.size()) {
+      auto item = ring.try_pop();
+      if (!item) {
+        break;
+      }
+      f(*item);
+      ++popped;
+    }
+    return popped;
+  } else if constexpr (Mode == access_mode::bulk) {
+    auto popped = ring.try_pop_bulk(scratch);
+    for (std::size_t i = 0; i < popped; ++i) {
+      f(scratch[i]);
+    }
+    return popped;
+  } else {
+    // read in place, then release the slots
+    std::size_t seen = 0;
+    for (const auto &view : ring.get_read_views(scratch.size())) {
+      for (const auto &item : view) {
+        f(item);
+      }
+      seen += view.size();
+    }
+    ring.advance_read(seen);
+    return seen;
+  }
+}
+
+struct thread_stats {
+  oc::bench::perf_counters::values perf;
+  bool perf_valid = false;
+  uint64_t stalls = 0; // push/pop attempts that made no progress
+};
+
+// Pins the calling thread and brackets `body` with hardware counters.
+template <typename F>
+thread_stats run_pinned(int cpu, bool with_perf, std::atomic<bool> &go,
+                        F &&body) {
+  oc::bench::pin_current_thread(cpu);
+  std::optional<oc::bench::perf_counters> counters;
+  if (with_perf) {
+    counters.emplace();
+  }
+  while (!go.load(std::memory_order_acquire)) {
+  }
+
+  thread_stats stats;
+  if (counters) {
+    counters->start();
+  }
+  stats.stalls = body();
+  if (counters) {
+    counters->stop();
+    stats.perf = counters->read();
+    stats.perf_valid = counters->valid();
+  }
+  return stats;
+}
+
+struct throughput_result {
+  double seconds = 0;
+  uint64_t received = 0;
+  bool in_order = true;
+  thread_stats producer;
+  thread_stats consumer;
+};
+
+template <typename Ring, access_mode Mode, typename T>
+throughput_result run_throughput(const bench_config &config,
+                                 const cpu_pair &cpus, std::size_t batch) {
+  Ring ring(config.capacity);
+  idle_strategy idle{cpus.producer == cpus.consumer};
+  std::atomic<bool> go{false};
+  throughput_result result;
+
+  auto produce = [&] {
+    std::vector<T> items(batch);
+    uint64_t next = 0;
+    uint64_t stalls = 0;
+    while (next < config.elements) {
+      auto count = std::min<uint64_t>(batch, config.elements - next);
+      for (uint64_t i = 0; i < count; ++i) {
+        items[i].seq = next + i;
+      }
+      std::span<const T> pending(items.data(), count);
+      while (!pending.empty()) {
+        auto pushed = push_batch<Mode>(ring, pending);
+        if (pushed == 0) {
+          ++stalls;
+          idle();
+        }
+        pending = pending.subspan(pushed);
+      }
+      next += count;
+    }
+    return stalls;
+  };
+
+  auto consume = [&] {
+    std::vector<T> scratch(batch);
+    uint64_t stalls = 0;
+    while (result.received < config.elements) {
+      auto popped = consume_batch<Mode>(
+          ring, std::span<T>(scratch), [&](const T &item) {
+            result.in_order &= item.seq == result.received;
+            ++result.received;
+          });
+      if (popped == 0) {
+        ++stalls;
+        idle();
+      }
+    }
+    return stalls;
+  };
+
+  std::thread producer([&] {
+    result.producer = run_pinned(cpus.producer, config.perf, go, produce);
+  });
+  std::thread consumer([&] {
+    result.consumer = run_pinned(cpus.consumer, config.perf, go, consume);
+  });
+
+  auto start = clock_type::now();
+  go.store(true, std::memory_order_release);
+  consumer.join();
+  result.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+  producer.join();
+  return result;
+}
+
+// Overwrite rings on one thread: push a batch, drain what survived.
+template <typename Ring, access_mode Mode, typename T>
+throughput_result run_throughput_single_thread(const bench_config &config,
+                                               int cpu, std::size_t batch) {
+  Ring ring(config.capacity);
+  std::atomic<bool> go{true};
+  throughput_result result;
+
+  auto body = [&] {
+    std::vector<T> items(batch);
+    std::vector<T> scratch(config.capacity);
+    uint64_t next = 0;
+    uint64_t last = 0;
+    bool first = true;
+    while (next < config.elements) {
+      auto count = std::min<uint64_t>(batch, config.elements - next);
+      for (uint64_t i = 0; i < count; ++i) {
+        items[i].seq = next + i;
+      }
+      push_batch<Mode>(ring, std::span<const T>(items.data(), count));
+      next += count;
+      consume_batch<Mode>(ring, std::span<T>(scratch), [&](const T &item) {
+        // overwriting may skip items, but never reorders them
+        result.in_order &= first || item.seq > last;
+        first = false;
+        last = item.seq;
+        ++result.received;
+      });
+    }
+    return uint64_t{0};
+  };
+
+  auto start = clock_type::now();
+  result.producer = run_pinned(cpu, config.perf, go, body);
+  result.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+  return result;
+}
+
+struct pingpong_result {
+  oc::utils::Histogram rtt_ns;
+  thread_stats producer;
+  thread_stats consumer;
+};
+
+template <typename Ring, access_mode Mode, typename T>
+pingpong_result run_pingpong(const bench_config &config, const cpu_pair &cpus) {
+  Ring forward(config.capacity);
+  Ring backward(config.capacity);
+  idle_strategy idle{cpus.producer == cpus.consumer};
+  std::atomic<bool> go{false};
+  auto warmup = config.iterations / 10;
+  auto total = warmup + config.iterations;
+
+  pingpong_result result;
+
+  auto bounce = [&](Ring &from, uint64_t expected) {
+    T scratch[1];
+    bool got = false;
+    while (!got) {
+      got = consume_batch<Mode>(from, std::span<T>(scratch), [&](const T &item) {
+              if (item.seq != expected) {
+                std::cerr << "rb-bench: ping-pong out of order\n";
+                std::abort();
+              }
+            }) == 1;
+      if (!got) {
+        idle();
+      }
+    }
+  };
+
+  auto send = [&](Ring &to, uint64_t seq) {
+    T item{};
+    item.seq = seq;
+    while (push_batch<Mode>(to, std::span<const T>(&item, 1)) == 0) {
+      idle();
+    }
+  };
+
+  auto ping = [&] {
+    for (uint64_t i = 0; i < total; ++i) {
+      auto start = clock_type::now();
+      send(forward, i);
+      bounce(backward, i);
+      auto rtt = clock_type::now() - start;
+      if (i >= warmup) {
+        result.rtt_ns.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(rtt).count()));
+      }
+    }
+    return uint64_t{0};
+  };
+
+  auto pong = [&] {
+    for (uint64_t i = 0; i < total; ++i) {
+      bounce(forward, i);
+      send(backward, i);
+    }
+    return uint64_t{0};
+  };
+
+  std::thread producer([&] {
+    result.producer = run_pinned(cpus.producer, config.perf, go, ping);
+  });
+  std::thread consumer([&] {
+    result.consumer = run_pinned(cpus.consumer, config.perf, go, pong);
+  });
+  go.store(true, std::memory_order_release);
+  producer.join();
+  consumer.join();
+  return result;
+}
+
+// A market-data style record: neighbours differ only in their low bits.
+struct tick_record {
+  uint64_t timestamp_ns;
+  double price;
+  uint64_t sequence;
+  uint32_t quantity;
+  uint32_t flags;
+};
+
+struct codec_result {
+  oc::codec_stats stats;
+  double encode_seconds = 0;
+  double decode_seconds = 0;
+  double copy_seconds = 0;
+  bool lossless = false;
+  thread_stats encoder;
+  thread_stats decoder;
+};
+
+codec_result run_codec(const bench_config &config, int cpu) {
+  std::vector<tick_record> records(config.elements);
+  uint64_t state = 1;
+  uint64_t now = 1'700'000'000'000'000'000ull;
+  double price = 100;
+  for (uint64_t i = 0; i < config.elements; ++i) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    now += 900 + (state >> 40) % 200;
+    price += (static_cast<double>((state >> 50) % 5) - 2) * 0.25;
+    records[i] = {now, price, i, static_cast<uint32_t>((state >> 33) % 100),
+                  0x10};
+  }
+
+  oc::RecordEncoder<tick_record> encoder;
+  oc::RecordDecoder<tick_record> decoder;
+  auto block = encoder.block_records();
+  std::vector<std::byte> encoded(
+      (config.elements / block + 1) *
+      oc::RecordEncoder<tick_record>::max_block_bytes(block));
+  std::vector<tick_record> decoded(config.elements);
+  std::size_t encoded_bytes = 0;
+  std::atomic<bool> go{true};
+  codec_result result;
+
+  auto start = clock_type::now();
+  result.encoder = run_pinned(cpu, config.perf, go, [&] {
+    for (std::size_t i = 0; i < records.size(); i += block) {
+      auto bytes = encoder.encode_block(std::span(records).subspan(i));
+      std::memcpy(encoded.data() + encoded_bytes, bytes.data(), bytes.size());
+      encoded_bytes += bytes.size();
+    }
+    return uint64_t{0};
+  });
+  auto encoded_at = clock_type::now();
+  result.decoder = run_pinned(cpu, config.perf, go, [&] {
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < decoded.size();) {
+      auto bytes = std::span(encoded).subspan(offset, encoded_bytes - offset);
+      oc::CodecBlockHeader header;
+      std::memcpy(&header, bytes.data(), sizeof(header));
+      i += decoder.decode_block(bytes, std::span(decoded).subspan(i));
+      offset += header.block_bytes;
+    }
+    return uint64_t{0};
+  });
+  auto decoded_at = clock_type::now();
+  std::vector<tick_record> copied(config.elements);
+  std::memcpy(copied.data(), records.data(),
+              records.size() * sizeof(tick_record));
+  auto copied_at = clock_type::now();
+
+  using seconds = std::chrono::duration<double>;
+  result.encode_seconds = seconds(encoded_at - start).count();
+  result.decode_seconds = seconds(decoded_at - encoded_at).count();
+  result.copy_seconds = seconds(copied_at - decoded_at).count();
+  result.stats = encoder.stats();
+  result.lossless = std::memcmp(decoded.data(), records.data(),
+                                records.size() * sizeof(tick_record)) == 0;
+  return result;
+}
+
+// A 64-byte quote of which consumers typically read one or two fields.
+struct quote_record {
+  uint64_t timestamp_ns;
+  double bid;
+  double ask;
+  uint64_t sequence;
+  uint32_t bid_size;
+  uint32_t ask_size;
+  uint16_t venue;
+  uint16_t flags;
+  std::byte pad[20];
+};
+
+static_assert(sizeof(quote_record) == 64);
+
+using quote_columns =
+    ColumnarRingBuffer<quote_record, &quote_record::timestamp_ns,
+                       &quote_record::bid, &quote_record::ask,
+                       &quote_record::venue>;
+
+struct columns_result {
+  double aos_push_seconds = 0;
+  double soa_push_seconds = 0;
+  double aos_scan_seconds = 0;
+  double soa_scan_seconds = 0;
+  uint64_t aos_hits = 0;
+  uint64_t soa_hits = 0;
+  thread_stats aos;
+  thread_stats soa;
+};
+
+// Rings of --capacity records are filled and then scanned for bids above a
+// threshold, the same count either way; only the memory layout differs. The
+// count is kept in a double so that GCC vectorizes the column loop at the
+// baseline target.
+columns_result run_columns(const bench_config &config, int cpu) {
+  std::vector<quote_record> records(config.capacity);
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    auto bid = 100.0 + static_cast<double>(i * 37 % 1000) * 0.01;
+    records[i] = {i, bid, bid + 0.01, i, 100, 200, static_cast<uint16_t>(i % 9),
+                  0, {}};
+  }
+  constexpr double threshold = 105.0;
+  auto rounds = std::max<uint64_t>(config.elements / config.capacity, 1);
+
+  using seconds = std::chrono::duration<double>;
+  columns_result result;
+  std::atomic<bool> go{true};
+
+  PodRingBuffer<quote_record> aos(config.capacity);
+  result.aos = run_pinned(cpu, config.perf, go, [&] {
+    for (uint64_t round = 0; round < rounds; ++round) {
+      auto start = clock_type::now();
+      aos.try_push_bulk(records);
+      auto pushed = clock_type::now();
+      double hits = 0;
+      for (const auto &view : aos.get_read_views()) {
+        for (const auto &record : view) {
+          hits += record.bid > threshold ? 1.0 : 0.0;
+        }
+      }
+      aos.advance_read(aos.size());
+      result.aos_hits += static_cast<uint64_t>(hits);
+      result.aos_push_seconds += seconds(pushed - start).count();
+      result.aos_scan_seconds += seconds(clock_type::now() - pushed).count();
+    }
+    return uint64_t{0};
+  });
+
+  quote_columns soa(config.capacity);
+  result.soa = run_pinned(cpu, config.perf, go, [&] {
+    for (uint64_t round = 0; round < rounds; ++round) {
+      auto start = clock_type::now();
+      soa.try_push_bulk(records);
+      auto pushed = clock_type::now();
+      double hits = 0;
+      for (auto bids : soa.get_column_views<&quote_record::bid>()) {
+        for (auto bid : bids) {
+          hits += bid > threshold ? 1.0 : 0.0;
+        }
+      }
+      soa.advance_read(soa.size());
+      result.soa_hits += static_cast<uint64_t>(hits);
+      result.soa_push_seconds += seconds(pushed - start).count();
+      result.soa_scan_seconds += seconds(clock_type::now() - pushed).count();
+    }
+    return uint64_t{0};
+  });
+  return result;
+}
+
+// --- output -----------------------------------------------------------------
+
+struct run_labels {
+  const char *ring;
+  const char *policy;
+  const char *mode;
+  std::size_t element_bytes;
+};
+
+void print_common(const char *test, const run_labels &labels,
+                  const bench_config &config, const std::string &placement,
+                  int producer_cpu, int consumer_cpu) {
+  std::printf("{\"test\": \"%s\", \"ring\": \"%s\", \"policy\": \"%s\", "
+              "\"mode\": \"%s\", \"element_bytes\": %zu, \"capacity\": %zu, "
+              "\"placement\": \"%s\", \"producer_cpu\": %d, "
+              "\"consumer_cpu\": %d",
+              test, labels.ring, labels.policy, labels.mode,
+              labels.element_bytes, config.capacity, placement.c_str(),
+              producer_cpu, consumer_cpu);
+}
+
+void print_perf(const char *name, const thread_stats &stats, uint64_t per) {
+  if (!stats.perf_valid) {
+    return;
+  }
+  auto per_item = [&](uint64_t value) {
+    return static_cast<double>(value) / static_cast<double>(std::max<uint64_t>(per, 1));
+  };
+  std::printf(", \"%s_perf\": {\"cycles\": %lu, \"instructions\": %lu, "
+              "\"cache_misses\": %lu, \"branch_misses\": %lu, "
+              "\"cycles_per_item\": %.2f, \"ipc\": %.3f}",
+              name, stats.perf.cycles, stats.perf.instructions,
+              stats.perf.cache_misses, stats.perf.branch_misses,
+              per_item(stats.perf.cycles),
+              stats.perf.cycles
+                  ? static_cast<double>(stats.perf.instructions) /
+                        static_cast<double>(stats.perf.cycles)
+                  : 0.0);
+}
+
+void print_throughput(const run_labels &labels, const bench_config &config,
+                      const std::string &placement, int producer_cpu,
+                      int consumer_cpu, std::size_t batch,
+                      const throughput_result &result) {
+  auto seconds = std::max(result.seconds, 1e-9);
+  print_common("throughput", labels, config, placement, producer_cpu,
+               consumer_cpu);
+  std::printf(", \"batch\": %zu, \"elements\": %lu, \"received\": %lu, "
+              "\"in_order\": %s, \"seconds\": %.6f, \"mitems_per_sec\": %.3f, "
+              "\"gbytes_per_sec\": %.3f, \"producer_stalls\": %lu, "
+              "\"consumer_stalls\": %lu",
+              batch, config.elements, result.received,
+              result.in_order ? "true" : "false", result.seconds,
+              static_cast<double>(result.received) / seconds / 1e6,
+              static_cast<double>(result.received * labels.element_bytes) /
+                  seconds / 1e9,
+              result.producer.stalls, result.consumer.stalls);
+  print_perf("producer", result.producer, config.elements);
+  print_perf("consumer", result.consumer, result.received);
+  std::printf("}\n");
+}
+
+void print_pingpong(const run_labels &labels, const bench_config &config,
+                    const cpu_pair &cpus, const pingpong_result &result) {
+  const auto &rtt = result.rtt_ns;
+
+  print_common("pingpong", labels, config, cpus.label, cpus.producer,
+               cpus.consumer);
+  std::printf(", \"iterations\": %lu, \"rtt_ns\": {\"min\": %lu, \"p50\": %lu, "
+              "\"p90\": %lu, \"p99\": %lu, \"p99.9\": %lu, \"p99.99\": %lu, "
+              "\"max\": %lu, \"mean\": %.1f}",
+              config.iterations, rtt.min(), rtt.percentile(50),
+              rtt.percentile(90), rtt.percentile(99), rtt.percentile(99.9),
+              rtt.percentile(99.99), rtt.max(), rtt.mean());
+  print_perf("producer", result.producer, config.iterations);
+  print_perf("consumer", result.consumer, config.iterations);
+  std::printf("}\n");
+  std::fflush(stdout);
+}
+
+void print_codec(const bench_config &config, int cpu,
+                 const codec_result &result) {
+  auto rate = [&](double seconds) {
+    return static_cast<double>(result.stats.raw_bytes) /
+           std::max(seconds, 1e-9) / 1e9;
+  };
+  std::printf("{\"test\": \"codec\", \"element_bytes\": %zu, "
+              "\"elements\": %lu, \"cpu\": %d, \"lossless\": %s, "
+              "\"ratio\": %.3f, \"encoded_bytes\": %lu, "
+              "\"encode_gbytes_per_sec\": %.3f, "
+              "\"decode_gbytes_per_sec\": %.3f, "
+              "\"memcpy_gbytes_per_sec\": %.3f, "
+              "\"columns\": {\"frame_of_reference\": %lu, \"delta\": %lu, "
+              "\"xor\": %lu}",
+              sizeof(tick_record), config.elements, cpu,
+              result.lossless ? "true" : "false", result.stats.ratio(),
+              result.stats.encoded_bytes, rate(result.encode_seconds),
+              rate(result.decode_seconds), rate(result.copy_seconds),
+              result.stats.columns[0], result.stats.columns[1],
+              result.stats.columns[2]);
+  print_perf("encoder", result.encoder, config.elements);
+  print_perf("decoder", result.decoder, config.elements);
+  std::printf("}\n");
+}
+
+void print_columns(const bench_config &config, int cpu,
+                   const columns_result &result) {
+  auto rounds = std::max<uint64_t>(config.elements / config.capacity, 1);
+  auto records = static_cast<double>(rounds * config.capacity);
+  auto rate = [&](double seconds) {
+    return records / std::max(seconds, 1e-9) / 1e6;
+  };
+  std::printf("{\"test\": \"columns\", \"element_bytes\": %zu, "
+              "\"capacity\": %zu, \"elements\": %.0f, \"cpu\": %d, "
+              "\"columns\": %zu, \"agree\": %s, "
+              "\"aos_push_mrecords_per_sec\": %.1f, "
+              "\"soa_push_mrecords_per_sec\": %.1f, "
+              "\"aos_scan_mrecords_per_sec\": %.1f, "
+              "\"soa_scan_mrecords_per_sec\": %.1f, "
+              "\"scan_speedup\": %.2f",
+              sizeof(quote_record), config.capacity, records, cpu,
+              quote_columns::columns,
+              result.aos_hits == result.soa_hits ? "true" : "false",
+              rate(result.aos_push_seconds), rate(result.soa_push_seconds),
+              rate(result.aos_scan_seconds), rate(result.soa_scan_seconds),
+              result.aos_scan_seconds / std::max(result.soa_scan_seconds, 1e-9));
+  print_perf("aos", result.aos, rounds * config.capacity);
+  print_perf("soa", result.soa, rounds * config.capacity);
+  std::printf("}\n");
+}
+
+// --- suite ------------------------------------------------------------------
+
+template <typename Ring, access_mode Mode, OverflowPolicy Policy, typename T>
+void run_ring(const bench_config &config, const char *ring_name,
+              const std::vector<cpu_pair> &pairs) {
+  run_labels labels{ring_name, to_string(Policy), to_string(Mode), sizeof(T)};
+
+  if constexpr (Policy == OverflowPolicy::Overwrite) {
+    if (bench_config::contains(config.tests, std::string("throughput"))) {
+      auto cpu = pairs.empty() ? 0 : pairs.front().producer;
+      for (auto batch : config.batches) {
+        auto result =
+            run_throughput_single_thread<Ring, Mode, T>(config, cpu, batch);
+        print_throughput(labels, config, "single-thread", cpu, cpu, batch,
+                         result);
+      }
+    }
+    return;
+  }
+
+  for (const auto &cpus : pairs) {
+    if (bench_config::contains(config.tests, std::string("throughput"))) {
+      for (auto batch : config.batches) {
+        auto result = run_throughput<Ring, Mode, T>(config, cpus, batch);
+        print_throughput(labels, config, cpus.label, cpus.producer,
+                         cpus.consumer, batch, result);
+      }
+    }
+    if (bench_config::contains(config.tests, std::string("pingpong"))) {
+      auto result = run_pingpong<Ring, Mode, T>(config, cpus);
+      print_pingpong(labels, config, cpus, result);
+    }
+  }
+}
+
+template <typename T, OverflowPolicy Policy>
+void run_policy(const bench_config &config, const std::vector<cpu_pair> &pairs) {
+  if (!bench_config::contains(config.policies, std::string(to_string(Policy)))) {
+    return;
+  }
+  auto wants_mode = [&](access_mode mode) {
+    return bench_config::contains(config.modes, std::string(to_string(mode)));
+  };
+
+  if (bench_config::contains(config.rings, std::string("basic")) &&
+      wants_mode(access_mode::single)) {
+    run_ring<BasicRingBuffer<T, Policy>, access_mode::single, Policy, T>(
+        config, "basic", pairs);
+  }
+  if (bench_config::contains(config.rings, std::string("pod"))) {
+    if (wants_mode(access_mode::single)) {
+      run_ring<PodRingBuffer<T, Policy>, access_mode::single, Policy, T>(
+          config, "pod", pairs);
+    }
+    if (wants_mode(access_mode::bulk)) {
+      run_ring<PodRingBuffer<T, Policy>, access_mode::bulk, Policy, T>(
+          config, "pod", pairs);
+    }
+    if (wants_mode(access_mode::zero_copy)) {
+      run_ring<PodRingBuffer<T, Policy>, access_mode::zero_copy, Policy, T>(
+          config, "pod", pairs);
+    }
+  }
+}
+
+template <std::size_t Bytes>
+void run_element_size(const bench_config &config,
+                      const std::vector<cpu_pair> &pairs) {
+  if (!bench_config::contains(config.sizes, Bytes)) {
+    return;
+  }
+  run_policy<element<Bytes>, OverflowPolicy::Block>(config, pairs);
+  run_policy<element<Bytes>, OverflowPolicy::Drop>(config, pairs);
+  run_policy<element<Bytes>, OverflowPolicy::Overwrite>(config, pairs);
+}
+
+// --- command line -------------------------------------------------------------
+
+std::vector<std::string> split_list(std::string_view value) {
+  std::vector<std::string> items;
+  while (!value.empty()) {
+    auto comma = value.find(',');
+    items.emplace_back(value.substr(0, comma));
+    if (comma == std::string_view::npos) {
+      break;
+    }
+    value.remove_prefix(comma + 1);
+  }
+  return items;
+}
+
+std::vector<std::size_t> split_numbers(std::string_view value) {
+  std::vector<std::size_t> numbers;
+  for (const auto &item : split_list(value)) {
+    numbers.push_back(std::stoull(item));
+  }
+  return numbers;
+}
+
+void usage(const char *argv0) {
+  std::cerr
+      << "usage: " << argv0 << " [options]   (lists are comma separated)\n"
+      << "  --test=throughput,pingpong,codec,columns\n"
+      << "  --ring=basic,pod\n"
+      << "  --policy=block,drop,overwrite\n"
+      << "  --mode=single,bulk,zero-copy        bulk/zero-copy are pod only\n"
+      << "  --size=8,64,256,1024                element bytes\n"
+      << "  --batch=1,16,256                    throughput batch sizes\n"
+      << "  --placement=same-core,smt,same-socket,cross-socket\n"
+      << "  --cpus=P,C                          explicit producer/consumer\n"
+      << "  --capacity=N                        ring capacity in elements\n"
+      << "  --elements=N                        items per throughput run\n"
+      << "  --iterations=N                      round trips per ping-pong run\n"
+      << "  --perf=0|1                          hardware counters\n";
+}
+
+bench_config parse_args(int argc, char **argv) {
+  bench_config config;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    auto eq = arg.find('=');
+    if (!arg.starts_with("--") || eq == std::string_view::npos) {
+      throw std::invalid_argument("unexpected argument '" + std::string(arg) +
+                                  "'");
+    }
+    auto key = arg.substr(2, eq - 2);
+    auto value = arg.substr(eq + 1);
+
+    if (key == "test") {
+      config.tests = split_list(value);
+    } else if (key == "ring") {
+      config.rings = split_list(value);
+    } else if (key == "policy") {
+      config.policies = split_list(value);
+    } else if (key == "mode") {
+      config.modes = split_list(value);
+    } else if (key == "size") {
+      config.sizes = split_numbers(value);
+    } else if (key == "batch") {
+      config.batches = split_numbers(value);
+    } else if (key == "placement") {
+      config.placements.clear();
+      for (const auto &name : split_list(value)) {
+        auto p = oc::bench::parse_placement(name);
+        if (!p) {
+          throw std::invalid_argument("unknown placement '" + name + "'");
+        }
+        config.placements.push_back(*p);
+      }
+    } else if (key == "cpus") {
+      auto cpus = split_numbers(value);
+      if (cpus.size() != 2) {
+        throw std::invalid_argument("--cpus takes two CPU numbers");
+      }
+      config.cpus = std::pair{static_cast<int>(cpus[0]), static_cast<int>(cpus[1])};
+    } else if (key == "capacity") {
+      config.capacity = std::stoull(std::string(value));
+    } else if (key == "elements") {
+      config.elements = std::stoull(std::string(value));
+    } else if (key == "iterations") {
+      config.iterations = std::stoull(std::string(value));
+    } else if (key == "perf") {
+      config.perf = value == "1";
+    } else {
+      throw std::invalid_argument("unknown option '--" + std::string(key) + "'");
+    }
+  }
+
+  for (auto size : config.sizes) {
+    if (size != 8 && size != 64 && size != 256 && size != 1024) {
+      throw std::invalid_argument("element sizes are 8, 64, 256 or 1024");
+    }
+  }
+  for (auto batch : config.batches) {
+    if (batch == 0 || batch > config.capacity) {
+      throw std::invalid_argument("batch sizes must be in [1, capacity]");
+    }
+  }
+  return config;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  bench_config config;
+  try {
+    config = parse_args(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << "rb-bench: " << e.what() << "\n";
+    usage(argv[0]);
+    return 2;
+  }
+
+  if (config.perf && !oc::bench::perf_counters().valid()) {
+    std::cerr << "rb-bench: perf_event_open unavailable, counters disabled\n";
+    config.perf = false;
+  }
+
+  try {
+    auto pairs = resolve_cpu_pairs(config);
+    run_element_size<8>(config, pairs);
+    run_element_size<64>(config, pairs);
+    run_element_size<256>(config, pairs);
+    run_element_size<1024>(config, pairs);
+    if (bench_config::contains(config.tests, std::string("codec"))) {
+      auto cpu = pairs.empty() ? 0 : pairs.front().producer;
+      print_codec(config, cpu, run_codec(config, cpu));
+    }
+    if (bench_config::contains(config.tests, std::string("columns"))) {
+      auto cpu = pairs.empty() ? 0 : pairs.front().producer;
+      print_columns(config, cpu, run_columns(config, cpu));
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "rb-bench: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -10,23 +10,61 @@
 #include "doca_stdexec/mmap.hpp"
 #include "doca_stdexec/progress_engine.hpp"
 #include "exec/task.hpp"
+#include "oc/bootstrap.hpp"
+#include "oc/metadata_page.hpp"
+#include "oc/mr/doca_mmap_backend.hpp"
 
+#include <cstdlib>
 #include <memory>
+#include <stdexcept>
+#include <vector>
+
+using Registration = oc::mr::DocaRegistrationCache::Registration;
+
+struct aligned_free {
+  void operator()(std::byte *memory) const noexcept { free(memory); }
+};
+
+// Page aligned memory, owned here rather than by the mmap registering it
+using AlignedMemory = std::unique_ptr<std::byte[], aligned_free>;
+
+inline AlignedMemory allocate_aligned(size_t size) {
+  return AlignedMemory(static_cast<std::byte *>(aligned_alloc(4096, size)));
+}
+
+// Exported regions are addressed by the peer from their first byte, so the
+// cache must not grow one by merging it with a neighbouring allocation.
+inline std::shared_ptr<oc::mr::DocaRegistrationCache>
+make_registration_cache(std::shared_ptr<doca_stdexec::Device> device) {
+  return std::make_shared<oc::mr::DocaRegistrationCache>(
+      oc::mr::DocaMMapBackend(std::move(device)),
+      oc::mr::RegistrationCacheConfig{.merge_adjacent = false});
+}
 
 struct RDMASetupResult {
   std::shared_ptr<doca_stdexec::Device> device;
   std::shared_ptr<doca_stdexec::rdma::Rdma> rdma;
   std::shared_ptr<doca_stdexec::rdma::RdmaConnection> rdma_connection;
-  doca_stdexec::MMap<std::byte> src_buffer_mmap;
+
+  // declared in this order so registrations go before the cache and the
+  // cache deregisters before the memory is freed
+  AlignedMemory src_buffer_memory;
+  AlignedMemory src_metadata_memory;
+  std::shared_ptr<oc::mr::DocaRegistrationCache> registrations;
+
+  Registration src_buffer_registration;
   doca_stdexec::MMap<std::byte> dst_buffer_mmap;
-  doca_stdexec::MMap<std::byte> src_tail_mmap;
-  doca_stdexec::MMap<std::byte> dst_tail_mmap;
-  doca_stdexec::MMap<std::byte> src_head_mmap;
-  doca_stdexec::MMap<std::byte> dst_head_mmap;
+
+  // one page holds every counter of every pipe between the two peers
+  oc::MetadataPageLayout metadata_layout;
+  Registration src_metadata_registration;
+  doca_stdexec::MMap<std::byte> dst_metadata_mmap;
 
   doca_stdexec::BufInventory buf_inventory;
   doca_stdexec::Buf src_buffer_buf;
   doca_stdexec::Buf dst_buffer_buf;
+
+  // slots of pipe 0 inside the local (src) and remote (dst) metadata page
   doca_stdexec::Buf src_tail_buf;
   doca_stdexec::Buf dst_tail_buf;
   doca_stdexec::Buf src_head_buf;
@@ -37,32 +75,87 @@ struct RDMASetupResult {
 };
 
 struct SymmetricMMapPair {
-  doca_stdexec::MMap<std::byte> src_mmap;
+  Registration src_registration;
   doca_stdexec::MMap<std::byte> dst_mmap;
 };
 
+// Export descriptor of a registration, which must cover exactly the range
+// it was acquired for
+inline auto export_registration(const Registration &registration,
+                                doca_stdexec::Device &device) {
+  if (registration.offset() != 0 ||
+      registration.region().size() != registration.requested().size()) {
+    throw std::logic_error("exported registration was merged with another");
+  }
+  return registration.handle()->export_rdma(device);
+}
+
+inline doca_stdexec::MMap<std::byte>
+import_remote_mmap(std::span<const std::byte> export_desc,
+                   std::shared_ptr<doca_stdexec::Device> device) {
+  return doca_stdexec::MMap<std::byte>::create_from_export(
+      nullptr, export_desc.data(), export_desc.size(), device);
+}
+
+// Register `memory` and exchange it with the peer on its own round trip.
+// Prefer batching descriptors into one oc::BootstrapMessage.
 inline SymmetricMMapPair
-create_symmetric_mmap(size_t size, std::shared_ptr<doca_stdexec::Device> device,
+create_symmetric_mmap(std::span<std::byte> memory,
+                      oc::mr::DocaRegistrationCache &registrations,
                       doca_stdexec::tcp::tcp_socket &comm) {
+  const auto &device = registrations.backend().device();
+  auto registration = registrations.acquire(memory);
 
-  auto buffer = aligned_alloc(4096, size);
-  auto mmap = doca_stdexec::MMap<std::byte>(
-      std::span<std::byte>(static_cast<std::byte *>(buffer), size));
-  mmap.add_device(device);
-  mmap.set_permissions(DOCA_ACCESS_FLAG_RDMA_WRITE |
-                       DOCA_ACCESS_FLAG_RDMA_READ |
-                       DOCA_ACCESS_FLAG_LOCAL_READ_WRITE);
-  mmap.set_max_devices(8);
-  mmap.set_free_callback([](std::span<std::byte> data) { free(data.data()); });
-  mmap.start();
-
-  auto export_desc = mmap.export_rdma(*device);
+  auto export_desc = export_registration(registration, *device);
   comm.send_dynamic(export_desc);
   auto received_desc = comm.receive_dynamic();
-  auto dst_mmap = doca_stdexec::MMap<std::byte>::create_from_export(
-      nullptr, received_desc.data(), received_desc.size(), device);
+  auto dst_mmap = import_remote_mmap(std::as_bytes(std::span(received_desc)),
+                                     device);
 
-  return SymmetricMMapPair{std::move(mmap), std::move(dst_mmap)};
+  return SymmetricMMapPair{std::move(registration), std::move(dst_mmap)};
+}
+
+// Whole messages over the DOCA socket, which frames them itself, so
+// oc::bootstrap_exchange can run on the connection the RDMA handshake used.
+// The base class's raw reads and writes have no descriptor and fail.
+class DocaSocketComm : public OrderedOutBandCommBase {
+public:
+  explicit DocaSocketComm(doca_stdexec::tcp::tcp_socket &socket)
+      : socket_(socket) {
+    socketfd = -1;
+  }
+
+  void write_message(std::span<const std::byte> message) override {
+    socket_.send_dynamic(
+        std::vector<std::byte>(message.begin(), message.end()));
+  }
+
+  std::vector<std::byte> read_message() override {
+    auto received = socket_.receive_dynamic();
+    auto bytes = std::as_bytes(std::span(received));
+    return {bytes.begin(), bytes.end()};
+  }
+
+private:
+  doca_stdexec::tcp::tcp_socket &socket_;
+};
+
+// Buffer for [offset, offset + len) of a registered mmap
+inline doca_stdexec::Buf buf_for_range(doca_stdexec::BufInventory &inventory,
+                                       doca_stdexec::MMap<std::byte> &mmap,
+                                       size_t offset, size_t len) {
+  auto buf = inventory.get_buffer_for_mmap(mmap);
+  buf.set_data(static_cast<std::byte *>(buf.get_data()) + offset, len);
+  return buf;
+}
+
+// Buffer for [offset, offset + len) of the range a registration was
+// acquired for
+inline doca_stdexec::Buf buf_for_range(doca_stdexec::BufInventory &inventory,
+                                       const Registration &registration,
+                                       size_t offset, size_t len) {
+  return buf_for_range(inventory, *registration.handle(),
+                       registration.offset() + offset, len);
 }
 
 inline exec::task<RDMASetupResult>
@@ -86,40 +179,97 @@ setup_rdma(doca_stdexec::tcp::tcp_socket &comm,
   auto connection = std::make_shared<doca_stdexec::rdma::RdmaConnection>(
       co_await rdma->connect(comm));
 
-  auto [src_buffer_mmap, dst_buffer_mmap] =
-      create_symmetric_mmap(1024 * 1024, device, comm);
+  // a single pipe for now; the page has one forward and one backward slot
+  auto metadata_layout = oc::MetadataPageLayout(1);
+
+  auto registrations = make_registration_cache(device);
+
+  constexpr size_t buffer_size = 1024 * 1024;
+  auto src_buffer_memory = allocate_aligned(buffer_size);
+  auto src_buffer_registration = registrations->acquire(
+      std::span<std::byte>(src_buffer_memory.get(), buffer_size));
+
+  // the peer reads and writes the page as soon as it is exported, so every
+  // slot has to be constructed (zeroed) before that
+  auto src_metadata_memory = allocate_aligned(metadata_layout.size_bytes());
+  auto metadata_page = oc::MetadataPage(
+      std::span<std::byte>(src_metadata_memory.get(),
+                           metadata_layout.size_bytes()),
+      metadata_layout);
+  auto src_metadata_registration =
+      registrations->acquire(metadata_page.bytes());
 
-  auto [src_tail_mmap, dst_tail_mmap] = create_symmetric_mmap(8, device, comm);
-  auto [src_head_mmap, dst_head_mmap] = create_symmetric_mmap(8, device, comm);
+  // every descriptor goes out in one message, so registering both regions
+  // costs a single round trip
+  oc::BootstrapMessage local;
+  local.capabilities = oc::bootstrap_capability::packed_metadata_page;
+  local.add_value(oc::BootstrapEntryKind::MetadataLayout, 0,
+                  metadata_layout.num_pipes());
+  auto buffer_desc = export_registration(src_buffer_registration, *device);
+  local.add(oc::BootstrapEntryKind::DataRingExport, 0,
+            std::as_bytes(std::span(buffer_desc)));
+  auto metadata_desc = export_registration(src_metadata_registration, *device);
+  local.add(oc::BootstrapEntryKind::MetadataPageExport, 0,
+            std::as_bytes(std::span(metadata_desc)));
+
+  auto bootstrap_comm = DocaSocketComm(comm);
+  auto remote = oc::bootstrap_exchange(bootstrap_comm, local);
+
+  if (remote.get_value<uint32_t>(oc::BootstrapEntryKind::MetadataLayout) !=
+      metadata_layout.num_pipes()) {
+    throw std::runtime_error("peer uses a different metadata page layout");
+  }
+
+  auto dst_buffer_mmap = import_remote_mmap(
+      remote.get(oc::BootstrapEntryKind::DataRingExport, 0), device);
+  auto dst_metadata_mmap = import_remote_mmap(
+      remote.get(oc::BootstrapEntryKind::MetadataPageExport), device);
 
   auto buf_inventory = BufInventory(16);
   buf_inventory.start();
-  auto src_buf = buf_inventory.get_buffer_for_mmap(src_buffer_mmap);
+  auto src_buf =
+      buf_for_range(buf_inventory, src_buffer_registration, 0, buffer_size);
   auto dst_buf = buf_inventory.get_buffer_for_mmap(dst_buffer_mmap);
-  auto src_tail_buf = buf_inventory.get_buffer_for_mmap(src_tail_mmap);
-  auto dst_tail_buf = buf_inventory.get_buffer_for_mmap(dst_tail_mmap);
-  auto src_head_buf = buf_inventory.get_buffer_for_mmap(src_head_mmap);
-  auto dst_head_buf = buf_inventory.get_buffer_for_mmap(dst_head_mmap);
 
-  auto [src_metadata_mmap, dst_metadata_mmap] =
-      create_symmetric_mmap(8, device, comm);
-  auto src_metadata_buf = buf_inventory.get_buffer_for_mmap(src_metadata_mmap);
-  auto dst_metadata_buf = buf_inventory.get_buffer_for_mmap(dst_metadata_mmap);
+  auto forward = metadata_layout.forward_offset(0);
+  auto backward = metadata_layout.backward_offset(0);
+  constexpr auto forward_len = sizeof(oc::ForwardSlot);
+  constexpr auto backward_len = sizeof(oc::BackwardSlot);
+
+  auto src_tail_buf = buf_for_range(buf_inventory, src_metadata_registration,
+                                    forward, forward_len);
+  auto dst_tail_buf =
+      buf_for_range(buf_inventory, dst_metadata_mmap, forward, forward_len);
+  auto src_head_buf = buf_for_range(buf_inventory, src_metadata_registration,
+                                    backward, backward_len);
+  auto dst_head_buf =
+      buf_for_range(buf_inventory, dst_metadata_mmap, backward, backward_len);
+  // the local copies of the slots we own double as staging buffers
+  auto forward_metadata_buf = buf_for_range(
+      buf_inventory, src_metadata_registration, forward, forward_len);
+  auto backward_metadata_buf = buf_for_range(
+      buf_inventory, src_metadata_registration, backward, backward_len);
 
   co_return RDMASetupResult{device,
                             std::move(rdma),
                             std::move(connection),
-                            std::move(src_buffer_mmap),
+                            std::move(src_buffer_memory),
+                            std::move(src_metadata_memory),
+                            std::move(registrations),
+                            std::move(src_buffer_registration),
                             std::move(dst_buffer_mmap),
-                            std::move(src_tail_mmap),
-                            std::move(dst_tail_mmap),
-                            std::move(src_head_mmap),
-                            std::move(dst_head_mmap),
+                            metadata_layout,
+                            std::move(src_metadata_registration),
+                            std::move(dst_metadata_mmap),
                             std::move(buf_inventory),
                             std::move(src_buf),
                             std::move(dst_buf),
-                            std::move(src_metadata_buf),
-                            std::move(dst_metadata_buf)};
+                            std::move(src_tail_buf),
+                            std::move(dst_tail_buf),
+                            std::move(src_head_buf),
+                            std::move(dst_head_buf),
+                            std::move(forward_metadata_buf),
+                            std::move(backward_metadata_buf)};
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,310 @@
+#pragma once
+#ifndef AGGREGATE_HPP
+#define AGGREGATE_HPP
+
+#include "oc/rb/pod_rb.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace oc {
+
+/**
+ * @file aggregate.hpp
+ * @brief Per-key windowed aggregates computed where the records land
+ *
+ * Rolling sums, counts and extremes per key need only a handful of numbers
+ * per window, yet computing them downstream means shipping and copying the
+ * whole stream first. WindowAggregator consumes records in place from a
+ * PodRingBuffer, via get_read_views(), and writes one AggregateRecord per
+ * key into a destination ring whenever a window closes.
+ *
+ * Windows are `size` long and start every `slide`, counted in records or,
+ * when a timestamp field is given, in that field's units; slide == size (or
+ * 0) makes them tumbling. Every window is built from panes of one slide
+ * each, and every pane keeps its keys in an open-addressed table with
+ * linear probing over flat slots, so adding a record touches one or two
+ * cache lines. Closing a pane emits the window that ends with it by merging
+ * the size / slide panes it covers.
+ *
+ * Records whose timestamp falls in a pane that has already closed are
+ * dropped and counted as late.
+ */
+
+struct AggregateRecord {
+  uint64_t window_start; // inclusive, in records or timestamp units
+  uint64_t window_end;   // exclusive
+  uint64_t key;
+  uint64_t count;
+  double sum;
+  double min;
+  double max;
+};
+
+static_assert(sizeof(AggregateRecord) == 56);
+
+struct window_spec {
+  uint64_t size = 1000;
+  uint64_t slide = 0; // 0 or `size` for tumbling windows; must divide size
+};
+
+struct aggregate_stats {
+  uint64_t records = 0;
+  uint64_t late = 0;       // dropped, their pane had closed
+  uint64_t windows = 0;    // closed with at least one key
+  uint64_t aggregates = 0; // records emitted
+};
+
+namespace detail {
+
+// Open-addressed per-key table, in insertion order for emission.
+class AggregateTable {
+public:
+  struct slot {
+    uint64_t key;
+    uint64_t count; // 0 marks an empty slot
+    double sum;
+    double min;
+    double max;
+  };
+
+  AggregateTable() { rehash(16); }
+
+  void add(uint64_t key, double value) {
+    auto &s = find(key);
+    if (s.count == 0) {
+      s = {key, 1, value, value, value};
+      return;
+    }
+    ++s.count;
+    s.sum += value;
+    s.min = std::min(s.min, value);
+    s.max = std::max(s.max, value);
+  }
+
+  void merge(const slot &other) {
+    auto &s = find(other.key);
+    if (s.count == 0) {
+      s = other;
+      return;
+    }
+    s.count += other.count;
+    s.sum += other.sum;
+    s.min = std::min(s.min, other.min);
+    s.max = std::max(s.max, other.max);
+  }
+
+  template <typename F> void for_each(F &&f) const {
+    for (auto index : used_) {
+      f(slots_[index]);
+    }
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return used_.empty(); }
+  [[nodiscard]] std::size_t size() const noexcept { return used_.size(); }
+
+  // Keeps the capacity, so a steady key set stops allocating.
+  void clear() noexcept {
+    for (auto index : used_) {
+      slots_[index].count = 0;
+    }
+    used_.clear();
+  }
+
+private:
+  std::size_t home(uint64_t key) const noexcept {
+    return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> shift_);
+  }
+
+  slot &find(uint64_t key) {
+    if ((used_.size() + 1) * 2 > slots_.size()) {
+      rehash(slots_.size() * 2);
+    }
+    auto mask = slots_.size() - 1;
+    for (auto index = home(key);; index = (index + 1) & mask) {
+      auto &s = slots_[index];
+      if (s.count == 0) {
+        s.key = key;
+        used_.push_back(static_cast<uint32_t>(index));
+        return s;
+      }
+      if (s.key == key) {
+        return s;
+      }
+    }
+  }
+
+  void rehash(std::size_t capacity) {
+    std::vector<slot> old;
+    old.swap(slots_);
+    std::vector<uint32_t> order;
+    order.swap(used_);
+    slots_.assign(capacity, slot{});
+    used_.reserve(capacity / 2);
+    shift_ = 64 - std::countr_zero(capacity);
+    for (auto index : order) {
+      merge(old[index]);
+    }
+  }
+
+  std::vector<slot> slots_;
+  std::vector<uint32_t> used_; // occupied slots, in insertion order
+  int shift_ = 0;
+};
+
+} // namespace detail
+
+// Key must name an integral field and Value an arithmetic one; Time, if
+// given, an unsigned timestamp field that windows are measured in.
+template <rb::PodType T, auto Key, auto Value, auto Time = nullptr>
+class WindowAggregator {
+public:
+  explicit WindowAggregator(window_spec spec)
+      : size_(spec.size), slide_(spec.slide == 0 ? spec.size : spec.slide) {
+    if (size_ == 0 || slide_ > size_ || size_ % slide_ != 0) {
+      throw std::invalid_argument(
+          "Window slide must be positive and divide the window size");
+    }
+    panes_.resize(size_ / slide_);
+  }
+
+  // Add one record, closing any panes it moves past.
+  void add(const T &record) {
+    uint64_t position;
+    if constexpr (Time != nullptr) {
+      position = static_cast<uint64_t>(record.*Time);
+    } else {
+      position = seen_++;
+    }
+    auto pane = position / slide_;
+    if (!started_) {
+      current_ = pane;
+      started_ = true;
+    } else if (pane < current_) {
+      ++stats_.late;
+      return;
+    }
+    while (current_ < pane) {
+      close_pane();
+      if (live_panes() == 0) {
+        current_ = pane; // skip a gap of empty windows
+      }
+    }
+    panes_[current_ % panes_.size()].add(
+        static_cast<uint64_t>(record.*Key),
+        static_cast<double>(record.*Value));
+    ++stats_.records;
+  }
+
+  // Consume records from `in` in place and write closed windows to `out`.
+  // Stops taking input while aggregates are waiting for room in `out`, so
+  // a slow reader backs up into `in` rather than into memory. Returns the
+  // aggregates written.
+  template <rb::OverflowPolicy InPolicy, rb::OverflowPolicy OutPolicy>
+  std::size_t pump(rb::PodRingBuffer<T, InPolicy> &in,
+                   rb::PodRingBuffer<AggregateRecord, OutPolicy> &out) {
+    auto written = drain(out);
+    std::size_t consumed = 0;
+    for (const auto &view : in.get_read_views()) {
+      for (const auto &record : view) {
+        if (pending() > 0) {
+          break;
+        }
+        add(record);
+        ++consumed;
+        written += drain(out);
+      }
+    }
+    in.advance_read(consumed);
+    return written;
+  }
+
+  // Close the open pane now, e.g. at the end of a stream, and write what
+  // that emits. Returns the aggregates written.
+  template <rb::OverflowPolicy OutPolicy>
+  std::size_t flush(rb::PodRingBuffer<AggregateRecord, OutPolicy> &out) {
+    if (started_) {
+      close_pane();
+    }
+    return drain(out);
+  }
+
+  // aggregates emitted but not yet written to a destination
+  [[nodiscard]] std::size_t pending() const noexcept {
+    return pending_.size() - pending_head_;
+  }
+
+  [[nodiscard]] const aggregate_stats &stats() const noexcept {
+    return stats_;
+  }
+
+private:
+  std::size_t live_panes() const noexcept {
+    return static_cast<std::size_t>(
+        std::count_if(panes_.begin(), panes_.end(),
+                      [](const auto &pane) { return !pane.empty(); }));
+  }
+
+  // Emit the window ending with the current pane, then retire the pane
+  // that drops out of the next one.
+  void close_pane() {
+    auto end = (current_ + 1) * slide_;
+    auto start = end > size_ ? end - size_ : 0;
+    auto emit = [&](const detail::AggregateTable::slot &s) {
+      pending_.push_back(
+          {start, end, s.key, s.count, s.sum, s.min, s.max});
+    };
+    auto before = pending_.size();
+    if (panes_.size() == 1) {
+      panes_[0].for_each(emit);
+    } else {
+      window_.clear();
+      // oldest pane first, so keys come out in arrival order
+      for (std::size_t i = 1; i <= panes_.size(); ++i) {
+        panes_[(current_ + i) % panes_.size()].for_each(
+            [&](const auto &s) { window_.merge(s); });
+      }
+      window_.for_each(emit);
+    }
+    if (pending_.size() > before) {
+      ++stats_.windows;
+      stats_.aggregates += pending_.size() - before;
+    }
+    ++current_;
+    panes_[current_ % panes_.size()].clear();
+  }
+
+  template <rb::OverflowPolicy OutPolicy>
+  std::size_t drain(rb::PodRingBuffer<AggregateRecord, OutPolicy> &out) {
+    if (pending() == 0) {
+      return 0;
+    }
+    auto written = out.try_push_bulk(
+        std::span<const AggregateRecord>(pending_).subspan(pending_head_));
+    pending_head_ += written;
+    if (pending_head_ == pending_.size()) {
+      pending_.clear();
+      pending_head_ = 0;
+    }
+    return written;
+  }
+
+  uint64_t size_;
+  uint64_t slide_;
+  std::vector<detail::AggregateTable> panes_; // ring of size / slide panes
+  detail::AggregateTable window_;             // scratch for sliding merges
+  uint64_t current_ = 0;                      // index of the open pane
+  uint64_t seen_ = 0;                         // records, for count windows
+  bool started_ = false;
+  std::vector<AggregateRecord> pending_;
+  std::size_t pending_head_ = 0;
+  aggregate_stats stats_;
+};
+
+} // namespace oc
+
+#endif
@@ -0,0 +1,104 @@
+#pragma once
+#ifndef BATCHING_HPP
+#define BATCHING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace oc {
+
+/**
+ * @file batching.hpp
+ * @brief Nagle-style coalescing of small records in front of a pipe
+ *
+ * A pipe forwards whatever was published since its last round, so a
+ * producer that publishes one small record at a time pays one adapter
+ * transfer, and its fixed cost, per record. A BatchGate holds the pipe back
+ * until `min_bytes` are waiting or the oldest waiting byte is `deadline`
+ * old, then lets everything go as one transfer. The deadline bounds the
+ * latency added to a lone record; raising it trades latency for fewer,
+ * larger transfers.
+ *
+ * flush() lets the next round through regardless, for producers that just
+ * published something latency-critical; it may be called from any thread.
+ *
+ * Time is in the caller's unit: utils::tsc_clock ticks in a pipe,
+ * nanoseconds in the simulator.
+ */
+
+struct batch_policy {
+  uint32_t min_bytes = 0;               // forward once this much waits
+  std::chrono::nanoseconds deadline{0}; // or once the oldest byte is this old
+};
+
+class BatchGate {
+public:
+  BatchGate(uint32_t min_bytes, uint64_t deadline)
+      : min_bytes_(min_bytes), deadline_(deadline) {}
+
+  // May a round forward now, with `backlog` bytes waiting?
+  bool ready(uint64_t backlog, uint64_t now) noexcept {
+    if (backlog == 0) {
+      waiting_ = false;
+      return false;
+    }
+    if (!waiting_) {
+      waiting_ = true;
+      since_ = now;
+    }
+    if (flush_requested_.exchange(false, std::memory_order_acquire)) {
+      ++flushed_;
+      return true;
+    }
+    if (backlog >= min_bytes_) {
+      ++filled_;
+      return true;
+    }
+    if (now - since_ >= deadline_) {
+      ++expired_;
+      return true;
+    }
+    ++held_;
+    return false;
+  }
+
+  // A round forwarded and `left` bytes are still waiting; they keep the
+  // age of the oldest.
+  void forwarded(uint64_t left) noexcept {
+    if (left == 0) {
+      waiting_ = false;
+    }
+  }
+
+  void flush() noexcept {
+    flush_requested_.store(true, std::memory_order_release);
+  }
+
+  // when a held backlog's deadline expires
+  [[nodiscard]] uint64_t due() const noexcept { return since_ + deadline_; }
+
+  [[nodiscard]] uint32_t min_bytes() const noexcept { return min_bytes_; }
+  [[nodiscard]] uint64_t deadline() const noexcept { return deadline_; }
+
+  // rounds held back, and batches released by size, deadline or flush
+  [[nodiscard]] uint64_t held() const noexcept { return held_; }
+  [[nodiscard]] uint64_t filled() const noexcept { return filled_; }
+  [[nodiscard]] uint64_t expired() const noexcept { return expired_; }
+  [[nodiscard]] uint64_t flushed() const noexcept { return flushed_; }
+
+private:
+  uint32_t min_bytes_;
+  uint64_t deadline_;
+  bool waiting_ = false;
+  uint64_t since_ = 0;
+  std::atomic<bool> flush_requested_{false};
+  uint64_t held_ = 0;
+  uint64_t filled_ = 0;
+  uint64_t expired_ = 0;
+  uint64_t flushed_ = 0;
+};
+
+} // namespace oc
+
+#endif
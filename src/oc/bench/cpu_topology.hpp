@@ -0,0 +1,119 @@
+#pragma once
+
+#ifndef CPU_TOPOLOGY_HPP
+#define CPU_TOPOLOGY_HPP
+
+#include <fstream>
+#include <optional>
+#include <sched.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace oc::bench {
+
+// Where a CPU sits in the machine, as reported by sysfs.
+struct cpu_info {
+  int cpu;
+  int core;    // physical core id, shared by SMT siblings
+  int package; // socket
+};
+
+// Relative placement of a producer/consumer pair.
+enum class placement { same_core, smt_sibling, same_socket, cross_socket };
+
+inline const char *to_string(placement p) {
+  switch (p) {
+  case placement::same_core:
+    return "same-core";
+  case placement::smt_sibling:
+    return "smt";
+  case placement::same_socket:
+    return "same-socket";
+  case placement::cross_socket:
+    return "cross-socket";
+  }
+  return "unknown";
+}
+
+inline std::optional<placement> parse_placement(std::string_view name) {
+  for (auto p : {placement::same_core, placement::smt_sibling,
+                 placement::same_socket, placement::cross_socket}) {
+    if (name == to_string(p)) {
+      return p;
+    }
+  }
+  return std::nullopt;
+}
+
+namespace detail {
+
+inline std::optional<int> read_sysfs_int(const std::string &path) {
+  std::ifstream in(path);
+  int value;
+  if (in >> value) {
+    return value;
+  }
+  return std::nullopt;
+}
+
+} // namespace detail
+
+// CPUs this process may run on. Without sysfs topology every CPU is treated
+// as its own core on socket 0.
+inline std::vector<cpu_info> allowed_cpus() {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+    return {};
+  }
+
+  std::vector<cpu_info> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (!CPU_ISSET(cpu, &set)) {
+      continue;
+    }
+    auto base =
+        "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+    auto core = detail::read_sysfs_int(base + "core_id");
+    auto package = detail::read_sysfs_int(base + "physical_package_id");
+    cpus.push_back({cpu, core.value_or(cpu), package.value_or(0)});
+  }
+  return cpus;
+}
+
+// Pick a (producer, consumer) CPU pair matching the placement, if the machine
+// has one. Core ids are only unique within a package.
+inline std::optional<std::pair<int, int>>
+resolve_placement(placement p, const std::vector<cpu_info> &cpus) {
+  for (const auto &a : cpus) {
+    if (p == placement::same_core) {
+      return std::pair{a.cpu, a.cpu};
+    }
+    for (const auto &b : cpus) {
+      if (a.cpu == b.cpu) {
+        continue;
+      }
+      bool same_package = a.package == b.package;
+      bool same_core = same_package && a.core == b.core;
+      if ((p == placement::smt_sibling && same_core) ||
+          (p == placement::same_socket && same_package && !same_core) ||
+          (p == placement::cross_socket && !same_package)) {
+        return std::pair{a.cpu, b.cpu};
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+inline bool pin_current_thread(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+} // namespace oc::bench
+
+#endif
@@ -0,0 +1,109 @@
+#pragma once
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace oc::bench {
+
+// Hardware counters for the calling thread, read as one perf_event group so
+// all values cover the same interval. Opening fails quietly (valid() is
+// false) when the kernel or container does not allow perf_event_open.
+class perf_counters {
+public:
+  struct values {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+  };
+
+  perf_counters() {
+    constexpr std::array<uint64_t, num_events> configs = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    for (std::size_t i = 0; i < num_events; ++i) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.disabled = i == 0; // the leader gates the whole group
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+
+      int leader = i == 0 ? -1 : fds_[0];
+      fds_[i] = static_cast<int>(
+          syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+      if (fds_[i] < 0) {
+        close_all();
+        return;
+      }
+    }
+  }
+
+  perf_counters(const perf_counters &) = delete;
+  perf_counters &operator=(const perf_counters &) = delete;
+
+  ~perf_counters() { close_all(); }
+
+  [[nodiscard]] bool valid() const noexcept { return fds_[0] >= 0; }
+
+  void start() {
+    if (valid()) {
+      ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  void stop() {
+    if (valid()) {
+      ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  [[nodiscard]] values read() const {
+    values result;
+    if (!valid()) {
+      return result;
+    }
+    // PERF_FORMAT_GROUP layout: nr, then one value per event in open order
+    std::array<uint64_t, 1 + num_events> buf{};
+    if (::read(fds_[0], buf.data(), sizeof(buf)) !=
+        static_cast<ssize_t>(sizeof(buf))) {
+      return result;
+    }
+    result.cycles = buf[1];
+    result.instructions = buf[2];
+    result.cache_misses = buf[3];
+    result.branch_misses = buf[4];
+    return result;
+  }
+
+private:
+  static constexpr std::size_t num_events = 4;
+
+  void close_all() {
+    for (auto &fd : fds_) {
+      if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+      }
+    }
+  }
+
+  std::array<int, num_events> fds_ = {-1, -1, -1, -1};
+};
+
+} // namespace oc::bench
+
+#endif
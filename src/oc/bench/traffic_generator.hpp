@@ -0,0 +1,253 @@
+#pragma once
+
+#ifndef TRAFFIC_GENERATOR_HPP
+#define TRAFFIC_GENERATOR_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace oc::bench {
+
+namespace detail {
+
+inline std::vector<std::string_view> split_spec(std::string_view spec) {
+  std::vector<std::string_view> fields;
+  while (true) {
+    auto colon = spec.find(':');
+    fields.push_back(spec.substr(0, colon));
+    if (colon == std::string_view::npos) {
+      return fields;
+    }
+    spec.remove_prefix(colon + 1);
+  }
+}
+
+inline double parse_number(std::string_view field, std::string_view spec) {
+  try {
+    std::size_t consumed = 0;
+    auto value = std::stod(std::string(field), &consumed);
+    if (consumed == field.size()) {
+      return value;
+    }
+  } catch (const std::logic_error &) {
+  }
+  throw std::invalid_argument("invalid number '" + std::string(field) +
+                              "' in '" + std::string(spec) + "'");
+}
+
+} // namespace detail
+
+// Message size model.
+//
+//   fixed:<bytes>
+//   uniform:<min>:<max>
+//   pareto:<min>:<max>:<alpha>   bounded Pareto, heavy tail for alpha < 2
+struct size_distribution {
+  enum class kind { fixed, uniform, pareto };
+
+  kind type = kind::fixed;
+  std::size_t min_bytes = 64;
+  std::size_t max_bytes = 64;
+  double alpha = 1.2;
+
+  static size_distribution parse(std::string_view spec) {
+    auto fields = detail::split_spec(spec);
+    auto number = [&](std::size_t i) {
+      return detail::parse_number(fields[i], spec);
+    };
+
+    size_distribution dist;
+    if (fields[0] == "fixed" && fields.size() == 2) {
+      dist.type = kind::fixed;
+      dist.min_bytes = dist.max_bytes = static_cast<std::size_t>(number(1));
+    } else if (fields[0] == "uniform" && fields.size() == 3) {
+      dist.type = kind::uniform;
+      dist.min_bytes = static_cast<std::size_t>(number(1));
+      dist.max_bytes = static_cast<std::size_t>(number(2));
+    } else if (fields[0] == "pareto" && fields.size() == 4) {
+      dist.type = kind::pareto;
+      dist.min_bytes = static_cast<std::size_t>(number(1));
+      dist.max_bytes = static_cast<std::size_t>(number(2));
+      dist.alpha = number(3);
+      if (dist.alpha <= 0) {
+        throw std::invalid_argument("pareto alpha must be positive");
+      }
+    } else {
+      throw std::invalid_argument("invalid size spec '" + std::string(spec) +
+                                  "'");
+    }
+
+    if (dist.min_bytes == 0 || dist.min_bytes > dist.max_bytes) {
+      throw std::invalid_argument("invalid size range in '" +
+                                  std::string(spec) + "'");
+    }
+    return dist;
+  }
+
+  template <typename Rng> std::size_t operator()(Rng &rng) const {
+    switch (type) {
+    case kind::fixed:
+      return min_bytes;
+    case kind::uniform:
+      return std::uniform_int_distribution<std::size_t>(min_bytes,
+                                                        max_bytes)(rng);
+    case kind::pareto: {
+      // inverse CDF of the Pareto distribution truncated to [min, max]
+      auto u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+      auto lo = static_cast<double>(min_bytes);
+      auto hi = static_cast<double>(max_bytes);
+      auto tail = 1.0 - std::pow(lo / hi, alpha);
+      auto x = lo / std::pow(1.0 - u * tail, 1.0 / alpha);
+      return std::clamp(static_cast<std::size_t>(x), min_bytes, max_bytes);
+    }
+    }
+    return min_bytes;
+  }
+};
+
+// Message arrival model, rates in messages per second.
+//
+//   max                                 back to back, as fast as accepted
+//   constant:<rate>
+//   poisson:<rate>
+//   bursty:<rate>:<on_us>:<off_us>      Poisson at <rate> during ON periods,
+//                                       silent during OFF periods
+struct arrival_process {
+  enum class kind { max, constant, poisson, bursty };
+
+  kind type = kind::max;
+  double rate = 0;
+  std::chrono::nanoseconds on_period{0};
+  std::chrono::nanoseconds off_period{0};
+
+  static arrival_process parse(std::string_view spec) {
+    auto fields = detail::split_spec(spec);
+    auto number = [&](std::size_t i) {
+      return detail::parse_number(fields[i], spec);
+    };
+
+    arrival_process process;
+    if (fields[0] == "max" && fields.size() == 1) {
+      process.type = kind::max;
+      return process;
+    } else if (fields[0] == "constant" && fields.size() == 2) {
+      process.type = kind::constant;
+      process.rate = number(1);
+    } else if (fields[0] == "poisson" && fields.size() == 2) {
+      process.type = kind::poisson;
+      process.rate = number(1);
+    } else if (fields[0] == "bursty" && fields.size() == 4) {
+      process.type = kind::bursty;
+      process.rate = number(1);
+      process.on_period = std::chrono::nanoseconds(
+          static_cast<int64_t>(number(2) * 1000));
+      process.off_period = std::chrono::nanoseconds(
+          static_cast<int64_t>(number(3) * 1000));
+      if (process.on_period.count() <= 0 || process.off_period.count() < 0) {
+        throw std::invalid_argument("invalid burst periods in '" +
+                                    std::string(spec) + "'");
+      }
+    } else {
+      throw std::invalid_argument("invalid rate spec '" + std::string(spec) +
+                                  "'");
+    }
+
+    if (process.rate <= 0) {
+      throw std::invalid_argument("rate must be positive in '" +
+                                  std::string(spec) + "'");
+    }
+    return process;
+  }
+
+  // mean offered rate over a whole ON/OFF cycle, 0 for max
+  [[nodiscard]] double mean_rate() const {
+    if (type == kind::bursty) {
+      auto cycle = on_period + off_period;
+      return rate * static_cast<double>(on_period.count()) /
+             static_cast<double>(cycle.count());
+    }
+    return type == kind::max ? 0 : rate;
+  }
+};
+
+// Open-loop traffic source. Arrival times are fixed by the model, not by when
+// the system under test accepts a message, so a stalled consumer shows up as
+// latency instead of silently lowering the offered load.
+template <typename Clock = std::chrono::steady_clock> class traffic_generator {
+public:
+  using time_point = typename Clock::time_point;
+
+  struct message {
+    time_point due;
+    std::size_t bytes;
+  };
+
+  traffic_generator(size_distribution sizes, arrival_process arrivals,
+                    time_point start, uint64_t seed = 1)
+      : sizes_(sizes), arrivals_(arrivals), rng_(seed), start_(start),
+        next_{start, sizes_(rng_)} {}
+
+  // the next message to send; stays the same until pop()
+  [[nodiscard]] const message &peek() const { return next_; }
+
+  // true if the next message is due at `now` (always true for max rate)
+  [[nodiscard]] bool ready(time_point now) const {
+    return arrivals_.type == arrival_process::kind::max || next_.due <= now;
+  }
+
+  void pop() {
+    next_.due = next_arrival(next_.due);
+    next_.bytes = sizes_(rng_);
+  }
+
+  [[nodiscard]] const size_distribution &sizes() const { return sizes_; }
+  [[nodiscard]] const arrival_process &arrivals() const { return arrivals_; }
+
+private:
+  std::chrono::nanoseconds exponential_gap() {
+    auto mean_ns = 1e9 / arrivals_.rate;
+    return std::chrono::nanoseconds(static_cast<int64_t>(
+        std::exponential_distribution<double>(1.0 / mean_ns)(rng_)));
+  }
+
+  time_point next_arrival(time_point previous) {
+    switch (arrivals_.type) {
+    case arrival_process::kind::max:
+      return previous;
+    case arrival_process::kind::constant:
+      return previous + std::chrono::nanoseconds(
+                            static_cast<int64_t>(1e9 / arrivals_.rate));
+    case arrival_process::kind::poisson:
+      return previous + exponential_gap();
+    case arrival_process::kind::bursty: {
+      // arrivals that fall into an OFF period are pushed to the next ON
+      // period, keeping the Poisson process memoryless within bursts
+      auto due = previous + exponential_gap();
+      auto cycle = arrivals_.on_period + arrivals_.off_period;
+      auto phase = (due - start_) % cycle;
+      if (phase >= arrivals_.on_period) {
+        due += cycle - phase;
+      }
+      return due;
+    }
+    }
+    return previous;
+  }
+
+  size_distribution sizes_;
+  arrival_process arrivals_;
+  std::mt19937_64 rng_;
+  time_point start_;
+  message next_;
+};
+
+} // namespace oc::bench
+
+#endif
@@ -0,0 +1,251 @@
+#pragma once
+#ifndef BOOTSTRAP_HPP
+#define BOOTSTRAP_HPP
+
+#include "utils/tcp.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace oc {
+
+/**
+ * @file bootstrap.hpp
+ * @brief Single-round-trip connection bootstrap
+ *
+ * Everything one side needs to tell the other about a connection (exported
+ * mmap descriptors of data rings and metadata pages, connection blobs,
+ * capabilities) is collected into one BootstrapMessage, and each side sends
+ * exactly one message and receives exactly one. Setup cost becomes one round
+ * trip per connection instead of one per registered buffer, and with
+ * bootstrap_exchange_all() one round trip for any number of connections.
+ *
+ * Wire format (host byte order; peers are assumed to share endianness):
+ *
+ *   header:  magic u32 | version u16 | reserved u16 | capabilities u64
+ *            | entry_count u32 | payload_bytes u32
+ *   entries: kind u16 | reserved u16 | pipe u32 | length u32 | bytes[length]
+ *
+ * Unknown entry kinds are kept so that newer peers can add entries without a
+ * version bump; a different version is rejected.
+ */
+
+enum class BootstrapEntryKind : uint16_t {
+  DataRingExport = 1,     // exported mmap of a pipe's data ring
+  MetadataPageExport = 2, // exported mmap of the shared metadata page
+  ConnectionBlob = 3,     // transport connection details (e.g. RDMA QP)
+  MetadataLayout = 4,     // number of pipes the metadata page is laid out for
+};
+
+namespace bootstrap_capability {
+inline constexpr uint64_t scatter_gather = 1ull << 0;
+inline constexpr uint64_t packed_metadata_page = 1ull << 1;
+} // namespace bootstrap_capability
+
+class BootstrapMessage {
+public:
+  static constexpr uint32_t magic = 0x4f434253; // "OCBS"
+  static constexpr uint16_t version = 1;
+
+  struct Entry {
+    BootstrapEntryKind kind;
+    uint32_t pipe;
+    std::vector<std::byte> payload;
+  };
+
+  uint64_t capabilities = 0;
+
+  void add(BootstrapEntryKind kind, uint32_t pipe,
+           std::span<const std::byte> payload) {
+    entries_.push_back({kind, pipe, {payload.begin(), payload.end()}});
+  }
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void add_value(BootstrapEntryKind kind, uint32_t pipe, const T &value) {
+    add(kind, pipe, std::as_bytes(std::span(&value, 1)));
+  }
+
+  [[nodiscard]] const Entry *find(BootstrapEntryKind kind,
+                                  uint32_t pipe = 0) const noexcept {
+    auto it = std::find_if(entries_.begin(), entries_.end(), [&](auto &e) {
+      return e.kind == kind && e.pipe == pipe;
+    });
+    return it == entries_.end() ? nullptr : &*it;
+  }
+
+  // Like find(), but a missing entry is a protocol error
+  [[nodiscard]] std::span<const std::byte> get(BootstrapEntryKind kind,
+                                               uint32_t pipe = 0) const {
+    auto *entry = find(kind, pipe);
+    if (!entry) {
+      throw std::runtime_error("bootstrap: missing entry");
+    }
+    return entry->payload;
+  }
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  [[nodiscard]] T get_value(BootstrapEntryKind kind, uint32_t pipe = 0) const {
+    auto payload = get(kind, pipe);
+    if (payload.size() != sizeof(T)) {
+      throw std::runtime_error("bootstrap: entry size mismatch");
+    }
+    T value;
+    std::memcpy(&value, payload.data(), sizeof(T));
+    return value;
+  }
+
+  [[nodiscard]] const std::vector<Entry> &entries() const noexcept {
+    return entries_;
+  }
+
+  [[nodiscard]] std::vector<std::byte> serialize() const {
+    std::size_t payload_bytes = 0;
+    for (const auto &entry : entries_) {
+      payload_bytes += entry_header_size + entry.payload.size();
+    }
+
+    std::vector<std::byte> out(header_size + payload_bytes);
+    auto *cursor = out.data();
+    put<uint32_t>(cursor, magic);
+    put<uint16_t>(cursor, version);
+    put<uint16_t>(cursor, 0);
+    put<uint64_t>(cursor, capabilities);
+    put<uint32_t>(cursor, static_cast<uint32_t>(entries_.size()));
+    put<uint32_t>(cursor, static_cast<uint32_t>(payload_bytes));
+
+    for (const auto &entry : entries_) {
+      put<uint16_t>(cursor, static_cast<uint16_t>(entry.kind));
+      put<uint16_t>(cursor, 0);
+      put<uint32_t>(cursor, entry.pipe);
+      put<uint32_t>(cursor, static_cast<uint32_t>(entry.payload.size()));
+      std::memcpy(cursor, entry.payload.data(), entry.payload.size());
+      cursor += entry.payload.size();
+    }
+    return out;
+  }
+
+  [[nodiscard]] static BootstrapMessage parse(std::span<const std::byte> in) {
+    if (in.size() < header_size) {
+      throw std::runtime_error("bootstrap: truncated header");
+    }
+
+    const auto *cursor = in.data();
+    const auto *end = in.data() + in.size();
+
+    if (take<uint32_t>(cursor) != magic) {
+      throw std::runtime_error("bootstrap: bad magic");
+    }
+    if (take<uint16_t>(cursor) != version) {
+      throw std::runtime_error("bootstrap: unsupported version");
+    }
+    take<uint16_t>(cursor);
+
+    BootstrapMessage message;
+    message.capabilities = take<uint64_t>(cursor);
+    auto entry_count = take<uint32_t>(cursor);
+    auto payload_bytes = take<uint32_t>(cursor);
+
+    if (payload_bytes != static_cast<std::size_t>(end - cursor)) {
+      throw std::runtime_error("bootstrap: payload size mismatch");
+    }
+
+    // the count comes from the peer: every entry takes at least its header,
+    // so a larger count cannot be honest and must not size the reservation
+    if (entry_count > payload_bytes / entry_header_size) {
+      throw std::runtime_error("bootstrap: entry count exceeds payload");
+    }
+    message.entries_.reserve(entry_count);
+    for (uint32_t i = 0; i < entry_count; ++i) {
+      if (end - cursor < static_cast<std::ptrdiff_t>(entry_header_size)) {
+        throw std::runtime_error("bootstrap: truncated entry");
+      }
+      auto kind = static_cast<BootstrapEntryKind>(take<uint16_t>(cursor));
+      take<uint16_t>(cursor);
+      auto pipe = take<uint32_t>(cursor);
+      auto length = take<uint32_t>(cursor);
+      if (static_cast<std::size_t>(end - cursor) < length) {
+        throw std::runtime_error("bootstrap: truncated entry payload");
+      }
+      message.add(kind, pipe, {cursor, length});
+      cursor += length;
+    }
+
+    if (cursor != end) {
+      throw std::runtime_error("bootstrap: trailing bytes");
+    }
+    return message;
+  }
+
+private:
+  static constexpr std::size_t header_size = 4 + 2 + 2 + 8 + 4 + 4;
+  static constexpr std::size_t entry_header_size = 2 + 2 + 4 + 4;
+
+  template <typename T> static void put(std::byte *&cursor, T value) {
+    std::memcpy(cursor, &value, sizeof(T));
+    cursor += sizeof(T);
+  }
+
+  template <typename T> static T take(const std::byte *&cursor) {
+    T value;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+  }
+
+  std::vector<Entry> entries_;
+};
+
+// Capabilities both sides can use
+[[nodiscard]] inline uint64_t
+negotiated_capabilities(const BootstrapMessage &local,
+                        const BootstrapMessage &remote) noexcept {
+  return local.capabilities & remote.capabilities;
+}
+
+/**
+ * @brief Send our message and receive the peer's: one round trip
+ *
+ * Both sides write before reading, so neither waits for the other to speak
+ * first.
+ */
+inline BootstrapMessage bootstrap_exchange(OrderedOutBandCommBase &comm,
+                                           const BootstrapMessage &local) {
+  comm.write_message(local.serialize());
+  return BootstrapMessage::parse(comm.read_message());
+}
+
+/**
+ * @brief Bootstrap many connections at once
+ *
+ * All messages go out before any reply is awaited, so the exchanges overlap
+ * and the total wait is roughly the slowest single round trip rather than
+ * their sum.
+ */
+inline std::vector<BootstrapMessage>
+bootstrap_exchange_all(std::span<OrderedOutBandCommBase *const> comms,
+                       std::span<const BootstrapMessage> locals) {
+  if (comms.size() != locals.size()) {
+    throw std::invalid_argument("bootstrap: one message per connection");
+  }
+
+  for (std::size_t i = 0; i < comms.size(); ++i) {
+    comms[i]->write_message(locals[i].serialize());
+  }
+
+  std::vector<BootstrapMessage> remotes;
+  remotes.reserve(comms.size());
+  for (auto *comm : comms) {
+    remotes.push_back(BootstrapMessage::parse(comm->read_message()));
+  }
+  return remotes;
+}
+
+} // namespace oc
+
+#endif
@@ -0,0 +1,273 @@
+#include "capture.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <time.h>
+#include <unistd.h>
+
+namespace oc {
+
+namespace {
+
+constexpr std::size_t write_batch = 1 << 16;
+
+[[noreturn]] void throw_errno(const char *what) {
+  throw std::system_error(errno, std::system_category(), what);
+}
+
+bool write_all(int fd, const void *data, std::size_t size) {
+  auto *bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    auto n = ::write(fd, bytes, size);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+void put_varint(std::vector<uint8_t> &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t get_varint(std::span<const std::byte> in, std::size_t &pos) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (pos >= in.size()) {
+      throw std::runtime_error("Truncated capture entry");
+    }
+    auto byte = std::to_integer<uint8_t>(in[pos++]);
+    value |= uint64_t{byte & 0x7fu} << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+  throw std::runtime_error("Malformed varint in capture");
+}
+
+// Copy `size` bytes starting `offset` bytes into the two read views.
+void copy_out(const std::array<rb::ZeroCopyView<std::byte>, 2> &views,
+              std::size_t offset, std::size_t size, void *out) {
+  auto *dst = static_cast<std::byte *>(out);
+  for (const auto &view : views) {
+    if (offset >= view.size()) {
+      offset -= view.size();
+      continue;
+    }
+    auto n = std::min(size, view.size() - offset);
+    std::memcpy(dst, view.data() + offset, n);
+    dst += n;
+    size -= n;
+    offset = 0;
+  }
+}
+
+} // namespace
+
+StreamRecorder::StreamRecorder(const std::string &path, options opts)
+    : opts_(opts), staging_(opts.staging_bytes),
+      last_stamp_(utils::tsc_clock::now()) {
+  if (opts.staging_bytes < 2 * sizeof(frame)) {
+    throw std::invalid_argument("Capture staging ring is too small");
+  }
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    throw_errno("open(capture) failed");
+  }
+
+  CaptureHeader header{};
+  std::memcpy(header.magic, CaptureHeader::expected_magic,
+              sizeof(header.magic));
+  header.version = CaptureHeader::current_version;
+  header.flags = opts.payload ? CaptureHeader::has_payload : 0;
+  timespec wall{};
+  ::clock_gettime(CLOCK_REALTIME, &wall);
+  header.start_unix_ns = int64_t{wall.tv_sec} * 1'000'000'000 + wall.tv_nsec;
+  if (!write_all(fd_, &header, sizeof(header))) {
+    int saved = errno;
+    ::close(fd_);
+    errno = saved;
+    throw_errno("write(capture header) failed");
+  }
+
+  encoded_.reserve(2 * write_batch);
+  writer_ = std::thread([this] { run(); });
+}
+
+StreamRecorder::~StreamRecorder() {
+  try {
+    close();
+  } catch (...) {
+    // the destructor cannot report a failed write; call close() to see it
+  }
+}
+
+void StreamRecorder::close() {
+  if (writer_.joinable()) {
+    stop_.store(true, std::memory_order_release);
+    writer_.join();
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  if (int error = error_.exchange(0)) {
+    throw std::system_error(error, std::system_category(),
+                            "write(capture) failed");
+  }
+}
+
+void StreamRecorder::run() noexcept {
+  while (true) {
+    // read the flag first so a record pushed before stop is still drained
+    bool stopping = stop_.load(std::memory_order_acquire);
+    if (drain()) {
+      continue;
+    }
+    write_out();
+    if (stopping) {
+      return;
+    }
+    std::this_thread::sleep_for(opts_.idle_flush);
+  }
+}
+
+bool StreamRecorder::drain() {
+  bool progressed = false;
+  while (true) {
+    auto views = staging_.get_read_views();
+    auto available = views[0].size() + views[1].size();
+    if (available < sizeof(frame)) {
+      break;
+    }
+    frame f;
+    copy_out(views, 0, sizeof(f), &f);
+    auto payload =
+        f.kind == frame::record && opts_.payload ? std::size_t(f.length) : 0;
+    if (available < sizeof(f) + payload) {
+      break; // the producer is between the frame and its payload
+    }
+
+    auto gap = f.stamp > last_stamp_
+                   ? utils::tsc_clock::to_nanoseconds(f.stamp - last_stamp_)
+                   : 0;
+    last_stamp_ = std::max(last_stamp_, f.stamp);
+    put_varint(encoded_, static_cast<uint64_t>(gap));
+    put_varint(encoded_, uint64_t{f.length} << 1 | f.kind);
+    auto at = encoded_.size();
+    encoded_.resize(at + payload);
+    copy_out(views, sizeof(f), payload, encoded_.data() + at);
+    staging_.advance_read(sizeof(f) + payload);
+    progressed = true;
+
+    if (encoded_.size() >= write_batch) {
+      write_out();
+    }
+  }
+  return progressed;
+}
+
+void StreamRecorder::write_out() {
+  if (encoded_.empty()) {
+    return;
+  }
+  if (error_.load(std::memory_order_relaxed) == 0 &&
+      !write_all(fd_, encoded_.data(), encoded_.size())) {
+    error_.store(errno, std::memory_order_relaxed);
+  }
+  encoded_.clear();
+}
+
+StreamCapture StreamCapture::load(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw_errno("open(capture) failed");
+  }
+  struct stat st{};
+  if (::fstat(fd, &st) < 0) {
+    int saved = errno;
+    ::close(fd);
+    errno = saved;
+    throw_errno("fstat(capture) failed");
+  }
+
+  StreamCapture capture;
+  auto size = static_cast<std::size_t>(st.st_size);
+  if (size < sizeof(CaptureHeader)) {
+    ::close(fd);
+    throw std::runtime_error("Capture file is too short: " + path);
+  }
+  capture.data_.resize(size - sizeof(CaptureHeader));
+  auto read_all = [fd](void *out, std::size_t n) {
+    auto *bytes = static_cast<char *>(out);
+    while (n > 0) {
+      auto got = ::read(fd, bytes, n);
+      if (got < 0 && errno == EINTR) {
+        continue;
+      }
+      if (got <= 0) {
+        return false;
+      }
+      bytes += got;
+      n -= static_cast<std::size_t>(got);
+    }
+    return true;
+  };
+  bool ok = read_all(&capture.header_, sizeof(CaptureHeader)) &&
+            read_all(capture.data_.data(), capture.data_.size());
+  int saved = errno;
+  ::close(fd);
+  if (!ok) {
+    errno = saved;
+    throw_errno("read(capture) failed");
+  }
+
+  const auto &header = capture.header_;
+  if (std::memcmp(header.magic, CaptureHeader::expected_magic,
+                  sizeof(header.magic)) != 0) {
+    throw std::runtime_error("Not a capture file: " + path);
+  }
+  if (header.version != CaptureHeader::current_version) {
+    throw std::runtime_error("Unsupported capture version " +
+                             std::to_string(header.version));
+  }
+
+  std::span<const std::byte> in(capture.data_);
+  bool payloads = capture.has_payload();
+  std::chrono::nanoseconds offset{0};
+  std::size_t pos = 0;
+  while (pos < in.size()) {
+    offset += std::chrono::nanoseconds(get_varint(in, pos));
+    auto tag = get_varint(in, pos);
+    auto length = static_cast<std::size_t>(tag >> 1);
+    if (tag & 1) {
+      capture.dropped_ += length;
+      continue;
+    }
+    std::span<const std::byte> payload;
+    if (payloads) {
+      if (in.size() - pos < length) {
+        throw std::runtime_error("Truncated capture payload");
+      }
+      payload = in.subspan(pos, length);
+      pos += length;
+    }
+    capture.records_.push_back({offset, length, payload});
+  }
+  return capture;
+}
+
+} // namespace oc
@@ -0,0 +1,264 @@
+#pragma once
+#ifndef CAPTURE_HPP
+#define CAPTURE_HPP
+
+#include "oc/rb/pod_rb.hpp"
+#include "utils/tsc_clock.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace oc {
+
+/**
+ * @file capture.hpp
+ * @brief Record a record stream to disk and replay it into a pipeline
+ *
+ * A capture file is a fixed header followed by one varint-encoded entry per
+ * record:
+ *
+ *   [CaptureHeader] { varint gap_ns, varint length * 2 + kind, payload }...
+ *
+ * gap_ns is the time since the previous entry (or the start of the capture),
+ * so the file keeps inter-arrival times at nanosecond resolution in one or
+ * two bytes for dense traffic. Payloads are optional: a shape-only capture
+ * keeps record boundaries and timing but no data. A drop entry (kind 1)
+ * stands for `length` records the recorder had to skip.
+ *
+ * StreamRecorder is the tee on the hot path: record() copies the record into
+ * an in-memory staging ring and returns; a background thread encodes and
+ * writes. When the ring is full the record is dropped and counted instead of
+ * stalling the producer. StreamCapture loads a file and replay_source feeds
+ * it to a producer at the original pace, scaled, or as fast as accepted.
+ */
+
+struct CaptureHeader {
+  static constexpr char expected_magic[8] = {'O', 'C', 'C', 'A',
+                                             'P', 'T', 'R', 0};
+  static constexpr uint32_t current_version = 1;
+  static constexpr uint32_t has_payload = 1;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  int64_t start_unix_ns; // wall clock at capture start, informational
+  uint64_t reserved;
+};
+
+static_assert(sizeof(CaptureHeader) == 32);
+
+class StreamRecorder {
+public:
+  struct options {
+    bool payload = true;
+    std::size_t staging_bytes = 1 << 24;
+    std::chrono::milliseconds idle_flush{10};
+  };
+
+  // Creates (truncates) `path` and starts the writer thread.
+  StreamRecorder(const std::string &path, options opts);
+  explicit StreamRecorder(const std::string &path)
+      : StreamRecorder(path, options{}) {}
+  ~StreamRecorder();
+
+  StreamRecorder(const StreamRecorder &) = delete;
+  StreamRecorder &operator=(const StreamRecorder &) = delete;
+
+  // Producer: tee one record. Never blocks; returns false if the record was
+  // dropped because the writer fell behind. Single producer.
+  bool record(std::span<const std::byte> data,
+              utils::tsc_clock::ticks now = utils::tsc_clock::now()) noexcept {
+    return record(data, {}, now);
+  }
+
+  // A record stored in two pieces, e.g. across the wrap of a ring
+  bool record(std::span<const std::byte> first,
+              std::span<const std::byte> second,
+              utils::tsc_clock::ticks now = utils::tsc_clock::now()) noexcept {
+    auto length = first.size() + second.size();
+    auto payload = opts_.payload ? length : 0;
+    auto need = sizeof(frame) * (pending_drops_ ? 2 : 1) + payload;
+    if (staging_.available() < need) {
+      ++pending_drops_;
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (pending_drops_) {
+      push(frame{now, pending_drops_, frame::dropped});
+      pending_drops_ = 0;
+    }
+    push(frame{now, length, frame::record});
+    if (opts_.payload) {
+      staging_.try_push_bulk(first);
+      staging_.try_push_bulk(second);
+    }
+    recorded_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Drain the staging ring, flush and close the file; idempotent. Throws if
+  // the writer hit an I/O error.
+  void close();
+
+  [[nodiscard]] uint64_t recorded() const noexcept {
+    return recorded_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] uint64_t dropped() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct frame {
+    enum kind_t : uint64_t { record = 0, dropped = 1 };
+
+    utils::tsc_clock::ticks stamp;
+    uint64_t length : 63;
+    uint64_t kind : 1;
+  };
+
+  static_assert(sizeof(frame) == 16);
+
+  void push(const frame &f) noexcept {
+    staging_.try_push_bulk(std::as_bytes(std::span(&f, 1)));
+  }
+
+  void run() noexcept;
+  bool drain();
+  void write_out();
+
+  options opts_;
+  int fd_ = -1;
+  rb::PodDroppingRingBuffer<std::byte> staging_;
+  uint64_t pending_drops_ = 0; // producer only
+  std::atomic<uint64_t> recorded_{0};
+  std::atomic<uint64_t> dropped_{0};
+
+  // writer thread
+  utils::tsc_clock::ticks last_stamp_;
+  std::vector<uint8_t> encoded_;
+  std::atomic<bool> stop_{false};
+  std::atomic<int> error_{0};
+  std::thread writer_;
+};
+
+/**
+ * @brief A capture file loaded into memory
+ */
+class StreamCapture {
+public:
+  struct entry {
+    std::chrono::nanoseconds offset; // since the capture started
+    std::size_t bytes;
+    std::span<const std::byte> payload; // empty in shape-only captures
+  };
+
+  static StreamCapture load(const std::string &path);
+
+  // entries point into the capture's own buffer
+  StreamCapture(const StreamCapture &) = delete;
+  StreamCapture &operator=(const StreamCapture &) = delete;
+  StreamCapture(StreamCapture &&) noexcept = default;
+  StreamCapture &operator=(StreamCapture &&) noexcept = default;
+
+  [[nodiscard]] const std::vector<entry> &records() const noexcept {
+    return records_;
+  }
+
+  [[nodiscard]] bool has_payload() const noexcept {
+    return header_.flags & CaptureHeader::has_payload;
+  }
+
+  [[nodiscard]] const CaptureHeader &header() const noexcept {
+    return header_;
+  }
+
+  // records the recorder dropped while capturing
+  [[nodiscard]] uint64_t dropped() const noexcept { return dropped_; }
+
+  [[nodiscard]] std::chrono::nanoseconds duration() const noexcept {
+    return records_.empty() ? std::chrono::nanoseconds{0}
+                            : records_.back().offset;
+  }
+
+private:
+  StreamCapture() = default;
+
+  CaptureHeader header_{};
+  std::vector<std::byte> data_;
+  std::vector<entry> records_;
+  uint64_t dropped_ = 0;
+};
+
+/**
+ * @brief Offers the records of a capture to a producer on their schedule
+ *
+ * Same peek/ready/pop shape as bench::traffic_generator. `speed` scales the
+ * captured gaps: 1 keeps the original pace, 2 halves every gap, and 0 (max)
+ * makes every record ready as soon as the previous one was accepted.
+ */
+template <typename Clock = std::chrono::steady_clock> class replay_source {
+public:
+  using time_point = typename Clock::time_point;
+
+  struct message {
+    time_point due;
+    std::size_t bytes;
+    std::span<const std::byte> payload;
+  };
+
+  replay_source(const StreamCapture &capture, double speed, time_point start)
+      : capture_(capture), speed_(speed), start_(start) {
+    if (speed < 0) {
+      throw std::invalid_argument("replay speed must not be negative");
+    }
+    load();
+  }
+
+  [[nodiscard]] bool done() const noexcept {
+    return index_ == capture_.records().size();
+  }
+
+  // the next record; stays the same until pop()
+  [[nodiscard]] const message &peek() const { return next_; }
+
+  [[nodiscard]] bool ready(time_point now) const {
+    return !done() && (speed_ == 0 || next_.due <= now);
+  }
+
+  void pop() {
+    ++index_;
+    load();
+  }
+
+private:
+  void load() {
+    if (done()) {
+      return;
+    }
+    const auto &entry = capture_.records()[index_];
+    auto offset = speed_ == 0 ? std::chrono::nanoseconds{0}
+                              : std::chrono::nanoseconds(static_cast<int64_t>(
+                                    static_cast<double>(entry.offset.count()) /
+                                    speed_));
+    next_ = {start_ + std::chrono::duration_cast<typename Clock::duration>(
+                          offset),
+             entry.bytes, entry.payload};
+  }
+
+  const StreamCapture &capture_;
+  double speed_;
+  time_point start_;
+  std::size_t index_ = 0;
+  message next_{};
+};
+
+} // namespace oc
+
+#endif
@@ -0,0 +1,180 @@
+#include "checksum.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace oc {
+
+namespace {
+
+constexpr uint32_t castagnoli = 0x82f63b78; // reflected polynomial
+
+// the three hardware streams run over blocks of these sizes
+constexpr std::size_t long_block = 8192;
+constexpr std::size_t short_block = 256;
+
+using shift_table = uint32_t[4][256];
+
+struct crc_tables {
+  uint32_t slice[8][256];
+  shift_table shift_long;
+  shift_table shift_short;
+};
+
+// the raw CRC register after `len` zero bytes
+uint32_t shift_zeros(uint32_t crc, std::size_t len,
+                     const uint32_t (&table)[256]) noexcept {
+  while (len-- > 0) {
+    crc = table[crc & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+// Appending `len` zero bytes is linear in the register, so it is tabulated
+// per register byte from its effect on each of the 32 bits.
+void fill_shift(shift_table &out, std::size_t len,
+                const uint32_t (&table)[256]) noexcept {
+  uint32_t basis[32];
+  for (int bit = 0; bit < 32; ++bit) {
+    basis[bit] = shift_zeros(uint32_t{1} << bit, len, table);
+  }
+  for (int k = 0; k < 4; ++k) {
+    for (uint32_t n = 0; n < 256; ++n) {
+      uint32_t value = 0;
+      for (int bit = 0; bit < 8; ++bit) {
+        if (n & (1u << bit)) {
+          value ^= basis[8 * k + bit];
+        }
+      }
+      out[k][n] = value;
+    }
+  }
+}
+
+const crc_tables &tables() noexcept {
+  static const crc_tables built = [] {
+    crc_tables t{};
+    for (uint32_t n = 0; n < 256; ++n) {
+      auto crc = n;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = crc & 1 ? (crc >> 1) ^ castagnoli : crc >> 1;
+      }
+      t.slice[0][n] = crc;
+    }
+    for (uint32_t n = 0; n < 256; ++n) {
+      for (int k = 1; k < 8; ++k) {
+        auto previous = t.slice[k - 1][n];
+        t.slice[k][n] = (previous >> 8) ^ t.slice[0][previous & 0xff];
+      }
+    }
+    fill_shift(t.shift_long, long_block, t.slice[0]);
+    fill_shift(t.shift_short, short_block, t.slice[0]);
+    return t;
+  }();
+  return built;
+}
+
+uint64_t load64(const std::byte *p) noexcept {
+  uint64_t word;
+  std::memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+uint32_t software(const std::byte *p, std::size_t n, uint32_t crc) noexcept {
+  const auto &t = tables().slice;
+  crc = ~crc;
+  while (n >= 8) {
+    auto word = load64(p) ^ crc;
+    crc = t[7][word & 0xff] ^ t[6][(word >> 8) & 0xff] ^
+          t[5][(word >> 16) & 0xff] ^ t[4][(word >> 24) & 0xff] ^
+          t[3][(word >> 32) & 0xff] ^ t[2][(word >> 40) & 0xff] ^
+          t[1][(word >> 48) & 0xff] ^ t[0][word >> 56];
+    p += 8;
+    n -= 8;
+  }
+  while (n-- > 0) {
+    crc = t[0][(crc ^ std::to_integer<uint32_t>(*p++)) & 0xff] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+#if defined(__x86_64__)
+
+uint32_t shift(const shift_table &table, uint32_t crc) noexcept {
+  return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^
+         table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+}
+
+// Three streams over consecutive blocks, then the first two are shifted
+// past the blocks behind them and folded in.
+template <std::size_t Block>
+__attribute__((target("sse4.2"))) uint64_t
+interleaved(const std::byte *&p, std::size_t &n, uint64_t crc0,
+            const shift_table &table) noexcept {
+  while (n >= 3 * Block) {
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    for (std::size_t i = 0; i < Block; i += 8) {
+      crc0 = _mm_crc32_u64(crc0, load64(p + i));
+      crc1 = _mm_crc32_u64(crc1, load64(p + Block + i));
+      crc2 = _mm_crc32_u64(crc2, load64(p + 2 * Block + i));
+    }
+    crc0 = shift(table, static_cast<uint32_t>(crc0)) ^ crc1;
+    crc0 = shift(table, static_cast<uint32_t>(crc0)) ^ crc2;
+    p += 3 * Block;
+    n -= 3 * Block;
+  }
+  return crc0;
+}
+
+__attribute__((target("sse4.2"))) uint32_t
+hardware(const std::byte *p, std::size_t n, uint32_t crc) noexcept {
+  const auto &t = tables();
+  uint64_t crc0 = ~crc;
+  crc0 = interleaved<long_block>(p, n, crc0, t.shift_long);
+  crc0 = interleaved<short_block>(p, n, crc0, t.shift_short);
+  while (n >= 8) {
+    crc0 = _mm_crc32_u64(crc0, load64(p));
+    p += 8;
+    n -= 8;
+  }
+  auto crc32 = static_cast<uint32_t>(crc0);
+  while (n-- > 0) {
+    crc32 = _mm_crc32_u8(crc32, std::to_integer<uint8_t>(*p++));
+  }
+  return ~crc32;
+}
+
+bool has_sse42() noexcept { return __builtin_cpu_supports("sse4.2"); }
+
+#else
+
+uint32_t hardware(const std::byte *p, std::size_t n, uint32_t crc) noexcept {
+  return software(p, n, crc);
+}
+
+bool has_sse42() noexcept { return false; }
+
+#endif
+
+} // namespace
+
+uint32_t crc32c(std::span<const std::byte> data, uint32_t crc) noexcept {
+  static const auto implementation = has_sse42() ? hardware : software;
+  return implementation(data.data(), data.size(), crc);
+}
+
+uint32_t crc32c_software(std::span<const std::byte> data,
+                         uint32_t crc) noexcept {
+  return software(data.data(), data.size(), crc);
+}
+
+bool crc32c_accelerated() noexcept {
+  static const bool accelerated = has_sse42();
+  return accelerated;
+}
+
+} // namespace oc
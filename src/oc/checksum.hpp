@@ -0,0 +1,120 @@
+#pragma once
+#ifndef CHECKSUM_HPP
+#define CHECKSUM_HPP
+
+#include "oc/pipe_policy.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace oc {
+
+/**
+ * @file checksum.hpp
+ * @brief CRC32C end-to-end integrity for chunks crossing a pipe
+ *
+ * crc32c() uses the SSE4.2 crc32 instruction when the CPU has it, running
+ * three independent streams over large buffers to hide the instruction's
+ * latency and combining them with precomputed shift tables; elsewhere it
+ * falls back to a slicing-by-8 table. Both give the standard CRC32C
+ * (Castagnoli) value, and crc32c(b, crc32c(a)) == crc32c(a followed by b).
+ *
+ * ChunkChecksum is the per-pipe stage: the producer seals every chunk it
+ * writes into the source ring with a ChunkTrailer holding the CRC of the
+ * chunk, and the consumer verifies the chunk where it lands in the
+ * destination ring, counting mismatches. Both ends of a pipe must agree on
+ * whether checksums are on, since the trailer takes ring space.
+ */
+
+// CRC32C of `data`, continuing from `crc`
+uint32_t crc32c(std::span<const std::byte> data, uint32_t crc = 0) noexcept;
+
+// the table implementation, whatever the CPU
+uint32_t crc32c_software(std::span<const std::byte> data,
+                         uint32_t crc = 0) noexcept;
+
+// whether crc32c() runs on the crc32 instruction
+bool crc32c_accelerated() noexcept;
+
+struct ChunkTrailer {
+  uint32_t crc;
+  uint32_t chunk_bytes; // covered bytes, catches truncation and misframing
+};
+
+static_assert(sizeof(ChunkTrailer) == 8);
+
+class ChunkChecksum {
+public:
+  explicit ChunkChecksum(bool enabled = true) : enabled_(enabled) {}
+
+  [[nodiscard]] bool enabled() const noexcept { return enabled_; }
+
+  // ring bytes every chunk takes on top of its own
+  [[nodiscard]] uint32_t overhead() const noexcept {
+    return enabled_ ? sizeof(ChunkTrailer) : 0;
+  }
+
+  // Producer: the `bytes` at `position` of `ring` are a complete chunk;
+  // write its trailer right behind it.
+  void seal(std::span<std::byte> ring, uint32_t position, uint32_t bytes) {
+    if (!enabled_) {
+      return;
+    }
+    ChunkTrailer trailer{checksum(ring, position, bytes), bytes};
+    auto *in = reinterpret_cast<const std::byte *>(&trailer);
+    for_each_ring_piece(ring.size(), position + bytes, sizeof(trailer),
+                        [&](std::size_t offset, std::size_t piece) {
+                          std::memcpy(ring.data() + offset, in, piece);
+                          in += piece;
+                        });
+    ++sealed_;
+  }
+
+  // Consumer: does the chunk of `bytes` at `position`, followed by its
+  // trailer, match? Always true while checksums are off.
+  bool verify(std::span<const std::byte> ring, uint32_t position,
+              uint32_t bytes) {
+    if (!enabled_) {
+      return true;
+    }
+    ChunkTrailer trailer;
+    auto *out = reinterpret_cast<std::byte *>(&trailer);
+    for_each_ring_piece(ring.size(), position + bytes, sizeof(trailer),
+                        [&](std::size_t offset, std::size_t piece) {
+                          std::memcpy(out, ring.data() + offset, piece);
+                          out += piece;
+                        });
+    if (trailer.chunk_bytes != bytes ||
+        trailer.crc != checksum(ring, position, bytes)) {
+      ++mismatches_;
+      return false;
+    }
+    ++verified_;
+    return true;
+  }
+
+  [[nodiscard]] uint64_t sealed() const noexcept { return sealed_; }
+  [[nodiscard]] uint64_t verified() const noexcept { return verified_; }
+  [[nodiscard]] uint64_t mismatches() const noexcept { return mismatches_; }
+
+private:
+  static uint32_t checksum(std::span<const std::byte> ring, uint32_t position,
+                           uint32_t bytes) noexcept {
+    uint32_t crc = 0;
+    for_each_ring_piece(ring.size(), position, bytes,
+                        [&](std::size_t offset, std::size_t piece) {
+                          crc = crc32c(ring.subspan(offset, piece), crc);
+                        });
+    return crc;
+  }
+
+  bool enabled_;
+  uint64_t sealed_ = 0;
+  uint64_t verified_ = 0;
+  uint64_t mismatches_ = 0;
+};
+
+} // namespace oc
+
+#endif
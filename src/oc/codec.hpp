@@ -0,0 +1,510 @@
+#pragma once
+#ifndef CODEC_HPP
+#define CODEC_HPP
+
+#include "oc/pipe_policy.hpp"
+#include "oc/rb/pod_rb.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace oc {
+
+/**
+ * @file codec.hpp
+ * @brief Lightweight compression of fixed-size numeric records
+ *
+ * Streams of counters, prices and timestamps change little from one record
+ * to the next, so most of their bits are redundant. RecordEncoder views each
+ * record as `columns` machine words and encodes blocks of records column by
+ * column, picking per column and block the cheapest of
+ *
+ *  - frame of reference: value - min of the block,
+ *  - delta: zigzag(value - previous), for counters and timestamps,
+ *  - xor: value ^ previous, for floating point fields,
+ *
+ * then bit-packs the residuals at the width of the largest one. Packing works
+ * on groups of 64 residuals with every shift a compile-time constant, one
+ * unrolled kernel per width, which the compiler turns into straight-line
+ * (and where the target allows, vector) code with no per-value branches.
+ *
+ * RecordEncoder::pump() moves records from a PodRingBuffer into a pipe's
+ * source ring as encoded blocks; RecordDecoder::poll() reads blocks from a
+ * destination ring back into a PodRingBuffer. Blocks are self-describing and
+ * 8-byte aligned, so they can cross any number of pipes unchanged.
+ */
+
+enum class column_coding : uint8_t { frame_of_reference, delta, xor_previous };
+
+struct CodecBlockHeader {
+  static constexpr uint32_t expected_magic = 0x4b4c4243; // "CBLK"
+
+  uint32_t magic;
+  uint32_t block_bytes; // header, column headers and packed data
+  uint32_t records;
+  uint16_t columns;
+  uint16_t word_bytes;
+};
+
+struct CodecColumnHeader {
+  uint64_t base; // the block's minimum, or its first value
+  column_coding coding;
+  uint8_t bits; // width of every packed residual
+  uint8_t reserved[6];
+};
+
+static_assert(sizeof(CodecBlockHeader) == 16);
+static_assert(sizeof(CodecColumnHeader) == 16);
+
+struct codec_stats {
+  uint64_t blocks = 0;
+  uint64_t records = 0;
+  uint64_t raw_bytes = 0;
+  uint64_t encoded_bytes = 0;
+  std::array<uint64_t, 3> columns{}; // encoded with each column_coding
+
+  // raw bytes per encoded byte
+  [[nodiscard]] double ratio() const noexcept {
+    return encoded_bytes > 0 ? static_cast<double>(raw_bytes) /
+                                   static_cast<double>(encoded_bytes)
+                             : 0;
+  }
+};
+
+namespace detail {
+
+constexpr std::size_t codec_group = 64; // residuals per packing kernel
+
+template <unsigned Bits, std::size_t I>
+inline void pack_value(const uint64_t *in, uint64_t *out) noexcept {
+  constexpr auto bit = I * Bits;
+  constexpr auto word = bit / 64;
+  constexpr auto shift = bit % 64;
+  out[word] |= in[I] << shift;
+  if constexpr (shift + Bits > 64) {
+    out[word + 1] |= in[I] >> (64 - shift);
+  }
+}
+
+template <unsigned Bits, std::size_t I>
+inline void unpack_value(const uint64_t *in, uint64_t *out) noexcept {
+  constexpr auto bit = I * Bits;
+  constexpr auto word = bit / 64;
+  constexpr auto shift = bit % 64;
+  constexpr auto mask = Bits == 64 ? ~uint64_t{0} : (uint64_t{1} << Bits) - 1;
+  auto value = in[word] >> shift;
+  if constexpr (shift + Bits > 64) {
+    value |= in[word + 1] << (64 - shift);
+  }
+  out[I] = value & mask;
+}
+
+// 64 residuals of `Bits` bits each into `Bits` zeroed words, and back. A
+// constant column packs into no words at all, so with Bits == 0 `in` and
+// `out` may point past the end of the buffer and must not be touched.
+template <unsigned Bits>
+void pack_group(const uint64_t *in, uint64_t *out) noexcept {
+  if constexpr (Bits > 0) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (pack_value<Bits, I>(in, out), ...);
+    }(std::make_index_sequence<codec_group>{});
+  }
+}
+
+template <unsigned Bits>
+void unpack_group(const uint64_t *in, uint64_t *out) noexcept {
+  if constexpr (Bits == 0) {
+    std::fill_n(out, codec_group, uint64_t{0});
+  } else {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (unpack_value<Bits, I>(in, out), ...);
+    }(std::make_index_sequence<codec_group>{});
+  }
+}
+
+using group_kernel = void (*)(const uint64_t *, uint64_t *) noexcept;
+
+template <std::size_t... Bits>
+constexpr std::array<group_kernel, sizeof...(Bits)>
+packers(std::index_sequence<Bits...>) {
+  return {&pack_group<Bits>...};
+}
+
+template <std::size_t... Bits>
+constexpr std::array<group_kernel, sizeof...(Bits)>
+unpackers(std::index_sequence<Bits...>) {
+  return {&unpack_group<Bits>...};
+}
+
+inline constexpr auto pack_kernels = packers(std::make_index_sequence<65>{});
+inline constexpr auto unpack_kernels =
+    unpackers(std::make_index_sequence<65>{});
+
+constexpr std::size_t codec_groups(std::size_t records) noexcept {
+  return (records + codec_group - 1) / codec_group;
+}
+
+// sign bit to the bottom, so small negative deltas stay narrow
+template <typename Word> constexpr Word zigzag(Word value) noexcept {
+  constexpr auto sign = sizeof(Word) * 8 - 1;
+  return static_cast<Word>((value << 1) ^ (0 - (value >> sign)));
+}
+
+template <typename Word> constexpr Word unzigzag(Word value) noexcept {
+  return static_cast<Word>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+} // namespace detail
+
+template <typename T, typename Word>
+concept CodecRecord =
+    rb::PodType<T> &&
+    (std::same_as<Word, uint32_t> || std::same_as<Word, uint64_t>) &&
+    sizeof(T) % sizeof(Word) == 0;
+
+template <typename T, typename Word = uint64_t>
+  requires CodecRecord<T, Word>
+class RecordEncoder {
+public:
+  static constexpr std::size_t columns = sizeof(T) / sizeof(Word);
+
+  // Blocks hold up to `block_records` records, a multiple of 64; larger
+  // blocks amortise the per-column headers, smaller ones adapt faster.
+  explicit RecordEncoder(uint32_t block_records = 256)
+      : block_records_(block_records) {
+    if (block_records == 0 || block_records % detail::codec_group != 0) {
+      throw std::invalid_argument(
+          "Codec block size must be a positive multiple of 64");
+    }
+    values_.resize(columns * block_records);
+    residuals_.resize(block_records);
+    block_.resize(max_block_bytes(block_records) / sizeof(uint64_t));
+  }
+
+  // Upper bound of an encoded block of `records` records
+  [[nodiscard]] static constexpr std::size_t
+  max_block_bytes(std::size_t records) noexcept {
+    return sizeof(CodecBlockHeader) +
+           columns * (sizeof(CodecColumnHeader) +
+                      detail::codec_groups(records) * sizeof(Word) * 8 *
+                          sizeof(uint64_t));
+  }
+
+  // Encode at most block_records() records as one block. The result points
+  // into the encoder and stays valid until the next call.
+  std::span<const std::byte> encode_block(std::span<const T> records) {
+    auto n = std::min<std::size_t>(records.size(), block_records_);
+    if (n == 0) {
+      return {};
+    }
+    auto groups = detail::codec_groups(n);
+    auto *raw = reinterpret_cast<const std::byte *>(records.data());
+
+    // one sequential pass over the records into per-column arrays
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t column = 0; column < columns; ++column) {
+        std::memcpy(&values_[column * block_records_ + i],
+                    raw + i * sizeof(T) + column * sizeof(Word), sizeof(Word));
+      }
+    }
+
+    auto *out = block_.data() + sizeof(CodecBlockHeader) / sizeof(uint64_t);
+    for (std::size_t column = 0; column < columns; ++column) {
+      const auto *values = values_.data() + column * block_records_;
+      auto header = choose(values, n);
+      residuals(values, n, header);
+      std::memcpy(out, &header, sizeof(header));
+      out += sizeof(header) / sizeof(uint64_t);
+      std::fill_n(out, groups * header.bits, 0);
+      for (std::size_t g = 0; g < groups; ++g) {
+        detail::pack_kernels[header.bits](
+            residuals_.data() + g * detail::codec_group, out);
+        out += header.bits;
+      }
+      ++stats_.columns[static_cast<std::size_t>(header.coding)];
+    }
+
+    auto bytes = static_cast<uint32_t>(
+        reinterpret_cast<std::byte *>(out) -
+        reinterpret_cast<std::byte *>(block_.data()));
+    CodecBlockHeader header{CodecBlockHeader::expected_magic, bytes,
+                            static_cast<uint32_t>(n),
+                            static_cast<uint16_t>(columns),
+                            static_cast<uint16_t>(sizeof(Word))};
+    std::memcpy(block_.data(), &header, sizeof(header));
+
+    ++stats_.blocks;
+    stats_.records += n;
+    stats_.raw_bytes += n * sizeof(T);
+    stats_.encoded_bytes += bytes;
+    return std::as_bytes(std::span(block_)).first(bytes);
+  }
+
+  // Move records from `in` into `ring` as encoded blocks while they fit
+  // between `tail` and `head`; advances `tail`. Records are taken from `in`
+  // as soon as they are encoded, and a block that does not fit yet is kept
+  // for the next call. Returns the bytes written.
+  template <rb::OverflowPolicy Policy>
+  uint32_t pump(rb::PodRingBuffer<T, Policy> &in, std::span<std::byte> ring,
+                uint32_t head, uint32_t &tail) {
+    if (!std::has_single_bit(ring.size())) {
+      throw std::invalid_argument("Ring size must be a power of two");
+    }
+    auto capacity = static_cast<uint32_t>(ring.size());
+    if (max_block_bytes(block_records_) > capacity) {
+      throw std::invalid_argument("Ring is smaller than a codec block");
+    }
+    uint32_t written = 0;
+    while (true) {
+      if (pending_.empty()) {
+        auto view = in.get_contiguous_read_view(block_records_);
+        if (view.empty()) {
+          break;
+        }
+        pending_ = encode_block(view.to_span());
+        in.advance_read(view.size());
+      }
+      if (capacity - (tail - head) < pending_.size()) {
+        break;
+      }
+      auto *bytes = pending_.data();
+      for_each_ring_piece(capacity, tail, pending_.size(),
+                          [&](std::size_t offset, std::size_t piece) {
+                            std::memcpy(ring.data() + offset, bytes, piece);
+                            bytes += piece;
+                          });
+      tail += static_cast<uint32_t>(pending_.size());
+      written += static_cast<uint32_t>(pending_.size());
+      pending_ = {};
+    }
+    return written;
+  }
+
+  [[nodiscard]] uint32_t block_records() const noexcept {
+    return block_records_;
+  }
+
+  [[nodiscard]] const codec_stats &stats() const noexcept { return stats_; }
+
+private:
+  // the coding with the narrowest residuals, frame of reference on ties
+  static CodecColumnHeader choose(const Word *values, std::size_t n) noexcept {
+    Word low = values[0];
+    Word high = values[0];
+    Word deltas = 0;
+    Word xors = 0;
+    for (std::size_t i = 1; i < n; ++i) {
+      low = std::min(low, values[i]);
+      high = std::max(high, values[i]);
+      deltas |= detail::zigzag<Word>(values[i] - values[i - 1]);
+      xors |= values[i] ^ values[i - 1];
+    }
+
+    CodecColumnHeader header{};
+    header.base = low;
+    header.coding = column_coding::frame_of_reference;
+    header.bits = static_cast<uint8_t>(std::bit_width<Word>(high - low));
+    if (auto bits = std::bit_width(deltas); bits < header.bits) {
+      header.base = values[0];
+      header.coding = column_coding::delta;
+      header.bits = static_cast<uint8_t>(bits);
+    }
+    if (auto bits = std::bit_width(xors); bits < header.bits) {
+      header.base = values[0];
+      header.coding = column_coding::xor_previous;
+      header.bits = static_cast<uint8_t>(bits);
+    }
+    return header;
+  }
+
+  void residuals(const Word *values, std::size_t n,
+                 const CodecColumnHeader &header) noexcept {
+    auto base = static_cast<Word>(header.base);
+    switch (header.coding) {
+    case column_coding::frame_of_reference:
+      for (std::size_t i = 0; i < n; ++i) {
+        residuals_[i] = static_cast<Word>(values[i] - base);
+      }
+      break;
+    case column_coding::delta:
+      residuals_[0] = 0;
+      for (std::size_t i = 1; i < n; ++i) {
+        residuals_[i] = detail::zigzag<Word>(values[i] - values[i - 1]);
+      }
+      break;
+    case column_coding::xor_previous:
+      residuals_[0] = 0;
+      for (std::size_t i = 1; i < n; ++i) {
+        residuals_[i] = values[i] ^ values[i - 1];
+      }
+      break;
+    }
+    // the last group is packed whole
+    std::fill(residuals_.begin() + static_cast<std::ptrdiff_t>(n),
+              residuals_.begin() + static_cast<std::ptrdiff_t>(
+                                       detail::codec_groups(n) *
+                                       detail::codec_group),
+              0);
+  }
+
+  uint32_t block_records_;
+  std::vector<Word> values_;        // the block, column by column
+  std::vector<uint64_t> residuals_; // padded to whole groups
+  std::vector<uint64_t> block_;     // aligned scratch for the encoded block
+  std::span<const std::byte> pending_; // encoded, not yet in the ring
+  codec_stats stats_;
+};
+
+template <typename T, typename Word = uint64_t>
+  requires CodecRecord<T, Word>
+class RecordDecoder {
+public:
+  static constexpr std::size_t columns = sizeof(T) / sizeof(Word);
+
+  // Decode one block into `out`, which must hold its records. Returns the
+  // number of records decoded.
+  std::size_t decode_block(std::span<const std::byte> block, std::span<T> out) {
+    auto header = read_header(block.first(
+        std::min(block.size(), sizeof(CodecBlockHeader))));
+    if (block.size() < header.block_bytes) {
+      throw std::runtime_error("Codec block is truncated");
+    }
+    words_.resize(header.block_bytes / sizeof(uint64_t));
+    std::memcpy(words_.data(), block.data(), header.block_bytes);
+    return decode(header, out);
+  }
+
+  // Decode every complete block between `head` and `tail` of `ring` into
+  // `out` while it has room for them; advances `head`. Returns the number
+  // of records decoded.
+  template <rb::OverflowPolicy Policy>
+  std::size_t poll(std::span<const std::byte> ring, uint32_t &head,
+                   uint32_t tail, rb::PodRingBuffer<T, Policy> &out) {
+    auto capacity = static_cast<uint32_t>(ring.size());
+    std::size_t decoded = 0;
+    while (tail - head >= sizeof(CodecBlockHeader)) {
+      std::array<std::byte, sizeof(CodecBlockHeader)> bytes;
+      copy_out(ring, head, bytes.data(), bytes.size());
+      auto header = read_header(bytes);
+      if (header.block_bytes > capacity) {
+        throw std::runtime_error("Codec block is larger than its ring");
+      }
+      if (tail - head < header.block_bytes ||
+          out.available() < header.records) {
+        break;
+      }
+      words_.resize(header.block_bytes / sizeof(uint64_t));
+      copy_out(ring, head, words_.data(), header.block_bytes);
+      records_.resize(header.records);
+      decode(header, records_);
+      out.try_push_bulk(std::span<const T>(records_));
+      decoded += header.records;
+      head += header.block_bytes;
+    }
+    return decoded;
+  }
+
+private:
+  static void copy_out(std::span<const std::byte> ring, uint32_t position,
+                       void *out, std::size_t len) {
+    auto *bytes = static_cast<std::byte *>(out);
+    for_each_ring_piece(ring.size(), position, len,
+                        [&](std::size_t offset, std::size_t piece) {
+                          std::memcpy(bytes, ring.data() + offset, piece);
+                          bytes += piece;
+                        });
+  }
+
+  static CodecBlockHeader read_header(std::span<const std::byte> bytes) {
+    CodecBlockHeader header;
+    if (bytes.size() < sizeof(header)) {
+      throw std::runtime_error("Codec block is truncated");
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != CodecBlockHeader::expected_magic) {
+      throw std::runtime_error("Not a codec block");
+    }
+    if (header.columns != columns || header.word_bytes != sizeof(Word)) {
+      throw std::runtime_error("Codec block is for a different record type");
+    }
+    if (header.block_bytes % sizeof(uint64_t) != 0 ||
+        header.block_bytes < sizeof(CodecBlockHeader)) {
+      throw std::runtime_error("Codec block size is invalid");
+    }
+    return header;
+  }
+
+  // decode the block in words_
+  std::size_t decode(const CodecBlockHeader &header, std::span<T> out) {
+    auto n = std::size_t{header.records};
+    if (out.size() < n) {
+      throw std::length_error("Codec output is too small");
+    }
+    auto groups = detail::codec_groups(n);
+    residuals_.resize(groups * detail::codec_group);
+    auto *raw = reinterpret_cast<std::byte *>(out.data());
+    auto *end = words_.data() + words_.size();
+    auto *in = words_.data() + sizeof(CodecBlockHeader) / sizeof(uint64_t);
+
+    for (std::size_t column = 0; column < columns; ++column) {
+      CodecColumnHeader column_header;
+      if (end - in < static_cast<std::ptrdiff_t>(sizeof(column_header) /
+                                                 sizeof(uint64_t))) {
+        throw std::runtime_error("Codec block is truncated");
+      }
+      std::memcpy(&column_header, in, sizeof(column_header));
+      in += sizeof(column_header) / sizeof(uint64_t);
+      if (column_header.bits > sizeof(Word) * 8 ||
+          end - in < static_cast<std::ptrdiff_t>(groups * column_header.bits)) {
+        throw std::runtime_error("Codec column is corrupt");
+      }
+      for (std::size_t g = 0; g < groups; ++g) {
+        detail::unpack_kernels[column_header.bits](
+            in, residuals_.data() + g * detail::codec_group);
+        in += column_header.bits;
+      }
+
+      auto value = static_cast<Word>(column_header.base);
+      auto *field = raw + column * sizeof(Word);
+      switch (column_header.coding) {
+      case column_coding::frame_of_reference:
+        for (std::size_t i = 0; i < n; ++i) {
+          auto decoded = static_cast<Word>(value + residuals_[i]);
+          std::memcpy(field + i * sizeof(T), &decoded, sizeof(Word));
+        }
+        break;
+      case column_coding::delta:
+        for (std::size_t i = 0; i < n; ++i) {
+          value += detail::unzigzag(static_cast<Word>(residuals_[i]));
+          std::memcpy(field + i * sizeof(T), &value, sizeof(Word));
+        }
+        break;
+      case column_coding::xor_previous:
+        for (std::size_t i = 0; i < n; ++i) {
+          value ^= static_cast<Word>(residuals_[i]);
+          std::memcpy(field + i * sizeof(T), &value, sizeof(Word));
+        }
+        break;
+      default:
+        throw std::runtime_error("Unknown codec column coding");
+      }
+    }
+    return n;
+  }
+
+  std::vector<uint64_t> words_;     // aligned copy of the block
+  std::vector<uint64_t> residuals_; // one column, padded to whole groups
+  std::vector<T> records_;
+};
+
+} // namespace oc
+
+#endif
@@ -0,0 +1,299 @@
+#pragma once
+#ifndef FILTER_HPP
+#define FILTER_HPP
+
+#include "oc/rb/pod_rb.hpp"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace oc {
+
+/**
+ * @file filter.hpp
+ * @brief Drop and trim records before they are sent
+ *
+ * A consumer that throws most records away still pays for every one of them
+ * crossing the pipe. RecordFilter runs on the producer side, between the
+ * application's PodRingBuffer and the one the pipe sends from: records that
+ * fail its predicates are never written, and with a projection only the
+ * listed fields of the survivors are.
+ *
+ * Predicates compare one arithmetic field against constants (equal, less,
+ * greater, a closed range, or a bitmask) and are ANDed. They are evaluated
+ * column-wise over batches of records: each predicate gathers its field for
+ * the batch into a contiguous lane array and compares it in a branch-free
+ * loop the compiler vectorizes, narrowing a per-record keep mask. Survivors
+ * are then compacted through an index list and copied, or projected field
+ * by field, into the destination.
+ */
+
+enum class field_test : uint8_t {
+  equal,
+  not_equal,
+  less,
+  greater,
+  between,  // a <= field <= b
+  all_bits, // field & a == a
+  any_bits, // field & a != 0
+};
+
+struct filter_stats {
+  uint64_t batches = 0;
+  uint64_t examined = 0;
+  uint64_t passed = 0;
+
+  // share of records that survive
+  [[nodiscard]] double selectivity() const noexcept {
+    return examined > 0 ? static_cast<double>(passed) /
+                              static_cast<double>(examined)
+                        : 0;
+  }
+};
+
+namespace detail {
+
+constexpr std::size_t filter_batch = 256; // records per evaluation pass
+
+// predicate operands are kept in 8 bytes, which rules out long double
+template <typename F>
+concept FilterField = std::is_arithmetic_v<F> && !std::same_as<F, bool> &&
+                      sizeof(F) <= sizeof(uint64_t);
+
+// byte offset of `member` within R
+template <typename R, typename F>
+std::size_t field_offset(F R::*member) noexcept {
+  union probe {
+    char none;
+    R record;
+    probe() : none() {}
+  } p;
+  return static_cast<std::size_t>(
+      reinterpret_cast<const std::byte *>(&(p.record.*member)) -
+      reinterpret_cast<const std::byte *>(&p.record));
+}
+
+} // namespace detail
+
+template <rb::PodType T, rb::PodType Out = T> class RecordFilter {
+public:
+  // Keep only records whose `member` passes `test` against `a` (and `b`
+  // for field_test::between). Predicates accumulate and are ANDed.
+  template <detail::FilterField F>
+  RecordFilter &where(F T::*member, field_test test, F a, F b = {}) {
+    if constexpr (!std::integral<F>) {
+      if (test == field_test::all_bits || test == field_test::any_bits) {
+        throw std::invalid_argument(
+            "Bitmask tests need an integral record field");
+      }
+    }
+    static_assert(sizeof(F) <= sizeof(value_bytes));
+    predicate p{detail::field_offset(member), test, {}, {},
+                &evaluate<F>};
+    std::memcpy(p.a.data(), &a, sizeof(F));
+    std::memcpy(p.b.data(), &b, sizeof(F));
+    predicates_.push_back(p);
+    return *this;
+  }
+
+  // Copy `from` of every survivor into `to` of its output record. Once a
+  // projection is set only projected fields are written; the rest of the
+  // output record is zero.
+  template <detail::FilterField F>
+  RecordFilter &project(F T::*from, F Out::*to) {
+    fields_.push_back({detail::field_offset(from), detail::field_offset(to),
+                       &copy_field<F>});
+    return *this;
+  }
+
+  // Filter `in` into `out`, taking no more records than `out` could hold
+  // if all of them passed. Returns the records consumed and written.
+  std::pair<std::size_t, std::size_t> filter(std::span<const T> in,
+                                             std::span<Out> out) {
+    if constexpr (!std::same_as<T, Out>) {
+      if (fields_.empty()) {
+        throw std::invalid_argument(
+            "Filtering into another record type needs a projection");
+      }
+    }
+    std::size_t consumed = 0;
+    std::size_t written = 0;
+    while (consumed < in.size()) {
+      auto n = std::min({detail::filter_batch, in.size() - consumed,
+                         out.size() - written});
+      if (n == 0) {
+        break;
+      }
+      written += filter_batch(in.data() + consumed, n, out.data() + written);
+      consumed += n;
+    }
+    return {consumed, written};
+  }
+
+  // Move records from `in` to `out`, reading both wrap segments of `in` and
+  // writing survivors through a single write view of `out`. Records are
+  // taken from `in` only once their batch has been filtered. Returns the
+  // records written.
+  template <rb::OverflowPolicy InPolicy, rb::OverflowPolicy OutPolicy>
+  std::size_t pump(rb::PodRingBuffer<T, InPolicy> &in,
+                   rb::PodRingBuffer<Out, OutPolicy> &out) {
+    auto views = in.get_read_views();
+    if (views[0].empty()) {
+      return 0;
+    }
+    auto write = out.get_write_view();
+    auto space = write.as_span();
+    std::size_t consumed = 0;
+    std::size_t written = 0;
+    for (const auto &view : views) {
+      auto [taken, kept] = filter(view.to_span(), space.subspan(written));
+      consumed += taken;
+      written += kept;
+      if (taken < view.size()) {
+        break;
+      }
+    }
+    write.commit(written);
+    in.advance_read(consumed);
+    return written;
+  }
+
+  [[nodiscard]] const filter_stats &stats() const noexcept { return stats_; }
+
+private:
+  using value_bytes = std::array<std::byte, sizeof(uint64_t)>;
+
+  struct predicate {
+    std::size_t offset;
+    field_test test;
+    value_bytes a;
+    value_bytes b;
+    void (*apply)(const predicate &, const T *, std::size_t, uint8_t *);
+  };
+
+  struct projected_field {
+    std::size_t from;
+    std::size_t to;
+    void (*copy)(const projected_field &, const T *, const uint32_t *,
+                 std::size_t, Out *);
+  };
+
+  // Narrow `keep` to the records whose field passes. Each case is a plain
+  // loop over the lanes, so it vectorizes.
+  template <typename F>
+  static void evaluate(const predicate &p, const T *records, std::size_t n,
+                       uint8_t *keep) noexcept {
+    F a;
+    F b;
+    std::memcpy(&a, p.a.data(), sizeof(F));
+    std::memcpy(&b, p.b.data(), sizeof(F));
+    F lanes[detail::filter_batch];
+    auto *raw = reinterpret_cast<const std::byte *>(records) + p.offset;
+    for (std::size_t i = 0; i < n; ++i) {
+      std::memcpy(&lanes[i], raw + i * sizeof(T), sizeof(F));
+    }
+    switch (p.test) {
+    case field_test::equal:
+      for (std::size_t i = 0; i < n; ++i) {
+        keep[i] &= lanes[i] == a;
+      }
+      break;
+    case field_test::not_equal:
+      for (std::size_t i = 0; i < n; ++i) {
+        keep[i] &= lanes[i] != a;
+      }
+      break;
+    case field_test::less:
+      for (std::size_t i = 0; i < n; ++i) {
+        keep[i] &= lanes[i] < a;
+      }
+      break;
+    case field_test::greater:
+      for (std::size_t i = 0; i < n; ++i) {
+        keep[i] &= lanes[i] > a;
+      }
+      break;
+    case field_test::between:
+      for (std::size_t i = 0; i < n; ++i) {
+        keep[i] &= (lanes[i] >= a) & (lanes[i] <= b);
+      }
+      break;
+    case field_test::all_bits:
+      if constexpr (std::integral<F>) {
+        for (std::size_t i = 0; i < n; ++i) {
+          keep[i] &= (lanes[i] & a) == a;
+        }
+      }
+      break;
+    case field_test::any_bits:
+      if constexpr (std::integral<F>) {
+        for (std::size_t i = 0; i < n; ++i) {
+          keep[i] &= (lanes[i] & a) != 0;
+        }
+      }
+      break;
+    }
+  }
+
+  template <typename F>
+  static void copy_field(const projected_field &field, const T *records,
+                         const uint32_t *survivors, std::size_t n,
+                         Out *out) noexcept {
+    auto *in = reinterpret_cast<const std::byte *>(records) + field.from;
+    auto *to = reinterpret_cast<std::byte *>(out) + field.to;
+    for (std::size_t j = 0; j < n; ++j) {
+      std::memcpy(to + j * sizeof(Out), in + survivors[j] * sizeof(T),
+                  sizeof(F));
+    }
+  }
+
+  std::size_t filter_batch(const T *records, std::size_t n, Out *out) {
+    std::fill_n(keep_.begin(), n, uint8_t{1});
+    for (const auto &p : predicates_) {
+      p.apply(p, records, n, keep_.data());
+    }
+
+    // branch-free compaction into the survivors' indices
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      survivors_[kept] = static_cast<uint32_t>(i);
+      kept += keep_[i];
+    }
+
+    if (fields_.empty()) {
+      if constexpr (std::same_as<T, Out>) {
+        for (std::size_t j = 0; j < kept; ++j) {
+          out[j] = records[survivors_[j]];
+        }
+      }
+    } else {
+      std::memset(static_cast<void *>(out), 0, kept * sizeof(Out));
+      for (const auto &field : fields_) {
+        field.copy(field, records, survivors_.data(), kept, out);
+      }
+    }
+
+    ++stats_.batches;
+    stats_.examined += n;
+    stats_.passed += kept;
+    return kept;
+  }
+
+  std::vector<predicate> predicates_;
+  std::vector<projected_field> fields_;
+  std::array<uint8_t, detail::filter_batch> keep_{};
+  std::array<uint32_t, detail::filter_batch> survivors_{};
+  filter_stats stats_;
+};
+
+} // namespace oc
+
+#endif
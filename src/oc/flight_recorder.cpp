@@ -0,0 +1,333 @@
+#include "flight_recorder.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <sys/syscall.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace oc {
+
+namespace {
+
+std::atomic<uint64_t> next_recorder_id{1};
+
+// Buffered writer for signal handlers: no allocation, no locale, no stdio.
+class fd_writer {
+public:
+  explicit fd_writer(int fd) noexcept : fd_(fd) {}
+
+  fd_writer &str(const char *text) noexcept {
+    while (*text) {
+      put(*text++);
+    }
+    return *this;
+  }
+
+  fd_writer &num(uint64_t value) noexcept {
+    char digits[20];
+    int n = 0;
+    do {
+      digits[n++] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    } while (value);
+    while (n) {
+      put(digits[--n]);
+    }
+    return *this;
+  }
+
+  // nanoseconds as microseconds with three decimals, the Chrome ts unit
+  fd_writer &micros(int64_t ns) noexcept {
+    if (ns < 0) {
+      put('-');
+      ns = -ns;
+    }
+    num(static_cast<uint64_t>(ns) / 1000);
+    put('.');
+    auto frac = static_cast<uint64_t>(ns) % 1000;
+    put(static_cast<char>('0' + frac / 100));
+    put(static_cast<char>('0' + frac / 10 % 10));
+    put(static_cast<char>('0' + frac % 10));
+    return *this;
+  }
+
+  bool flush() noexcept {
+    std::size_t done = 0;
+    while (ok_ && done < used_) {
+      auto written = ::write(fd_, buffer_ + done, used_ - done);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        ok_ = false;
+        break;
+      }
+      done += static_cast<std::size_t>(written);
+    }
+    used_ = 0;
+    return ok_;
+  }
+
+private:
+  void put(char c) noexcept {
+    if (used_ == sizeof(buffer_)) {
+      flush();
+    }
+    buffer_[used_++] = c;
+  }
+
+  int fd_;
+  bool ok_ = true;
+  std::size_t used_ = 0;
+  char buffer_[4096];
+};
+
+const char *event_name(flight_event kind) noexcept {
+  switch (kind) {
+  case flight_event::transfer:
+    return "transfer";
+  case flight_event::metadata_sync:
+    return "metadata_sync";
+  case flight_event::round:
+    return "round";
+  case flight_event::stall:
+    return "stall";
+  }
+  return "unknown";
+}
+
+const char *stall_name(uint64_t reason) noexcept {
+  switch (static_cast<flight_stall>(reason)) {
+  case flight_stall::source_empty:
+    return "source_empty";
+  case flight_stall::destination_full:
+    return "destination_full";
+  case flight_stall::metadata:
+    return "metadata";
+  case flight_stall::batching:
+    return "batching";
+  }
+  return "unknown";
+}
+
+// Chrome processes are tracks: 0 for events without one, pipe N is N + 1
+uint64_t process_of(uint32_t track) noexcept {
+  return track == FlightRecorder::no_track ? 0 : uint64_t{track} + 1;
+}
+
+constexpr int fatal_signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
+std::atomic<const FlightRecorder *> signal_recorder{nullptr};
+char signal_path[4096];
+
+void dump_and_reraise(int signo) {
+  if (const auto *recorder =
+          signal_recorder.exchange(nullptr, std::memory_order_acquire)) {
+    int fd = ::open(signal_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+    if (fd >= 0) {
+      recorder->write_chrome_trace(fd);
+      ::close(fd);
+    }
+  }
+  // SA_RESETHAND restored the default action
+  ::raise(signo);
+}
+
+} // namespace
+
+FlightRecorder::FlightRecorder(std::size_t events_per_thread,
+                               std::size_t max_threads)
+    : id_(next_recorder_id.fetch_add(1, std::memory_order_relaxed)),
+      mask_(std::bit_ceil(std::max<std::size_t>(events_per_thread, 1)) - 1),
+      max_threads_(max_threads), rings_(new thread_ring[max_threads]) {
+  if (max_threads == 0) {
+    throw std::invalid_argument("FlightRecorder needs at least one thread");
+  }
+}
+
+FlightRecorder::~FlightRecorder() {
+  const FlightRecorder *self = this;
+  if (signal_recorder.compare_exchange_strong(self, nullptr)) {
+    for (int signo : fatal_signals) {
+      std::signal(signo, SIG_DFL);
+    }
+  }
+}
+
+FlightRecorder::thread_ring *FlightRecorder::register_thread() noexcept {
+  auto index = registered_.fetch_add(1, std::memory_order_relaxed);
+  if (index >= max_threads_) {
+    return nullptr;
+  }
+  auto &ring = rings_[index];
+  ring.words.reset(new (std::nothrow)
+                       std::atomic<uint64_t>[(mask_ + 1) * words_per_event]);
+  if (!ring.words) {
+    return nullptr;
+  }
+  ring.tid = static_cast<int32_t>(::syscall(SYS_gettid));
+  ring.ready.store(true, std::memory_order_release);
+  return &ring;
+}
+
+uint64_t FlightRecorder::recorded() const noexcept {
+  uint64_t total = 0;
+  auto threads = std::min(registered_.load(std::memory_order_acquire),
+                          max_threads_);
+  for (std::size_t i = 0; i < threads; ++i) {
+    if (rings_[i].ready.load(std::memory_order_acquire)) {
+      total += rings_[i].head.load(std::memory_order_acquire);
+    }
+  }
+  return total;
+}
+
+bool FlightRecorder::write_chrome_trace(int fd) const noexcept {
+  fd_writer out(fd);
+  const auto &clock = utils::tsc_clock::current_calibration();
+  auto to_ns = [&](ticks stamp) {
+    auto delta =
+        static_cast<double>(static_cast<int64_t>(stamp - clock.tick_base));
+    return clock.ns_base + static_cast<int64_t>(delta * clock.ns_per_tick);
+  };
+
+  out.str("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+  bool first = true;
+  auto separator = [&] {
+    if (!first) {
+      out.str(",\n");
+    }
+    first = false;
+  };
+
+  // name each track's process once; tracks past the bitmap stay unnamed
+  constexpr std::size_t named_limit = 1024;
+  uint64_t named[named_limit / 64] = {};
+  auto name_process = [&](uint32_t track) {
+    auto process = process_of(track);
+    if (process >= named_limit || named[process / 64] >> process % 64 & 1) {
+      return;
+    }
+    named[process / 64] |= uint64_t{1} << process % 64;
+    separator();
+    out.str("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":")
+        .num(process)
+        .str(",\"args\":{\"name\":\"");
+    if (track == no_track) {
+      out.str("pipeline");
+    } else {
+      out.str("pipe ").num(track);
+    }
+    out.str("\"}}");
+  };
+
+  auto threads =
+      std::min(registered_.load(std::memory_order_acquire), max_threads_);
+  for (std::size_t t = 0; t < threads; ++t) {
+    const auto &ring = rings_[t];
+    if (!ring.ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+
+    auto capacity = mask_ + 1;
+    auto head = ring.head.load(std::memory_order_acquire);
+    auto first_kept = head > capacity ? head - capacity : 0;
+    for (auto index = first_kept; index < head; ++index) {
+      const auto *slot = &ring.words[(index & mask_) * words_per_event];
+      auto stamp = slot[0].load(std::memory_order_relaxed);
+      auto value = slot[1].load(std::memory_order_relaxed);
+      auto packed = slot[2].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // the writer may have lapped us while we copied. It rewrites slot
+      // `now_head - capacity` before publishing head + 1, so that slot is in
+      // flight too; one more is left out in case now_head is already stale.
+      auto now_head = ring.head.load(std::memory_order_relaxed);
+      if (index + capacity <= now_head + 1) {
+        continue;
+      }
+
+      auto track = static_cast<uint32_t>(packed);
+      auto kind = static_cast<flight_event>(packed >> 32 & 0xff);
+      auto ph = static_cast<phase>(packed >> 40 & 0xff);
+
+      name_process(track);
+      separator();
+      out.str("{\"name\":\"")
+          .str(event_name(kind))
+          .str("\",\"ph\":\"")
+          .str(ph == phase::begin ? "B" : ph == phase::end ? "E" : "i")
+          .str(ph == phase::instant ? "\",\"s\":\"t" : "")
+          .str("\",\"pid\":")
+          .num(process_of(track))
+          .str(",\"tid\":")
+          .num(static_cast<uint64_t>(ring.tid))
+          .str(",\"ts\":")
+          .micros(to_ns(stamp));
+      switch (kind) {
+      case flight_event::transfer:
+        if (ph == phase::begin) {
+          out.str(",\"args\":{\"bytes\":").num(value).str("}");
+        }
+        break;
+      case flight_event::metadata_sync:
+        if (ph == phase::begin) {
+          out.str(",\"args\":{\"counter\":").num(value).str("}");
+        }
+        break;
+      case flight_event::stall:
+        out.str(",\"args\":{\"reason\":\"").str(stall_name(value)).str("\"}");
+        break;
+      case flight_event::round:
+        break;
+      }
+      out.str("}");
+    }
+  }
+  out.str("\n]}\n");
+  return out.flush();
+}
+
+void FlightRecorder::dump(const char *path) const {
+  int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::system_error(errno, std::system_category(),
+                            "open(flight dump) failed");
+  }
+  bool ok = write_chrome_trace(fd);
+  int saved = errno;
+  ::close(fd);
+  if (!ok) {
+    throw std::system_error(saved, std::system_category(),
+                            "write(flight dump) failed");
+  }
+}
+
+void FlightRecorder::dump_on_fatal_signal(const char *path) {
+  if (std::strlen(path) >= sizeof(signal_path)) {
+    throw std::invalid_argument("Flight dump path too long");
+  }
+  signal_recorder.store(nullptr, std::memory_order_release);
+  std::strcpy(signal_path, path);
+  signal_recorder.store(this, std::memory_order_release);
+
+  struct sigaction action {};
+  action.sa_handler = dump_and_reraise;
+  action.sa_flags = SA_RESETHAND | SA_NODEFER;
+  sigemptyset(&action.sa_mask);
+  for (int signo : fatal_signals) {
+    if (::sigaction(signo, &action, nullptr) < 0) {
+      throw std::system_error(errno, std::system_category(),
+                              "sigaction failed");
+    }
+  }
+}
+
+} // namespace oc
@@ -0,0 +1,162 @@
+#pragma once
+#ifndef FLIGHT_RECORDER_HPP
+#define FLIGHT_RECORDER_HPP
+
+#include "oc/rb/basic_rb.hpp"
+#include "utils/tsc_clock.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace oc {
+
+/**
+ * @file flight_recorder.hpp
+ * @brief Always-on per-thread event rings with Chrome trace export
+ *
+ * Every thread that records gets its own ring of compact events, sized to a
+ * power of two and overwriting its oldest entries like
+ * PodOverwritingRingBuffer, so the recorder always holds the last few
+ * thousand events of each thread. Recording is a thread_local lookup, one
+ * clock read and four relaxed/release stores into memory only that thread
+ * writes: no locks, no allocation after the thread's first event.
+ *
+ * write_chrome_trace() renders every ring as Chrome trace / Perfetto JSON
+ * with one process per track (a pipe) and one row per thread. It does not
+ * allocate or lock, so it is safe both on demand while recording continues
+ * and from a fatal signal handler installed with dump_on_fatal_signal().
+ * Events a writer overwrites while they are being copied are left out, and
+ * so are the two oldest slots of a full ring, which it may be rewriting.
+ *
+ * A thread binds to one recorder at a time and takes a new ring each time it
+ * switches, so keep a single recorder per process.
+ */
+
+enum class flight_event : uint8_t {
+  transfer,      // value: bytes
+  metadata_sync, // value: counter stored
+  round,
+  stall, // value: flight_stall
+};
+
+enum class flight_stall : uint8_t {
+  source_empty,
+  destination_full,
+  metadata,
+  batching, // held for more records
+};
+
+class FlightRecorder {
+public:
+  using ticks = utils::tsc_clock::ticks;
+
+  static constexpr uint32_t no_track = std::numeric_limits<uint32_t>::max();
+
+  enum class phase : uint8_t { begin, end, instant };
+
+  explicit FlightRecorder(std::size_t events_per_thread = 1 << 14,
+                          std::size_t max_threads = 64);
+  ~FlightRecorder();
+
+  FlightRecorder(const FlightRecorder &) = delete;
+  FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+  void begin(flight_event kind, uint32_t track, uint64_t value = 0,
+             ticks now = utils::tsc_clock::now()) noexcept {
+    record(kind, phase::begin, track, value, now);
+  }
+
+  void end(flight_event kind, uint32_t track, uint64_t value = 0,
+           ticks now = utils::tsc_clock::now()) noexcept {
+    record(kind, phase::end, track, value, now);
+  }
+
+  void instant(flight_event kind, uint32_t track, uint64_t value = 0,
+               ticks now = utils::tsc_clock::now()) noexcept {
+    record(kind, phase::instant, track, value, now);
+  }
+
+  void record(flight_event kind, phase ph, uint32_t track, uint64_t value,
+              ticks now) noexcept {
+    auto *ring = this_thread_ring();
+    if (!ring) [[unlikely]] {
+      untracked_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    auto head = ring->head.load(std::memory_order_relaxed);
+    auto *slot = &ring->words[(head & mask_) * words_per_event];
+    slot[0].store(now, std::memory_order_relaxed);
+    slot[1].store(value, std::memory_order_relaxed);
+    slot[2].store(pack(kind, ph, track), std::memory_order_relaxed);
+    ring->head.store(head + 1, std::memory_order_release);
+  }
+
+  // Events recorded by all threads, including overwritten ones
+  [[nodiscard]] uint64_t recorded() const noexcept;
+
+  // Events lost because more threads recorded than max_threads allows
+  [[nodiscard]] uint64_t untracked() const noexcept {
+    return untracked_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::size_t events_per_thread() const noexcept {
+    return mask_ + 1;
+  }
+
+  // Write the retained events as Chrome trace JSON. Async-signal-safe.
+  // Returns false if a write to fd failed.
+  bool write_chrome_trace(int fd) const noexcept;
+
+  // Write the retained events to a new file at `path`; throws on failure.
+  void dump(const char *path) const;
+
+  // Dump to `path` on SIGSEGV, SIGBUS, SIGFPE, SIGILL or SIGABRT, then let
+  // the signal take its default action. One recorder owns the handlers at a
+  // time; the recorder must outlive them (uninstalled on destruction).
+  void dump_on_fatal_signal(const char *path);
+
+private:
+  static constexpr std::size_t words_per_event = 3;
+
+  struct alignas(rb::cache_line_size) thread_ring {
+    std::atomic<uint64_t> head{0};
+    std::atomic<bool> ready{false}; // words and tid are set
+    int32_t tid = 0;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+  };
+
+  static uint64_t pack(flight_event kind, phase ph, uint32_t track) noexcept {
+    return uint64_t{track} | uint64_t{static_cast<uint8_t>(kind)} << 32 |
+           uint64_t{static_cast<uint8_t>(ph)} << 40;
+  }
+
+  thread_ring *this_thread_ring() noexcept {
+    // keyed by id rather than address so a recorder at a reused address
+    // does not inherit a dead one's binding
+    struct binding {
+      uint64_t owner = 0;
+      thread_ring *ring = nullptr;
+    };
+    static thread_local binding cached;
+    if (cached.owner != id_) [[unlikely]] {
+      cached.ring = register_thread();
+      cached.owner = id_;
+    }
+    return cached.ring;
+  }
+
+  thread_ring *register_thread() noexcept;
+
+  uint64_t id_;
+  std::size_t mask_;
+  std::size_t max_threads_;
+  std::unique_ptr<thread_ring[]> rings_;
+  std::atomic<std::size_t> registered_{0};
+  std::atomic<uint64_t> untracked_{0};
+};
+
+} // namespace oc
+
+#endif
@@ -0,0 +1,286 @@
+#pragma once
+#ifndef FRAGMENT_HPP
+#define FRAGMENT_HPP
+
+#include "oc/pipe_policy.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace oc {
+
+/**
+ * @file fragment.hpp
+ * @brief Carry messages of any size through fixed-size pipe rings
+ *
+ * A pipe only moves what fits in its rings, so a message larger than
+ * src_capacity or dst_capacity could never be sent, and one close to it
+ * holds most of the ring while it drains. Fragmenter cuts messages into
+ * fragments of at most `max_fragment_bytes`, each a FragmentHeader (message
+ * id, total size, offset) followed by its slice of the payload, and writes
+ * them into a source ring as space frees up. Reassembler reads fragments
+ * from a destination ring and copies each payload slice straight into the
+ * buffer the caller supplied for that message.
+ *
+ * A message that fits in one fragment lying contiguously in the ring is
+ * handed to the caller in place, without a copy; larger ones take exactly
+ * one copy, from the ring into the final buffer.
+ *
+ * Rings are addressed like a pipe's: a byte span whose size is a power of
+ * two and free-running uint32_t head/tail positions. Fragments start on
+ * 8-byte boundaries so headers and payloads stay aligned.
+ */
+
+struct FragmentHeader {
+  static constexpr uint32_t first = 1;
+  static constexpr uint32_t last = 2;
+
+  uint32_t payload_bytes;
+  uint32_t flags;
+  uint64_t message_id;
+  uint64_t message_bytes;
+  uint64_t offset;
+};
+
+static_assert(sizeof(FragmentHeader) == 32);
+
+namespace detail {
+
+constexpr std::size_t fragment_alignment = 8;
+
+constexpr uint32_t fragment_stride(uint32_t payload_bytes) noexcept {
+  auto bytes = sizeof(FragmentHeader) + payload_bytes;
+  return static_cast<uint32_t>((bytes + fragment_alignment - 1) &
+                               ~(fragment_alignment - 1));
+}
+
+inline void ring_copy_in(std::span<std::byte> ring, uint32_t position,
+                         const void *data, std::size_t len) {
+  auto *bytes = static_cast<const std::byte *>(data);
+  for_each_ring_piece(ring.size(), position, len,
+                      [&](std::size_t offset, std::size_t piece) {
+                        std::memcpy(ring.data() + offset, bytes, piece);
+                        bytes += piece;
+                      });
+}
+
+inline void ring_copy_out(std::span<const std::byte> ring, uint32_t position,
+                          void *out, std::size_t len) {
+  auto *bytes = static_cast<std::byte *>(out);
+  for_each_ring_piece(ring.size(), position, len,
+                      [&](std::size_t offset, std::size_t piece) {
+                        std::memcpy(bytes, ring.data() + offset, piece);
+                        bytes += piece;
+                      });
+}
+
+} // namespace detail
+
+class Fragmenter {
+public:
+  explicit Fragmenter(uint32_t max_fragment_bytes)
+      : max_payload_(max_fragment_bytes > sizeof(FragmentHeader)
+                         ? (max_fragment_bytes - sizeof(FragmentHeader)) &
+                               ~uint32_t(detail::fragment_alignment - 1)
+                         : 0) {
+    if (max_payload_ == 0) {
+      throw std::invalid_argument("Fragments must hold more than a header");
+    }
+  }
+
+  // Queue `message` for sending and return its id. The bytes are read as
+  // fragments are written, so they must stay valid until sent() covers it.
+  uint64_t push(std::span<const std::byte> message) {
+    queue_.push_back({next_id_, message, 0});
+    return next_id_++;
+  }
+
+  // Write fragments of the queued messages, in order, into `ring` while
+  // they fit between `tail` and `head`; advances `tail`. Returns the bytes
+  // written.
+  uint32_t pump(std::span<std::byte> ring, uint32_t head, uint32_t &tail) {
+    if (!std::has_single_bit(ring.size())) {
+      throw std::invalid_argument("Ring size must be a power of two");
+    }
+    auto capacity = static_cast<uint32_t>(ring.size());
+    uint32_t written = 0;
+    while (!queue_.empty()) {
+      auto &message = queue_.front();
+      auto free = capacity - (tail - head);
+      if (free <= sizeof(FragmentHeader)) {
+        break;
+      }
+      auto room = (free - sizeof(FragmentHeader)) &
+                  ~uint32_t(detail::fragment_alignment - 1);
+      auto remaining = message.data.size() - message.offset;
+      auto payload = static_cast<uint32_t>(
+          std::min<uint64_t>({remaining, max_payload_, room}));
+      if (payload == 0 && remaining > 0) {
+        break;
+      }
+
+      FragmentHeader header{payload, 0, message.id, message.data.size(),
+                            message.offset};
+      if (message.offset == 0) {
+        header.flags |= FragmentHeader::first;
+      }
+      if (payload == remaining) {
+        header.flags |= FragmentHeader::last;
+      }
+      detail::ring_copy_in(ring, tail, &header, sizeof(header));
+      detail::ring_copy_in(ring, tail + sizeof(header),
+                           message.data.data() + message.offset, payload);
+
+      auto stride = detail::fragment_stride(payload);
+      tail += stride;
+      written += stride;
+      message.offset += payload;
+      ++fragments_;
+      if (message.offset == message.data.size()) {
+        sent_ = message.id + 1;
+        queue_.pop_front();
+      }
+    }
+    return written;
+  }
+
+  // messages with an id below this are fully in the ring
+  [[nodiscard]] uint64_t sent() const noexcept { return sent_; }
+
+  [[nodiscard]] bool idle() const noexcept { return queue_.empty(); }
+
+  [[nodiscard]] uint64_t fragments() const noexcept { return fragments_; }
+
+  [[nodiscard]] uint32_t max_payload_bytes() const noexcept {
+    return max_payload_;
+  }
+
+private:
+  struct pending {
+    uint64_t id;
+    std::span<const std::byte> data;
+    uint64_t offset;
+  };
+
+  uint32_t max_payload_;
+  std::deque<pending> queue_;
+  uint64_t next_id_ = 0;
+  uint64_t sent_ = 0;
+  uint64_t fragments_ = 0;
+};
+
+class Reassembler {
+public:
+  // Consume every complete fragment between `head` and `tail` of `ring`,
+  // advancing `head`.
+  //
+  // allocate(id, bytes) supplies the buffer for a message when its first
+  // fragment arrives: a span of at least `bytes`, or an empty one to
+  // discard the message. deliver(id, data) gets each complete message,
+  // either a view into the ring (valid only during the call) or the
+  // allocated buffer. Returns the number of messages delivered.
+  template <typename Allocate, typename Deliver>
+  std::size_t poll(std::span<const std::byte> ring, uint32_t &head,
+                   uint32_t tail, Allocate &&allocate, Deliver &&deliver) {
+    std::size_t delivered = 0;
+    auto capacity = static_cast<uint32_t>(ring.size());
+    while (tail - head >= sizeof(FragmentHeader)) {
+      FragmentHeader header;
+      detail::ring_copy_out(ring, head, &header, sizeof(header));
+      auto stride = detail::fragment_stride(header.payload_bytes);
+      if (tail - head < stride) {
+        break; // the rest of the fragment is still in flight
+      }
+      auto payload_at = head + static_cast<uint32_t>(sizeof(header));
+
+      bool whole = (header.flags & FragmentHeader::first) &&
+                   (header.flags & FragmentHeader::last);
+      if (whole && payload_at % capacity + header.payload_bytes <= capacity) {
+        deliver(header.message_id,
+                std::span<const std::byte>(ring.data() + payload_at % capacity,
+                                           header.payload_bytes));
+        ++delivered;
+        ++in_place_;
+      } else if (accept(header, ring, payload_at, allocate)) {
+        auto &message = partial_.at(header.message_id);
+        if (message.received == header.message_bytes) {
+          deliver(header.message_id,
+                  std::span<const std::byte>(message.buffer.data(),
+                                             header.message_bytes));
+          partial_.erase(header.message_id);
+          ++delivered;
+        }
+      }
+      head += stride;
+    }
+    return delivered;
+  }
+
+  // messages that arrived as one contiguous fragment and were not copied
+  [[nodiscard]] uint64_t delivered_in_place() const noexcept {
+    return in_place_;
+  }
+
+  // messages whose buffer the caller declined
+  [[nodiscard]] uint64_t discarded() const noexcept { return discarded_; }
+
+  // messages with fragments still outstanding
+  [[nodiscard]] std::size_t partial() const noexcept { return partial_.size(); }
+
+private:
+  struct assembly {
+    std::span<std::byte> buffer; // empty: discarding
+    uint64_t received = 0;
+  };
+
+  // copy one fragment into its message's buffer; false if discarded
+  template <typename Allocate>
+  bool accept(const FragmentHeader &header, std::span<const std::byte> ring,
+              uint32_t payload_at, Allocate &allocate) {
+    auto found = partial_.find(header.message_id);
+    if (found == partial_.end()) {
+      if (!(header.flags & FragmentHeader::first)) {
+        throw std::runtime_error("Fragment of an unknown message");
+      }
+      std::span<std::byte> buffer =
+          allocate(header.message_id, header.message_bytes);
+      if (!buffer.empty() && buffer.size() < header.message_bytes) {
+        throw std::length_error("Reassembly buffer is too small");
+      }
+      if (buffer.empty()) {
+        ++discarded_;
+      }
+      found = partial_.emplace(header.message_id, assembly{buffer}).first;
+    }
+
+    auto &message = found->second;
+    if (header.offset + header.payload_bytes > header.message_bytes) {
+      throw std::runtime_error("Fragment past the end of its message");
+    }
+    if (message.buffer.empty()) {
+      if (header.flags & FragmentHeader::last) {
+        partial_.erase(found);
+      }
+      return false;
+    }
+    detail::ring_copy_out(ring, payload_at,
+                          message.buffer.data() + header.offset,
+                          header.payload_bytes);
+    message.received += header.payload_bytes;
+    return true;
+  }
+
+  std::unordered_map<uint64_t, assembly> partial_;
+  uint64_t in_place_ = 0;
+  uint64_t discarded_ = 0;
+};
+
+} // namespace oc
+
+#endif
@@ -0,0 +1,410 @@
+#pragma once
+#include "tap.hpp"
+#include "utils/tsc_clock.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#ifndef INSTRUMENT_HPP
+#define INSTRUMENT_HPP
+
+namespace ex = stdexec;
+
+// Instrumentation adaptors, built like tap:
+//
+//   s | timed(sink)        records start-to-completion time in
+//                          utils::tsc_clock ticks into sink.record(ticks)
+//   s | counted(counter)   counts value, error and stopped completions
+//   s | sampled(n, f)      calls f(values...) on every n-th value completion
+//
+// None of them change the values or completions of the wrapped sender.
+// Building with OC_DISABLE_INSTRUMENTATION turns every adaptor into a
+// pass-through that returns the sender unchanged, so probes can stay in the
+// source of production paths such as adapter.transfer(...).
+//
+//   s | suspended(flag)    sets flag to whether s completed after its
+//                          start() returned, i.e. its awaiter had to wait
+//
+// suspended stays on in either build: pipes count metadata stalls with it.
+
+// Anything latency samples can go to, e.g. utils::Histogram or a
+// utils::ConcurrentHistogram::Recorder.
+template <class T>
+concept latency_sink = requires(T &sink, uint64_t ticks) { sink.record(ticks); };
+
+struct completion_counter {
+  std::atomic<uint64_t> value{0};
+  std::atomic<uint64_t> error{0};
+  std::atomic<uint64_t> stopped{0};
+
+  [[nodiscard]] uint64_t total() const noexcept {
+    return value.load(std::memory_order_relaxed) +
+           error.load(std::memory_order_relaxed) +
+           stopped.load(std::memory_order_relaxed);
+  }
+};
+
+#ifndef OC_DISABLE_INSTRUMENTATION
+
+// --- timed ------------------------------------------------------------------
+
+template <class R, class Sink> class timed_receiver {
+  R r_;
+  Sink *sink_;
+  const uint64_t *start_;
+
+  void record() noexcept {
+    sink_->record(oc::utils::tsc_clock::now() - *start_);
+  }
+
+public:
+  using receiver_concept = ex::receiver_t;
+
+  timed_receiver(R r, Sink *sink, const uint64_t *start)
+      : r_(std::move(r)), sink_(sink), start_(start) {}
+
+  template <class... As> void set_value(As &&...as) && noexcept {
+    record();
+    ex::set_value(std::move(r_), std::forward<As>(as)...);
+  }
+
+  template <class E> void set_error(E &&e) && noexcept {
+    record();
+    ex::set_error(std::move(r_), std::forward<E>(e));
+  }
+
+  void set_stopped() && noexcept {
+    record();
+    ex::set_stopped(std::move(r_));
+  }
+
+  decltype(auto) get_env() const noexcept { return ex::get_env(r_); }
+};
+
+// Owns the start stamp, which the receiver reads on completion; operation
+// states do not move, so the pointer stays valid.
+template <class S, class R, class Sink> struct timed_operation {
+  using operation_state_concept = ex::operation_state_t;
+
+  uint64_t start_ = 0;
+  ex::connect_result_t<S, timed_receiver<R, Sink>> op_;
+
+  timed_operation(S &&s, R r, Sink *sink)
+      : op_(ex::connect(std::move(s),
+                        timed_receiver<R, Sink>(std::move(r), sink, &start_))) {
+  }
+
+  void start() & noexcept {
+    start_ = oc::utils::tsc_clock::now();
+    ex::start(op_);
+  }
+};
+
+template <class S, class Sink> struct timed_sender {
+  using sender_concept = ex::sender_t;
+
+  S s_;
+  Sink *sink_;
+
+  template <class Env>
+  auto get_completion_signatures(Env &&) const noexcept
+      -> stdexec::completion_signatures_of_t<S, Env> {
+    return {};
+  }
+
+  template <class R> auto connect(R r) && {
+    return timed_operation<S, R, Sink>(std::move(s_), std::move(r), sink_);
+  }
+
+  decltype(auto) get_env() const noexcept { return ex::get_env(s_); }
+};
+
+struct timed_t {
+  template <class S, latency_sink Sink>
+  auto operator()(S &&s, Sink &sink) const {
+    return timed_sender<std::decay_t<S>, Sink>{std::forward<S>(s), &sink};
+  }
+
+  template <class S, latency_sink Sink>
+  auto operator()(S &&s, Sink *sink) const {
+    return timed_sender<std::decay_t<S>, Sink>{std::forward<S>(s), sink};
+  }
+
+  template <latency_sink Sink> auto operator()(Sink &sink) const {
+    return __binder_back<timed_t, Sink *>{&sink};
+  }
+};
+
+// --- counted ----------------------------------------------------------------
+
+template <class R> class counted_receiver {
+  R r_;
+  completion_counter *counter_;
+
+public:
+  using receiver_concept = ex::receiver_t;
+
+  counted_receiver(R r, completion_counter *counter)
+      : r_(std::move(r)), counter_(counter) {}
+
+  template <class... As> void set_value(As &&...as) && noexcept {
+    counter_->value.fetch_add(1, std::memory_order_relaxed);
+    ex::set_value(std::move(r_), std::forward<As>(as)...);
+  }
+
+  template <class E> void set_error(E &&e) && noexcept {
+    counter_->error.fetch_add(1, std::memory_order_relaxed);
+    ex::set_error(std::move(r_), std::forward<E>(e));
+  }
+
+  void set_stopped() && noexcept {
+    counter_->stopped.fetch_add(1, std::memory_order_relaxed);
+    ex::set_stopped(std::move(r_));
+  }
+
+  decltype(auto) get_env() const noexcept { return ex::get_env(r_); }
+};
+
+template <class S> struct counted_sender {
+  using sender_concept = ex::sender_t;
+
+  S s_;
+  completion_counter *counter_;
+
+  template <class Env>
+  auto get_completion_signatures(Env &&) const noexcept
+      -> stdexec::completion_signatures_of_t<S, Env> {
+    return {};
+  }
+
+  template <class R> auto connect(R r) && {
+    return ex::connect(std::move(s_),
+                       counted_receiver<R>(std::move(r), counter_));
+  }
+
+  decltype(auto) get_env() const noexcept { return ex::get_env(s_); }
+};
+
+struct counted_t {
+  template <class S> auto operator()(S &&s, completion_counter &counter) const {
+    return counted_sender<std::decay_t<S>>{std::forward<S>(s), &counter};
+  }
+
+  template <class S> auto operator()(S &&s, completion_counter *counter) const {
+    return counted_sender<std::decay_t<S>>{std::forward<S>(s), counter};
+  }
+
+  auto operator()(completion_counter &counter) const {
+    return __binder_back<counted_t, completion_counter *>{&counter};
+  }
+};
+
+// --- sampled ----------------------------------------------------------------
+
+// Shared by every sender built from one sampled(n, f) closure, so the count
+// carries across calls; build the closure once and reuse it.
+template <class F> struct sample_state {
+  uint64_t every;
+  std::atomic<uint64_t> seen{0};
+  F f;
+
+  sample_state(uint64_t every, F f) : every(every ? every : 1), f(std::move(f)) {}
+
+  template <class... As> void operator()(const As &...as) noexcept {
+    if (seen.fetch_add(1, std::memory_order_relaxed) % every != every - 1) {
+      return;
+    }
+    try {
+      std::invoke(f, as...);
+    } catch (...) {
+      // a failing probe must not fail the data path
+    }
+  }
+};
+
+template <class S, class F> struct sampled_sender {
+  using sender_concept = ex::sender_t;
+
+  S s_;
+  std::shared_ptr<sample_state<F>> state_;
+
+  template <class Env>
+  auto get_completion_signatures(Env &&) const noexcept
+      -> stdexec::completion_signatures_of_t<S, Env> {
+    return {};
+  }
+
+  template <class R> auto connect(R r) && {
+    auto *state = state_.get();
+    auto observe = [state](const auto &...as) noexcept { (*state)(as...); };
+    return ex::connect(std::move(s_),
+                       tap_receiver<R, decltype(observe)>(std::move(r),
+                                                          std::move(observe)));
+  }
+
+  decltype(auto) get_env() const noexcept { return ex::get_env(s_); }
+};
+
+struct sampled_t {
+  template <class S, class F>
+  auto operator()(S &&s, std::shared_ptr<sample_state<F>> state) const {
+    return sampled_sender<std::decay_t<S>, F>{std::forward<S>(s),
+                                              std::move(state)};
+  }
+
+  template <class S, class F>
+    requires ex::sender<S>
+  auto operator()(S &&s, uint64_t every, F &&f) const {
+    return (*this)(std::forward<S>(s),
+                   std::make_shared<sample_state<std::decay_t<F>>>(
+                       every, std::forward<F>(f)));
+  }
+
+  template <class F> auto operator()(uint64_t every, F &&f) const {
+    return __binder_back<sampled_t, std::shared_ptr<sample_state<std::decay_t<F>>>>{
+        std::make_shared<sample_state<std::decay_t<F>>>(every,
+                                                        std::forward<F>(f))};
+  }
+};
+
+#else // OC_DISABLE_INSTRUMENTATION
+
+struct instrumentation_passthrough
+    : ex::sender_adaptor_closure<instrumentation_passthrough> {
+  template <ex::sender S> std::decay_t<S> operator()(S &&s) const {
+    return std::forward<S>(s);
+  }
+};
+
+struct timed_t {
+  template <ex::sender S, class Sink>
+  std::decay_t<S> operator()(S &&s, Sink &&) const {
+    return std::forward<S>(s);
+  }
+  template <class Sink> auto operator()(Sink &&) const {
+    return instrumentation_passthrough{};
+  }
+};
+
+struct counted_t {
+  template <ex::sender S> std::decay_t<S> operator()(S &&s, auto &&) const {
+    return std::forward<S>(s);
+  }
+  auto operator()(completion_counter &) const {
+    return instrumentation_passthrough{};
+  }
+};
+
+struct sampled_t {
+  template <ex::sender S, class F>
+  std::decay_t<S> operator()(S &&s, uint64_t, F &&) const {
+    return std::forward<S>(s);
+  }
+  template <class F> auto operator()(uint64_t, F &&) const {
+    return instrumentation_passthrough{};
+  }
+};
+
+#endif // OC_DISABLE_INSTRUMENTATION
+
+// --- suspended --------------------------------------------------------------
+
+// Operation whose start() is running on this thread, innermost first.
+inline thread_local const void *suspended_starting = nullptr;
+
+template <class R> class suspended_receiver {
+  R r_;
+  bool *flag_;
+  const void *op_;
+
+  // completing from inside our own start() means nobody had to wait
+  void record() noexcept { *flag_ = suspended_starting != op_; }
+
+public:
+  using receiver_concept = ex::receiver_t;
+
+  suspended_receiver(R r, bool *flag, const void *op)
+      : r_(std::move(r)), flag_(flag), op_(op) {}
+
+  template <class... As> void set_value(As &&...as) && noexcept {
+    record();
+    ex::set_value(std::move(r_), std::forward<As>(as)...);
+  }
+
+  template <class E> void set_error(E &&e) && noexcept {
+    record();
+    ex::set_error(std::move(r_), std::forward<E>(e));
+  }
+
+  void set_stopped() && noexcept {
+    record();
+    ex::set_stopped(std::move(r_));
+  }
+
+  decltype(auto) get_env() const noexcept { return ex::get_env(r_); }
+};
+
+template <class S, class R> struct suspended_operation {
+  using operation_state_concept = ex::operation_state_t;
+
+  ex::connect_result_t<S, suspended_receiver<R>> op_;
+
+  suspended_operation(S &&s, R r, bool *flag)
+      : op_(ex::connect(std::move(s),
+                        suspended_receiver<R>(std::move(r), flag, this))) {}
+
+  void start() & noexcept {
+    // an inline completion may resume the awaiter, which can destroy this
+    // operation before ex::start returns: touch only the thread_local after
+    auto *outer = std::exchange(suspended_starting, this);
+    ex::start(op_);
+    suspended_starting = outer;
+  }
+};
+
+template <class S> struct suspended_sender {
+  using sender_concept = ex::sender_t;
+
+  S s_;
+  bool *flag_;
+
+  template <class Env>
+  auto get_completion_signatures(Env &&) const noexcept
+      -> stdexec::completion_signatures_of_t<S, Env> {
+    return {};
+  }
+
+  template <class R> auto connect(R r) && {
+    return suspended_operation<S, R>(std::move(s_), std::move(r), flag_);
+  }
+
+  decltype(auto) get_env() const noexcept { return ex::get_env(s_); }
+};
+
+struct suspended_t {
+  template <class S> auto operator()(S &&s, bool &flag) const {
+    return suspended_sender<std::decay_t<S>>{std::forward<S>(s), &flag};
+  }
+
+  template <class S> auto operator()(S &&s, bool *flag) const {
+    return suspended_sender<std::decay_t<S>>{std::forward<S>(s), flag};
+  }
+
+  auto operator()(bool &flag) const {
+    return __binder_back<suspended_t, bool *>{&flag};
+  }
+};
+
+// Usage: adapter.transfer(src, dst) | timed(recorder)
+inline constexpr timed_t timed{};
+// Usage: pipe->transfer() | counted(transfer_completions)
+inline constexpr counted_t counted{};
+// Usage: auto probe = sampled(1024, [](auto const&...) { /*observe*/ });
+//        s | probe
+inline constexpr sampled_t sampled{};
+// Usage: co_await (metadata_adapter.transfer(src, dst) | suspended(waited))
+inline constexpr suspended_t suspended{};
+
+#endif
@@ -0,0 +1,251 @@
+#include "control_channel.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace oc::io {
+
+namespace {
+
+constexpr std::size_t rx_chunk = 64 * 1024;
+
+} // namespace
+
+ControlChannel::ControlChannel(EpollReactor &reactor, int fd,
+                               std::size_t max_frame_size)
+    : reactor_(reactor), fd_(fd), max_frame_size_(max_frame_size),
+      rx_(rx_chunk) {
+  set_nonblocking(fd_);
+  reactor_.watch(fd_, this);
+}
+
+ControlChannel::~ControlChannel() {
+  reactor_.unwatch(fd_);
+  ::close(fd_);
+}
+
+void ControlChannel::submit(SendOp *op) noexcept {
+  op->owner = this;
+  op->execute = [](ReactorOp *base) noexcept {
+    auto *op = static_cast<SendOp *>(base);
+    op->owner->start_send(op);
+  };
+  reactor_.post(op);
+}
+
+void ControlChannel::submit(ReceiveOp *op) noexcept {
+  op->owner = this;
+  op->execute = [](ReactorOp *base) noexcept {
+    auto *op = static_cast<ReceiveOp *>(base);
+    op->owner->start_receive(op);
+  };
+  reactor_.post(op);
+}
+
+void ControlChannel::start_send(SendOp *op) noexcept {
+  if (error_) {
+    op->error = error_;
+    op->complete(op);
+    return;
+  }
+  if (op->payload.size() > max_frame_size_) {
+    op->error = EMSGSIZE;
+    op->complete(op);
+    return;
+  }
+
+  op->header = {op->channel, static_cast<uint32_t>(op->payload.size())};
+  op->written = 0;
+  op->error = 0;
+  op->next_send = nullptr;
+
+  bool idle = send_head_ == nullptr;
+  if (send_tail_) {
+    send_tail_->next_send = op;
+  } else {
+    send_head_ = op;
+  }
+  send_tail_ = op;
+
+  // with a send in flight we are waiting for EPOLLOUT already
+  if (idle) {
+    flush_sends();
+  }
+}
+
+void ControlChannel::start_receive(ReceiveOp *op) noexcept {
+  op->error = 0;
+
+  auto queued = inbox_.find(op->channel);
+  if (queued != inbox_.end() && !queued->second.empty()) {
+    op->message = std::move(queued->second.front());
+    queued->second.pop_front();
+    op->complete(op);
+    return;
+  }
+
+  if (error_) {
+    op->error = error_;
+    op->complete(op);
+    return;
+  }
+
+  waiters_[op->channel].push_back(op);
+}
+
+void ControlChannel::flush_sends() noexcept {
+  while (send_head_) {
+    auto *op = send_head_;
+    const auto header_size = sizeof(FrameHeader);
+    const auto total = header_size + op->payload.size();
+
+    iovec iov[2];
+    int iov_count = 0;
+    if (op->written < header_size) {
+      iov[iov_count++] = {reinterpret_cast<std::byte *>(&op->header) +
+                              op->written,
+                          header_size - op->written};
+    }
+    auto payload_done = op->written > header_size ? op->written - header_size
+                                                  : std::size_t{0};
+    if (payload_done < op->payload.size()) {
+      iov[iov_count++] = {
+          const_cast<std::byte *>(op->payload.data()) + payload_done,
+          op->payload.size() - payload_done};
+    }
+
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_count;
+    ssize_t n = ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return;
+      }
+      fail(errno);
+      return;
+    }
+
+    op->written += static_cast<std::size_t>(n);
+    if (op->written == total) {
+      send_head_ = op->next_send;
+      if (!send_head_) {
+        send_tail_ = nullptr;
+      }
+      op->complete(op);
+    }
+  }
+}
+
+void ControlChannel::read_available() noexcept {
+  while (!error_) {
+    if (rx_len_ == rx_.size()) {
+      // a single frame larger than the buffer: grow up to the frame limit
+      auto limit = sizeof(FrameHeader) + max_frame_size_;
+      if (rx_.size() >= limit) {
+        fail(EMSGSIZE);
+        return;
+      }
+      rx_.resize(std::min(limit, rx_.size() * 2));
+    }
+
+    ssize_t n = ::recv(fd_, rx_.data() + rx_len_, rx_.size() - rx_len_, 0);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        fail(errno);
+      }
+      return;
+    }
+    if (n == 0) {
+      fail(ECONNRESET);
+      return;
+    }
+
+    rx_len_ += static_cast<std::size_t>(n);
+    parse_frames();
+  }
+}
+
+void ControlChannel::parse_frames() noexcept {
+  std::size_t offset = 0;
+  while (rx_len_ - offset >= sizeof(FrameHeader)) {
+    FrameHeader header;
+    std::memcpy(&header, rx_.data() + offset, sizeof(header));
+    if (header.length > max_frame_size_) {
+      fail(EMSGSIZE);
+      return;
+    }
+    if (rx_len_ - offset < sizeof(header) + header.length) {
+      break;
+    }
+
+    auto *payload = rx_.data() + offset + sizeof(header);
+    deliver(header.channel,
+            std::vector<std::byte>(payload, payload + header.length));
+    offset += sizeof(header) + header.length;
+  }
+
+  if (offset > 0) {
+    std::memmove(rx_.data(), rx_.data() + offset, rx_len_ - offset);
+    rx_len_ -= offset;
+  }
+}
+
+void ControlChannel::deliver(uint32_t channel,
+                             std::vector<std::byte> message) noexcept {
+  auto waiting = waiters_.find(channel);
+  if (waiting != waiters_.end() && !waiting->second.empty()) {
+    auto *op = waiting->second.front();
+    waiting->second.pop_front();
+    op->message = std::move(message);
+    op->complete(op);
+    return;
+  }
+  inbox_[channel].push_back(std::move(message));
+}
+
+void ControlChannel::fail(int error) noexcept {
+  if (error_) {
+    return;
+  }
+  error_ = error;
+
+  while (send_head_) {
+    auto *op = send_head_;
+    send_head_ = op->next_send;
+    op->error = error;
+    op->complete(op);
+  }
+  send_tail_ = nullptr;
+
+  auto waiters = std::move(waiters_);
+  waiters_.clear();
+  for (auto &[channel, ops] : waiters) {
+    for (auto *op : ops) {
+      op->error = error;
+      op->complete(op);
+    }
+  }
+}
+
+void ControlChannel::on_ready(uint32_t events) noexcept {
+  if (events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) {
+    read_available();
+  }
+  if (send_head_ && (events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+    flush_sends();
+  }
+}
+
+} // namespace oc::io
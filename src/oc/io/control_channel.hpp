@@ -0,0 +1,103 @@
+#pragma once
+#ifndef CONTROL_CHANNEL_HPP
+#define CONTROL_CHANNEL_HPP
+
+#include "oc/io/epoll_reactor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace oc::io {
+
+// Wire header of one frame; payload follows
+struct FrameHeader {
+  uint32_t channel;
+  uint32_t length;
+};
+
+static_assert(sizeof(FrameHeader) == 8);
+
+/**
+ * @brief Framed, multiplexed control connection on an EpollReactor
+ *
+ * Many logical channels share one non-blocking socket. Every message is one
+ * frame tagged with its channel id; frames of concurrent sends are never
+ * interleaved and each channel sees its messages in send order. Messages
+ * that arrive before anyone asked for them are queued per channel.
+ *
+ * After a socket error or peer hang-up every pending and future operation
+ * fails with the sticky error, except receives that can still be satisfied
+ * from already queued messages.
+ */
+class ControlChannel final : private FdHandler {
+public:
+  static constexpr std::size_t default_max_frame_size = 1 << 20;
+
+  struct SendOp : ReactorOp {
+    ControlChannel *owner = nullptr;
+    uint32_t channel = 0;
+    std::span<const std::byte> payload; // must outlive the op
+    FrameHeader header{};
+    std::size_t written = 0;
+    int error = 0;
+    void (*complete)(SendOp *) noexcept = nullptr;
+    SendOp *next_send = nullptr;
+  };
+
+  struct ReceiveOp : ReactorOp {
+    ControlChannel *owner = nullptr;
+    uint32_t channel = 0;
+    std::vector<std::byte> message;
+    int error = 0;
+    void (*complete)(ReceiveOp *) noexcept = nullptr;
+  };
+
+  // Takes ownership of a connected stream socket
+  ControlChannel(EpollReactor &reactor, int fd,
+                 std::size_t max_frame_size = default_max_frame_size);
+  ~ControlChannel();
+
+  ControlChannel(const ControlChannel &) = delete;
+  ControlChannel &operator=(const ControlChannel &) = delete;
+
+  // Both start op from any thread; completions run on the reactor thread
+  void submit(SendOp *op) noexcept;
+  void submit(ReceiveOp *op) noexcept;
+
+  [[nodiscard]] EpollReactor &reactor() const noexcept { return reactor_; }
+
+  // Sticky errno after failure, 0 while healthy; reactor thread only
+  [[nodiscard]] int error() const noexcept { return error_; }
+
+private:
+  void on_ready(uint32_t events) noexcept override;
+
+  void start_send(SendOp *op) noexcept;
+  void start_receive(ReceiveOp *op) noexcept;
+  void flush_sends() noexcept;
+  void read_available() noexcept;
+  void parse_frames() noexcept;
+  void deliver(uint32_t channel, std::vector<std::byte> message) noexcept;
+  void fail(int error) noexcept;
+
+  EpollReactor &reactor_;
+  int fd_;
+  std::size_t max_frame_size_;
+  int error_ = 0;
+
+  SendOp *send_head_ = nullptr;
+  SendOp *send_tail_ = nullptr;
+
+  std::vector<std::byte> rx_;
+  std::size_t rx_len_ = 0;
+
+  std::unordered_map<uint32_t, std::deque<std::vector<std::byte>>> inbox_;
+  std::unordered_map<uint32_t, std::deque<ReceiveOp *>> waiters_;
+};
+
+} // namespace oc::io
+
+#endif
@@ -0,0 +1,242 @@
+#include "epoll_reactor.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace oc::io {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char *what) {
+  throw std::system_error(errno, std::system_category(), what);
+}
+
+constexpr int max_events = 64;
+
+} // namespace
+
+void set_nonblocking(int fd) {
+  int flags = ::fcntl(fd, F_GETFL, 0);
+  if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    throw_errno("fcntl(O_NONBLOCK) failed");
+  }
+}
+
+EpollReactor::EpollReactor() {
+  epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    throw_errno("epoll_create1 failed");
+  }
+
+  wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd_ < 0) {
+    ::close(epoll_fd_);
+    throw_errno("eventfd failed");
+  }
+
+  // data.ptr == nullptr marks the wake-up eventfd
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.ptr = nullptr;
+  if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event) < 0) {
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+    throw_errno("epoll_ctl(eventfd) failed");
+  }
+}
+
+EpollReactor::~EpollReactor() {
+  ::close(wake_fd_);
+  ::close(epoll_fd_);
+}
+
+void EpollReactor::post(ReactorOp *op) noexcept {
+  op->next = nullptr;
+  bool need_wake = false;
+  {
+    std::lock_guard lock(mutex_);
+    if (posted_tail_) {
+      posted_tail_->next = op;
+    } else {
+      posted_head_ = op;
+    }
+    posted_tail_ = op;
+    need_wake = !std::exchange(wake_pending_, true);
+  }
+  if (need_wake) {
+    wake();
+  }
+}
+
+void EpollReactor::wake() noexcept {
+  uint64_t one = 1;
+  // EAGAIN means the counter is already non-zero, which is just as good
+  [[maybe_unused]] auto written = ::write(wake_fd_, &one, sizeof(one));
+}
+
+std::size_t EpollReactor::drain_posted() noexcept {
+  ReactorOp *op;
+  {
+    std::lock_guard lock(mutex_);
+    op = std::exchange(posted_head_, nullptr);
+    posted_tail_ = nullptr;
+    wake_pending_ = false;
+  }
+
+  std::size_t ran = 0;
+  while (op) {
+    // execute() may complete and destroy the op, read next first
+    auto *next = op->next;
+    op->execute(op);
+    op = next;
+    ++ran;
+  }
+  return ran;
+}
+
+std::size_t EpollReactor::run_once(int timeout_ms) {
+  {
+    std::lock_guard lock(mutex_);
+    if (posted_head_) {
+      timeout_ms = 0;
+    }
+  }
+
+  epoll_event events[max_events];
+  int ready = ::epoll_wait(epoll_fd_, events, max_events, timeout_ms);
+  if (ready < 0) {
+    if (errno == EINTR) {
+      return 0;
+    }
+    throw_errno("epoll_wait failed");
+  }
+
+  std::size_t ran = 0;
+  for (int i = 0; i < ready; ++i) {
+    if (events[i].data.ptr == nullptr) {
+      uint64_t count;
+      [[maybe_unused]] auto read = ::read(wake_fd_, &count, sizeof(count));
+      continue;
+    }
+    static_cast<FdHandler *>(events[i].data.ptr)->on_ready(events[i].events);
+    ++ran;
+  }
+
+  return ran + drain_posted();
+}
+
+void EpollReactor::run() {
+  while (!stop_requested()) {
+    run_once(-1);
+  }
+}
+
+void EpollReactor::request_stop() noexcept {
+  stop_requested_.store(true, std::memory_order_release);
+  wake();
+}
+
+void EpollReactor::watch(int fd, FdHandler *handler) {
+  epoll_event event{};
+  event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+  event.data.ptr = handler;
+  if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+    throw_errno("epoll_ctl(ADD) failed");
+  }
+}
+
+void EpollReactor::unwatch(int fd) noexcept {
+  ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+AsyncSocket::AsyncSocket(EpollReactor &reactor, int fd)
+    : reactor_(reactor), fd_(fd) {
+  set_nonblocking(fd_);
+  reactor_.watch(fd_, this);
+}
+
+AsyncSocket::~AsyncSocket() {
+  reactor_.unwatch(fd_);
+  ::close(fd_);
+}
+
+void AsyncSocket::submit(IoOp *op) noexcept {
+  op->socket = this;
+  op->transferred = 0;
+  op->error = 0;
+  op->execute = [](ReactorOp *base) noexcept {
+    auto *op = static_cast<IoOp *>(base);
+    auto &slot = op->is_write ? op->socket->writer_ : op->socket->reader_;
+    if (slot) {
+      op->error = EBUSY; // one outstanding op per direction
+      op->complete(op);
+      return;
+    }
+    if (!op->socket->attempt(op)) {
+      slot = op;
+    }
+  };
+  reactor_.post(op);
+}
+
+bool AsyncSocket::attempt(IoOp *op) noexcept {
+  while (op->transferred < op->size) {
+    auto *data = op->data + op->transferred;
+    auto remaining = op->size - op->transferred;
+    ssize_t n = op->is_write ? ::send(fd_, data, remaining, MSG_NOSIGNAL)
+                             : ::recv(fd_, data, remaining, 0);
+
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return false;
+      }
+      op->error = errno;
+      break;
+    }
+
+    if (n == 0 && !op->is_write) {
+      // EOF: fine for a "some" read, a failure for an exact one
+      if (op->exact) {
+        op->error = ECONNRESET;
+      }
+      break;
+    }
+
+    op->transferred += static_cast<std::size_t>(n);
+    if (!op->exact) {
+      break;
+    }
+  }
+
+  op->complete(op);
+  return true;
+}
+
+void AsyncSocket::on_ready(uint32_t events) noexcept {
+  constexpr uint32_t failure = EPOLLERR | EPOLLHUP;
+  if (reader_ && (events & (EPOLLIN | EPOLLRDHUP | failure))) {
+    auto *op = reader_;
+    reader_ = nullptr;
+    if (!attempt(op)) {
+      reader_ = op;
+    }
+  }
+  if (writer_ && (events & (EPOLLOUT | failure))) {
+    auto *op = writer_;
+    writer_ = nullptr;
+    if (!attempt(op)) {
+      writer_ = op;
+    }
+  }
+}
+
+} // namespace oc::io
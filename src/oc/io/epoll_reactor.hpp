@@ -0,0 +1,145 @@
+#pragma once
+#ifndef EPOLL_REACTOR_HPP
+#define EPOLL_REACTOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+
+namespace oc::io {
+
+/**
+ * @brief Unit of work executed on the reactor thread
+ *
+ * Operation states embed a ReactorOp and hand it to EpollReactor::post();
+ * the reactor calls execute() from run_once(). Intrusive, so posting never
+ * allocates.
+ */
+struct ReactorOp {
+  ReactorOp *next = nullptr;
+  void (*execute)(ReactorOp *) noexcept = nullptr;
+};
+
+/**
+ * @brief Receives readiness notifications for a watched file descriptor
+ *
+ * Descriptors are watched edge-triggered, so a handler must drain the fd
+ * (until EAGAIN) before it can expect the next notification.
+ */
+class FdHandler {
+public:
+  virtual void on_ready(uint32_t events) noexcept = 0;
+
+protected:
+  ~FdHandler() = default;
+};
+
+/**
+ * @brief Single-threaded epoll event loop
+ *
+ * post() may be called from any thread; everything else, including every
+ * ReactorOp::execute and FdHandler::on_ready, runs on the thread driving
+ * run_once()/run(). The loop can get its own thread or be polled with
+ * run_once(0) from an existing progress loop, so control-plane traffic never
+ * blocks the data path.
+ */
+class EpollReactor {
+public:
+  EpollReactor();
+  ~EpollReactor();
+
+  EpollReactor(const EpollReactor &) = delete;
+  EpollReactor &operator=(const EpollReactor &) = delete;
+
+  // Queue op for execution on the reactor thread; thread-safe
+  void post(ReactorOp *op) noexcept;
+
+  /**
+   * @brief Wait for readiness or posted work and dispatch it
+   * @param timeout_ms epoll timeout; ignored (treated as 0) if work is queued
+   * @return Number of handlers and ops that ran
+   */
+  std::size_t run_once(int timeout_ms = -1);
+
+  // Run until request_stop()
+  void run();
+
+  // Make run() return; thread-safe
+  void request_stop() noexcept;
+
+  [[nodiscard]] bool stop_requested() const noexcept {
+    return stop_requested_.load(std::memory_order_acquire);
+  }
+
+  // Watch fd for input, output and hang-up, edge-triggered
+  void watch(int fd, FdHandler *handler);
+  void unwatch(int fd) noexcept;
+
+private:
+  void wake() noexcept;
+  std::size_t drain_posted() noexcept;
+
+  int epoll_fd_ = -1;
+  int wake_fd_ = -1;
+
+  std::mutex mutex_;
+  ReactorOp *posted_head_ = nullptr;
+  ReactorOp *posted_tail_ = nullptr;
+  bool wake_pending_ = false;
+
+  std::atomic<bool> stop_requested_{false};
+};
+
+/**
+ * @brief Non-blocking stream socket driven by an EpollReactor
+ *
+ * At most one read and one write may be outstanding at a time. An exact
+ * operation keeps going until the whole buffer is transferred; a "some"
+ * operation completes after the first successful transfer (0 on EOF).
+ */
+class AsyncSocket final : private FdHandler {
+public:
+  struct IoOp : ReactorOp {
+    AsyncSocket *socket = nullptr;
+    std::byte *data = nullptr;
+    std::size_t size = 0;
+    std::size_t transferred = 0;
+    bool exact = false;
+    bool is_write = false;
+    int error = 0; // errno value, 0 on success
+    void (*complete)(IoOp *) noexcept = nullptr;
+  };
+
+  // Takes ownership of fd and switches it to non-blocking mode
+  AsyncSocket(EpollReactor &reactor, int fd);
+  ~AsyncSocket();
+
+  AsyncSocket(const AsyncSocket &) = delete;
+  AsyncSocket &operator=(const AsyncSocket &) = delete;
+
+  // Start op; its completion runs on the reactor thread
+  void submit(IoOp *op) noexcept;
+
+  [[nodiscard]] EpollReactor &reactor() const noexcept { return reactor_; }
+  [[nodiscard]] int fd() const noexcept { return fd_; }
+
+private:
+  void on_ready(uint32_t events) noexcept override;
+  // Transfer as much as possible; true if the op finished (and completed)
+  bool attempt(IoOp *op) noexcept;
+
+  EpollReactor &reactor_;
+  int fd_;
+  IoOp *reader_ = nullptr;
+  IoOp *writer_ = nullptr;
+};
+
+// Put fd into non-blocking mode; throws std::system_error on failure
+void set_nonblocking(int fd);
+
+} // namespace oc::io
+
+#endif
@@ -0,0 +1,251 @@
+#pragma once
+#ifndef IO_SENDERS_HPP
+#define IO_SENDERS_HPP
+
+#include "oc/io/control_channel.hpp"
+#include "oc/io/epoll_reactor.hpp"
+#include <span>
+#include <stdexec/execution.hpp>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace ex = stdexec;
+
+namespace oc::io {
+
+/**
+ * @file senders.hpp
+ * @brief stdexec view of the epoll reactor and the control channel
+ *
+ * - get_scheduler(reactor): a scheduler whose schedule() completes on the
+ *   reactor thread
+ * - async_read_some/async_read/async_write_some/async_write on AsyncSocket,
+ *   completing with the number of bytes transferred
+ * - send/receive on ControlChannel for framed messages on a logical channel
+ *
+ * Every sender completes on the reactor thread; errors are reported as
+ * std::error_code. Cancellation is not supported: an operation, once
+ * started, runs until it succeeds or the connection fails.
+ */
+
+inline std::error_code errno_code(int error) noexcept {
+  return {error, std::system_category()};
+}
+
+class ReactorScheduler {
+public:
+  explicit ReactorScheduler(EpollReactor *reactor) noexcept
+      : reactor_(reactor) {}
+
+  template <class Receiver> struct schedule_op : ReactorOp {
+    EpollReactor *reactor;
+    Receiver rcvr;
+
+    schedule_op(EpollReactor *reactor, Receiver rcvr)
+        : reactor(reactor), rcvr(std::move(rcvr)) {
+      execute = [](ReactorOp *base) noexcept {
+        auto *self = static_cast<schedule_op *>(base);
+        ex::set_value(std::move(self->rcvr));
+      };
+    }
+
+    void start() & noexcept { reactor->post(this); }
+  };
+
+  struct env {
+    EpollReactor *reactor;
+
+    template <class CPO>
+    ReactorScheduler
+    query(ex::get_completion_scheduler_t<CPO>) const noexcept {
+      return ReactorScheduler(reactor);
+    }
+  };
+
+  struct sender {
+    using sender_concept = ex::sender_t;
+    using completion_signatures =
+        ex::completion_signatures<ex::set_value_t()>;
+
+    EpollReactor *reactor;
+
+    template <class Receiver> auto connect(Receiver rcvr) const {
+      return schedule_op<Receiver>(reactor, std::move(rcvr));
+    }
+
+    env get_env() const noexcept { return {reactor}; }
+  };
+
+  sender schedule() const noexcept { return {reactor_}; }
+
+  bool operator==(const ReactorScheduler &) const noexcept = default;
+
+private:
+  EpollReactor *reactor_;
+};
+
+inline ReactorScheduler get_scheduler(EpollReactor &reactor) noexcept {
+  return ReactorScheduler(&reactor);
+}
+
+template <class Receiver> struct socket_io_op : AsyncSocket::IoOp {
+  Receiver rcvr;
+
+  socket_io_op(AsyncSocket *socket, std::byte *data, std::size_t size,
+               bool exact, bool is_write, Receiver rcvr)
+      : rcvr(std::move(rcvr)) {
+    this->socket = socket;
+    this->data = data;
+    this->size = size;
+    this->exact = exact;
+    this->is_write = is_write;
+    this->complete = [](AsyncSocket::IoOp *base) noexcept {
+      auto *self = static_cast<socket_io_op *>(base);
+      if (self->error) {
+        ex::set_error(std::move(self->rcvr), errno_code(self->error));
+      } else {
+        ex::set_value(std::move(self->rcvr), self->transferred);
+      }
+    };
+  }
+
+  void start() & noexcept { this->socket->submit(this); }
+};
+
+struct socket_io_sender {
+  using sender_concept = ex::sender_t;
+  using completion_signatures =
+      ex::completion_signatures<ex::set_value_t(std::size_t),
+                                ex::set_error_t(std::error_code)>;
+
+  AsyncSocket *socket;
+  std::byte *data;
+  std::size_t size;
+  bool exact;
+  bool is_write;
+
+  template <class Receiver> auto connect(Receiver rcvr) const {
+    return socket_io_op<Receiver>(socket, data, size, exact, is_write,
+                                  std::move(rcvr));
+  }
+};
+
+// Completes after the first successful read; 0 means EOF
+inline socket_io_sender async_read_some(AsyncSocket &socket,
+                                        std::span<std::byte> buf) noexcept {
+  return {&socket, buf.data(), buf.size(), false, false};
+}
+
+// Completes once buf is full; EOF before that is an error
+inline socket_io_sender async_read(AsyncSocket &socket,
+                                   std::span<std::byte> buf) noexcept {
+  return {&socket, buf.data(), buf.size(), true, false};
+}
+
+inline socket_io_sender
+async_write_some(AsyncSocket &socket, std::span<const std::byte> buf) noexcept {
+  return {&socket, const_cast<std::byte *>(buf.data()), buf.size(), false,
+          true};
+}
+
+inline socket_io_sender async_write(AsyncSocket &socket,
+                                    std::span<const std::byte> buf) noexcept {
+  return {&socket, const_cast<std::byte *>(buf.data()), buf.size(), true,
+          true};
+}
+
+template <class Receiver> struct channel_send_op : ControlChannel::SendOp {
+  ControlChannel *target;
+  std::vector<std::byte> storage;
+  Receiver rcvr;
+
+  channel_send_op(ControlChannel *target, uint32_t channel,
+                  std::vector<std::byte> storage, Receiver rcvr)
+      : target(target), storage(std::move(storage)), rcvr(std::move(rcvr)) {
+    this->channel = channel;
+    this->payload = this->storage;
+    this->complete = [](ControlChannel::SendOp *base) noexcept {
+      auto *self = static_cast<channel_send_op *>(base);
+      if (self->error) {
+        ex::set_error(std::move(self->rcvr), errno_code(self->error));
+      } else {
+        ex::set_value(std::move(self->rcvr));
+      }
+    };
+  }
+
+  void start() & noexcept { target->submit(this); }
+};
+
+struct channel_send_sender {
+  using sender_concept = ex::sender_t;
+  using completion_signatures =
+      ex::completion_signatures<ex::set_value_t(),
+                                ex::set_error_t(std::error_code)>;
+
+  ControlChannel *target;
+  uint32_t channel;
+  std::vector<std::byte> payload;
+
+  template <class Receiver> auto connect(Receiver rcvr) && {
+    return channel_send_op<Receiver>(target, channel, std::move(payload),
+                                     std::move(rcvr));
+  }
+
+  template <class Receiver> auto connect(Receiver rcvr) const & {
+    return channel_send_op<Receiver>(target, channel, payload,
+                                     std::move(rcvr));
+  }
+};
+
+template <class Receiver> struct channel_receive_op : ControlChannel::ReceiveOp {
+  ControlChannel *target;
+  Receiver rcvr;
+
+  channel_receive_op(ControlChannel *target, uint32_t channel, Receiver rcvr)
+      : target(target), rcvr(std::move(rcvr)) {
+    this->channel = channel;
+    this->complete = [](ControlChannel::ReceiveOp *base) noexcept {
+      auto *self = static_cast<channel_receive_op *>(base);
+      if (self->error) {
+        ex::set_error(std::move(self->rcvr), errno_code(self->error));
+      } else {
+        ex::set_value(std::move(self->rcvr), std::move(self->message));
+      }
+    };
+  }
+
+  void start() & noexcept { target->submit(this); }
+};
+
+struct channel_receive_sender {
+  using sender_concept = ex::sender_t;
+  using completion_signatures =
+      ex::completion_signatures<ex::set_value_t(std::vector<std::byte>),
+                                ex::set_error_t(std::error_code)>;
+
+  ControlChannel *target;
+  uint32_t channel;
+
+  template <class Receiver> auto connect(Receiver rcvr) const {
+    return channel_receive_op<Receiver>(target, channel, std::move(rcvr));
+  }
+};
+
+// Send one framed message on a logical channel; the payload is owned by the
+// operation, so callers may drop their copy right away
+inline channel_send_sender send(ControlChannel &target, uint32_t channel,
+                                std::vector<std::byte> payload) {
+  return {&target, channel, std::move(payload)};
+}
+
+// Next message on a logical channel, in send order
+inline channel_receive_sender receive(ControlChannel &target,
+                                      uint32_t channel) noexcept {
+  return {&target, channel};
+}
+
+} // namespace oc::io
+
+#endif
@@ -0,0 +1,163 @@
+#pragma once
+#ifndef METADATA_PAGE_HPP
+#define METADATA_PAGE_HPP
+
+#include "oc/rb/basic_rb.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace oc {
+
+/**
+ * @file metadata_page.hpp
+ * @brief Packed metadata page shared by all pipes between two peers
+ *
+ * Instead of one registered 8-byte region per counter, both peers register a
+ * single page with the same layout and exchange it once. Every pipe between
+ * the two peers owns one forward and one backward slot:
+ *
+ *   [forward slot, pipe 0][forward slot, pipe 1]...[forward slot, pipe N-1]
+ *   [backward slot, pipe 0]...[backward slot, pipe N-1]
+ *
+ * The forward slot carries what the upstream side publishes (tail, credit),
+ * the backward slot what the downstream side publishes (head). Each slot is a
+ * full cache line, so counters written by different sides never share one,
+ * and the two counters of a forward slot go out with one write. Forward slots
+ * are contiguous, so a single write of forward_range() refreshes the tails of
+ * several pipes at once.
+ *
+ * A side only ever writes into the peer's page the slots it owns for that
+ * pipe; its own copy of those slots is free and serves as the staging buffer
+ * for the transfer.
+ */
+
+struct alignas(rb::cache_line_size) ForwardSlot {
+  std::atomic<uint32_t> tail{0};
+  std::atomic<uint32_t> credit{0};
+};
+
+struct alignas(rb::cache_line_size) BackwardSlot {
+  std::atomic<uint32_t> head{0};
+};
+
+static_assert(sizeof(ForwardSlot) == rb::cache_line_size);
+static_assert(sizeof(BackwardSlot) == rb::cache_line_size);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+class MetadataPageLayout {
+public:
+  static constexpr uint32_t version = 1;
+
+  constexpr explicit MetadataPageLayout(uint32_t num_pipes) noexcept
+      : num_pipes_(num_pipes) {}
+
+  [[nodiscard]] constexpr uint32_t num_pipes() const noexcept {
+    return num_pipes_;
+  }
+
+  [[nodiscard]] constexpr std::size_t size_bytes() const noexcept {
+    return num_pipes_ * (sizeof(ForwardSlot) + sizeof(BackwardSlot));
+  }
+
+  [[nodiscard]] constexpr std::size_t forward_offset(uint32_t pipe) const {
+    check(pipe);
+    return pipe * sizeof(ForwardSlot);
+  }
+
+  [[nodiscard]] constexpr std::size_t backward_offset(uint32_t pipe) const {
+    check(pipe);
+    return num_pipes_ * sizeof(ForwardSlot) + pipe * sizeof(BackwardSlot);
+  }
+
+  // (offset, length) of the forward slots of pipes [first, first + count)
+  [[nodiscard]] constexpr std::pair<std::size_t, std::size_t>
+  forward_range(uint32_t first, uint32_t count) const {
+    check_range(first, count);
+    return {first * sizeof(ForwardSlot), count * sizeof(ForwardSlot)};
+  }
+
+  // (offset, length) of the backward slots of pipes [first, first + count)
+  [[nodiscard]] constexpr std::pair<std::size_t, std::size_t>
+  backward_range(uint32_t first, uint32_t count) const {
+    check_range(first, count);
+    return {num_pipes_ * sizeof(ForwardSlot) + first * sizeof(BackwardSlot),
+            count * sizeof(BackwardSlot)};
+  }
+
+  constexpr bool operator==(const MetadataPageLayout &) const = default;
+
+private:
+  constexpr void check(uint32_t pipe) const {
+    if (pipe >= num_pipes_) {
+      throw std::out_of_range("Metadata page slot out of range");
+    }
+  }
+
+  // an empty range may sit anywhere up to the end of the page
+  constexpr void check_range(uint32_t first, uint32_t count) const {
+    if (first > num_pipes_ || count > num_pipes_ - first) {
+      throw std::out_of_range("Metadata page slot range out of bounds");
+    }
+  }
+
+  uint32_t num_pipes_;
+};
+
+/**
+ * @brief Typed view of a metadata page living in registered memory
+ *
+ * Does not own the memory. Constructing the view zero-initialises every slot,
+ * so do it before the page is exported to the peer.
+ */
+class MetadataPage {
+public:
+  MetadataPage(std::span<std::byte> memory, MetadataPageLayout layout)
+      : memory_(memory), layout_(layout) {
+    if (memory.size() < layout.size_bytes()) {
+      throw std::invalid_argument("Metadata page memory too small");
+    }
+    if (reinterpret_cast<std::uintptr_t>(memory.data()) %
+            rb::cache_line_size !=
+        0) {
+      throw std::invalid_argument("Metadata page must be cache-line aligned");
+    }
+
+    for (uint32_t pipe = 0; pipe < layout.num_pipes(); ++pipe) {
+      std::construct_at(reinterpret_cast<ForwardSlot *>(
+          memory.data() + layout.forward_offset(pipe)));
+      std::construct_at(reinterpret_cast<BackwardSlot *>(
+          memory.data() + layout.backward_offset(pipe)));
+    }
+  }
+
+  [[nodiscard]] ForwardSlot &forward(uint32_t pipe) const {
+    return *std::launder(reinterpret_cast<ForwardSlot *>(
+        memory_.data() + layout_.forward_offset(pipe)));
+  }
+
+  [[nodiscard]] BackwardSlot &backward(uint32_t pipe) const {
+    return *std::launder(reinterpret_cast<BackwardSlot *>(
+        memory_.data() + layout_.backward_offset(pipe)));
+  }
+
+  [[nodiscard]] std::span<std::byte> bytes() const noexcept {
+    return memory_.first(layout_.size_bytes());
+  }
+
+  [[nodiscard]] const MetadataPageLayout &layout() const noexcept {
+    return layout_;
+  }
+
+private:
+  std::span<std::byte> memory_;
+  MetadataPageLayout layout_;
+};
+
+} // namespace oc
+
+#endif
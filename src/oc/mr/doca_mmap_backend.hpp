@@ -0,0 +1,50 @@
+#pragma once
+#ifndef DOCA_MMAP_BACKEND_HPP
+#define DOCA_MMAP_BACKEND_HPP
+
+#include "oc/mr/registration_cache.hpp"
+#include <doca_stdexec/device.hpp>
+#include <doca_stdexec/mmap.hpp>
+#include <memory>
+
+namespace oc::mr {
+
+// Registers caller-owned memory as a started doca mmap on one device. The
+// memory itself is not freed on deregistration, only the mmap.
+class DocaMMapBackend {
+public:
+  using handle_type = std::shared_ptr<doca_stdexec::MMap<std::byte>>;
+
+  explicit DocaMMapBackend(std::shared_ptr<doca_stdexec::Device> device,
+                           uint32_t permissions = DOCA_ACCESS_FLAG_RDMA_WRITE |
+                                                  DOCA_ACCESS_FLAG_RDMA_READ |
+                                                  DOCA_ACCESS_FLAG_LOCAL_READ_WRITE)
+      : device_(std::move(device)), permissions_(permissions) {}
+
+  handle_type register_region(std::span<std::byte> range) {
+    auto mmap = std::make_shared<doca_stdexec::MMap<std::byte>>(range);
+    mmap->add_device(device_);
+    mmap->set_permissions(permissions_);
+    mmap->set_max_devices(8);
+    mmap->start();
+    return mmap;
+  }
+
+  // dropping the last reference stops and destroys the mmap
+  void deregister_region(handle_type &handle) { handle.reset(); }
+
+  [[nodiscard]] const std::shared_ptr<doca_stdexec::Device> &
+  device() const noexcept {
+    return device_;
+  }
+
+private:
+  std::shared_ptr<doca_stdexec::Device> device_;
+  uint32_t permissions_;
+};
+
+using DocaRegistrationCache = RegistrationCache<DocaMMapBackend>;
+
+} // namespace oc::mr
+
+#endif
@@ -0,0 +1,367 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace oc::mr {
+
+/**
+ * @brief Backend that performs the actual (expensive) memory registration
+ *
+ * register_region() pins/registers a byte range and returns an opaque handle
+ * (e.g. a started doca mmap); deregister_region() releases it again. Handles
+ * must be copyable, the cache keeps one copy per live region.
+ */
+template <typename B>
+concept RegistrationBackend =
+    requires(B b, std::span<std::byte> range, typename B::handle_type handle) {
+      typename B::handle_type;
+      { b.register_region(range) } -> std::same_as<typename B::handle_type>;
+      b.deregister_region(handle);
+    };
+
+struct RegistrationCacheConfig {
+  // Unreferenced regions kept around for reuse before LRU eviction kicks in
+  std::size_t max_idle_regions = 64;
+  std::size_t max_idle_bytes = std::size_t{1} << 30;
+  // Also coalesce with cached regions that merely touch the requested range
+  bool merge_adjacent = true;
+};
+
+struct RegistrationCacheStats {
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t merges = 0;
+  std::size_t evictions = 0;
+  std::size_t invalidations = 0;
+  std::size_t registrations = 0;
+  std::size_t deregistrations = 0;
+};
+
+/**
+ * @brief Reference-counted cache of registered memory regions
+ *
+ * Regions are keyed by address range and never overlap while indexed:
+ * - acquire() of a range inside a cached region is a hit and only bumps the
+ *   reference count
+ * - a miss registers the requested range, or with merge_adjacent the union of
+ *   it and every overlapping/adjacent cached region. Absorbed regions leave
+ *   the index; they are deregistered immediately if idle, otherwise when
+ *   their last Registration goes away
+ * - regions whose reference count drops to zero stay registered on an LRU
+ *   list and are evicted once the idle limits are exceeded
+ *
+ * The cache cannot see memory being freed. Callers must invalidate() a range
+ * before they free or unmap it: otherwise a later allocation at the same
+ * address hits the stale region, whose registration still pins (or points
+ * at) the old pages.
+ *
+ * All operations take one mutex; registration happens under it, so two
+ * threads never register the same range twice.
+ *
+ * @tparam Backend Registration backend (see RegistrationBackend)
+ */
+template <RegistrationBackend Backend> class RegistrationCache {
+public:
+  using handle_type = typename Backend::handle_type;
+
+private:
+  struct Region {
+    std::uintptr_t begin;
+    std::uintptr_t end;
+    handle_type handle;
+    std::size_t refcount = 0;
+    bool indexed = true;
+    typename std::list<Region *>::iterator lru_pos;
+
+    std::size_t size() const noexcept { return end - begin; }
+  };
+
+public:
+  /**
+   * @brief RAII reference to a cached region, move-only
+   *
+   * region() is the whole registered range, which may be larger than what was
+   * requested; offset() is where the requested range starts inside it.
+   */
+  class Registration {
+  public:
+    Registration() noexcept = default;
+
+    Registration(const Registration &) = delete;
+    Registration &operator=(const Registration &) = delete;
+
+    Registration(Registration &&other) noexcept
+        : cache_(std::exchange(other.cache_, nullptr)),
+          region_(std::exchange(other.region_, nullptr)),
+          requested_(other.requested_) {}
+
+    Registration &operator=(Registration &&other) noexcept {
+      if (this != &other) {
+        reset();
+        cache_ = std::exchange(other.cache_, nullptr);
+        region_ = std::exchange(other.region_, nullptr);
+        requested_ = other.requested_;
+      }
+      return *this;
+    }
+
+    ~Registration() { reset(); }
+
+    [[nodiscard]] const handle_type &handle() const noexcept {
+      return region_->handle;
+    }
+
+    [[nodiscard]] std::span<std::byte> region() const noexcept {
+      return {reinterpret_cast<std::byte *>(region_->begin), region_->size()};
+    }
+
+    [[nodiscard]] std::span<std::byte> requested() const noexcept {
+      return requested_;
+    }
+
+    [[nodiscard]] std::size_t offset() const noexcept {
+      return reinterpret_cast<std::uintptr_t>(requested_.data()) -
+             region_->begin;
+    }
+
+    [[nodiscard]] explicit operator bool() const noexcept {
+      return region_ != nullptr;
+    }
+
+    void reset() noexcept {
+      if (region_) {
+        cache_->release(region_);
+        cache_ = nullptr;
+        region_ = nullptr;
+      }
+    }
+
+  private:
+    friend class RegistrationCache;
+
+    Registration(RegistrationCache *cache, Region *region,
+                 std::span<std::byte> requested) noexcept
+        : cache_(cache), region_(region), requested_(requested) {}
+
+    RegistrationCache *cache_ = nullptr;
+    Region *region_ = nullptr;
+    std::span<std::byte> requested_;
+  };
+
+  explicit RegistrationCache(Backend backend,
+                             RegistrationCacheConfig config = {})
+      : backend_(std::move(backend)), config_(config) {}
+
+  RegistrationCache(const RegistrationCache &) = delete;
+  RegistrationCache &operator=(const RegistrationCache &) = delete;
+
+  // Outstanding Registrations must not outlive the cache
+  ~RegistrationCache() {
+    for (auto &region : regions_) {
+      backend_.deregister_region(region->handle);
+    }
+  }
+
+  /**
+   * @brief Look up or register a region covering @p range
+   */
+  [[nodiscard]] Registration acquire(std::span<std::byte> range) {
+    const auto begin = reinterpret_cast<std::uintptr_t>(range.data());
+    const auto end = begin + range.size();
+
+    std::lock_guard lock(mutex_);
+
+    if (auto *region = find_covering(begin, end)) {
+      ++stats_.hits;
+      retain(region);
+      return Registration(this, region, range);
+    }
+
+    ++stats_.misses;
+
+    auto union_begin = begin;
+    auto union_end = end;
+    std::vector<Region *> absorbed;
+
+    // Overlapping regions are always absorbed, since the index never holds
+    // overlaps; merely touching ones only with merge_adjacent
+    auto it = index_.upper_bound(begin);
+    if (it != index_.begin()) {
+      --it;
+    }
+    while (it != index_.end() && it->second->begin <= end) {
+      auto *region = it->second;
+      bool overlaps = region->end > begin && region->begin < end;
+      bool adjacent = region->end == begin || region->begin == end;
+      if (overlaps || (config_.merge_adjacent && adjacent)) {
+        union_begin = std::min(union_begin, region->begin);
+        union_end = std::max(union_end, region->end);
+        absorbed.push_back(region);
+      }
+      ++it;
+    }
+
+    auto handle = backend_.register_region(
+        {reinterpret_cast<std::byte *>(union_begin), union_end - union_begin});
+    ++stats_.registrations;
+
+    if (!absorbed.empty()) {
+      ++stats_.merges;
+    }
+    for (auto *region : absorbed) {
+      unindex(region);
+    }
+
+    auto owned = std::make_unique<Region>(
+        Region{union_begin, union_end, std::move(handle), 1, true, {}});
+    auto *region = owned.get();
+    regions_.push_back(std::move(owned));
+    index_.emplace(union_begin, region);
+
+    return Registration(this, region, range);
+  }
+
+  [[nodiscard]] RegistrationCacheStats stats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+  }
+
+  // Regions currently indexed (referenced or idle)
+  [[nodiscard]] std::size_t cached_regions() const {
+    std::lock_guard lock(mutex_);
+    return index_.size();
+  }
+
+  [[nodiscard]] std::size_t idle_regions() const {
+    std::lock_guard lock(mutex_);
+    return lru_.size();
+  }
+
+  /**
+   * @brief Deregister every idle region
+   */
+  void flush() {
+    std::lock_guard lock(mutex_);
+    while (!lru_.empty()) {
+      evict(lru_.back());
+    }
+  }
+
+  /**
+   * @brief Forget every region overlapping @p range, before it is freed
+   *
+   * Idle regions are deregistered right away. Referenced ones leave the
+   * index so no later acquire() hits them, and are deregistered when their
+   * last Registration goes away.
+   */
+  void invalidate(std::span<std::byte> range) {
+    const auto begin = reinterpret_cast<std::uintptr_t>(range.data());
+    const auto end = begin + range.size();
+
+    std::lock_guard lock(mutex_);
+
+    std::vector<Region *> overlapping;
+    auto it = index_.upper_bound(begin);
+    if (it != index_.begin()) {
+      --it;
+    }
+    for (; it != index_.end() && it->second->begin < end; ++it) {
+      if (it->second->end > begin) {
+        overlapping.push_back(it->second);
+      }
+    }
+    for (auto *region : overlapping) {
+      unindex(region);
+      ++stats_.invalidations;
+    }
+  }
+
+  [[nodiscard]] Backend &backend() noexcept { return backend_; }
+
+private:
+  Region *find_covering(std::uintptr_t begin, std::uintptr_t end) {
+    auto it = index_.upper_bound(begin);
+    if (it == index_.begin()) {
+      return nullptr;
+    }
+    --it;
+    auto *region = it->second;
+    return region->end >= end ? region : nullptr;
+  }
+
+  void retain(Region *region) {
+    if (region->refcount++ == 0 && region->indexed) {
+      idle_bytes_ -= region->size();
+      lru_.erase(region->lru_pos);
+    }
+  }
+
+  void release(Region *region) noexcept {
+    std::lock_guard lock(mutex_);
+    if (--region->refcount > 0) {
+      return;
+    }
+    if (!region->indexed) {
+      destroy(region);
+      return;
+    }
+    lru_.push_front(region);
+    region->lru_pos = lru_.begin();
+    idle_bytes_ += region->size();
+    while (!lru_.empty() && (lru_.size() > config_.max_idle_regions ||
+                             idle_bytes_ > config_.max_idle_bytes)) {
+      evict(lru_.back());
+      ++stats_.evictions;
+    }
+  }
+
+  // Drop a region from the index; idle ones go right away, referenced ones
+  // once released
+  void unindex(Region *region) {
+    index_.erase(region->begin);
+    region->indexed = false;
+    if (region->refcount == 0) {
+      idle_bytes_ -= region->size();
+      lru_.erase(region->lru_pos);
+      destroy(region);
+    }
+  }
+
+  void evict(Region *region) {
+    idle_bytes_ -= region->size();
+    lru_.erase(region->lru_pos);
+    index_.erase(region->begin);
+    destroy(region);
+  }
+
+  void destroy(Region *region) {
+    backend_.deregister_region(region->handle);
+    ++stats_.deregistrations;
+    std::erase_if(regions_, [region](const std::unique_ptr<Region> &owned) {
+      return owned.get() == region;
+    });
+  }
+
+  Backend backend_;
+  RegistrationCacheConfig config_;
+  mutable std::mutex mutex_;
+
+  std::vector<std::unique_ptr<Region>> regions_;
+  std::map<std::uintptr_t, Region *> index_;
+  std::list<Region *> lru_; // idle regions, most recently used first
+  std::size_t idle_bytes_ = 0;
+  RegistrationCacheStats stats_;
+};
+
+} // namespace oc::mr
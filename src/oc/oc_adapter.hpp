@@ -2,8 +2,15 @@
 #ifndef OC_ADAPTER_HPP
 #define OC_ADAPTER_HPP
 
+#include "oc/containers/small_vector.hpp"
+#include "oc/pipe_policy.hpp"
 #include "oc/rb/pod_rb.hpp"
+#include <algorithm>
+#include <array>
 #include <doca_stdexec/buf.hpp>
+#include <span>
+#include <stdexcept>
+#include <utility>
 
 namespace oc {
 
@@ -20,6 +27,110 @@ concept oc_adapter = requires(T t, typename T::local_buf_t src_buf,
   { t.transfer(src_buf, dst_buf) } -> stdexec::sender;
 };
 
+// Adapter whose buffers can be carved into sub-buffers without a new
+// registration, e.g. to address one slot of a metadata page or one contiguous
+// piece of a ring. Offsets and lengths are in bytes.
+template <typename T>
+concept oc_slicing_adapter =
+    oc_adapter<T> && requires(const typename T::local_buf_t &local_buf,
+                              const typename T::remote_buf_t &remote_buf,
+                              std::size_t offset, std::size_t len) {
+      {
+        T::slice_local(local_buf, offset, len)
+      } -> std::same_as<typename T::local_buf_t>;
+      {
+        T::slice_remote(remote_buf, offset, len)
+      } -> std::same_as<typename T::remote_buf_t>;
+    };
+
+// Adapter that can move one logical batch described by a list of local and a
+// list of remote segments with a single submission. The byte streams of both
+// lists are concatenated and copied in order, so the lists do not need to
+// have the same shape (e.g. local wraps once, remote does not).
+//
+// Every segment boundary of either list ends a piece, so two lists cut into
+// at most src.size() + dst.size() - 1 pieces. transfer_sg takes lists of up
+// to T::max_sg_pieces pieces and throws std::invalid_argument for longer
+// ones; a ring batch has at most three.
+template <typename T>
+concept oc_sg_adapter =
+    oc_slicing_adapter<T> &&
+    requires(T t, std::span<const typename T::local_buf_t> src_segments,
+             std::span<const typename T::remote_buf_t> dst_segments) {
+      typename T::sg_transfer_type;
+      requires stdexec::sender<typename T::sg_transfer_type>;
+      { T::max_sg_pieces } -> std::convertible_to<std::size_t>;
+      {
+        t.transfer_sg(src_segments, dst_segments)
+      } -> std::same_as<typename T::sg_transfer_type>;
+    };
+
+// Segment list for one ring batch: a wrap splits a ring into at most two
+// contiguous pieces, so the list never needs the heap.
+template <typename Buf> using sg_list = containers::small_vector2<Buf>;
+
+// Turn the result of PodRingBuffer::get_read_views into a gather list,
+// dropping the empty second view when the data does not wrap.
+template <rb::PodType T>
+sg_list<std::span<const T>>
+as_sg_list(const std::array<rb::ZeroCopyView<T>, 2> &views) {
+  sg_list<std::span<const T>> segments;
+  for (const auto &view : views) {
+    if (!view.empty()) {
+      segments.push_back(view.to_span());
+    }
+  }
+  return segments;
+}
+
+// Walk a source and a destination segment list in lockstep and call
+// f(src_piece, dst_piece) for every maximal pair of equally sized pieces.
+// Both lists hold span-like segments; stops at the end of the shorter stream.
+template <typename SrcSegment, typename DstSegment, typename F>
+void for_each_sg_piece(std::span<const SrcSegment> src,
+                       std::span<const DstSegment> dst, F &&f) {
+  std::size_t src_idx = 0, src_off = 0;
+  std::size_t dst_idx = 0, dst_off = 0;
+
+  while (src_idx < src.size() && dst_idx < dst.size()) {
+    auto len = std::min(src[src_idx].size() - src_off,
+                        dst[dst_idx].size() - dst_off);
+    f(src[src_idx].subspan(src_off, len), dst[dst_idx].subspan(dst_off, len));
+
+    src_off += len;
+    dst_off += len;
+    if (src_off == src[src_idx].size()) {
+      ++src_idx;
+      src_off = 0;
+    }
+    if (dst_off == dst[dst_idx].size()) {
+      ++dst_idx;
+      dst_off = 0;
+    }
+  }
+}
+
+// (src, dst) piece pairs of one transfer_sg call, flattened up front so the
+// sender owns them instead of the caller's segment lists.
+template <typename Local, typename Remote, std::size_t N>
+using sg_piece_list = containers::small_vector<std::pair<Local, Remote>, N>;
+
+// Flatten two segment lists into at most N pieces, throwing
+// std::invalid_argument if they cut into more.
+template <std::size_t N, typename Local, typename Remote>
+sg_piece_list<Local, Remote, N> flatten_sg_pieces(std::span<const Local> src,
+                                                  std::span<const Remote> dst) {
+  sg_piece_list<Local, Remote, N> pieces;
+  for_each_sg_piece(src, dst, [&](Local s, Remote d) {
+    if (pieces.size() == N) {
+      throw std::invalid_argument(
+          "Scatter-gather lists cut into more pieces than the adapter takes");
+    }
+    pieces.emplace_back(s, d);
+  });
+  return pieces;
+}
+
 } // namespace oc
 
-#endif
\ No newline at end of file
+#endif
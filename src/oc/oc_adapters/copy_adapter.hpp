@@ -0,0 +1,80 @@
+#pragma once
+#include <cstring>
+#include <utility>
+#ifndef COPY_ADAPTER_HPP
+#define COPY_ADAPTER_HPP
+
+#include "oc/oc_adapter.hpp"
+
+namespace ex = stdexec;
+
+namespace oc::oc_adapters {
+
+// Local copy engine: source and destination are distinct buffers in the same
+// address space and a transfer is a memcpy performed when the sender starts.
+// Useful as a stand-in for a DMA engine and for testing pipes without NICs.
+template <typename T> struct copy_adapter {
+public:
+  using local_buf_t = std::span<const T>;
+  using remote_buf_t = std::span<T>;
+
+  // pieces one transfer_sg call takes, see oc_sg_adapter
+  static constexpr std::size_t max_sg_pieces = 16;
+
+private:
+  using sg_pieces = sg_piece_list<local_buf_t, remote_buf_t, max_sg_pieces>;
+
+  struct copy_fn {
+    local_buf_t src;
+    remote_buf_t dst;
+
+    void operator()() const {
+      std::memcpy(dst.data(), src.data(),
+                  std::min(src.size_bytes(), dst.size_bytes()));
+    }
+  };
+
+  struct copy_sg_fn {
+    sg_pieces pieces;
+
+    void operator()() const {
+      for (const auto &[src, dst] : pieces) {
+        std::memcpy(dst.data(), src.data(), src.size_bytes());
+      }
+    }
+  };
+
+public:
+  using transfer_type =
+      decltype(ex::then(ex::just(), std::declval<copy_fn>()));
+  using sg_transfer_type =
+      decltype(ex::then(ex::just(), std::declval<copy_sg_fn>()));
+
+  copy_adapter() = default;
+
+  static local_buf_t slice_local(const local_buf_t &buf, std::size_t offset,
+                                 std::size_t len) {
+    return buf.subspan(offset / sizeof(T), len / sizeof(T));
+  }
+
+  static remote_buf_t slice_remote(const remote_buf_t &buf, std::size_t offset,
+                                   std::size_t len) {
+    return buf.subspan(offset / sizeof(T), len / sizeof(T));
+  }
+
+  transfer_type transfer(local_buf_t src, remote_buf_t dst) {
+    return ex::then(ex::just(), copy_fn{src, dst});
+  }
+
+  // The segment lists only need to outlive this call: they are flattened
+  // into (src, dst) piece pairs up front, which the sender owns.
+  sg_transfer_type transfer_sg(std::span<const local_buf_t> src,
+                               std::span<const remote_buf_t> dst) {
+    auto pieces = flatten_sg_pieces<max_sg_pieces>(src, dst);
+    return ex::then(ex::just(), copy_sg_fn{std::move(pieces)});
+  }
+};
+
+} // namespace oc::oc_adapters
+
+#endif
@@ -0,0 +1,130 @@
+#pragma once
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <utility>
+#ifndef EMULATED_ADAPTER_HPP
+#define EMULATED_ADAPTER_HPP
+
+#include "oc/oc_adapter.hpp"
+
+namespace ex = stdexec;
+
+namespace oc::oc_adapters {
+
+// Link model for emulated transfers: a transfer of n bytes completes
+// latency + n / bandwidth after the link becomes free. Transfers are
+// serialised on the link, so back-to-back submissions queue up.
+struct emulated_link_config {
+  std::chrono::nanoseconds latency{2000};
+  double bandwidth_bytes_per_ns = 12.5; // 100 Gbit/s
+};
+
+// Copy engine behind a modelled link: data is copied immediately, but the
+// sender only completes once the modelled completion time has passed. Lets
+// pipes be exercised with NIC-like latency and bandwidth without hardware.
+template <typename T> struct emulated_adapter {
+public:
+  using local_buf_t = std::span<const T>;
+  using remote_buf_t = std::span<T>;
+
+  // pieces one transfer_sg call takes, see oc_sg_adapter
+  static constexpr std::size_t max_sg_pieces = 16;
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  struct link_state {
+    emulated_link_config config;
+    clock::time_point free_at{};
+
+    // reserve the link for `bytes` and return when the transfer completes
+    clock::time_point reserve(std::size_t bytes) {
+      auto now = clock::now();
+      auto start = std::max(now, free_at);
+      auto wire = std::chrono::nanoseconds(static_cast<int64_t>(
+          static_cast<double>(bytes) / config.bandwidth_bytes_per_ns));
+      free_at = start + wire;
+      return free_at + config.latency;
+    }
+  };
+
+  static void wait_until(clock::time_point deadline) {
+    while (clock::now() < deadline) {
+    }
+  }
+
+  using sg_pieces = sg_piece_list<local_buf_t, remote_buf_t, max_sg_pieces>;
+
+  struct copy_fn {
+    std::shared_ptr<link_state> link;
+    local_buf_t src;
+    remote_buf_t dst;
+
+    void operator()() const {
+      auto bytes = std::min(src.size_bytes(), dst.size_bytes());
+      auto done = link->reserve(bytes);
+      std::memcpy(dst.data(), src.data(), bytes);
+      wait_until(done);
+    }
+  };
+
+  struct copy_sg_fn {
+    std::shared_ptr<link_state> link;
+    sg_pieces pieces;
+
+    void operator()() const {
+      std::size_t bytes = 0;
+      for (const auto &[src, dst] : pieces) {
+        bytes += src.size_bytes();
+      }
+      // one submission, so one latency for the whole batch
+      auto done = link->reserve(bytes);
+      for (const auto &[src, dst] : pieces) {
+        std::memcpy(dst.data(), src.data(), src.size_bytes());
+      }
+      wait_until(done);
+    }
+  };
+
+public:
+  using transfer_type =
+      decltype(ex::then(ex::just(), std::declval<copy_fn>()));
+  using sg_transfer_type =
+      decltype(ex::then(ex::just(), std::declval<copy_sg_fn>()));
+
+  explicit emulated_adapter(emulated_link_config config = {})
+      : link_(std::make_shared<link_state>(link_state{config})) {}
+
+  static local_buf_t slice_local(const local_buf_t &buf, std::size_t offset,
+                                 std::size_t len) {
+    return buf.subspan(offset / sizeof(T), len / sizeof(T));
+  }
+
+  static remote_buf_t slice_remote(const remote_buf_t &buf, std::size_t offset,
+                                   std::size_t len) {
+    return buf.subspan(offset / sizeof(T), len / sizeof(T));
+  }
+
+  transfer_type transfer(local_buf_t src, remote_buf_t dst) {
+    return ex::then(ex::just(), copy_fn{link_, src, dst});
+  }
+
+  sg_transfer_type transfer_sg(std::span<const local_buf_t> src,
+                               std::span<const remote_buf_t> dst) {
+    auto pieces = flatten_sg_pieces<max_sg_pieces>(src, dst);
+    return ex::then(ex::just(), copy_sg_fn{link_, std::move(pieces)});
+  }
+
+  [[nodiscard]] const emulated_link_config &config() const noexcept {
+    return link_->config;
+  }
+
+private:
+  // copies of the adapter share one link
+  std::shared_ptr<link_state> link_;
+};
+
+} // namespace oc::oc_adapters
+
+#endif
@@ -1,4 +1,5 @@
 #pragma once
+#include <limits>
 #include <memory>
 #ifndef SHARED_MEMORY_ADAPTER_HPP
 #define SHARED_MEMORY_ADAPTER_HPP
@@ -14,16 +15,37 @@ public:
   using local_buf_t = std::span<T>;
   using remote_buf_t = std::span<T>;
   using transfer_type = decltype(ex::just());
+  using sg_transfer_type = decltype(ex::just());
+
+  // nothing is moved, so any number of pieces will do
+  static constexpr std::size_t max_sg_pieces =
+      std::numeric_limits<std::size_t>::max();
 
   // shared memory, so source and destination are the same
   shared_memory_adapter(local_buf_t buffer)
       : src_buffer_(buffer), dst_buffer_(buffer) {}
 
+  static local_buf_t slice_local(const local_buf_t &buf, std::size_t offset,
+                                 std::size_t len) {
+    return buf.subspan(offset / sizeof(T), len / sizeof(T));
+  }
+
+  static remote_buf_t slice_remote(const remote_buf_t &buf, std::size_t offset,
+                                   std::size_t len) {
+    return buf.subspan(offset / sizeof(T), len / sizeof(T));
+  }
+
   // no need to transfer
   transfer_type transfer(local_buf_t src, remote_buf_t dst) {
     return ex::just();
   }
 
+  // no need to transfer, regardless of how many segments
+  sg_transfer_type transfer_sg(std::span<const local_buf_t> src,
+                               std::span<const remote_buf_t> dst) {
+    return ex::just();
+  }
+
 private:
   local_buf_t src_buffer_;
   remote_buf_t dst_buffer_;
@@ -31,4 +53,4 @@ private:
 
 } // namespace oc::oc_adapters
 
-#endif
\ No newline at end of file
+#endif
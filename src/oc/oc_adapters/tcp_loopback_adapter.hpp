@@ -0,0 +1,175 @@
+#pragma once
+#include <arpa/inet.h>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifndef TCP_LOOPBACK_ADAPTER_HPP
+#define TCP_LOOPBACK_ADAPTER_HPP
+
+#include "oc/oc_adapter.hpp"
+
+namespace ex = stdexec;
+
+namespace oc::oc_adapters {
+
+// Moves data through a real TCP connection over 127.0.0.1: the source side
+// sends, the destination side receives straight into the destination buffer.
+// Both ends live in this process, so a transfer completes once the bytes have
+// made the full trip through the kernel stack.
+template <typename T> struct tcp_loopback_adapter {
+public:
+  using local_buf_t = std::span<const T>;
+  using remote_buf_t = std::span<T>;
+
+  // pieces one transfer_sg call takes, see oc_sg_adapter
+  static constexpr std::size_t max_sg_pieces = 16;
+
+private:
+  // Small enough to always fit in the socket buffers, so a blocking send
+  // never waits for a recv that only this thread could issue.
+  static constexpr std::size_t chunk_bytes = 16 * 1024;
+
+  struct connection {
+    int tx = -1;
+    int rx = -1;
+
+    ~connection() {
+      if (tx >= 0) {
+        ::close(tx);
+      }
+      if (rx >= 0) {
+        ::close(rx);
+      }
+    }
+
+    void move(const std::byte *src, std::byte *dst, std::size_t bytes) const {
+      while (bytes > 0) {
+        auto chunk = std::min(bytes, chunk_bytes);
+        if (::send(tx, src, chunk, MSG_NOSIGNAL) != static_cast<ssize_t>(chunk)) {
+          throw std::runtime_error("tcp loopback send failed");
+        }
+        std::size_t received = 0;
+        while (received < chunk) {
+          auto n = ::recv(rx, dst + received, chunk - received, 0);
+          if (n <= 0) {
+            throw std::runtime_error("tcp loopback recv failed");
+          }
+          received += static_cast<std::size_t>(n);
+        }
+        src += chunk;
+        dst += chunk;
+        bytes -= chunk;
+      }
+    }
+  };
+
+  static void check(int rc, const char *what) {
+    if (rc < 0) {
+      throw std::runtime_error(std::string(what) + " failed");
+    }
+  }
+
+  static std::shared_ptr<connection> connect_loopback() {
+    auto conn = std::make_shared<connection>();
+
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    check(listener, "socket");
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+
+    try {
+      check(::bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)),
+            "bind");
+      check(::listen(listener, 1), "listen");
+      check(::getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &len),
+            "getsockname");
+
+      // connect completes against the backlog, so no second thread needed
+      conn->tx = ::socket(AF_INET, SOCK_STREAM, 0);
+      check(conn->tx, "socket");
+      check(::connect(conn->tx, reinterpret_cast<sockaddr *>(&addr),
+                      sizeof(addr)),
+            "connect");
+      conn->rx = ::accept(listener, nullptr, nullptr);
+      check(conn->rx, "accept");
+    } catch (...) {
+      ::close(listener);
+      throw;
+    }
+    ::close(listener);
+
+    int one = 1;
+    ::setsockopt(conn->tx, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return conn;
+  }
+
+  using sg_pieces = sg_piece_list<local_buf_t, remote_buf_t, max_sg_pieces>;
+
+  struct move_fn {
+    std::shared_ptr<connection> conn;
+    local_buf_t src;
+    remote_buf_t dst;
+
+    void operator()() const {
+      conn->move(reinterpret_cast<const std::byte *>(src.data()),
+                 reinterpret_cast<std::byte *>(dst.data()),
+                 std::min(src.size_bytes(), dst.size_bytes()));
+    }
+  };
+
+  struct move_sg_fn {
+    std::shared_ptr<connection> conn;
+    sg_pieces pieces;
+
+    void operator()() const {
+      for (const auto &[src, dst] : pieces) {
+        conn->move(reinterpret_cast<const std::byte *>(src.data()),
+                   reinterpret_cast<std::byte *>(dst.data()),
+                   src.size_bytes());
+      }
+    }
+  };
+
+public:
+  using transfer_type =
+      decltype(ex::then(ex::just(), std::declval<move_fn>()));
+  using sg_transfer_type =
+      decltype(ex::then(ex::just(), std::declval<move_sg_fn>()));
+
+  tcp_loopback_adapter() : conn_(connect_loopback()) {}
+
+  static local_buf_t slice_local(const local_buf_t &buf, std::size_t offset,
+                                 std::size_t len) {
+    return buf.subspan(offset / sizeof(T), len / sizeof(T));
+  }
+
+  static remote_buf_t slice_remote(const remote_buf_t &buf, std::size_t offset,
+                                   std::size_t len) {
+    return buf.subspan(offset / sizeof(T), len / sizeof(T));
+  }
+
+  transfer_type transfer(local_buf_t src, remote_buf_t dst) {
+    return ex::then(ex::just(), move_fn{conn_, src, dst});
+  }
+
+  sg_transfer_type transfer_sg(std::span<const local_buf_t> src,
+                               std::span<const remote_buf_t> dst) {
+    auto pieces = flatten_sg_pieces<max_sg_pieces>(src, dst);
+    return ex::then(ex::just(), move_sg_fn{conn_, std::move(pieces)});
+  }
+
+private:
+  std::shared_ptr<connection> conn_;
+};
+
+} // namespace oc::oc_adapters
+
+#endif
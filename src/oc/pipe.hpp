@@ -1,13 +1,27 @@
 #pragma once
 #include "doca_stdexec/progress_engine.hpp"
 #include "stdexec/__detail/__start_detached.hpp"
+#include <limits>
 #include <memory>
 #include <optional>
 #include <queue>
+#include <stdexcept>
+#include <vector>
 #ifndef PIPE_HPP
 #define PIPE_HPP
 
+#include "oc/batching.hpp"
+#include "oc/flight_recorder.hpp"
+#include "oc/instrument.hpp"
+#include "oc/metadata_page.hpp"
 #include "oc/oc_adapter.hpp"
+#include "oc/pipe_policy.hpp"
+#include "oc/pipe_scheduler.hpp"
+#include "oc/pipe_tuner.hpp"
+#include "oc/stats_page.hpp"
+#include "oc/trace.hpp"
+#include "utils/histogram.hpp"
+#include "utils/tsc_clock.hpp"
 #include <doca_stdexec/buf.hpp>
 #include <exec/task.hpp>
 #include <stdexec/execution.hpp>
@@ -36,7 +50,8 @@ class ForwardPipeMetadataBase {
 public:
   virtual ~ForwardPipeMetadataBase() = default;
   virtual uint32_t fetch_head() = 0;
-  virtual exec::task<void> store_tail(uint32_t tail) = 0;
+  // true if the store did not complete inline and had to be waited for
+  virtual exec::task<bool> store_tail(uint32_t tail) = 0;
 };
 
 // store head to previous pipe (so possibly remote)
@@ -45,7 +60,8 @@ class BackwardPipeMetadataBase {
 public:
   virtual ~BackwardPipeMetadataBase() = default;
   virtual uint32_t fetch_tail() = 0;
-  virtual exec::task<void> store_head(uint32_t head) = 0;
+  // true if the store did not complete inline and had to be waited for
+  virtual exec::task<bool> store_head(uint32_t head) = 0;
 };
 
 class PipeMetadataBase {
@@ -59,6 +75,14 @@ public:
   std::shared_ptr<BackwardPipeMetadataBase> backward_metadata;
 };
 
+// Counter stored at the start of a metadata buffer. Adapters may hand out
+// local buffers as read-only views (they are transfer sources), but the
+// staging memory behind them is ours to write.
+template <typename Buf> std::atomic_uint32_t &metadata_counter(const Buf &buf) {
+  return *reinterpret_cast<std::atomic_uint32_t *>(
+      const_cast<void *>(static_cast<const void *>(buf.data())));
+}
+
 template <oc_adapter MetadataAdapter>
 class ForwardPipeMetadata : public ForwardPipeMetadataBase {
 public:
@@ -77,9 +101,14 @@ public:
   MetadataAdapter::local_buf_t head_buf;
   MetadataAdapter::remote_buf_t remote_tail_buf;
 
-  uint32_t fetch_head() override { return head_buf.get_data(); }
-  exec::task<void> store_tail(uint32_t tail) override {
-    return metadata_adapter.transfer(local_buf, remote_tail_buf);
+  uint32_t fetch_head() override { return metadata_counter(head_buf).load(); }
+  exec::task<bool> store_tail(uint32_t tail) override {
+    // assuming writing to buffer is synchronous
+    metadata_counter(local_buf).store(tail);
+    bool waited = false;
+    co_await (metadata_adapter.transfer(local_buf, remote_tail_buf) |
+              suspended(waited));
+    co_return waited;
   }
 };
 
@@ -98,9 +127,14 @@ public:
   MetadataAdapter::remote_buf_t remote_head_buf;
   MetadataAdapter::local_buf_t tail_buf;
 
-  uint32_t fetch_tail() override { return tail_buf.get_data(); }
-  exec::task<void> store_head(uint32_t head) override {
-    return metadata_adapter.transfer(local_buf, remote_head_buf);
+  uint32_t fetch_tail() override { return metadata_counter(tail_buf).load(); }
+  exec::task<bool> store_head(uint32_t head) override {
+    // assuming writing to buffer is synchronous
+    metadata_counter(local_buf).store(head);
+    bool waited = false;
+    co_await (metadata_adapter.transfer(local_buf, remote_head_buf) |
+              suspended(waited));
+    co_return waited;
   }
 };
 
@@ -124,6 +158,43 @@ public:
   BackwardPipeMetadata<MetadataAdapter> backward_metadata;
 };
 
+// Metadata for pipe `pipe` of a MetadataPage pair, seen from the upstream
+// side: our forward slot stages the tail, the peer writes heads into our
+// backward slot, and tails go to the peer's forward slot.
+template <oc_slicing_adapter MetadataAdapter>
+ForwardPipeMetadata<MetadataAdapter>
+make_forward_metadata(MetadataAdapter metadata_adapter,
+                      const typename MetadataAdapter::local_buf_t &local_page,
+                      const typename MetadataAdapter::remote_buf_t &remote_page,
+                      const MetadataPageLayout &layout, uint32_t pipe) {
+  auto forward = layout.forward_offset(pipe);
+  auto backward = layout.backward_offset(pipe);
+  return ForwardPipeMetadata<MetadataAdapter>(
+      metadata_adapter,
+      MetadataAdapter::slice_local(local_page, forward, sizeof(ForwardSlot)),
+      MetadataAdapter::slice_local(local_page, backward, sizeof(BackwardSlot)),
+      MetadataAdapter::slice_remote(remote_page, forward, sizeof(ForwardSlot)));
+}
+
+// Metadata for pipe `pipe` of a MetadataPage pair, seen from the downstream
+// side: our backward slot stages the head, the peer writes tails into our
+// forward slot, and heads go to the peer's backward slot.
+template <oc_slicing_adapter MetadataAdapter>
+BackwardPipeMetadata<MetadataAdapter>
+make_backward_metadata(MetadataAdapter metadata_adapter,
+                       const typename MetadataAdapter::local_buf_t &local_page,
+                       const typename MetadataAdapter::remote_buf_t &remote_page,
+                       const MetadataPageLayout &layout, uint32_t pipe) {
+  auto forward = layout.forward_offset(pipe);
+  auto backward = layout.backward_offset(pipe);
+  return BackwardPipeMetadata<MetadataAdapter>(
+      metadata_adapter,
+      MetadataAdapter::slice_local(local_page, backward, sizeof(BackwardSlot)),
+      MetadataAdapter::slice_remote(remote_page, backward,
+                                    sizeof(BackwardSlot)),
+      MetadataAdapter::slice_local(local_page, forward, sizeof(ForwardSlot)));
+}
+
 class PipeBase {
 
 public:
@@ -136,6 +207,185 @@ public:
   virtual exec::task<void> fetch_head() = 0;
   virtual exec::task<void> sync_head() = 0;
 
+  // Record the latency of every forward transfer into `histogram`, in
+  // utils::tsc_clock ticks. The pipe holds a recorder, so it must be
+  // progressed from one thread at a time.
+  void record_transfer_latency(utils::ConcurrentHistogram &histogram) {
+    transfer_latency = histogram.recorder();
+  }
+
+  // Stamp sampled records as they pass this pipe, as hop `hop` of `tracer`.
+  void trace(PipeTracer &tracer, std::size_t hop) {
+    this->tracer = &tracer;
+    trace_hop = hop;
+  }
+
+  // Publish live counters into slot `slot` of `file` once per round. The
+  // file must outlive the pipe.
+  void publish_stats(StatsFile &file, uint32_t slot) {
+    stats_slot = &file.writer_slot(slot);
+  }
+
+  // Record this pipe's events into `recorder` on track `track`.
+  void record_flight(FlightRecorder &recorder, uint32_t track) {
+    flight = &recorder;
+    flight_track = track;
+  }
+
+  // Let `tuner` choose this pipe's transfer size and depth from what each
+  // round achieves. The tuner must outlive the pipe.
+  void tune(PipeTuner &tuner) { this->tuner = &tuner; }
+
+  // Hold forwarding until `policy.min_bytes` wait or the oldest waiting
+  // byte is `policy.deadline` old, so small records share a transfer.
+  void batch(batch_policy policy) {
+    batching.emplace(policy.min_bytes,
+                     static_cast<uint64_t>(
+                         static_cast<double>(policy.deadline.count()) /
+                         utils::tsc_clock::ns_per_tick()));
+  }
+
+  // Let the next round forward whatever waits, ignoring the batch policy.
+  void flush() noexcept {
+    if (batching) {
+      batching->flush();
+    }
+  }
+
+protected:
+  // transfer size and count one round may use
+  [[nodiscard]] tuning limits() const noexcept {
+    if (tuner) {
+      return tuner->current();
+    }
+    return {std::numeric_limits<uint32_t>::max(),
+            std::numeric_limits<uint32_t>::max()};
+  }
+
+  // the batch policy keeps `backlog` waiting bytes for a later round
+  bool held_for_batch(uint64_t backlog) noexcept {
+    if (!batching || batching->ready(backlog, utils::tsc_clock::now())) {
+      return false;
+    }
+    stalled(&PipeStats::held_batching, flight_stall::batching);
+    return true;
+  }
+
+  // bytes this round may forward: the tuner's limits and the scheduler's
+  // allowance, whichever is smaller
+  [[nodiscard]] uint32_t round_budget() const noexcept {
+    return std::min(limits().round_bytes(), round_allowance);
+  }
+
+  // `transfers` adapter transfers moving `bytes` were submitted
+  void issued(uint64_t transfers, uint64_t bytes) noexcept {
+    stats.transfers_issued += transfers;
+    stats.bytes_issued += bytes;
+    stats.in_flight = transfers;
+    if (flight) {
+      flight->begin(flight_event::transfer, flight_track, bytes);
+    }
+    publish();
+  }
+
+  // a round moved nothing, or waited, for `reason`
+  void stalled(uint64_t PipeStats::*counter, flight_stall reason) noexcept {
+    ++(stats.*counter);
+    if (flight) {
+      flight->instant(flight_event::stall, flight_track,
+                      static_cast<uint64_t>(reason));
+    }
+  }
+
+  // a metadata store of `counter` is about to be awaited
+  utils::tsc_clock::ticks metadata_sync_started(uint32_t counter) noexcept {
+    if (!stats_slot && !flight) {
+      return 0;
+    }
+    auto now = utils::tsc_clock::now();
+    if (flight) {
+      flight->begin(flight_event::metadata_sync, flight_track, counter, now);
+    }
+    return now;
+  }
+
+  // the metadata store started at `start` completed; `waited` if it did
+  // not complete inline
+  void metadata_stored(utils::tsc_clock::ticks start, bool waited) noexcept {
+    if (waited) {
+      stalled(&PipeStats::stall_metadata, flight_stall::metadata);
+    }
+    if (!stats_slot && !flight) {
+      return;
+    }
+    auto now = utils::tsc_clock::now();
+    stats.metadata_wait_ticks += now - start;
+    if (flight) {
+      flight->end(flight_event::metadata_sync, flight_track, 0, now);
+    }
+  }
+
+  utils::tsc_clock::ticks round_started() noexcept {
+    auto now = utils::tsc_clock::now();
+    round_bytes_start = stats.bytes_issued;
+    round_transfers_start = stats.transfers_issued;
+    round_backlog = src_tail - dst_tail;
+    if (flight) {
+      flight->begin(flight_event::round, flight_track, 0, now);
+    }
+    return now;
+  }
+
+  void round_done(utils::tsc_clock::ticks start) noexcept {
+    auto now = utils::tsc_clock::now();
+    if (flight) {
+      flight->end(flight_event::round, flight_track, 0, now);
+    }
+    auto elapsed = now - start;
+    ++stats.rounds;
+    stats.round_ticks_total += elapsed;
+    stats.round_ticks_max = std::max(stats.round_ticks_max, elapsed);
+    stats.round_ticks_last = elapsed;
+    stats.in_flight = 0;
+    if (tuner) {
+      tuner->observe(stats.bytes_issued - round_bytes_start,
+                     stats.transfers_issued - round_transfers_start, elapsed,
+                     round_backlog, now);
+      stats.chunk_limit = tuner->current().chunk_bytes;
+      stats.depth_limit = tuner->current().depth;
+    }
+    publish();
+  }
+
+  void publish() noexcept {
+    if (stats_slot) {
+      stats.src_head = src_head;
+      stats.src_tail = src_tail;
+      stats.dst_head = dst_head;
+      stats.dst_tail = dst_tail;
+      stats_slot->publish(stats);
+    }
+  }
+
+  // Forward transfer of the stream range ending at `end`.
+  template <typename Sender>
+  exec::task<void> timed_transfer(Sender sender, uint32_t end) {
+    if (tracer) {
+      tracer->arrived(trace_hop, end);
+    }
+    if (transfer_latency) {
+      co_await (std::move(sender) | timed(transfer_latency));
+    } else {
+      co_await std::move(sender);
+    }
+    if (flight) {
+      flight->end(flight_event::transfer, flight_track);
+    }
+    if (tracer) {
+      tracer->departed(trace_hop, end);
+    }
+  }
+
 public:
   uint32_t src_capacity;
   uint32_t dst_capacity;
@@ -153,6 +403,27 @@ public:
   PipeLine *pipe_line;
   std::shared_ptr<PipeBase> prev;
   std::shared_ptr<PipeBase> next;
+
+  utils::ConcurrentHistogram::Recorder transfer_latency;
+  PipeTracer *tracer = nullptr;
+  std::size_t trace_hop = 0;
+
+  // owned by the progress thread; stats_slot gets a copy each round
+  PipeStats stats;
+  PipeStatsSlot *stats_slot = nullptr;
+
+  FlightRecorder *flight = nullptr;
+  uint32_t flight_track = FlightRecorder::no_track;
+
+  // set by PipeLine's scheduler before each round
+  uint32_t round_allowance = std::numeric_limits<uint32_t>::max();
+
+  std::optional<BatchGate> batching;
+
+  PipeTuner *tuner = nullptr;
+  uint64_t round_bytes_start = 0;
+  uint64_t round_transfers_start = 0;
+  uint32_t round_backlog = 0; // bytes waiting when the round started
 };
 
 class PipeLine {
@@ -162,9 +433,78 @@ public:
   std::shared_ptr<PipeBase> head;
 
   exec::task<void> progress(ex::scheduler auto scheduler) {
-    for (auto pipe = head; pipe; pipe = pipe->next) {
+    if (!pipe_scheduler) {
+      for (auto pipe = head; pipe; pipe = pipe->next) {
+        co_await (scheduler.schedule() | ex::let_value([pipe](auto &&...) {
+                    return pipe->transfer();
+                  }));
+      }
+      co_return;
+    }
+
+    backlog.clear();
+    for (const auto &pipe : scheduled) {
+      backlog.push_back(pipe->src_tail - pipe->dst_tail);
+    }
+    pipe_scheduler->begin_round(backlog);
+    for (auto index : pipe_scheduler->order()) {
+      if (index >= scheduled.size()) {
+        continue; // configured after schedule() for a pipe the line lacks
+      }
+      auto pipe = scheduled[index];
+      pipe->round_allowance = pipe_scheduler->allowance(index);
+      auto before = pipe->stats.bytes_issued;
       co_await (scheduler.schedule() |
                 ex::let_value([pipe](auto &&...) { return pipe->transfer(); }));
+      pipe_scheduler->served(index, pipe->stats.bytes_issued - before);
+    }
+  }
+
+  // Service pipes by weight and deficit instead of list order, numbering
+  // them from the head of the line as in PipeScheduler::configure(). Call
+  // once the line is complete; the scheduler must outlive the line.
+  void schedule(PipeScheduler &pipe_scheduler) {
+    std::vector<std::shared_ptr<PipeBase>> pipes;
+    for (auto pipe = head; pipe; pipe = pipe->next) {
+      pipes.push_back(pipe);
+    }
+    if (pipe_scheduler.size() > pipes.size()) {
+      throw std::invalid_argument(
+          "PipeScheduler configures more pipes than the line has");
+    }
+    scheduled = std::move(pipes);
+    this->pipe_scheduler = &pipe_scheduler;
+  }
+
+  // Trace every pipe, numbering hops from the head of the line.
+  void trace(PipeTracer &tracer) {
+    std::size_t hop = 0;
+    for (auto pipe = head; pipe; pipe = pipe->next, ++hop) {
+      if (hop == tracer.hops()) {
+        throw std::invalid_argument("PipeTracer has fewer hops than the line");
+      }
+      pipe->trace(tracer, hop);
+    }
+  }
+
+  // Publish every pipe's counters into `file`, one slot per pipe numbered
+  // from the head of the line.
+  void publish_stats(StatsFile &file) {
+    uint32_t slot = 0;
+    for (auto pipe = head; pipe; pipe = pipe->next, ++slot) {
+      if (slot == file.num_pipes()) {
+        throw std::invalid_argument("Stats file has fewer slots than the line");
+      }
+      pipe->publish_stats(file, slot);
+    }
+  }
+
+  // Record every pipe into `recorder`, one track per pipe numbered from the
+  // head of the line.
+  void record_flight(FlightRecorder &recorder) {
+    uint32_t track = 0;
+    for (auto pipe = head; pipe; pipe = pipe->next, ++track) {
+      pipe->record_flight(recorder, track);
     }
   }
 
@@ -176,6 +516,11 @@ public:
     }
     head = pipe;
   }
+
+private:
+  PipeScheduler *pipe_scheduler = nullptr;
+  std::vector<std::shared_ptr<PipeBase>> scheduled; // from the head
+  std::vector<uint64_t> backlog;
 };
 
 // TODO: follow stdexec sender/receiver pattern
@@ -188,93 +533,184 @@ class Pipe : public PipeBase {
 public:
   Pipe(Adapter adapter, Adapter::local_buf_t src_buf,
        Adapter::remote_buf_t dst_buf)
-      : PipeBase(src_buf.get_len(), dst_buf.get_len()), adapter(adapter),
-        next_metadata(next_metadata) {}
+      : PipeBase(src_buf.size_bytes(), dst_buf.size_bytes()), adapter(adapter),
+        src_buf(src_buf), dst_buf(dst_buf) {}
   exec::task<void> transfer() override {
+    if (!stats_slot && !flight && !tuner) {
+      co_await step();
+      co_return;
+    }
+    auto start = round_started();
+    co_await step();
+    round_done(start);
+  }
+
+  exec::task<void> step() {
+    if (round_allowance == 0) {
+      // held back by the scheduler: only pass heads upstream
+      co_await backward();
+      co_return;
+    }
     co_await ex::when_all(forward(), backward());
   }
 
   exec::task<void> forward() {
-    if (src_tail == src_head) {
+    if constexpr (oc_sg_adapter<Adapter>) {
+      co_await forward_sg();
+    } else {
+      co_await forward_segments();
+    }
+  }
+
+  // The pieces of one round, each awaited before the next is started; the
+  // range only counts as moved once the last one has completed.
+  static exec::task<void>
+  run_transfers(std::span<typename Adapter::transfer_type> transfers) {
+    for (auto &transfer : transfers) {
+      co_await std::move(transfer);
+    }
+  }
+
+  // One transfer per contiguous piece, for adapters without scatter-gather.
+  // As in forward_sg, dst_tail is the forwarding cursor into src, so a round
+  // moves [dst_tail, dst_tail + moved) and nothing else.
+  exec::task<void> forward_segments() {
+    // a held batch polls for more records too
+    if (src_tail == dst_tail || batching) {
       co_await fetch_tail();
       co_await fetch_head();
-      if (src_tail == src_head) {
-        co_return;
-      }
     }
 
-    int num_transfer_senders = 0;
-
-    auto current_src_tail = src_tail;
-    auto current_dst_tail = dst_tail;
+    auto plan = plan_forward(src_tail, dst_tail, dst_head, dst_capacity,
+                             round_budget());
+    if (plan.outcome == forward_outcome::source_empty) {
+      stalled(&PipeStats::stall_source_empty, flight_stall::source_empty);
+      co_return;
+    }
+    if (plan.outcome == forward_outcome::destination_full) {
+      stalled(&PipeStats::stall_destination_full,
+              flight_stall::destination_full);
+      co_return;
+    }
+    if (held_for_batch(src_tail - dst_tail)) {
+      co_return;
+    }
 
-    constexpr int max_transfer_senders = 16;
+    constexpr uint32_t max_transfer_senders = 16;
+    auto round_limits = limits();
 
     typename Adapter::transfer_type transfer_senders[max_transfer_senders];
+    int num_transfer_senders = 0;
+    std::size_t moved = 0;
+
+    if constexpr (oc_slicing_adapter<Adapter>) {
+      moved = for_each_ring_piece(
+          src_capacity, dst_capacity, dst_tail, plan.bytes,
+          round_limits.chunk_bytes,
+          std::min(max_transfer_senders, round_limits.depth),
+          [&](std::size_t src_offset, std::size_t dst_offset, std::size_t len) {
+            transfer_senders[num_transfer_senders++] = adapter.transfer(
+                Adapter::slice_local(src_buf, src_offset, len),
+                Adapter::slice_remote(dst_buf, dst_offset, len));
+          });
+    } else {
+      // src_buf and dst_buf are single buffer handles that every transfer
+      // built from them shares, so they describe one piece per round
+      moved = for_each_ring_piece(
+          src_capacity, dst_capacity, dst_tail, plan.bytes,
+          round_limits.chunk_bytes, 1,
+          [&](std::size_t src_offset, std::size_t dst_offset, std::size_t len) {
+            // reset the buffers at the start of a new segment
+            if (src_offset == 0) {
+              src_buf.set_data(src_buf.get_data(), 0);
+            }
+            if (dst_offset == 0) {
+              dst_buf.set_data(dst_buf.get_data(), 0);
+            }
+            src_buf.set_data_len(len);
+            transfer_senders[num_transfer_senders++] =
+                adapter.transfer(src_buf, dst_buf);
+          });
+    }
 
-    for (num_transfer_senders = 0;
-         src_tail > src_head && num_transfer_senders < max_transfer_senders;
-         num_transfer_senders++) {
-
-      // reset src_buf if it is at the start of a new segment
-      if (src_head % src_capacity == 0) {
-        src_buf.set_data(src_buf.get_data(), 0);
-      }
-
-      // reset dst_buf if it is at the start of a new segment
-      if (dst_tail % dst_capacity == 0) {
-        dst_buf.set_data(dst_buf.get_data(), 0);
-      }
-
-      auto max_to_transfer = std::min(
-          src_tail - src_head,
-          src_capacity -
-              (src_head %
-               src_capacity)); // max to transfer from src_buf (contiguous)
-      auto max_remaining_capacity = std::min(
-          dst_capacity - (dst_tail - dst_head),
-          dst_capacity - (dst_tail % dst_capacity)); // max remaining capacity
-                                                     // in dst_buf (contiguous)
-
-      auto transfer_size = std::min(max_to_transfer, max_remaining_capacity);
-
-      if (transfer_size == 0) {
-        break; // no more data can be transferred
-      }
-
-      src_buf.set_data_len(transfer_size);
+    auto end = dst_tail + static_cast<uint32_t>(moved);
+    issued(num_transfer_senders, moved);
+    co_await timed_transfer(
+        run_transfers(std::span<typename Adapter::transfer_type>(
+            transfer_senders, num_transfer_senders)),
+        end);
 
-      auto target_src_tail = src_tail + transfer_size;
-      auto target_dst_tail = dst_tail + transfer_size;
+    dst_tail = end;
+    if (batching) {
+      batching->forwarded(src_tail - dst_tail);
+    }
 
-      // capture by value to record epoch
-      // TODO: figure out better way without using callback
-      transfer_senders[num_transfer_senders] =
-          adapter.transfer(src_buf, dst_buf);
+    if (next) {
+      next->src_tail = dst_tail;
+    }
+    co_await sync_tail();
+  }
 
-      current_src_tail = target_src_tail;
-      current_dst_tail = target_dst_tail;
+  // Move everything that is both produced and fits into dst as one
+  // scatter-gather submission. Under the symmetric transfer assumption src and
+  // dst share one index space, so dst_tail is also the forwarding cursor into
+  // src; either side may wrap, giving at most two segments per list.
+  exec::task<void> forward_sg() {
+    // a held batch polls for more records too
+    if (src_tail == dst_tail || batching) {
+      co_await fetch_tail();
+      co_await fetch_head();
     }
 
-    if (num_transfer_senders == 0) {
+    // one scatter-gather submission per round, so it carries the whole
+    // depth x chunk allowance
+    auto plan = plan_forward(src_tail, dst_tail, dst_head, dst_capacity,
+                             round_budget());
+    if (plan.outcome == forward_outcome::source_empty) {
+      stalled(&PipeStats::stall_source_empty, flight_stall::source_empty);
       co_return;
     }
-
-    src_tail = src_head;
-    dst_tail = dst_head;
-
-    auto job = ex::just(std::span<typename Adapter::transfer_type>(
-                   transfer_senders, num_transfer_senders)) |
-               ex::bulk(num_transfer_senders,
-                        [&](int i, auto &&...) { return transfer_senders[i]; });
-
-    co_await job;
+    if (plan.outcome == forward_outcome::destination_full) {
+      stalled(&PipeStats::stall_destination_full,
+              flight_stall::destination_full);
+      co_return;
+    }
+    if (held_for_batch(src_tail - dst_tail)) {
+      co_return;
+    }
+    auto batch = plan.bytes;
+
+    sg_list<typename Adapter::local_buf_t> src_segments;
+    sg_list<typename Adapter::remote_buf_t> dst_segments;
+
+    for_each_ring_piece(src_capacity, dst_tail, batch,
+                        [&](std::size_t offset, std::size_t len) {
+                          src_segments.push_back(
+                              Adapter::slice_local(src_buf, offset, len));
+                        });
+    for_each_ring_piece(dst_capacity, dst_tail, batch,
+                        [&](std::size_t offset, std::size_t len) {
+                          dst_segments.push_back(
+                              Adapter::slice_remote(dst_buf, offset, len));
+                        });
+
+    issued(1, batch);
+    co_await timed_transfer(adapter.transfer_sg(
+        std::span<const typename Adapter::local_buf_t>(src_segments.data(),
+                                                       src_segments.size()),
+        std::span<const typename Adapter::remote_buf_t>(dst_segments.data(),
+                                                        dst_segments.size())),
+        dst_tail + batch);
+
+    dst_tail += batch;
+    if (batching) {
+      batching->forwarded(src_tail - dst_tail);
+    }
 
     if (next) {
-      auto *next_pipe = next.get();
-
-      next_pipe->src_tail = dst_tail;
+      next->src_tail = dst_tail;
     }
+    co_await sync_tail();
   }
 
   exec::task<void> backward() {
@@ -290,40 +726,40 @@ public:
 
     if (prev) {
       prev->dst_head = dst_head;
-      // TODO: sync dst_head => remote
     }
+    co_await sync_head();
+  }
+
+  void set_prev_metadata(BackwardPipeMetadata<PrevMetadataAdapter> metadata) {
+    prev_metadata.emplace(std::move(metadata));
+  }
+
+  void set_next_metadata(ForwardPipeMetadata<NextMetadataAdapter> metadata) {
+    next_metadata.emplace(std::move(metadata));
   }
 
   // one way sync to next pipe
   exec::task<void> sync_tail() override {
     if (next_metadata) {
-      // assuming writing to buffer is synchronous
-      auto ptr = next_metadata->local_buf.data();
-      std::atomic_uint32_t *atomic_ptr =
-          reinterpret_cast<std::atomic_uint32_t *>(ptr);
-      atomic_ptr->store(dst_tail);
-      co_await next_metadata->metadata_adapter.transfer(
-          next_metadata->local_buf, next_metadata->remote_tail_buf);
+      auto start = metadata_sync_started(dst_tail);
+      auto waited = co_await next_metadata->store_tail(dst_tail);
+      metadata_stored(start, waited);
     }
     co_return;
   }
 
+  // tail published by the previous pipe into our local tail slot
   exec::task<void> fetch_tail() override {
     if (prev_metadata) {
-      auto ptr = prev_metadata->local_buf.data();
-      std::atomic_uint32_t *atomic_ptr =
-          reinterpret_cast<std::atomic_uint32_t *>(ptr);
-      src_tail = atomic_ptr->load();
+      src_tail = prev_metadata->fetch_tail();
     }
     co_return;
   }
 
+  // head published by the next pipe into our local head slot
   exec::task<void> fetch_head() override {
     if (next_metadata) {
-      auto ptr = next_metadata->local_buf.data();
-      std::atomic_uint32_t *atomic_ptr =
-          reinterpret_cast<std::atomic_uint32_t *>(ptr);
-      dst_head = atomic_ptr->load();
+      dst_head = next_metadata->fetch_head();
     }
     co_return;
   }
@@ -331,13 +767,9 @@ public:
   // one way sync to prev pipe
   exec::task<void> sync_head() override {
     if (prev_metadata) {
-      // assuming writing to buffer is synchronous
-      auto ptr = prev_metadata->local_buf.data();
-      std::atomic_uint32_t *atomic_ptr =
-          reinterpret_cast<std::atomic_uint32_t *>(ptr);
-      atomic_ptr->store(src_head);
-      co_await prev_metadata->metadata_adapter.transfer(
-          prev_metadata->local_buf, prev_metadata->remote_head_buf);
+      auto start = metadata_sync_started(src_head);
+      auto waited = co_await prev_metadata->store_head(src_head);
+      metadata_stored(start, waited);
     }
     co_return;
   }
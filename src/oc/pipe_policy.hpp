@@ -0,0 +1,101 @@
+#pragma once
+#ifndef PIPE_POLICY_HPP
+#define PIPE_POLICY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace oc {
+
+/**
+ * @file pipe_policy.hpp
+ * @brief Decisions a pipe makes each round, free of adapters and senders
+ *
+ * Pipe::forward and the offline simulator (oc/sim/pipeline_sim.hpp) both
+ * plan their transfers here, so a simulated topology moves data in exactly
+ * the batches the real pipe would.
+ */
+
+// Split the ring range [position, position + len) of a ring with `capacity`
+// bytes into contiguous pieces and call f(offset, piece_len) for each.
+template <typename F>
+void for_each_ring_piece(std::size_t capacity, std::size_t position,
+                         std::size_t len, F &&f) {
+  while (len > 0) {
+    auto offset = position % capacity;
+    auto piece = std::min(len, capacity - offset);
+    f(offset, piece);
+    position += piece;
+    len -= piece;
+  }
+}
+
+enum class forward_outcome { move, source_empty, destination_full };
+
+struct forward_plan {
+  forward_outcome outcome;
+  uint32_t bytes; // 0 unless outcome is move
+};
+
+// What the next forward transfer of a pipe moves. Under the symmetric
+// transfer assumption src and dst share one index space, so the dst tail is
+// also the forwarding cursor into src: everything produced past it that fits
+// into dst goes, up to `max_bytes`.
+inline forward_plan
+plan_forward(uint32_t src_tail, uint32_t dst_tail, uint32_t dst_head,
+             uint32_t dst_capacity,
+             uint32_t max_bytes = std::numeric_limits<uint32_t>::max()) {
+  if (src_tail == dst_tail) {
+    return {forward_outcome::source_empty, 0};
+  }
+  auto batch = std::min({src_tail - dst_tail,
+                         dst_capacity - (dst_tail - dst_head), max_bytes});
+  if (batch == 0) {
+    return {forward_outcome::destination_full, 0};
+  }
+  return {forward_outcome::move, batch};
+}
+
+// Split the stream range [position, position + len) into the pieces one
+// adapter transfer each can move when neither ring may wrap inside a
+// transfer: every boundary of either ring cuts the range, and so does
+// `max_piece`. Calls f(src_offset, dst_offset, piece_len) for at most
+// `max_pieces` pieces and returns the bytes they cover.
+template <typename F>
+std::size_t for_each_ring_piece(std::size_t src_capacity,
+                                std::size_t dst_capacity,
+                                std::size_t position, std::size_t len,
+                                std::size_t max_piece, std::size_t max_pieces,
+                                F &&f) {
+  std::size_t covered = 0;
+  for (std::size_t pieces = 0; covered < len && pieces < max_pieces;
+       ++pieces) {
+    auto src_offset = position % src_capacity;
+    auto dst_offset = position % dst_capacity;
+    auto piece = std::min({len - covered, max_piece, src_capacity - src_offset,
+                           dst_capacity - dst_offset});
+    f(src_offset, dst_offset, piece);
+    position += piece;
+    covered += piece;
+  }
+  return covered;
+}
+
+// Number of contiguous pieces a batch splits into when neither ring may wrap
+// inside one adapter transfer.
+inline std::size_t ring_pieces(std::size_t src_capacity,
+                               std::size_t dst_capacity, std::size_t position,
+                               std::size_t len) {
+  std::size_t pieces = 0;
+  for_each_ring_piece(src_capacity, dst_capacity, position, len,
+                      std::numeric_limits<std::size_t>::max(),
+                      std::numeric_limits<std::size_t>::max(),
+                      [&](std::size_t, std::size_t, std::size_t) { ++pieces; });
+  return pieces;
+}
+
+} // namespace oc
+
+#endif
@@ -0,0 +1,210 @@
+#pragma once
+#ifndef PIPE_SCHEDULER_HPP
+#define PIPE_SCHEDULER_HPP
+
+#include "utils/tsc_clock.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace oc {
+
+/**
+ * @file pipe_scheduler.hpp
+ * @brief Weighted sharing of a PipeLine's progress loop between its pipes
+ *
+ * Without a scheduler PipeLine::progress() services every pipe in list
+ * order and lets each move everything it can, so one bulk pipe with a deep
+ * backlog holds the loop, and the link, for as long as its transfer takes.
+ *
+ * PipeScheduler runs deficit round robin over bytes. Every round each pipe
+ * with a backlog earns `quantum x weight` bytes of deficit and may forward
+ * at most that much, further limited by an optional token bucket that caps
+ * its long-term rate. Pipes are serviced heaviest weight first, so a
+ * latency-critical pipe is never queued behind a bulk transfer in the same
+ * round, and the bulk pipe's transfer is bounded by its own allowance.
+ * Unused deficit is forfeited when a pipe runs dry, so idle pipes do not
+ * bank credit and busy ones take up the slack.
+ *
+ * The scheduler has no sender or adapter dependencies: PipeLine::schedule()
+ * attaches it, and it can be driven directly with begin_round()/served().
+ */
+
+struct pipe_share_config {
+  uint32_t weight = 1;
+  double max_bytes_per_sec = 0; // 0: no cap
+  uint32_t burst_bytes = 0;     // bucket depth; 0: one quantum x weight
+};
+
+struct pipe_share {
+  uint32_t weight;
+  uint64_t bytes;          // forwarded since the scheduler was attached
+  uint64_t throttled;      // rounds the token bucket held the pipe back
+  double achieved = 0;     // fraction of all forwarded bytes
+  double entitled = 0;     // weight / sum of weights
+};
+
+class PipeScheduler {
+public:
+  using ticks = utils::tsc_clock::ticks;
+
+  explicit PipeScheduler(uint32_t quantum_bytes = 64 << 10)
+      : quantum_(quantum_bytes) {
+    if (quantum_bytes == 0) {
+      throw std::invalid_argument("PipeScheduler quantum must be positive");
+    }
+  }
+
+  // Configure pipe `pipe`, numbered from the head of the line. Pipes never
+  // configured get weight 1 and no cap.
+  void configure(std::size_t pipe, pipe_share_config config) {
+    if (config.weight == 0) {
+      throw std::invalid_argument("Pipe weight must be positive");
+    }
+    resize(pipe + 1);
+    auto &state = pipes_[pipe];
+    state.config = config;
+    state.tokens = static_cast<double>(burst(state));
+    state.refilled = 0;
+    reorder();
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return pipes_.size(); }
+
+  // Start a round: `backlog[i]` bytes wait at pipe i. Afterwards order()
+  // is the service order and allowance(i) the bytes pipe i may forward.
+  void begin_round(std::span<const uint64_t> backlog,
+                   ticks now = utils::tsc_clock::now()) {
+    resize(backlog.size());
+    for (std::size_t i = 0; i < pipes_.size(); ++i) {
+      auto &state = pipes_[i];
+      auto waiting = i < backlog.size() ? backlog[i] : 0;
+      auto grant = uint64_t{quantum_} * state.config.weight;
+      if (waiting == 0) {
+        // nothing known to be waiting, but the pipe may find new data when
+        // it polls: one grant, without banking it
+        state.deficit = 0;
+      } else {
+        state.deficit = std::min(state.deficit + grant, 2 * grant);
+      }
+
+      state.allowance = static_cast<uint32_t>(
+          std::min<uint64_t>(waiting == 0 ? grant : state.deficit,
+                             std::numeric_limits<uint32_t>::max()));
+      if (state.config.max_bytes_per_sec > 0) {
+        // capped whatever the backlog says: a pipe reporting none may still
+        // find data when it polls, and must not get past its bucket that way
+        refill(state, now);
+        auto tokens = static_cast<uint64_t>(std::max(state.tokens, 0.0));
+        if (tokens < state.allowance) {
+          state.throttled += waiting > 0;
+          state.allowance = static_cast<uint32_t>(tokens);
+        }
+      }
+    }
+  }
+
+  // heaviest weight first, list order among equals
+  [[nodiscard]] std::span<const std::size_t> order() const noexcept {
+    return order_;
+  }
+
+  [[nodiscard]] uint32_t allowance(std::size_t pipe) const noexcept {
+    return pipes_[pipe].allowance;
+  }
+
+  // Pipe `pipe` forwarded `bytes` this round.
+  void served(std::size_t pipe, uint64_t bytes) noexcept {
+    auto &state = pipes_[pipe];
+    state.deficit -= std::min(state.deficit, bytes);
+    if (state.config.max_bytes_per_sec > 0) {
+      state.tokens -= static_cast<double>(bytes);
+    }
+    state.bytes += bytes;
+  }
+
+  [[nodiscard]] std::vector<pipe_share> shares() const {
+    uint64_t total_bytes = 0;
+    uint64_t total_weight = 0;
+    for (const auto &state : pipes_) {
+      total_bytes += state.bytes;
+      total_weight += state.config.weight;
+    }
+    std::vector<pipe_share> out;
+    out.reserve(pipes_.size());
+    for (const auto &state : pipes_) {
+      pipe_share share{state.config.weight, state.bytes, state.throttled};
+      if (total_bytes > 0) {
+        share.achieved = static_cast<double>(state.bytes) /
+                         static_cast<double>(total_bytes);
+      }
+      share.entitled = static_cast<double>(state.config.weight) /
+                       static_cast<double>(total_weight);
+      out.push_back(share);
+    }
+    return out;
+  }
+
+private:
+  struct pipe_state {
+    pipe_share_config config;
+    uint64_t deficit = 0;
+    uint32_t allowance = 0;
+    double tokens = 0;
+    ticks refilled = 0; // 0: bucket not started
+    uint64_t bytes = 0;
+    uint64_t throttled = 0;
+  };
+
+  [[nodiscard]] uint64_t burst(const pipe_state &state) const noexcept {
+    return state.config.burst_bytes
+               ? state.config.burst_bytes
+               : uint64_t{quantum_} * state.config.weight;
+  }
+
+  void refill(pipe_state &state, ticks now) const noexcept {
+    if (state.refilled != 0 && now > state.refilled) {
+      auto seconds = static_cast<double>(now - state.refilled) *
+                     utils::tsc_clock::ns_per_tick() / 1e9;
+      state.tokens =
+          std::min(state.tokens + seconds * state.config.max_bytes_per_sec,
+                   static_cast<double>(burst(state)));
+    }
+    state.refilled = now;
+  }
+
+  void resize(std::size_t pipes) {
+    if (pipes <= pipes_.size()) {
+      return;
+    }
+    auto before = pipes_.size();
+    pipes_.resize(pipes);
+    for (auto i = before; i < pipes; ++i) {
+      pipes_[i].tokens = static_cast<double>(burst(pipes_[i]));
+    }
+    reorder();
+  }
+
+  void reorder() {
+    order_.resize(pipes_.size());
+    for (std::size_t i = 0; i < order_.size(); ++i) {
+      order_[i] = i;
+    }
+    std::stable_sort(order_.begin(), order_.end(),
+                     [this](std::size_t a, std::size_t b) {
+                       return pipes_[a].config.weight > pipes_[b].config.weight;
+                     });
+  }
+
+  uint32_t quantum_;
+  std::vector<pipe_state> pipes_;
+  std::vector<std::size_t> order_;
+};
+
+} // namespace oc
+
+#endif
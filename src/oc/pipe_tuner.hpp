@@ -0,0 +1,290 @@
+#pragma once
+#ifndef PIPE_TUNER_HPP
+#define PIPE_TUNER_HPP
+
+#include "utils/tsc_clock.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace oc {
+
+/**
+ * @file pipe_tuner.hpp
+ * @brief Online tuning of a pipe's transfer size and depth
+ *
+ * A pipe forwards at most `depth` adapter transfers of at most `chunk_bytes`
+ * each per round. Larger limits amortise per-transfer cost, smaller ones
+ * bound how long a round holds the link; the best point depends on the
+ * adapter and the load and moves when either changes.
+ *
+ * PipeTuner watches every round (bytes moved, transfers, round time and how
+ * much was waiting) and, once per window, takes one step:
+ *
+ *  - if the mean transfer latency is above `latency_target`, halve both
+ *    limits (multiplicative decrease);
+ *  - else if the limits were binding in most rounds, hill-climb on
+ *    throughput: probe a neighbouring point (chunk x2 or /2, depth +-1) for
+ *    one window, keep it and repeat the move if throughput rose by more
+ *    than `tolerance`, otherwise go back and try the next move. When no
+ *    neighbour is better, stay for `settle_windows` unless throughput at
+ *    the current point shifts by more than `tolerance`;
+ *  - else the pipe is waiting on its producer and larger limits cannot
+ *    help, so hold and forget the throughput baseline.
+ *
+ * With the default 20 ms window the full chunk range is crossed in about
+ * twenty windows, so the tuner settles within a second of a load change.
+ * It has no adapter or sender dependencies: attach it with PipeBase::tune(),
+ * or drive observe() directly.
+ */
+
+struct tuning {
+  uint32_t chunk_bytes;
+  uint32_t depth;
+
+  // bytes one round may move
+  [[nodiscard]] uint32_t round_bytes() const noexcept {
+    auto bytes = uint64_t{chunk_bytes} * depth;
+    return static_cast<uint32_t>(
+        std::min<uint64_t>(bytes, std::numeric_limits<uint32_t>::max()));
+  }
+
+  bool operator==(const tuning &) const = default;
+};
+
+struct tuner_options {
+  uint32_t min_chunk_bytes = 4 << 10;
+  uint32_t max_chunk_bytes = 4 << 20;
+  uint32_t min_depth = 1;
+  uint32_t max_depth = 16;
+  tuning initial{64 << 10, 4};
+
+  std::chrono::nanoseconds window = std::chrono::milliseconds(20);
+  // relative throughput change treated as noise
+  double tolerance = 0.05;
+  // windows to stay at a point no neighbour improves on before probing again
+  uint32_t settle_windows = 10;
+  // 0: no latency bound
+  std::chrono::nanoseconds latency_target{0};
+};
+
+enum class tuner_action : uint8_t { hold, probe, revert, back_off };
+
+struct tuner_metrics {
+  tuning current;
+  double throughput_bytes_per_sec = 0; // last window
+  double transfer_latency_ns = 0;      // last window, mean per transfer
+  uint64_t windows = 0;
+  uint64_t steps = 0; // windows that changed the limits
+  uint64_t back_offs = 0;
+  tuner_action last_action = tuner_action::hold;
+};
+
+class PipeTuner {
+public:
+  using ticks = utils::tsc_clock::ticks;
+
+  // Throws std::invalid_argument for empty bounds or a non-positive window.
+  explicit PipeTuner(tuner_options options = {})
+      : options_(validated(options)), current_(clamp(options.initial)),
+        window_ticks_(static_cast<ticks>(
+            static_cast<double>(options.window.count()) /
+            utils::tsc_clock::ns_per_tick())),
+        best_(current_) {
+    metrics_.current = current_;
+  }
+
+  [[nodiscard]] const tuning &current() const noexcept { return current_; }
+
+  [[nodiscard]] const tuner_metrics &metrics() const noexcept {
+    return metrics_;
+  }
+
+  // One pipe round: it moved `bytes` in `transfers` adapter transfers,
+  // took `elapsed` ticks, and `backlog` bytes were waiting when it started.
+  void observe(uint64_t bytes, uint64_t transfers, ticks elapsed,
+               uint64_t backlog, ticks now = utils::tsc_clock::now()) {
+    if (window_.rounds == 0 && window_.start == 0) {
+      window_.start = now - std::min(now, elapsed);
+    }
+    ++window_.rounds;
+    window_.bytes += bytes;
+    if (transfers > 0) {
+      window_.transfers += transfers;
+      window_.busy_ticks += elapsed;
+      ++window_.moving_rounds;
+      if (backlog > current_.round_bytes()) {
+        ++window_.limited_rounds;
+      }
+    }
+
+    if (now - window_.start >= window_ticks_) {
+      decide(now);
+      window_ = {};
+      window_.start = now;
+    }
+  }
+
+private:
+  struct window_state {
+    ticks start = 0;
+    uint64_t rounds = 0;
+    uint64_t moving_rounds = 0;
+    uint64_t limited_rounds = 0;
+    uint64_t bytes = 0;
+    uint64_t transfers = 0;
+    ticks busy_ticks = 0;
+  };
+
+  void decide(ticks now) {
+    auto ns_per_tick = utils::tsc_clock::ns_per_tick();
+    auto seconds =
+        static_cast<double>(now - window_.start) * ns_per_tick / 1e9;
+    auto throughput = static_cast<double>(window_.bytes) / seconds;
+    auto latency = window_.transfers > 0
+                       ? static_cast<double>(window_.busy_ticks) *
+                             ns_per_tick /
+                             static_cast<double>(window_.transfers)
+                       : 0.0;
+    ++metrics_.windows;
+    metrics_.throughput_bytes_per_sec = throughput;
+    metrics_.transfer_latency_ns = latency;
+
+    auto before = current_;
+    auto target = static_cast<double>(options_.latency_target.count());
+    if (target > 0 && latency > target) {
+      current_ = best_ =
+          clamp({current_.chunk_bytes / 2, current_.depth / 2});
+      baseline_ = 0;
+      settle_ = 0;
+      metrics_.last_action = tuner_action::back_off;
+      ++metrics_.back_offs;
+    } else if (window_.limited_rounds * 2 >= window_.moving_rounds &&
+               window_.moving_rounds > 0) {
+      climb(throughput);
+    } else {
+      // a probe that starved the pipe of work says nothing about the link
+      current_ = best_;
+      baseline_ = 0;
+      metrics_.last_action = tuner_action::hold;
+    }
+
+    if (current_ != before) {
+      ++metrics_.steps;
+    }
+    metrics_.current = current_;
+  }
+
+  void climb(double throughput) {
+    if (current_ == best_) {
+      // measured at the accepted point: refresh the baseline, and during a
+      // settle period only leave early if the load visibly changed
+      auto changed = baseline_ > 0 && std::abs(throughput / baseline_ - 1) >
+                                          options_.tolerance;
+      baseline_ = throughput;
+      if (settle_ > 0 && !changed) {
+        --settle_;
+        metrics_.last_action = tuner_action::hold;
+        return;
+      }
+      settle_ = 0;
+      probe();
+      return;
+    }
+
+    // measured at a probe
+    if (throughput > baseline_ * (1 + options_.tolerance)) {
+      best_ = current_;
+      baseline_ = throughput;
+      failed_ = 0;
+      probe(); // the same move again
+      return;
+    }
+    current_ = best_;
+    metrics_.last_action = tuner_action::revert;
+    next_move();
+  }
+
+  // try the current move; moves pinned at a bound count as failed
+  void probe() {
+    while (failed_ < moves) {
+      auto next = clamp(stepped(move_));
+      if (next != current_) {
+        current_ = next;
+        metrics_.last_action = tuner_action::probe;
+        return;
+      }
+      next_move();
+    }
+    metrics_.last_action = tuner_action::hold;
+  }
+
+  void next_move() {
+    move_ = (move_ + 1) % moves;
+    if (++failed_ >= moves) {
+      // no neighbour is better: stay put for a while
+      failed_ = 0;
+      settle_ = options_.settle_windows;
+    }
+  }
+
+  // moves: 0 chunk x2, 1 chunk /2, 2 depth +1, 3 depth -1
+  static constexpr int moves = 4;
+
+  [[nodiscard]] tuning stepped(int move) const noexcept {
+    auto next = current_;
+    switch (move) {
+    case 0:
+      next.chunk_bytes = static_cast<uint32_t>(std::min<uint64_t>(
+          uint64_t{next.chunk_bytes} * 2, options_.max_chunk_bytes));
+      break;
+    case 1:
+      next.chunk_bytes /= 2;
+      break;
+    case 2:
+      ++next.depth;
+      break;
+    default:
+      --next.depth;
+      break;
+    }
+    return next;
+  }
+
+  // before anything clamps to them: std::clamp needs lo <= hi
+  static const tuner_options &validated(const tuner_options &options) {
+    if (options.min_chunk_bytes == 0 ||
+        options.min_chunk_bytes > options.max_chunk_bytes ||
+        options.min_depth == 0 || options.min_depth > options.max_depth) {
+      throw std::invalid_argument("PipeTuner bounds are empty");
+    }
+    if (options.window.count() <= 0) {
+      throw std::invalid_argument("PipeTuner window must be positive");
+    }
+    return options;
+  }
+
+  [[nodiscard]] tuning clamp(tuning t) const noexcept {
+    return {std::clamp(t.chunk_bytes, options_.min_chunk_bytes,
+                       options_.max_chunk_bytes),
+            std::clamp(t.depth, options_.min_depth, options_.max_depth)};
+  }
+
+  tuner_options options_;
+  tuning current_;
+  ticks window_ticks_;
+  window_state window_;
+  tuning best_;
+  double baseline_ = 0; // throughput measured at best_
+  int move_ = 0;
+  int failed_ = 0;     // consecutive probes that did not improve
+  uint32_t settle_ = 0; // windows left to hold at best_
+  tuner_metrics metrics_;
+};
+
+} // namespace oc
+
+#endif
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "pod_rb.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace oc::rb {
+
+/**
+ * @brief Field type and owning record of a pointer to data member
+ */
+template<typename M>
+struct member_traits;
+
+template<typename R, typename F>
+struct member_traits<F R::*> {
+    using record_type = R;
+    using field_type = F;
+};
+
+template<auto Field>
+using field_type_t = typename member_traits<decltype(Field)>::field_type;
+
+/**
+ * @brief Struct-of-arrays SPSC ring buffer for column-at-a-time consumers
+ *
+ * Stores the fields named by `Fields`, pointers to data members of T, each
+ * in its own cache-line aligned array. All columns share one head and one
+ * tail, so element i of every column belongs to the same record. Pushing
+ * records transposes them into the columns; consumers read a column as up to
+ * two contiguous spans (the second one after the wrap), which SIMD loops can
+ * scan at full density instead of striding over whole records.
+ *
+ * Fields of T that are not listed are not stored. Like PodRingBuffer, it is
+ * safe for one producer thread and one consumer thread; a full ring never
+ * blocks, pushes just take fewer records.
+ *
+ * Usage:
+ * @code
+ *   ColumnarRingBuffer<Quote, &Quote::timestamp_ns, &Quote::bid> ring(4096);
+ *   ring.try_push_bulk(quotes);
+ *   for (auto bids : ring.get_column_views<&Quote::bid>()) { ... }
+ *   ring.advance_read(ring.size());
+ * @endcode
+ */
+template<PodType T, auto... Fields>
+class alignas(cache_line_size) ColumnarRingBuffer {
+    static_assert(sizeof...(Fields) > 0, "A columnar ring needs at least one field");
+    static_assert((std::is_same_v<typename member_traits<decltype(Fields)>::record_type, T> && ...),
+                  "Every field must be a data member of the record type");
+    static_assert((PodType<field_type_t<Fields>> && ...), "Fields must be POD types");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    static constexpr size_type columns = sizeof...(Fields);
+    static constexpr size_type column_alignment = cache_line_size;
+
+private:
+    template<auto A, auto B>
+    static constexpr bool same_field() {
+        if constexpr (std::is_same_v<decltype(A), decltype(B)>) {
+            return A == B;
+        } else {
+            return false;
+        }
+    }
+
+    template<auto Field>
+    static constexpr size_type index_of() {
+        size_type index = 0;
+        size_type found = columns;
+        ((found = (found == columns && same_field<Field, Fields>()) ? index : found, ++index), ...);
+        return found;
+    }
+
+    static constexpr std::array<size_type, columns> field_bytes{sizeof(field_type_t<Fields>)...};
+
+    struct AlignedDelete {
+        void operator()(std::byte* p) const noexcept {
+            ::operator delete(p, std::align_val_t{column_alignment});
+        }
+    };
+
+    struct alignas(cache_line_size) ProducerIndex {
+        std::atomic<size_type> head{0};
+        char padding[cache_line_size - sizeof(std::atomic<size_type>)];
+    };
+
+    struct alignas(cache_line_size) ConsumerIndex {
+        std::atomic<size_type> tail{0};
+        char padding[cache_line_size - sizeof(std::atomic<size_type>)];
+    };
+
+    const size_type capacity_;
+    const size_type mask_;
+    std::array<size_type, columns> offsets_{}; // of each column in storage_
+    std::unique_ptr<std::byte, AlignedDelete> storage_;
+
+    ProducerIndex producer_idx_;
+    ConsumerIndex consumer_idx_;
+
+    template<size_type I>
+    using column_type = std::tuple_element_t<I, std::tuple<field_type_t<Fields>...>>;
+
+    template<size_type I>
+    column_type<I>* column_data() const noexcept {
+        return reinterpret_cast<column_type<I>*>(storage_.get() + offsets_[I]);
+    }
+
+    // Calls f(slot, done, run) for the one or two runs of `count` slots from
+    // ring position `position`; `done` counts the elements before the run.
+    template<typename F>
+    void for_each_run(size_type position, size_type count, F&& f) const {
+        const auto index = position & mask_;
+        const auto first = std::min(count, capacity_ - index);
+        if (first > 0) {
+            f(index, size_type{0}, first);
+        }
+        if (count > first) {
+            f(size_type{0}, first, count - first);
+        }
+    }
+
+    template<size_type... I>
+    void scatter(const T* items, size_type slot, size_type count, std::index_sequence<I...>) noexcept {
+        (scatter_column<I, Fields>(items, slot, count), ...);
+    }
+
+    template<size_type I, auto Field>
+    void scatter_column(const T* items, size_type slot, size_type count) noexcept {
+        auto* column = column_data<I>() + slot;
+        for (size_type i = 0; i < count; ++i) {
+            column[i] = items[i].*Field;
+        }
+    }
+
+    template<size_type... I>
+    void gather(T* items, size_type slot, size_type count, std::index_sequence<I...>) const noexcept {
+        (gather_column<I, Fields>(items, slot, count), ...);
+    }
+
+    template<size_type I, auto Field>
+    void gather_column(T* items, size_type slot, size_type count) const noexcept {
+        const auto* column = column_data<I>() + slot;
+        for (size_type i = 0; i < count; ++i) {
+            items[i].*Field = column[i];
+        }
+    }
+
+public:
+    explicit ColumnarRingBuffer(size_type capacity)
+        : capacity_(capacity == 0 ? 1 : std::bit_ceil(capacity))
+        , mask_(capacity_ - 1)
+    {
+        size_type bytes = 0;
+        for (size_type i = 0; i < columns; ++i) {
+            offsets_[i] = bytes;
+            bytes += (capacity_ * field_bytes[i] + column_alignment - 1) & ~(column_alignment - 1);
+        }
+        storage_.reset(static_cast<std::byte*>(
+            ::operator new(bytes, std::align_val_t{column_alignment})));
+    }
+
+    ColumnarRingBuffer(const ColumnarRingBuffer&) = delete;
+    ColumnarRingBuffer& operator=(const ColumnarRingBuffer&) = delete;
+
+    [[nodiscard]] size_type capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] size_type size() const noexcept {
+        const auto head = producer_idx_.head.load(std::memory_order_acquire);
+        const auto tail = consumer_idx_.tail.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    [[nodiscard]] bool full() const noexcept { return size() == capacity_; }
+    [[nodiscard]] size_type available() const noexcept { return capacity_ - size(); }
+
+    /**
+     * @brief Transpose records into the columns
+     *
+     * @param items Records to append, in order
+     * @return Number of records taken, fewer than items.size() if the ring fills
+     */
+    size_type try_push_bulk(std::span<const T> items) {
+        const auto count = std::min(items.size(), available());
+        if (count == 0) {
+            return 0;
+        }
+        const auto head = producer_idx_.head.load(std::memory_order_relaxed);
+        for_each_run(head, count, [&](size_type slot, size_type done, size_type run) {
+            scatter(items.data() + done, slot, run, std::index_sequence_for<decltype(Fields)...>{});
+        });
+        producer_idx_.head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    bool try_push(const T& item) {
+        return try_push_bulk(std::span<const T>(&item, 1)) == 1;
+    }
+
+    /**
+     * @brief Transpose records back out of the columns and consume them
+     *
+     * Only the listed fields of each output record are written.
+     *
+     * @param items Destination records
+     * @return Number of records read
+     */
+    size_type try_pop_bulk(std::span<T> items) {
+        const auto count = std::min(items.size(), size());
+        if (count == 0) {
+            return 0;
+        }
+        const auto tail = consumer_idx_.tail.load(std::memory_order_relaxed);
+        for_each_run(tail, count, [&](size_type slot, size_type done, size_type run) {
+            gather(items.data() + done, slot, run, std::index_sequence_for<decltype(Fields)...>{});
+        });
+        consumer_idx_.tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Zero-copy read access to one column
+     *
+     * Returns the column's readable elements as up to two contiguous spans,
+     * oldest first; the second is empty unless the data wraps. Element i of
+     * every column's views belongs to the same record. The spans stay valid
+     * until advance_read() moves past them.
+     *
+     * @tparam Field Pointer to the data member, one of Fields
+     * @param max_elements Maximum number of elements to include
+     */
+    template<auto Field>
+    [[nodiscard]] std::array<std::span<const field_type_t<Field>>, 2>
+    get_column_views(size_type max_elements = SIZE_MAX) const {
+        constexpr auto index = index_of<Field>();
+        static_assert(index < columns, "Field is not stored in this ring");
+
+        const auto count = std::min(max_elements, size());
+        const auto tail = consumer_idx_.tail.load(std::memory_order_acquire);
+        const auto* column = column_data<index>();
+        std::array<std::span<const field_type_t<Field>>, 2> views{};
+        for_each_run(tail, count, [&](size_type slot, size_type done, size_type run) {
+            views[done == 0 ? 0 : 1] = {column + slot, run};
+        });
+        return views;
+    }
+
+    /**
+     * @brief Consume records after reading them through column views
+     *
+     * @param count Number of records consumed
+     */
+    void advance_read(size_type count) {
+        if (count > size()) {
+            throw std::out_of_range("Cannot advance read beyond available data");
+        }
+        const auto tail = consumer_idx_.tail.load(std::memory_order_relaxed);
+        consumer_idx_.tail.store(tail + count, std::memory_order_release);
+    }
+
+    void clear() noexcept {
+        consumer_idx_.tail.store(producer_idx_.head.load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+    }
+};
+
+} // namespace oc::rb
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "pod_rb.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace oc::rb {
+
+/**
+ * @brief Delimiter scanning over ring buffer views, for text and line protocols
+ *
+ * Newline- or delimiter-separated feeds can be framed where they sit in a
+ * PodRingBuffer<std::byte>: find_delimiter() and count_records() work on one
+ * ZeroCopyView, and split_records() walks the up to two views returned by
+ * get_read_views() and hands every complete record to a callback as spans
+ * into the ring. A record that straddles the wrap point arrives as two
+ * pieces rather than being copied; everything after the last delimiter is
+ * left for the next call.
+ *
+ * The scan compares 32 bytes at a time with AVX2 when the CPU has it, 16 with
+ * SSE2 otherwise, and falls back to a byte loop on other targets. The choice
+ * is made once at run time, so no build flags are needed.
+ */
+
+/**
+ * @brief One framed record; `second` is non-empty only if it wraps
+ */
+struct RecordPieces {
+    std::span<const std::byte> first;
+    std::span<const std::byte> second;
+
+    [[nodiscard]] std::size_t size() const noexcept { return first.size() + second.size(); }
+    [[nodiscard]] bool contiguous() const noexcept { return second.empty(); }
+};
+
+namespace detail {
+
+// Calls f(index) for every byte equal to `delimiter`, in order, until f
+// returns false. Returns false if f stopped the scan.
+template<typename F>
+bool for_each_match_scalar(const std::byte* data, std::size_t size, std::size_t base,
+                           std::byte delimiter, F& f) {
+    for (std::size_t i = 0; i < size; ++i) {
+        if (data[i] == delimiter && !f(base + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// every set bit of a compare mask, lowest first
+template<typename Mask, typename F>
+bool for_each_bit(Mask mask, std::size_t base, F& f) {
+    while (mask) {
+        if (!f(base + static_cast<std::size_t>(std::countr_zero(mask)))) {
+            return false;
+        }
+        mask &= mask - 1;
+    }
+    return true;
+}
+
+#if defined(__x86_64__)
+
+template<typename F>
+bool for_each_match_sse2(const std::byte* data, std::size_t size, std::byte delimiter, F& f) {
+    const auto needle = _mm_set1_epi8(static_cast<char>(delimiter));
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+        if (mask && !for_each_bit(mask, i, f)) {
+            return false;
+        }
+    }
+    return for_each_match_scalar(data + i, size - i, i, delimiter, f);
+}
+
+template<typename F>
+__attribute__((target("avx2")))
+bool for_each_match_avx2(const std::byte* data, std::size_t size, std::byte delimiter, F& f) {
+    const auto needle = _mm256_set1_epi8(static_cast<char>(delimiter));
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+        if (mask && !for_each_bit(mask, i, f)) {
+            return false;
+        }
+    }
+    return for_each_match_scalar(data + i, size - i, i, delimiter, f);
+}
+
+inline bool has_avx2() noexcept {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+#endif
+
+template<typename F>
+bool for_each_match(std::span<const std::byte> data, std::byte delimiter, F&& f) {
+#if defined(__x86_64__)
+    if (has_avx2()) {
+        return for_each_match_avx2(data.data(), data.size(), delimiter, f);
+    }
+    return for_each_match_sse2(data.data(), data.size(), delimiter, f);
+#else
+    return for_each_match_scalar(data.data(), data.size(), 0, delimiter, f);
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Index of the first `delimiter` at or after `from`, or view.size()
+ */
+[[nodiscard]] inline std::size_t find_delimiter(const ZeroCopyView<std::byte>& view,
+                                                std::byte delimiter, std::size_t from = 0) {
+    if (from >= view.size()) {
+        return view.size();
+    }
+    auto found = view.size();
+    detail::for_each_match(view.to_span().subspan(from), delimiter, [&](std::size_t index) {
+        found = from + index;
+        return false;
+    });
+    return found;
+}
+
+/**
+ * @brief Offset of the first `delimiter` across both read views, or their
+ * combined size
+ */
+[[nodiscard]] inline std::size_t find_delimiter(const std::array<ZeroCopyView<std::byte>, 2>& views,
+                                                std::byte delimiter) {
+    auto found = find_delimiter(views[0], delimiter);
+    if (found < views[0].size()) {
+        return found;
+    }
+    return views[0].size() + find_delimiter(views[1], delimiter);
+}
+
+/**
+ * @brief Number of delimiters, i.e. of complete records, in a view
+ */
+[[nodiscard]] inline std::size_t count_records(const ZeroCopyView<std::byte>& view,
+                                               std::byte delimiter) {
+    std::size_t count = 0;
+    detail::for_each_match(view.to_span(), delimiter, [&](std::size_t) {
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+[[nodiscard]] inline std::size_t count_records(const std::array<ZeroCopyView<std::byte>, 2>& views,
+                                               std::byte delimiter) {
+    return count_records(views[0], delimiter) + count_records(views[1], delimiter);
+}
+
+/**
+ * @brief Frame every complete record in the read views
+ *
+ * Calls f(RecordPieces) for each record, without its delimiter, in ring
+ * order. The pieces point into the ring and stay valid until the consumer
+ * advances past them. Returns the bytes framed, delimiters included, which
+ * is what to pass to advance_read().
+ */
+template<typename F>
+std::size_t split_records(const std::array<ZeroCopyView<std::byte>, 2>& views,
+                          std::byte delimiter, F&& f) {
+    auto first = views[0].to_span();
+    auto second = views[1].to_span();
+
+    std::size_t start = 0; // of the current record in `first`
+    detail::for_each_match(first, delimiter, [&](std::size_t index) {
+        f(RecordPieces{first.subspan(start, index - start), {}});
+        start = index + 1;
+        return true;
+    });
+
+    // the record open at the end of `first` continues into `second`
+    auto carried = first.subspan(start);
+    std::size_t framed = start;
+    std::size_t next = 0; // of the current record in `second`
+    detail::for_each_match(second, delimiter, [&](std::size_t index) {
+        auto piece = second.subspan(next, index - next);
+        if (next == 0 && !carried.empty()) {
+            f(RecordPieces{carried, piece});
+            framed += carried.size();
+        } else {
+            f(RecordPieces{piece, {}});
+        }
+        framed += index - next + 1;
+        next = index + 1;
+        return true;
+    });
+    return framed;
+}
+
+/**
+ * @brief Frame every complete record in one view; see the two-view overload
+ */
+template<typename F>
+std::size_t split_records(const ZeroCopyView<std::byte>& view, std::byte delimiter, F&& f) {
+    return split_records(std::array<ZeroCopyView<std::byte>, 2>{view, ZeroCopyView<std::byte>{}},
+                         delimiter, std::forward<F>(f));
+}
+
+} // namespace oc::rb
@@ -0,0 +1,603 @@
+#pragma once
+#ifndef PIPELINE_SIM_HPP
+#define PIPELINE_SIM_HPP
+
+#include "oc/batching.hpp"
+#include "oc/bench/traffic_generator.hpp"
+#include "oc/pipe_policy.hpp"
+#include "utils/histogram.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace oc::sim {
+
+/**
+ * @file pipeline_sim.hpp
+ * @brief Offline discrete-event model of a PipeLine for capacity planning
+ *
+ * simulate() runs a pipeline_model against simulated time. The model holds
+ * the producer's traffic, each hop's ring, link and metadata policy, and the
+ * consumer's per-message cost. Every hop runs the same round as
+ * Pipe::transfer:
+ *
+ *   backward   declare src_head = dst_head and publish it upstream
+ *   forward    plan_forward() over the counters the hop has seen; move the
+ *              batch over the link, then publish the new tail downstream
+ *
+ * Both halves run concurrently and the round ends when the slower one does.
+ * Counters travel over the metadata link of the ring they describe, so a hop
+ * only sees what was published to it, as late as the link delivers it. A
+ * hop with nothing to do sleeps until a counter it reads changes, and that
+ * idle time is charged to the stall reason plan_forward() gave.
+ *
+ * The report gives end-to-end message latency percentiles (from scheduled
+ * arrival to consumption), throughput, and a time breakdown per hop. The
+ * hop with the highest utilisation is the bottleneck. A second of
+ * simulated traffic takes well under a second to run for typical batch
+ * sizes.
+ */
+
+// Simulated time for bench::traffic_generator
+struct sim_clock {
+  using duration = std::chrono::nanoseconds;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::time_point<sim_clock>;
+  static constexpr bool is_steady = true;
+};
+
+struct link_model {
+  std::chrono::nanoseconds latency{2000};
+  double bandwidth_bytes_per_ns = 12.5;  // 100 Gbit/s
+  std::chrono::nanoseconds per_transfer{0}; // posting cost per adapter op
+  std::chrono::nanoseconds jitter{0}; // mean of an exponential extra delay
+};
+
+// When a hop publishes a counter it advanced. A hop about to go idle always
+// publishes what it holds back, so deferred policies cannot deadlock.
+//
+//   round       every round that advanced it (what Pipe does)
+//   every:<n>   every n-th advance
+//   bytes:<n>   once it advanced by at least n bytes
+struct metadata_policy {
+  enum class kind { every_round, every_n, bytes };
+
+  kind type = kind::every_round;
+  uint32_t threshold = 1;
+
+  static metadata_policy parse(std::string_view spec) {
+    auto fields = bench::detail::split_spec(spec);
+    metadata_policy policy;
+    if (fields[0] == "round" && fields.size() == 1) {
+      return policy;
+    } else if (fields[0] == "every" && fields.size() == 2) {
+      policy.type = kind::every_n;
+    } else if (fields[0] == "bytes" && fields.size() == 2) {
+      policy.type = kind::bytes;
+    } else {
+      throw std::invalid_argument("invalid metadata policy '" +
+                                  std::string(spec) + "'");
+    }
+    auto value = bench::detail::parse_number(fields[1], spec);
+    if (value < 1) {
+      throw std::invalid_argument("metadata threshold must be positive in '" +
+                                  std::string(spec) + "'");
+    }
+    policy.threshold = static_cast<uint32_t>(value);
+    return policy;
+  }
+};
+
+struct hop_model {
+  uint32_t dst_capacity = 1 << 20;
+  // adapter transfers per submission when the adapter cannot scatter-gather
+  uint32_t max_in_flight = 16;
+  uint32_t max_batch_bytes = std::numeric_limits<uint32_t>::max();
+  bool scatter_gather = true;
+  link_model link;
+  link_model metadata_link;
+  metadata_policy metadata;
+  batch_policy batching; // min_bytes 0: forward as soon as anything waits
+  std::chrono::nanoseconds round_overhead{100};
+};
+
+struct pipeline_model {
+  uint32_t source_capacity = 1 << 20;
+  std::vector<hop_model> hops;
+  bench::size_distribution sizes;
+  bench::arrival_process arrivals;
+  std::chrono::nanoseconds consumer_cost{0}; // per message
+  uint64_t messages = 100000;                // 0: run for duration
+  std::chrono::nanoseconds duration{0};      // 0: run for messages
+  uint64_t seed = 1;
+};
+
+struct hop_report {
+  uint64_t bytes = 0;
+  uint64_t transfers = 0;
+  uint64_t rounds = 0;
+  uint64_t metadata_stores = 0;
+  std::chrono::nanoseconds transferring{0};
+  std::chrono::nanoseconds metadata{0}; // round time spent past the transfer
+  std::chrono::nanoseconds overhead{0};
+  std::chrono::nanoseconds stalled_source{0};
+  std::chrono::nanoseconds stalled_destination{0};
+  std::chrono::nanoseconds held_batching{0}; // waiting for a fuller batch
+
+  // share of the run this hop was working rather than waiting
+  [[nodiscard]] double utilization(std::chrono::nanoseconds elapsed) const {
+    if (elapsed.count() <= 0) {
+      return 0;
+    }
+    return static_cast<double>((transferring + metadata + overhead).count()) /
+           static_cast<double>(elapsed.count());
+  }
+};
+
+struct sim_report {
+  uint64_t messages = 0;
+  uint64_t bytes = 0;
+  std::chrono::nanoseconds elapsed{0};
+  utils::Histogram latency_ns;
+  std::vector<hop_report> hops;
+  std::size_t bottleneck = 0;
+  uint64_t events = 0;
+
+  [[nodiscard]] double messages_per_second() const {
+    return elapsed.count() > 0 ? static_cast<double>(messages) * 1e9 /
+                                     static_cast<double>(elapsed.count())
+                               : 0;
+  }
+
+  [[nodiscard]] double gbit_per_second() const {
+    return elapsed.count() > 0 ? static_cast<double>(bytes) * 8 /
+                                     static_cast<double>(elapsed.count())
+                               : 0;
+  }
+};
+
+namespace detail {
+
+class engine {
+public:
+  explicit engine(const pipeline_model &model)
+      : model_(model), hops_(model.hops.size()), rng_(model.seed + 1),
+        generator_(model.sizes, model.arrivals, sim_clock::time_point{},
+                   model.seed) {
+    validate();
+    report_.hops.resize(model.hops.size());
+    for (std::size_t i = 0; i < hops_.size(); ++i) {
+      const auto &batching = model.hops[i].batching;
+      if (batching.min_bytes > 0) {
+        hops_[i].gate.emplace(batching.min_bytes,
+                              static_cast<uint64_t>(batching.deadline.count()));
+      }
+    }
+  }
+
+  sim_report run() {
+    schedule(0, event_kind::produce);
+    for (std::size_t i = 0; i < hops_.size(); ++i) {
+      schedule(0, event_kind::round, i);
+      hops_[i].scheduled = true;
+    }
+
+    while (!finished()) {
+      if (events_.empty()) {
+        throw std::runtime_error("simulated pipeline deadlocked");
+      }
+      auto next = events_.top();
+      events_.pop();
+      now_ = next.at;
+      ++report_.events;
+      dispatch(next);
+    }
+
+    report_.elapsed = std::chrono::nanoseconds(consumer_.last_done);
+    for (std::size_t i = 0; i < hops_.size(); ++i) {
+      settle_idle(i, consumer_.last_done);
+      if (report_.hops[i].utilization(report_.elapsed) >
+          report_.hops[report_.bottleneck].utilization(report_.elapsed)) {
+        report_.bottleneck = i;
+      }
+    }
+    return std::move(report_);
+  }
+
+private:
+  using sim_time = int64_t; // simulated ns
+
+  enum class event_kind {
+    round,
+    tail_visible,
+    head_visible,
+    produce,
+    batch_due
+  };
+
+  struct event {
+    sim_time at;
+    uint64_t sequence;
+    event_kind kind;
+    std::size_t index; // hop or ring
+    uint64_t value;    // counter for *_visible
+
+    bool operator>(const event &other) const {
+      return at != other.at ? at > other.at : sequence > other.sequence;
+    }
+  };
+
+  enum class waiting { none, source, destination, batch };
+
+  struct hop_state {
+    uint64_t src_tail_seen = 0; // tail of ring i published to us
+    uint64_t dst_head_seen = 0; // head of ring i + 1 published to us
+    uint64_t dst_tail = 0;      // forwarding cursor
+    uint64_t published_tail = 0;
+    uint64_t published_head = 0;
+    uint32_t tail_advances = 0; // since the last tail publish
+    uint32_t head_advances = 0;
+    bool scheduled = false;
+    waiting idle = waiting::none;
+    sim_time idle_since = 0;
+    std::optional<BatchGate> gate;
+  };
+
+  struct message {
+    uint64_t end;
+    sim_time due;
+  };
+
+  void validate() const {
+    if (model_.hops.empty()) {
+      throw std::invalid_argument("pipeline model has no hops");
+    }
+    if (model_.messages == 0 && model_.duration.count() <= 0) {
+      throw std::invalid_argument("pipeline model needs messages or duration");
+    }
+    // the chain frees a source slot only once the consumer releases it, so
+    // every message must fit into every ring at once
+    auto smallest = model_.source_capacity;
+    for (const auto &hop : model_.hops) {
+      smallest = std::min(smallest, hop.dst_capacity);
+      if (hop.link.bandwidth_bytes_per_ns <= 0 ||
+          hop.metadata_link.bandwidth_bytes_per_ns <= 0) {
+        throw std::invalid_argument("link bandwidth must be positive");
+      }
+      if (hop.max_in_flight == 0 || hop.max_batch_bytes == 0) {
+        throw std::invalid_argument("hop needs a positive depth and batch");
+      }
+    }
+    if (model_.sizes.max_bytes > smallest) {
+      throw std::invalid_argument("largest message does not fit in a ring");
+    }
+  }
+
+  void schedule(sim_time at, event_kind kind, std::size_t index = 0,
+                uint64_t value = 0) {
+    events_.push({at, sequence_++, kind, index, value});
+  }
+
+  void dispatch(const event &e) {
+    switch (e.kind) {
+    case event_kind::round:
+      round(e.index);
+      break;
+    case event_kind::tail_visible:
+      tail_visible(e.index, e.value);
+      break;
+    case event_kind::head_visible:
+      head_visible(e.index, e.value);
+      break;
+    case event_kind::produce:
+      producer_.wake_pending = false;
+      produce();
+      break;
+    case event_kind::batch_due:
+      wake(e.index);
+      break;
+    }
+  }
+
+  sim_time link_time(const link_model &link, uint64_t bytes,
+                 uint64_t transfers) {
+    auto wire = static_cast<sim_time>(static_cast<double>(bytes) /
+                                  link.bandwidth_bytes_per_ns);
+    auto extra = sim_time{0};
+    if (link.jitter.count() > 0) {
+      extra = static_cast<sim_time>(std::exponential_distribution<double>(
+          1.0 / static_cast<double>(link.jitter.count()))(rng_));
+    }
+    return static_cast<sim_time>(transfers) * link.per_transfer.count() + wire +
+           link.latency.count() + extra;
+  }
+
+  // metadata of ring r crosses the link of the hop writing into it; the
+  // source ring sits next to the producer and first hop
+  sim_time metadata_time(std::size_t ring) {
+    if (ring == 0) {
+      return 0;
+    }
+    return link_time(model_.hops[ring - 1].metadata_link, sizeof(uint32_t), 1);
+  }
+
+  uint64_t ring_capacity(std::size_t ring) const {
+    return ring == 0 ? model_.source_capacity
+                     : model_.hops[ring - 1].dst_capacity;
+  }
+
+  bool should_publish(const metadata_policy &policy, uint64_t value,
+                      uint64_t published, uint32_t advances,
+                      bool flush) const {
+    if (value == published) {
+      return false;
+    }
+    if (flush) {
+      return true;
+    }
+    switch (policy.type) {
+    case metadata_policy::kind::every_round:
+      return true;
+    case metadata_policy::kind::every_n:
+      return advances >= policy.threshold;
+    case metadata_policy::kind::bytes:
+      return value - published >= policy.threshold;
+    }
+    return true;
+  }
+
+  // the reader of ring r sees its tail advance to `tail`
+  void tail_visible(std::size_t ring, uint64_t tail) {
+    if (ring == hops_.size()) {
+      consumer_.tail_seen = std::max(consumer_.tail_seen, tail);
+      consume();
+      return;
+    }
+    auto &hop = hops_[ring];
+    hop.src_tail_seen = std::max(hop.src_tail_seen, tail);
+    wake(ring);
+  }
+
+  // the writer of ring r sees its head advance to `head`
+  void head_visible(std::size_t ring, uint64_t head) {
+    if (ring == 0) {
+      producer_.head_seen = std::max(producer_.head_seen, head);
+      produce();
+      return;
+    }
+    auto &hop = hops_[ring - 1];
+    hop.dst_head_seen = std::max(hop.dst_head_seen, head);
+    wake(ring - 1);
+  }
+
+  // charge the idle stretch of hop i up to `until` to its stall reason
+  void settle_idle(std::size_t i, sim_time until) {
+    auto &hop = hops_[i];
+    auto &report = report_.hops[i];
+    auto idle = std::chrono::nanoseconds(until - hop.idle_since);
+    if (idle.count() > 0) {
+      if (hop.idle == waiting::source) {
+        report.stalled_source += idle;
+      } else if (hop.idle == waiting::destination) {
+        report.stalled_destination += idle;
+      } else if (hop.idle == waiting::batch) {
+        report.held_batching += idle;
+      }
+    }
+    hop.idle = waiting::none;
+  }
+
+  void wake(std::size_t i) {
+    auto &hop = hops_[i];
+    if (hop.scheduled) {
+      return;
+    }
+    settle_idle(i, now_);
+    hop.scheduled = true;
+    schedule(now_, event_kind::round, i);
+  }
+
+  void round(std::size_t i) {
+    auto &hop = hops_[i];
+    const auto &config = model_.hops[i];
+    auto &report = report_.hops[i];
+    auto start = now_;
+    auto overhead = config.round_overhead.count();
+    ++report.rounds;
+
+    auto plan = plan_forward(static_cast<uint32_t>(hop.src_tail_seen),
+                             static_cast<uint32_t>(hop.dst_tail),
+                             static_cast<uint32_t>(hop.dst_head_seen),
+                             config.dst_capacity, config.max_batch_bytes);
+    bool moved = plan.outcome == forward_outcome::move;
+    bool held = moved && hop.gate &&
+                !hop.gate->ready(hop.src_tail_seen - hop.dst_tail,
+                                 static_cast<uint64_t>(start));
+    moved = moved && !held;
+    auto flush = !moved;
+
+    // backward: src_head follows dst_head
+    sim_time backward = 0;
+    auto src_head = hop.dst_head_seen;
+    if (src_head != hop.published_head) {
+      ++hop.head_advances;
+    }
+    if (should_publish(config.metadata, src_head, hop.published_head,
+                       hop.head_advances, flush)) {
+      backward = metadata_time(i);
+      hop.published_head = src_head;
+      hop.head_advances = 0;
+      ++report.metadata_stores;
+      schedule(start + overhead + backward, event_kind::head_visible, i,
+               src_head);
+    }
+
+    // forward: one submission, then the tail
+    sim_time transfer = 0;
+    if (moved) {
+      uint64_t bytes = plan.bytes;
+      uint64_t transfers = 1;
+      if (!config.scatter_gather) {
+        // one transfer per piece, at most max_in_flight of them
+        transfers = 0;
+        bytes = for_each_ring_piece(
+            ring_capacity(i), config.dst_capacity, hop.dst_tail, bytes,
+            std::numeric_limits<std::size_t>::max(), config.max_in_flight,
+            [&](std::size_t, std::size_t, std::size_t) { ++transfers; });
+      }
+      transfer = link_time(config.link, bytes, transfers);
+      hop.dst_tail += bytes;
+      ++hop.tail_advances;
+      if (hop.gate) {
+        hop.gate->forwarded(hop.src_tail_seen - hop.dst_tail);
+      }
+      report.bytes += bytes;
+      report.transfers += transfers;
+    }
+    sim_time forward = transfer;
+    if (should_publish(config.metadata, hop.dst_tail, hop.published_tail,
+                       hop.tail_advances, flush)) {
+      auto tail = hop.dst_tail;
+      forward += metadata_time(i + 1);
+      hop.published_tail = tail;
+      hop.tail_advances = 0;
+      ++report.metadata_stores;
+      schedule(start + overhead + forward, event_kind::tail_visible, i + 1,
+               tail);
+    }
+
+    auto busy = std::max(forward, backward);
+    report.overhead += std::chrono::nanoseconds(overhead);
+    report.transferring += std::chrono::nanoseconds(transfer);
+    report.metadata += std::chrono::nanoseconds(busy - transfer);
+    auto end = start + overhead + busy;
+
+    if (moved || busy > 0) {
+      schedule(end, event_kind::round, i);
+      return;
+    }
+    // nothing to do: sleep until a counter we read changes
+    hop.scheduled = false;
+    hop.idle = held ? waiting::batch
+               : plan.outcome == forward_outcome::source_empty
+                   ? waiting::source
+                   : waiting::destination;
+    hop.idle_since = end;
+    if (held) {
+      schedule(static_cast<sim_time>(hop.gate->due()), event_kind::batch_due,
+               i);
+    }
+  }
+
+  bool producing() const {
+    if (model_.messages > 0 && producer_.sent >= model_.messages) {
+      return false;
+    }
+    if (model_.duration.count() > 0) {
+      // max rate has no schedule; it offers load until the clock runs out
+      auto offered = generator_.arrivals().type ==
+                             bench::arrival_process::kind::max
+                         ? now_
+                         : generator_.peek().due.time_since_epoch().count();
+      return offered < model_.duration.count();
+    }
+    return true;
+  }
+
+  void produce() {
+    while (producing()) {
+      const auto &next = generator_.peek();
+      auto due = next.due.time_since_epoch().count();
+      bool max_rate =
+          generator_.arrivals().type == bench::arrival_process::kind::max;
+      if (!max_rate && due > now_) {
+        if (!producer_.wake_pending) {
+          producer_.wake_pending = true;
+          schedule(due, event_kind::produce);
+        }
+        return;
+      }
+      if (model_.source_capacity - (producer_.tail - producer_.head_seen) <
+          next.bytes) {
+        return; // back-pressure; retried when the head moves
+      }
+      producer_.tail += next.bytes;
+      in_flight_.push_back({producer_.tail, max_rate ? now_ : due});
+      ++producer_.sent;
+      generator_.pop();
+      tail_visible(0, producer_.tail);
+    }
+  }
+
+  void consume() {
+    auto at = std::max(now_, consumer_.busy_until);
+    auto head = consumer_.head;
+    while (!in_flight_.empty() && in_flight_.front().end <= consumer_.tail_seen) {
+      auto done = in_flight_.front();
+      in_flight_.pop_front();
+      at += model_.consumer_cost.count();
+      report_.latency_ns.record(static_cast<uint64_t>(at - done.due));
+      report_.bytes += done.end - head;
+      ++report_.messages;
+      head = done.end;
+      consumer_.last_done = at;
+    }
+    if (head == consumer_.head) {
+      return;
+    }
+    consumer_.head = head;
+    consumer_.busy_until = at;
+    auto ring = hops_.size();
+    schedule(at + metadata_time(ring), event_kind::head_visible, ring, head);
+  }
+
+  bool finished() const {
+    return !producing() && in_flight_.empty() && producer_.sent > 0;
+  }
+
+  const pipeline_model &model_;
+  std::vector<hop_state> hops_;
+  std::priority_queue<event, std::vector<event>, std::greater<>> events_;
+  uint64_t sequence_ = 0;
+  sim_time now_ = 0;
+  std::mt19937_64 rng_;
+  bench::traffic_generator<sim_clock> generator_;
+  std::deque<message> in_flight_;
+
+  struct {
+    uint64_t tail = 0;
+    uint64_t head_seen = 0;
+    uint64_t sent = 0;
+    bool wake_pending = false;
+  } producer_;
+
+  struct {
+    uint64_t tail_seen = 0;
+    uint64_t head = 0;
+    sim_time busy_until = 0;
+    sim_time last_done = 0;
+  } consumer_;
+
+  sim_report report_;
+};
+
+} // namespace detail
+
+inline sim_report simulate(const pipeline_model &model) {
+  return detail::engine(model).run();
+}
+
+} // namespace oc::sim
+
+#endif
@@ -0,0 +1,157 @@
+#include "stats_page.hpp"
+
+#include "utils/tsc_clock.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <memory>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace oc {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char *what) {
+  throw std::system_error(errno, std::system_category(), what);
+}
+
+void *map(int fd, std::size_t size, int protection) {
+  void *memory = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+  int saved = errno;
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    errno = saved;
+    throw_errno("mmap(stats file) failed");
+  }
+  return memory;
+}
+
+} // namespace
+
+StatsFile StatsFile::create(const std::string &path, uint32_t num_pipes) {
+  if (num_pipes == 0) {
+    throw std::invalid_argument("Stats file needs at least one pipe");
+  }
+  auto size = size_bytes(num_pipes);
+
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw_errno("open(stats file) failed");
+  }
+  if (::ftruncate(fd, static_cast<off_t>(size)) < 0) {
+    int saved = errno;
+    ::close(fd);
+    errno = saved;
+    throw_errno("ftruncate(stats file) failed");
+  }
+  auto *memory = map(fd, size, PROT_READ | PROT_WRITE);
+
+  // ftruncate zero-fills, so the magic stays unset until the header is done
+  auto *header = std::construct_at(static_cast<StatsFileHeader *>(memory));
+  header->version = StatsFileHeader::current_version;
+  header->num_pipes = num_pipes;
+  header->header_size = sizeof(StatsFileHeader);
+  header->slot_size = sizeof(PipeStatsSlot);
+  header->pid = static_cast<int32_t>(::getpid());
+  header->ns_per_tick = utils::tsc_clock::ns_per_tick();
+
+  StatsFile file(path, memory, size, true);
+  for (uint32_t pipe = 0; pipe < num_pipes; ++pipe) {
+    std::construct_at(file.slots() + pipe);
+  }
+  header->magic.store(StatsFileHeader::expected_magic,
+                      std::memory_order_release);
+  return file;
+}
+
+StatsFile StatsFile::attach(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw_errno("open(stats file) failed");
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) < 0) {
+    int saved = errno;
+    ::close(fd);
+    errno = saved;
+    throw_errno("fstat(stats file) failed");
+  }
+  auto size = static_cast<std::size_t>(info.st_size);
+  if (size < sizeof(StatsFileHeader)) {
+    ::close(fd);
+    throw std::runtime_error("Stats file too small for its header");
+  }
+
+  StatsFile file(path, map(fd, size, PROT_READ), size, false);
+  const auto &header = file.header();
+  if (header.magic.load(std::memory_order_acquire) !=
+      StatsFileHeader::expected_magic) {
+    throw std::runtime_error("Not a stats file, or not initialised yet");
+  }
+  if (header.version != StatsFileHeader::current_version ||
+      header.header_size != sizeof(StatsFileHeader) ||
+      header.slot_size != sizeof(PipeStatsSlot)) {
+    throw std::runtime_error("Stats file layout version mismatch");
+  }
+  if (size < size_bytes(header.num_pipes)) {
+    throw std::runtime_error("Stats file truncated");
+  }
+  return file;
+}
+
+StatsFile::StatsFile(StatsFile &&other) noexcept
+    : path_(std::move(other.path_)),
+      memory_(std::exchange(other.memory_, nullptr)),
+      size_(std::exchange(other.size_, 0)), writable_(other.writable_) {}
+
+StatsFile &StatsFile::operator=(StatsFile &&other) noexcept {
+  if (this != &other) {
+    if (memory_) {
+      ::munmap(memory_, size_);
+    }
+    path_ = std::move(other.path_);
+    memory_ = std::exchange(other.memory_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    writable_ = other.writable_;
+  }
+  return *this;
+}
+
+StatsFile::~StatsFile() {
+  if (memory_) {
+    ::munmap(memory_, size_);
+  }
+}
+
+PipeStatsSlot *StatsFile::slots() const noexcept {
+  return reinterpret_cast<PipeStatsSlot *>(static_cast<std::byte *>(memory_) +
+                                           sizeof(StatsFileHeader));
+}
+
+PipeStatsSlot &StatsFile::writer_slot(uint32_t pipe) {
+  if (!writable_) {
+    throw std::logic_error("Stats file attached read-only");
+  }
+  if (pipe >= num_pipes()) {
+    throw std::out_of_range("Stats slot out of range");
+  }
+  return slots()[pipe];
+}
+
+const PipeStatsSlot &StatsFile::slot(uint32_t pipe) const {
+  if (pipe >= num_pipes()) {
+    throw std::out_of_range("Stats slot out of range");
+  }
+  return slots()[pipe];
+}
+
+void StatsFile::unlink() const {
+  if (::unlink(path_.c_str()) < 0 && errno != ENOENT) {
+    throw_errno("unlink(stats file) failed");
+  }
+}
+
+} // namespace oc
@@ -0,0 +1,202 @@
+#pragma once
+#ifndef STATS_PAGE_HPP
+#define STATS_PAGE_HPP
+
+#include "oc/rb/basic_rb.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace oc {
+
+/**
+ * @file stats_page.hpp
+ * @brief Live pipe counters in a memory-mapped file for external monitors
+ *
+ * A StatsFile is a header followed by one slot per pipe:
+ *
+ *   [StatsFileHeader][PipeStatsSlot, pipe 0]...[PipeStatsSlot, pipe N-1]
+ *
+ * Each pipe keeps its counters in plain memory on the data path and copies
+ * them into its slot once per round under a seqlock. A monitor maps the file
+ * read-only and retries a slot until it gets a copy no write overlapped, so
+ * it never takes a lock, never writes to shared memory and cannot stall the
+ * pipe. Slots are cache-line aligned and written by one pipe each.
+ *
+ * The layout is versioned: a monitor refuses files whose magic, version or
+ * slot size differ from its own. Durations are stored in the writer's
+ * utils::tsc_clock ticks; the header carries the conversion factor.
+ */
+
+// Counters of one pipe. Plain 64-bit words only, so a slot can copy them
+// word by word; append fields and bump StatsFileHeader::current_version.
+struct PipeStats {
+  uint64_t bytes_issued = 0;
+  uint64_t transfers_issued = 0;
+  uint64_t in_flight = 0; // adapter transfers of the current submission
+
+  uint64_t src_head = 0;
+  uint64_t src_tail = 0;
+  uint64_t dst_head = 0;
+  uint64_t dst_tail = 0;
+
+  // rounds that moved nothing, by reason
+  uint64_t stall_source_empty = 0;
+  uint64_t stall_destination_full = 0;
+  // metadata stores that did not complete inline, and the ticks spent on
+  // every store
+  uint64_t stall_metadata = 0;
+  uint64_t metadata_wait_ticks = 0;
+
+  uint64_t rounds = 0;
+  uint64_t round_ticks_total = 0;
+  uint64_t round_ticks_max = 0;
+  uint64_t round_ticks_last = 0;
+
+  // limits chosen by an attached PipeTuner; 0 when untuned
+  uint64_t chunk_limit = 0;
+  uint64_t depth_limit = 0;
+
+  // rounds a batch policy held back waiting for more records
+  uint64_t held_batching = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<PipeStats>);
+static_assert(sizeof(PipeStats) % sizeof(uint64_t) == 0);
+
+/**
+ * @brief Seqlock-protected copy of one pipe's PipeStats
+ *
+ * publish() is single-writer. read() may run concurrently in any process
+ * that maps the slot, even read-only.
+ */
+class alignas(rb::cache_line_size) PipeStatsSlot {
+public:
+  static constexpr std::size_t words = sizeof(PipeStats) / sizeof(uint64_t);
+
+  void publish(const PipeStats &stats) noexcept {
+    uint64_t source[words];
+    std::memcpy(source, &stats, sizeof(stats));
+
+    auto sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < words; ++i) {
+      words_[i].store(source[i], std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  // Consistent copy, or nullopt if every attempt overlapped a write (or the
+  // writer died halfway through one).
+  [[nodiscard]] std::optional<PipeStats>
+  read(int attempts = 64) const noexcept {
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+      auto before = sequence_.load(std::memory_order_acquire);
+      if (before & 1) {
+        continue;
+      }
+      uint64_t copy[words];
+      for (std::size_t i = 0; i < words; ++i) {
+        copy[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence_.load(std::memory_order_relaxed) == before) {
+        PipeStats stats;
+        std::memcpy(&stats, copy, sizeof(stats));
+        return stats;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // number of completed publishes
+  [[nodiscard]] uint64_t generation() const noexcept {
+    return sequence_.load(std::memory_order_acquire) / 2;
+  }
+
+private:
+  std::atomic<uint64_t> sequence_{0};
+  std::atomic<uint64_t> words_[words] = {};
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+struct alignas(rb::cache_line_size) StatsFileHeader {
+  static constexpr uint64_t expected_magic = 0x5354415453434f00; // "\0OCSTATS"
+  static constexpr uint32_t current_version = 3;
+
+  // written last by the creator, so a complete header is visible once it
+  // matches
+  std::atomic<uint64_t> magic;
+  uint32_t version;
+  uint32_t num_pipes;
+  uint32_t header_size;
+  uint32_t slot_size;
+  int32_t pid;
+  uint32_t reserved;
+  double ns_per_tick;
+};
+
+/**
+ * @brief A mapped stats file, either as its writer or as a read-only monitor
+ *
+ * create() sizes and maps a new file (typically under /dev/shm) and lays out
+ * zeroed slots; attach() maps an existing one read-only after checking its
+ * layout. The file stays on disk after the writer exits, so a monitor can
+ * read the final counters; the creator removes it with unlink().
+ */
+class StatsFile {
+public:
+  static StatsFile create(const std::string &path, uint32_t num_pipes);
+  static StatsFile attach(const std::string &path);
+
+  StatsFile(StatsFile &&other) noexcept;
+  StatsFile &operator=(StatsFile &&other) noexcept;
+  ~StatsFile();
+
+  StatsFile(const StatsFile &) = delete;
+  StatsFile &operator=(const StatsFile &) = delete;
+
+  [[nodiscard]] const StatsFileHeader &header() const noexcept {
+    return *static_cast<const StatsFileHeader *>(memory_);
+  }
+
+  [[nodiscard]] uint32_t num_pipes() const noexcept {
+    return header().num_pipes;
+  }
+
+  // Slot a pipe publishes into; throws on a read-only attachment.
+  [[nodiscard]] PipeStatsSlot &writer_slot(uint32_t pipe);
+
+  [[nodiscard]] const PipeStatsSlot &slot(uint32_t pipe) const;
+
+  [[nodiscard]] const std::string &path() const noexcept { return path_; }
+
+  void unlink() const;
+
+  static constexpr std::size_t size_bytes(uint32_t num_pipes) noexcept {
+    return sizeof(StatsFileHeader) + num_pipes * sizeof(PipeStatsSlot);
+  }
+
+private:
+  StatsFile(std::string path, void *memory, std::size_t size, bool writable)
+      : path_(std::move(path)), memory_(memory), size_(size),
+        writable_(writable) {}
+
+  [[nodiscard]] PipeStatsSlot *slots() const noexcept;
+
+  std::string path_;
+  void *memory_ = nullptr;
+  std::size_t size_ = 0;
+  bool writable_ = false;
+};
+
+} // namespace oc
+
+#endif
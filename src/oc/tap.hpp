@@ -1,3 +1,6 @@
+#pragma once
+#include "utils/tsc_clock.hpp"
+#include <functional>
 #include <stdexec/execution.hpp>
 #include <tuple>
 #include <type_traits>
@@ -111,3 +114,28 @@ struct tap_t {
 
 // Usage: s | tap([](auto const&...) { /*observe*/ });
 inline constexpr tap_t tap{};
+
+
+// Side effect that also receives the completion time in utils::tsc_clock
+// ticks, taken once per value completion.
+template <class F> struct stamped_fn {
+  F f_;
+
+  template <class... As> void operator()(const As &...as) {
+    std::invoke(f_, oc::utils::tsc_clock::now(), as...);
+  }
+};
+
+struct tap_stamped_t {
+  template <class S, class F> auto operator()(S &&s, F &&f) const {
+    return tap(std::forward<S>(s),
+               stamped_fn<std::decay_t<F>>{std::forward<F>(f)});
+  }
+
+  template <class F> auto operator()(F &&f) const {
+    return tap(stamped_fn<std::decay_t<F>>{std::forward<F>(f)});
+  }
+};
+
+// Usage: s | tap_stamped([](uint64_t ticks, auto const&...) { /*observe*/ });
+inline constexpr tap_stamped_t tap_stamped{};
@@ -0,0 +1,239 @@
+#pragma once
+#include "utils/histogram.hpp"
+#include "utils/tsc_clock.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+namespace oc {
+
+/**
+ * @brief Sampled per-record latency tracing through a PipeLine
+ *
+ * Records are identified by stream position: under the symmetric transfer
+ * assumption every pipe of a line shares one byte index space, so the end
+ * offset of a record names it at every hop without touching the payload.
+ * Sampled records live in a side-band ring of spans owned by the tracer:
+ *
+ *   producer   produced(end)        before publishing the record's tail;
+ *                                   samples one record in `sample_every`
+ *   hop i      arrived / departed   called by the pipe around each forward
+ *                                   transfer with the end of the moved range
+ *   consumer   consumed(head)       after releasing everything up to head;
+ *                                   finished spans go into the breakdown
+ *
+ * The breakdown splits each traced record's end-to-end time into, per hop,
+ * the time it waited before the hop picked it up (from production or the
+ * previous hop's departure) and the time the hop's transfer took, plus the
+ * delivery time from the last departure to consumption.
+ *
+ * Each role is single-threaded: one producer, one progress thread per hop
+ * and one consumer, which may all differ. When every span is in flight the
+ * producer skips the sample and counts it in dropped().
+ */
+class PipeTracer {
+public:
+  using ticks = utils::tsc_clock::ticks;
+
+  struct breakdown {
+    utils::Histogram end_to_end;
+    std::vector<utils::Histogram> wait;     // per hop, before pickup
+    std::vector<utils::Histogram> transfer; // per hop, pickup to departure
+    utils::Histogram delivery;              // last departure to consumption
+    uint64_t traced = 0;
+    uint64_t dropped = 0;
+  };
+
+  PipeTracer(uint32_t sample_every, std::size_t hops,
+             std::size_t max_in_flight = 1024)
+      : sample_every_(sample_every), hops_(hops), capacity_(max_in_flight),
+        spans_(new span[max_in_flight]),
+        stamps_(new std::atomic<ticks>[max_in_flight * 2 * hops]()),
+        cursors_(new hop_cursor[hops]), wait_(hops), transfer_(hops) {
+    if (sample_every == 0 || hops == 0 || max_in_flight == 0) {
+      throw std::invalid_argument(
+          "PipeTracer needs a sampling interval, hops and spans");
+    }
+    for (std::size_t hop = 0; hop < hops; ++hop) {
+      wait_[hop] = std::make_unique<utils::ConcurrentHistogram>();
+      transfer_[hop] = std::make_unique<utils::ConcurrentHistogram>();
+    }
+  }
+
+  PipeTracer(const PipeTracer &) = delete;
+  PipeTracer &operator=(const PipeTracer &) = delete;
+
+  [[nodiscard]] std::size_t hops() const noexcept { return hops_; }
+
+  // Producer: a record ending at stream position `end` is about to be
+  // published. Returns its trace id, or 0 when it is not sampled.
+  uint64_t produced(uint32_t end) noexcept {
+    if (++records_ % sample_every_ != 0) {
+      return 0;
+    }
+    auto seq = published_.load(std::memory_order_relaxed);
+    if (seq - retired_.load(std::memory_order_acquire) == capacity_) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+    }
+
+    auto &s = spans_[seq % capacity_];
+    s.id = seq + 1;
+    s.end = end;
+    s.produced = utils::tsc_clock::now();
+    for (std::size_t i = 0; i < 2 * hops_; ++i) {
+      stamps_[seq % capacity_ * 2 * hops_ + i].store(
+          0, std::memory_order_relaxed);
+    }
+    published_.store(seq + 1, std::memory_order_release);
+    return s.id;
+  }
+
+  // Hop `hop` picked up every byte before `end`.
+  void arrived(std::size_t hop, uint32_t end,
+               ticks now = utils::tsc_clock::now()) noexcept {
+    stamp(hop, cursors_[hop].arrived, 0, end, now);
+  }
+
+  // Hop `hop` delivered every byte before `end` downstream.
+  void departed(std::size_t hop, uint32_t end,
+                ticks now = utils::tsc_clock::now()) noexcept {
+    stamp(hop, cursors_[hop].departed, 1, end, now);
+  }
+
+  // Consumer: every byte before `head` was consumed. Returns the number of
+  // spans finished.
+  std::size_t consumed(uint32_t head,
+                       ticks now = utils::tsc_clock::now()) noexcept {
+    if (!end_to_end_recorder_) {
+      bind_consumer();
+    }
+
+    auto seq = retired_.load(std::memory_order_relaxed);
+    auto published = published_.load(std::memory_order_acquire);
+    std::size_t finished = 0;
+    for (; seq != published && covers(head, spans_[seq % capacity_].end);
+         ++seq, ++finished) {
+      finish(seq % capacity_, now);
+    }
+    retired_.store(seq, std::memory_order_release);
+    return finished;
+  }
+
+  // Per-hop breakdown in nanoseconds; safe while tracing is running.
+  [[nodiscard]] breakdown snapshot() const {
+    auto scale = utils::tsc_clock::ns_per_tick();
+    breakdown result;
+    result.end_to_end = end_to_end_.snapshot().rescaled(scale);
+    result.delivery = delivery_.snapshot().rescaled(scale);
+    for (std::size_t hop = 0; hop < hops_; ++hop) {
+      result.wait.push_back(wait_[hop]->snapshot().rescaled(scale));
+      result.transfer.push_back(transfer_[hop]->snapshot().rescaled(scale));
+    }
+    result.traced = result.end_to_end.count();
+    result.dropped = dropped_.load(std::memory_order_relaxed);
+    return result;
+  }
+
+private:
+  struct span {
+    uint64_t id;
+    uint32_t end;
+    ticks produced;
+  };
+
+  // written only by the hop's progress thread
+  struct alignas(64) hop_cursor {
+    uint64_t arrived = 0;
+    uint64_t departed = 0;
+  };
+
+  // wrap-safe `position >= end` on the 32-bit ring counters
+  static bool covers(uint32_t position, uint32_t end) noexcept {
+    return static_cast<int32_t>(position - end) >= 0;
+  }
+
+  std::atomic<ticks> &stamp_at(std::size_t slot, std::size_t hop,
+                               std::size_t which) noexcept {
+    return stamps_[slot * 2 * hops_ + hop * 2 + which];
+  }
+
+  void stamp(std::size_t hop, uint64_t &cursor, std::size_t which,
+             uint32_t end, ticks now) noexcept {
+    auto published = published_.load(std::memory_order_acquire);
+    // skip spans retired while this hop was idle; their slots may be reused
+    if (auto retired = retired_.load(std::memory_order_acquire);
+        cursor < retired) {
+      cursor = retired;
+    }
+    for (; cursor != published && covers(end, spans_[cursor % capacity_].end);
+         ++cursor) {
+      stamp_at(cursor % capacity_, hop, which)
+          .store(now, std::memory_order_release);
+    }
+  }
+
+  void bind_consumer() {
+    end_to_end_recorder_ = end_to_end_.recorder();
+    delivery_recorder_ = delivery_.recorder();
+    for (std::size_t hop = 0; hop < hops_; ++hop) {
+      wait_recorders_.push_back(wait_[hop]->recorder());
+      transfer_recorders_.push_back(transfer_[hop]->recorder());
+    }
+  }
+
+  // stamps can be a few ticks apart in the wrong order across cores
+  static uint64_t elapsed(ticks from, ticks to) noexcept {
+    return to > from ? to - from : 0;
+  }
+
+  void finish(std::size_t slot, ticks now) noexcept {
+    const auto &s = spans_[slot];
+    auto previous = s.produced;
+    for (std::size_t hop = 0; hop < hops_; ++hop) {
+      auto arrival = stamp_at(slot, hop, 0).load(std::memory_order_acquire);
+      auto departure = stamp_at(slot, hop, 1).load(std::memory_order_acquire);
+      if (arrival == 0 || departure == 0) {
+        return; // the record bypassed a hop that is not traced
+      }
+      wait_recorders_[hop].record(elapsed(previous, arrival));
+      transfer_recorders_[hop].record(elapsed(arrival, departure));
+      previous = departure;
+    }
+    delivery_recorder_.record(elapsed(previous, now));
+    end_to_end_recorder_.record(elapsed(s.produced, now));
+  }
+
+  uint32_t sample_every_;
+  std::size_t hops_;
+  std::size_t capacity_;
+  std::unique_ptr<span[]> spans_;
+  std::unique_ptr<std::atomic<ticks>[]> stamps_; // [span][hop][arrival, dep.]
+  std::unique_ptr<hop_cursor[]> cursors_;
+
+  // producer
+  uint64_t records_ = 0;
+  alignas(64) std::atomic<uint64_t> published_{0};
+  alignas(64) std::atomic<uint64_t> retired_{0};
+  std::atomic<uint64_t> dropped_{0};
+
+  utils::ConcurrentHistogram end_to_end_;
+  utils::ConcurrentHistogram delivery_;
+  std::vector<std::unique_ptr<utils::ConcurrentHistogram>> wait_;
+  std::vector<std::unique_ptr<utils::ConcurrentHistogram>> transfer_;
+
+  // consumer
+  utils::ConcurrentHistogram::Recorder end_to_end_recorder_;
+  utils::ConcurrentHistogram::Recorder delivery_recorder_;
+  std::vector<utils::ConcurrentHistogram::Recorder> wait_recorders_;
+  std::vector<utils::ConcurrentHistogram::Recorder> transfer_recorders_;
+};
+
+} // namespace oc
+
+#endif
@@ -0,0 +1,410 @@
+#pragma once
+
+#ifndef UTILS_HISTOGRAM_HPP
+#define UTILS_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace oc::utils {
+
+// Log-linear bucketing shared by all histogram flavours (HDR style).
+//
+// Values below 2^SubBucketBits get one bucket each. Above that every power of
+// two is split into 2^(SubBucketBits - 1) equal buckets, so the relative error
+// of any recorded value is below 2^-(SubBucketBits - 1): 1.6% for the default
+// of 7 bits, across the whole uint64_t range, in 3776 buckets.
+template <unsigned SubBucketBits = 7> struct HistogramLayout {
+  static_assert(SubBucketBits >= 2 && SubBucketBits < 32);
+
+  static constexpr unsigned sub_bucket_bits = SubBucketBits;
+  static constexpr std::size_t linear_buckets = std::size_t{1}
+                                                << SubBucketBits;
+  static constexpr std::size_t half = linear_buckets / 2;
+  static constexpr std::size_t bucket_count =
+      linear_buckets + (64 - SubBucketBits) * half;
+
+  static constexpr std::size_t index_of(uint64_t value) noexcept {
+    if (value < linear_buckets) {
+      return static_cast<std::size_t>(value);
+    }
+    auto width = static_cast<unsigned>(std::bit_width(value));
+    auto shift = width - SubBucketBits;
+    // top SubBucketBits bits of value, always in [half, linear_buckets)
+    auto top = static_cast<std::size_t>(value >> shift);
+    return linear_buckets + (shift - 1) * half + (top - half);
+  }
+
+  // smallest value that lands in bucket `index`
+  static constexpr uint64_t lower_bound(std::size_t index) noexcept {
+    if (index < linear_buckets) {
+      return index;
+    }
+    auto shift = (index - linear_buckets) / half + 1;
+    auto top = (index - linear_buckets) % half + half;
+    return static_cast<uint64_t>(top) << shift;
+  }
+
+  // largest value that lands in bucket `index`
+  static constexpr uint64_t upper_bound(std::size_t index) noexcept {
+    if (index < linear_buckets) {
+      return index;
+    }
+    auto shift = (index - linear_buckets) / half + 1;
+    return lower_bound(index) + ((uint64_t{1} << shift) - 1);
+  }
+
+  // value reported for samples in bucket `index`
+  static constexpr uint64_t midpoint(std::size_t index) noexcept {
+    return lower_bound(index) + (upper_bound(index) - lower_bound(index)) / 2;
+  }
+};
+
+/**
+ * @brief Single-threaded log-linear histogram
+ *
+ * Plain counters, no synchronisation. Used directly where one thread owns
+ * the data, and as the merged result of a ConcurrentHistogram snapshot.
+ *
+ * Export formats:
+ * - serialize()/deserialize(): compact binary, only non-empty buckets as
+ *   varint (index delta, count) pairs
+ * - to_text(): percentile table, one "value percentile count" row per line
+ */
+template <unsigned SubBucketBits = 7> class BasicHistogram {
+public:
+  using layout = HistogramLayout<SubBucketBits>;
+
+  BasicHistogram() : counts_(layout::bucket_count, 0) {}
+
+  void record(uint64_t value, uint64_t count = 1) noexcept {
+    counts_[layout::index_of(value)] += count;
+    total_ += count;
+  }
+
+  void merge(const BasicHistogram &other) noexcept {
+    for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+      counts_[i] += other.counts_[i];
+    }
+    total_ += other.total_;
+  }
+
+  // samples recorded since `earlier`, a previous snapshot of the same source
+  [[nodiscard]] BasicHistogram since(const BasicHistogram &earlier) const {
+    BasicHistogram delta;
+    for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+      delta.counts_[i] = counts_[i] - earlier.counts_[i];
+    }
+    delta.total_ = total_ - earlier.total_;
+    return delta;
+  }
+
+  // Same distribution with every value multiplied by `factor`, e.g. to turn
+  // samples recorded in clock ticks into nanoseconds when reporting.
+  [[nodiscard]] BasicHistogram rescaled(double factor) const {
+    BasicHistogram scaled;
+    for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+      if (counts_[i]) {
+        scaled.record(static_cast<uint64_t>(
+                          static_cast<double>(layout::midpoint(i)) * factor),
+                      counts_[i]);
+      }
+    }
+    return scaled;
+  }
+
+  void reset() noexcept {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_ = 0;
+  }
+
+  [[nodiscard]] uint64_t count() const noexcept { return total_; }
+  [[nodiscard]] bool empty() const noexcept { return total_ == 0; }
+
+  [[nodiscard]] uint64_t min() const noexcept {
+    for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+      if (counts_[i]) {
+        return layout::lower_bound(i);
+      }
+    }
+    return 0;
+  }
+
+  [[nodiscard]] uint64_t max() const noexcept {
+    for (std::size_t i = layout::bucket_count; i-- > 0;) {
+      if (counts_[i]) {
+        return layout::upper_bound(i);
+      }
+    }
+    return 0;
+  }
+
+  [[nodiscard]] double mean() const noexcept {
+    if (total_ == 0) {
+      return 0;
+    }
+    double sum = 0;
+    for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+      sum += static_cast<double>(counts_[i]) *
+             static_cast<double>(layout::midpoint(i));
+    }
+    return sum / static_cast<double>(total_);
+  }
+
+  // Value at percentile p in [0, 100]. Within the precision of the layout,
+  // at least p% of samples are <= the returned value.
+  [[nodiscard]] uint64_t percentile(double p) const noexcept {
+    if (total_ == 0) {
+      return 0;
+    }
+    p = std::clamp(p, 0.0, 100.0);
+    // the smallest rank with at least p% of samples at or below it; p x
+    // total is exact for integral p, so p50 of 100 samples is rank 50
+    auto rank = static_cast<uint64_t>(
+        std::ceil(p * static_cast<double>(total_) / 100.0));
+    rank = std::clamp<uint64_t>(rank, 1, total_);
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+      seen += counts_[i];
+      if (seen >= rank) {
+        return layout::midpoint(i);
+      }
+    }
+    return max();
+  }
+
+  [[nodiscard]] uint64_t bucket(std::size_t index) const noexcept {
+    return counts_[index];
+  }
+
+  [[nodiscard]] std::vector<uint8_t> serialize() const {
+    std::vector<uint8_t> out;
+    out.insert(out.end(), magic, magic + sizeof(magic));
+    out.push_back(static_cast<uint8_t>(SubBucketBits));
+    put_varint(out, total_);
+
+    std::size_t previous = 0;
+    for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+      if (counts_[i]) {
+        put_varint(out, i - previous);
+        put_varint(out, counts_[i]);
+        previous = i;
+      }
+    }
+    return out;
+  }
+
+  static BasicHistogram deserialize(std::span<const uint8_t> in) {
+    if (in.size() < sizeof(magic) + 1 ||
+        !std::equal(magic, magic + sizeof(magic), in.begin())) {
+      throw std::invalid_argument("histogram: bad magic");
+    }
+    if (in[sizeof(magic)] != SubBucketBits) {
+      throw std::invalid_argument("histogram: precision mismatch");
+    }
+    in = in.subspan(sizeof(magic) + 1);
+
+    BasicHistogram histogram;
+    auto total = get_varint(in);
+    std::size_t index = 0;
+    uint64_t seen = 0;
+    while (!in.empty()) {
+      index += static_cast<std::size_t>(get_varint(in));
+      auto count = get_varint(in);
+      if (index >= layout::bucket_count) {
+        throw std::invalid_argument("histogram: bucket out of range");
+      }
+      histogram.counts_[index] = count;
+      seen += count;
+    }
+    if (seen != total) {
+      throw std::invalid_argument("histogram: count mismatch");
+    }
+    histogram.total_ = total;
+    return histogram;
+  }
+
+  // percentile table in the spirit of HdrHistogram's text output
+  [[nodiscard]] std::string to_text() const {
+    std::string out = "value percentile count\n";
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+      if (!counts_[i]) {
+        continue;
+      }
+      seen += counts_[i];
+      out += std::to_string(layout::upper_bound(i)) + " " +
+             std::to_string(100.0 * static_cast<double>(seen) /
+                            static_cast<double>(total_)) +
+             " " + std::to_string(seen) + "\n";
+    }
+    return out;
+  }
+
+private:
+  static constexpr uint8_t magic[4] = {'O', 'C', 'H', '1'};
+
+  static void put_varint(std::vector<uint8_t> &out, uint64_t value) {
+    while (value >= 0x80) {
+      out.push_back(static_cast<uint8_t>(value) | 0x80);
+      value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+  }
+
+  static uint64_t get_varint(std::span<const uint8_t> &in) {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (in.empty()) {
+        throw std::invalid_argument("histogram: truncated varint");
+      }
+      auto byte = in.front();
+      in = in.subspan(1);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    throw std::invalid_argument("histogram: varint too long");
+  }
+
+  std::vector<uint64_t> counts_;
+  uint64_t total_ = 0;
+};
+
+/**
+ * @brief Histogram recorded from many threads, read without stopping them
+ *
+ * Each recording thread owns a shard obtained through recorder(). A shard has
+ * a single writer, so recording is one relaxed load/store pair on the bucket
+ * (no locked instruction, no allocation). Readers sum all shards with relaxed
+ * loads; snapshot() is wait-free and never blocks recorders, at the cost of
+ * possibly missing samples recorded concurrently with the read.
+ *
+ * Shards are allocated when a recorder is created and recycled when it is
+ * released, keeping their counts, so totals stay cumulative.
+ */
+template <unsigned SubBucketBits = 7> class BasicConcurrentHistogram {
+public:
+  using layout = HistogramLayout<SubBucketBits>;
+  using snapshot_type = BasicHistogram<SubBucketBits>;
+
+private:
+  struct Shard {
+    std::unique_ptr<std::atomic<uint64_t>[]> counts{
+        new std::atomic<uint64_t>[layout::bucket_count]()};
+    std::atomic<bool> in_use{true};
+    Shard *next = nullptr; // immutable once published
+  };
+
+public:
+  class Recorder {
+  public:
+    Recorder() = default;
+    Recorder(const Recorder &) = delete;
+    Recorder &operator=(const Recorder &) = delete;
+    Recorder(Recorder &&other) noexcept
+        : shard_(std::exchange(other.shard_, nullptr)) {}
+    Recorder &operator=(Recorder &&other) noexcept {
+      if (this != &other) {
+        release();
+        shard_ = std::exchange(other.shard_, nullptr);
+      }
+      return *this;
+    }
+    ~Recorder() { release(); }
+
+    // hot path: owning thread only
+    void record(uint64_t value) noexcept {
+      auto &bucket = shard_->counts[layout::index_of(value)];
+      bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] explicit operator bool() const noexcept {
+      return shard_ != nullptr;
+    }
+
+  private:
+    friend class BasicConcurrentHistogram;
+    explicit Recorder(Shard *shard) : shard_(shard) {}
+
+    void release() noexcept {
+      if (shard_) {
+        shard_->in_use.store(false, std::memory_order_release);
+        shard_ = nullptr;
+      }
+    }
+
+    Shard *shard_ = nullptr;
+  };
+
+  BasicConcurrentHistogram() = default;
+  BasicConcurrentHistogram(const BasicConcurrentHistogram &) = delete;
+  BasicConcurrentHistogram &
+  operator=(const BasicConcurrentHistogram &) = delete;
+
+  // all recorders must be gone by now
+  ~BasicConcurrentHistogram() {
+    auto *shard = shards_.load(std::memory_order_acquire);
+    while (shard) {
+      delete std::exchange(shard, shard->next);
+    }
+  }
+
+  // A recorder for the calling thread. Reuses an idle shard when possible;
+  // otherwise allocates one and pushes it onto the lock-free shard list.
+  [[nodiscard]] Recorder recorder() {
+    for (auto *shard = shards_.load(std::memory_order_acquire); shard;
+         shard = shard->next) {
+      bool idle = false;
+      if (shard->in_use.compare_exchange_strong(idle, true,
+                                                std::memory_order_acquire)) {
+        return Recorder(shard);
+      }
+    }
+
+    auto *shard = new Shard;
+    shard->next = shards_.load(std::memory_order_relaxed);
+    while (!shards_.compare_exchange_weak(shard->next, shard,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    }
+    return Recorder(shard);
+  }
+
+  // Wait-free merge of every shard.
+  [[nodiscard]] snapshot_type snapshot() const {
+    snapshot_type merged;
+    for (auto *shard = shards_.load(std::memory_order_acquire); shard;
+         shard = shard->next) {
+      for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+        if (auto count = shard->counts[i].load(std::memory_order_relaxed)) {
+          merged.record(layout::lower_bound(i), count);
+        }
+      }
+    }
+    return merged;
+  }
+
+private:
+  std::atomic<Shard *> shards_{nullptr};
+};
+
+using Histogram = BasicHistogram<>;
+using ConcurrentHistogram = BasicConcurrentHistogram<>;
+
+} // namespace oc::utils
+
+#endif
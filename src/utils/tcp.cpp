@@ -0,0 +1,114 @@
+#include "tcp.hpp"
+
+#include <cerrno>
+#include <netinet/tcp.h>
+#include <stdexcept>
+
+namespace {
+
+[[noreturn]] void throw_errno(const char *what) {
+  throw std::runtime_error(std::string(what) + ": " + strerror(errno));
+}
+
+void set_nodelay(int fd) {
+  int one = 1;
+  if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) < 0) {
+    throw_errno("setsockopt(TCP_NODELAY) failed");
+  }
+}
+
+} // namespace
+
+TcpServer::TcpServer(uint16_t port) {
+  server_socket = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (server_socket < 0) {
+    throw_errno("socket failed");
+  }
+
+  // option names, not flags, so each is set on its own
+  if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) <
+      0) {
+    int saved = errno;
+    ::close(server_socket);
+    errno = saved;
+    throw_errno("setsockopt(SO_REUSEADDR) failed");
+  }
+  if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) <
+      0) {
+    int saved = errno;
+    ::close(server_socket);
+    errno = saved;
+    throw_errno("setsockopt(SO_REUSEPORT) failed");
+  }
+
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = INADDR_ANY;
+  address.sin_port = htons(port);
+
+  if (::bind(server_socket, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) < 0) {
+    int saved = errno;
+    ::close(server_socket);
+    errno = saved;
+    throw_errno("bind failed");
+  }
+
+  if (::listen(server_socket, 1) < 0) {
+    int saved = errno;
+    ::close(server_socket);
+    errno = saved;
+    throw_errno("listen failed");
+  }
+
+  socketfd =
+      ::accept(server_socket, reinterpret_cast<sockaddr *>(&address), &addrlen);
+  if (socketfd < 0) {
+    int saved = errno;
+    ::close(server_socket);
+    errno = saved;
+    throw_errno("accept failed");
+  }
+
+  set_nodelay(socketfd);
+}
+
+TcpServer::~TcpServer() {
+  ::close(socketfd);
+  ::close(server_socket);
+}
+
+TcpClient::TcpClient(const std::string &server_ip, uint16_t port) {
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_port = htons(port);
+
+  if (inet_pton(AF_INET, server_ip.c_str(), &serv_addr.sin_addr) <= 0) {
+    throw std::runtime_error("invalid address: " + server_ip);
+  }
+
+  // the server may not be listening yet; retry for a few seconds
+  constexpr int max_attempts = 100;
+  for (int attempt = 0;; ++attempt) {
+    clientfd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (clientfd < 0) {
+      throw_errno("socket failed");
+    }
+
+    if (::connect(clientfd, reinterpret_cast<sockaddr *>(&serv_addr),
+                  sizeof(serv_addr)) == 0) {
+      break;
+    }
+
+    int saved = errno;
+    ::close(clientfd);
+    if (attempt + 1 == max_attempts) {
+      errno = saved;
+      throw_errno("connect failed");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  socketfd = clientfd;
+  set_nodelay(socketfd);
+}
+
+TcpClient::~TcpClient() { ::close(clientfd); }
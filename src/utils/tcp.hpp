@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include <netinet/in.h>
 #include <span>
+#include <stdexcept>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,6 +37,9 @@ public:
         perror("read failed");
         exit(EXIT_FAILURE);
       }
+      if (num_read == 0) {
+        throw std::runtime_error("read failed: connection closed");
+      }
 
       readed += num_read;
     }
@@ -52,8 +56,6 @@ public:
     if (num_send != buf.size_bytes()) {
       throw std::runtime_error("write failed");
     }
-
-    printf("writed %zu bytes\n", num_send);
   }
 
   template <class T>
@@ -100,6 +102,17 @@ public:
     return *reinterpret_cast<T *>(buf.data());
   }
 
+  // One whole message, length-prefixed on the socket by default. Transports
+  // that frame messages themselves override both; whole-message users such
+  // as the bootstrap exchange go through these only.
+  virtual void write_message(std::span<const std::byte> message) {
+    write_size(message);
+  }
+
+  virtual std::vector<std::byte> read_message() {
+    return read_size<std::byte>();
+  }
+
   virtual ~OrderedOutBandCommBase() = default;
 
 protected:
@@ -0,0 +1,200 @@
+#pragma once
+
+#ifndef UTILS_TSC_CLOCK_HPP
+#define UTILS_TSC_CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+namespace oc::utils {
+
+/**
+ * @brief Cycle counter clock for hot-path timestamps
+ *
+ * now() returns raw ticks: rdtsc on x86 with an invariant TSC, the generic
+ * timer on aarch64, and CLOCK_MONOTONIC nanoseconds everywhere else (one tick
+ * per nanosecond). Ticks are only comparable within one process and are
+ * converted to nanoseconds with a calibration measured once, during static
+ * initialisation of any program including this header (a ~20 ms busy-wait),
+ * or on first use if that comes earlier. Conversion belongs off the hot
+ * path: record ticks, convert when reporting.
+ */
+class tsc_clock {
+public:
+  using ticks = uint64_t;
+
+  enum class source { tsc, arm_generic_timer, monotonic };
+
+  struct calibration {
+    source origin;
+    double ns_per_tick;
+    ticks tick_base; // tick reading taken together with ns_base
+    int64_t ns_base; // CLOCK_MONOTONIC at tick_base
+  };
+
+  // hot path: a few ns with a TSC
+  static ticks now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    if (state().origin == source::tsc) [[likely]] {
+      return __rdtsc();
+    }
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#endif
+    return static_cast<ticks>(monotonic_ns());
+  }
+
+  // Like now(), but waits for earlier instructions to finish first, so the
+  // stamp cannot be taken before the work it is meant to follow.
+  static ticks now_ordered() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    if (state().origin == source::tsc) [[likely]] {
+      unsigned aux;
+      return __rdtscp(&aux);
+    }
+#elif defined(__aarch64__)
+    asm volatile("isb" ::: "memory");
+#endif
+    return now();
+  }
+
+  // off the hot path
+  static int64_t to_nanoseconds(ticks elapsed) noexcept {
+    return static_cast<int64_t>(static_cast<double>(elapsed) *
+                                state().ns_per_tick);
+  }
+
+  static std::chrono::nanoseconds to_duration(ticks elapsed) noexcept {
+    return std::chrono::nanoseconds(to_nanoseconds(elapsed));
+  }
+
+  // CLOCK_MONOTONIC time of a tick reading
+  static int64_t to_monotonic_ns(ticks stamp) noexcept {
+    const auto &c = state();
+    auto delta =
+        static_cast<double>(static_cast<int64_t>(stamp - c.tick_base));
+    return c.ns_base + static_cast<int64_t>(delta * c.ns_per_tick);
+  }
+
+  static double ns_per_tick() noexcept { return state().ns_per_tick; }
+
+  static const calibration &current_calibration() noexcept { return state(); }
+
+  // Measure the tick rate against CLOCK_MONOTONIC over `window`. Runs once
+  // automatically at startup; call again for a longer window, but only from
+  // main() before other threads start: it overwrites the calibration that
+  // now() and the conversions read without synchronisation.
+  static void calibrate(std::chrono::milliseconds window =
+                            std::chrono::milliseconds(20)) noexcept {
+    state() = measure(detect_source(), window);
+  }
+
+  static bool invariant_tsc() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) ||
+        eax < 0x80000007) {
+      return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+  }
+
+private:
+  static int64_t monotonic_ns() noexcept {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  }
+
+  static source detect_source() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return invariant_tsc() ? source::tsc : source::monotonic;
+#elif defined(__aarch64__)
+    return source::arm_generic_timer;
+#else
+    return source::monotonic;
+#endif
+  }
+
+  static ticks raw(source s) noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    if (s == source::tsc) {
+      return __rdtsc();
+    }
+#elif defined(__aarch64__)
+    if (s == source::arm_generic_timer) {
+      uint64_t value;
+      asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+      return value;
+    }
+#endif
+    return static_cast<ticks>(monotonic_ns());
+  }
+
+  // Pair a tick reading with CLOCK_MONOTONIC, keeping the tightest of a few
+  // attempts so a preemption between the two reads does not skew the pair.
+  static void paired_read(source s, ticks &tick, int64_t &ns) noexcept {
+    int64_t best = INT64_MAX;
+    for (int i = 0; i < 16; ++i) {
+      auto before = raw(s);
+      auto mono = monotonic_ns();
+      auto after = raw(s);
+      if (static_cast<int64_t>(after - before) < best) {
+        best = static_cast<int64_t>(after - before);
+        tick = before + (after - before) / 2;
+        ns = mono;
+      }
+    }
+  }
+
+  static calibration measure(source s,
+                             std::chrono::milliseconds window) noexcept {
+    calibration c{s, 1.0, 0, 0};
+    paired_read(s, c.tick_base, c.ns_base);
+    if (s == source::monotonic) {
+      return c;
+    }
+
+    auto deadline = c.ns_base +
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(window)
+                        .count();
+    while (monotonic_ns() < deadline) {
+    }
+
+    ticks end_tick = 0;
+    int64_t end_ns = 0;
+    paired_read(s, end_tick, end_ns);
+    if (end_tick > c.tick_base) {
+      c.ns_per_tick = static_cast<double>(end_ns - c.ns_base) /
+                      static_cast<double>(end_tick - c.tick_base);
+    }
+    return c;
+  }
+
+  static calibration &state() noexcept {
+    static calibration c =
+        measure(detect_source(), std::chrono::milliseconds(20));
+    return c;
+  }
+};
+
+// Calibrates before main(), so neither the first timestamp nor the first
+// pipe pays for the measurement.
+inline const bool tsc_clock_calibrated =
+    (static_cast<void>(tsc_clock::current_calibration()), true);
+
+} // namespace oc::utils
+
+#endif
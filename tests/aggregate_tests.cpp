@@ -0,0 +1,233 @@
+#include "oc/aggregate.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+using namespace oc;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+struct trade {
+  uint64_t timestamp_ns;
+  uint32_t symbol;
+  int32_t quantity;
+  double price;
+};
+
+using by_count = WindowAggregator<trade, &trade::symbol, &trade::price>;
+using by_time = WindowAggregator<trade, &trade::symbol, &trade::quantity,
+                                 &trade::timestamp_ns>;
+
+std::vector<trade> trades(std::size_t count, uint32_t symbols) {
+  std::vector<trade> out(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = {i * 3, static_cast<uint32_t>(i * 7 % symbols),
+              static_cast<int32_t>(i % 13) - 6,
+              100.0 + static_cast<double>(i % 17)};
+  }
+  return out;
+}
+
+// window start, window end and key
+using window_key = std::tuple<uint64_t, uint64_t, uint64_t>;
+
+// Brute force over every window that ends on a slide boundary.
+template <typename Position, typename Value>
+std::map<window_key, AggregateRecord>
+reference(const std::vector<trade> &in, window_spec spec, Position position,
+          Value value) {
+  std::map<window_key, AggregateRecord> out;
+  auto slide = spec.slide == 0 ? spec.size : spec.slide;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    auto at = position(in[i], i);
+    // every window [end - size, end) with end on a slide boundary
+    for (auto end = (at / slide + 1) * slide; end <= at + spec.size;
+         end += slide) {
+      auto start = end > spec.size ? end - spec.size : 0;
+      auto v = value(in[i]);
+      auto [it, fresh] = out.try_emplace({start, end, in[i].symbol},
+                                         AggregateRecord{start, end,
+                                                         in[i].symbol, 0, 0,
+                                                         v, v});
+      auto &a = it->second;
+      ++a.count;
+      a.sum += v;
+      a.min = std::min(a.min, v);
+      a.max = std::max(a.max, v);
+    }
+  }
+  return out;
+}
+
+template <typename Aggregator>
+std::vector<AggregateRecord> run(Aggregator &aggregator,
+                                 const std::vector<trade> &in,
+                                 std::size_t out_capacity = 4096) {
+  rb::PodRingBuffer<trade> source(1024);
+  rb::PodRingBuffer<AggregateRecord> destination(out_capacity);
+  std::vector<AggregateRecord> out;
+  auto collect = [&] {
+    while (auto record = destination.try_pop()) {
+      out.push_back(*record);
+    }
+  };
+  std::size_t offered = 0;
+  while (offered < in.size() || !source.empty()) {
+    offered += source.try_push_bulk(std::span(in).subspan(offered));
+    aggregator.pump(source, destination);
+    collect();
+  }
+  // the window ending with the last record
+  aggregator.flush(destination);
+  collect();
+  while (aggregator.pending() > 0) {
+    aggregator.pump(source, destination);
+    collect();
+  }
+  return out;
+}
+
+bool same(const AggregateRecord &a, const AggregateRecord &b) {
+  return a.window_start == b.window_start && a.window_end == b.window_end &&
+         a.key == b.key && a.count == b.count && a.sum == b.sum &&
+         a.min == b.min && a.max == b.max;
+}
+
+void test_tumbling_by_count() {
+  auto in = trades(10000, 5);
+  window_spec spec{100, 0};
+  by_count aggregator(spec);
+  auto out = run(aggregator, in);
+  auto want = reference(
+      in, spec, [](const trade &, std::size_t i) { return i; },
+      [](const trade &t) { return t.price; });
+  ASSERT(out.size() == want.size(),
+         "One aggregate per key and window, " << out.size() << " vs "
+                                              << want.size());
+  for (const auto &a : out) {
+    ASSERT(same(a, want.at({a.window_start, a.window_end, a.key})),
+           "Window " << a.window_start << " key " << a.key);
+  }
+  ASSERT(aggregator.stats().windows == 100, "Every window closed");
+  ASSERT(aggregator.stats().records == in.size(), "Every record counted");
+}
+
+// Only windows ending after the last record has been flushed are missing
+// from the stream; the reference stops at the same point.
+void test_sliding_by_time() {
+  auto in = trades(6000, 11);
+  window_spec spec{400, 100};
+  by_time aggregator(spec);
+  auto out = run(aggregator, in);
+  auto want = reference(
+      in, spec, [](const trade &t, std::size_t) { return t.timestamp_ns; },
+      [](const trade &t) { return static_cast<double>(t.quantity); });
+  auto last_end = out.back().window_end;
+  std::size_t expected = 0;
+  for (const auto &[key, a] : want) {
+    expected += std::get<1>(key) <= last_end;
+  }
+  ASSERT(out.size() == expected, out.size() << " vs " << expected);
+  for (const auto &a : out) {
+    ASSERT(same(a, want.at({a.window_start, a.window_end, a.key})),
+           "Window " << a.window_start << " key " << a.key);
+  }
+  ASSERT(out.front().window_start == 0 && out.front().window_end == 100,
+         "The first window is cut at the start of the stream");
+}
+
+void test_many_keys() {
+  auto in = trades(50000, 20011);
+  by_count aggregator(window_spec{25000, 0});
+  auto out = run(aggregator, in, 1 << 16);
+  ASSERT(out.size() == 2 * 20011, "Every key in both windows");
+  uint64_t total = 0;
+  for (const auto &a : out) {
+    total += a.count;
+  }
+  ASSERT(total == in.size(), "Counts add up");
+}
+
+void test_late_records_and_gaps() {
+  std::vector<trade> in{{10, 1, 1, 0}, {15, 1, 2, 0}, {5, 1, 100, 0},
+                        {25, 2, 3, 0}, {1000000, 1, 4, 0}};
+  by_time aggregator(window_spec{10, 0});
+  auto out = run(aggregator, in);
+  ASSERT(aggregator.stats().late == 1, "The record from a closed pane");
+  ASSERT(out.size() == 3, "Empty windows in the gap emit nothing");
+  ASSERT(out[0].window_start == 10 && out[0].count == 2 && out[0].sum == 3,
+         "First window");
+  ASSERT(out[1].key == 2 && out[1].window_end == 30, "Second window");
+  ASSERT(out[2].window_start == 1000000 && out[2].sum == 4, "After the gap");
+}
+
+// A destination with room for a few aggregates holds the input back.
+void test_backpressure() {
+  auto in = trades(5000, 50);
+  by_count aggregator(window_spec{500, 250});
+  auto out = run(aggregator, in, 8);
+  auto want = reference(
+      in, window_spec{500, 250},
+      [](const trade &, std::size_t i) { return i; },
+      [](const trade &t) { return t.price; });
+  std::size_t expected = 0;
+  for (const auto &[key, a] : want) {
+    expected += std::get<1>(key) <= out.back().window_end;
+  }
+  ASSERT(out.size() == expected, out.size() << " vs " << expected);
+  for (std::size_t i = 1; i < out.size(); ++i) {
+    ASSERT(out[i].window_end >= out[i - 1].window_end, "Windows in order");
+  }
+}
+
+void test_rejects_bad_windows() {
+  for (auto spec : {window_spec{0, 0}, window_spec{100, 30},
+                    window_spec{100, 200}}) {
+    bool threw = false;
+    try {
+      by_count aggregator(spec);
+    } catch (const std::invalid_argument &) {
+      threw = true;
+    }
+    ASSERT(threw, "Size " << spec.size << " slide " << spec.slide);
+  }
+}
+
+int main() {
+  std::cout << "Running Aggregate Tests\n";
+  std::cout << "=======================\n\n";
+
+  try {
+    TEST_CASE(tumbling_by_count);
+    TEST_CASE(sliding_by_time);
+    TEST_CASE(many_keys);
+    TEST_CASE(late_records_and_gaps);
+    TEST_CASE(backpressure);
+    TEST_CASE(rejects_bad_windows);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include "oc/batching.hpp"
+#include "oc/sim/pipeline_sim.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+using namespace oc;
+using namespace oc::sim;
+using namespace std::chrono_literals;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+bool near(double measured, double expected, double tolerance) {
+  return measured >= expected * (1 - tolerance) &&
+         measured <= expected * (1 + tolerance);
+}
+
+void test_releases_when_full() {
+  BatchGate gate(1024, 1000);
+  ASSERT(!gate.ready(0, 0), "Nothing waiting is never ready");
+  ASSERT(!gate.ready(100, 10), "A small backlog is held");
+  ASSERT(!gate.ready(1000, 20), "Still below the threshold");
+  ASSERT(gate.ready(1024, 30), "A full batch goes");
+  ASSERT(gate.held() == 2 && gate.filled() == 1, "Counted");
+}
+
+void test_releases_at_deadline() {
+  BatchGate gate(1024, 1000);
+  ASSERT(!gate.ready(8, 500), "Held");
+  ASSERT(gate.due() == 1500, "Due a deadline after the first byte waited");
+  ASSERT(!gate.ready(16, 1499), "Held until the deadline");
+  ASSERT(gate.ready(16, 1500), "Released at the deadline");
+  ASSERT(gate.expired() == 1, "Counted as expired");
+
+  // a partial transfer keeps the age of the oldest waiting byte
+  gate.forwarded(8);
+  ASSERT(gate.ready(8, 1501), "The rest is already overdue");
+  gate.forwarded(0);
+  ASSERT(!gate.ready(8, 1600), "A new backlog starts a new deadline");
+  ASSERT(gate.due() == 2600, "Measured from its first round");
+}
+
+void test_flush_now() {
+  BatchGate gate(1024, 1000);
+  ASSERT(!gate.ready(8, 0), "Held");
+  gate.flush();
+  ASSERT(gate.ready(8, 1), "A flush lets the next round go");
+  ASSERT(gate.flushed() == 1, "Counted as flushed");
+  gate.forwarded(0);
+  ASSERT(!gate.ready(8, 2), "The flush applies once");
+}
+
+pipeline_model tiny_messages() {
+  pipeline_model model;
+  model.sizes = bench::size_distribution::parse("fixed:64");
+  model.arrivals = bench::arrival_process::parse("constant:100000");
+  model.hops.resize(1);
+  model.hops[0].link.per_transfer = 2us;
+  model.messages = 20000;
+  return model;
+}
+
+// Records arriving one per round each pay a transfer's fixed cost;
+// coalescing them cuts the transfers, and the link time, by the batch size.
+void test_coalescing_cuts_transfers() {
+  auto model = tiny_messages();
+  auto plain = simulate(model);
+
+  model.hops[0].batching = {16 << 10, 100us};
+  auto batched = simulate(model);
+
+  ASSERT(plain.messages == batched.messages, "Every message is delivered");
+  ASSERT(plain.hops[0].transfers >= model.messages,
+         "Unbatched, every record is a transfer");
+  ASSERT(batched.hops[0].transfers * 5 < plain.hops[0].transfers,
+         "Far fewer transfers");
+  ASSERT(batched.hops[0].transferring * 5 < plain.hops[0].transferring,
+         "Far less link time");
+  ASSERT(near(batched.messages_per_second(), plain.messages_per_second(),
+              0.02),
+         "Throughput keeps up with the offered load");
+  ASSERT(batched.hops[0].held_batching.count() > 0, "Time spent holding");
+}
+
+// A lone record waits at most the deadline, not forever.
+void test_deadline_bounds_latency() {
+  auto model = tiny_messages();
+  model.arrivals = bench::arrival_process::parse("constant:1000");
+  model.messages = 50;
+  model.hops[0].batching = {1 << 20, 20us};
+  auto result = simulate(model);
+
+  ASSERT(result.messages == 50, "Every message is delivered");
+  ASSERT(result.latency_ns.max() >= 20000, "Held for the deadline");
+  ASSERT(result.latency_ns.max() < 30000, "But not much longer");
+}
+
+int main() {
+  std::cout << "Running Batching Tests\n";
+  std::cout << "======================\n\n";
+
+  try {
+    TEST_CASE(releases_when_full);
+    TEST_CASE(releases_at_deadline);
+    TEST_CASE(flush_now);
+    TEST_CASE(coalescing_cuts_transfers);
+    TEST_CASE(deadline_bounds_latency);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,213 @@
+#include "oc/bootstrap.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace oc;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+constexpr uint16_t base_port = 47310;
+
+std::vector<std::byte> bytes_of(const std::string &s) {
+  auto view = std::as_bytes(std::span(s.data(), s.size()));
+  return {view.begin(), view.end()};
+}
+
+BootstrapMessage sample_message(const std::string &tag) {
+  BootstrapMessage message;
+  message.capabilities = bootstrap_capability::scatter_gather |
+                         bootstrap_capability::packed_metadata_page;
+  message.add(BootstrapEntryKind::ConnectionBlob, 0, bytes_of("qp-" + tag));
+  message.add(BootstrapEntryKind::MetadataPageExport, 0, bytes_of("md-" + tag));
+  for (uint32_t pipe = 0; pipe < 4; ++pipe) {
+    message.add(BootstrapEntryKind::DataRingExport, pipe,
+                bytes_of(tag + "-ring-" + std::to_string(pipe)));
+  }
+  message.add_value(BootstrapEntryKind::MetadataLayout, 0, uint32_t{4});
+  return message;
+}
+
+void test_roundtrip() {
+  auto message = sample_message("a");
+  auto parsed = BootstrapMessage::parse(message.serialize());
+
+  ASSERT(parsed.capabilities == message.capabilities, "Capabilities kept");
+  ASSERT(parsed.entries().size() == message.entries().size(), "Entry count");
+  ASSERT(parsed.get(BootstrapEntryKind::DataRingExport, 3).size() ==
+             bytes_of("a-ring-3").size(),
+         "Entry payload kept");
+  ASSERT(parsed.get_value<uint32_t>(BootstrapEntryKind::MetadataLayout) == 4,
+         "Value entry kept");
+  ASSERT(parsed.find(BootstrapEntryKind::DataRingExport, 9) == nullptr,
+         "Unknown pipe not found");
+}
+
+void test_unknown_kinds_are_kept() {
+  BootstrapMessage message;
+  message.add(static_cast<BootstrapEntryKind>(0x7777), 2, bytes_of("future"));
+  auto parsed = BootstrapMessage::parse(message.serialize());
+  ASSERT(parsed.find(static_cast<BootstrapEntryKind>(0x7777), 2) != nullptr,
+         "Entries of unknown kind survive parsing");
+}
+
+void test_rejects_malformed() {
+  auto wire = sample_message("b").serialize();
+
+  auto rejects = [](std::span<const std::byte> data) {
+    try {
+      (void)BootstrapMessage::parse(data);
+    } catch (const std::runtime_error &) {
+      return true;
+    }
+    return false;
+  };
+
+  ASSERT(rejects(std::span(wire).first(10)), "Truncated header rejected");
+  ASSERT(rejects(std::span(wire).first(wire.size() - 1)),
+         "Truncated payload rejected");
+
+  auto bad_version = wire;
+  bad_version[4] = std::byte{0x42};
+  ASSERT(rejects(bad_version), "Other version rejected");
+
+  auto bad_magic = wire;
+  bad_magic[0] = std::byte{0};
+  ASSERT(rejects(bad_magic), "Bad magic rejected");
+
+  // entry count field, right after magic, version, padding and capabilities
+  auto huge_count = wire;
+  std::fill_n(huge_count.begin() + 16, 4, std::byte{0xff});
+  ASSERT(rejects(huge_count), "Count beyond the payload rejected");
+}
+
+void test_capability_negotiation() {
+  BootstrapMessage a, b;
+  a.capabilities = bootstrap_capability::scatter_gather |
+                   bootstrap_capability::packed_metadata_page;
+  b.capabilities = bootstrap_capability::packed_metadata_page;
+  ASSERT(negotiated_capabilities(a, b) ==
+             bootstrap_capability::packed_metadata_page,
+         "Only common capabilities are negotiated");
+}
+
+void test_loopback_exchange() {
+  BootstrapMessage from_server;
+  std::thread server_thread([&] {
+    TcpServer server(base_port);
+    from_server = bootstrap_exchange(server, sample_message("server"));
+  });
+
+  TcpClient client("127.0.0.1", base_port);
+  auto from_client = bootstrap_exchange(client, sample_message("client"));
+  server_thread.join();
+
+  ASSERT(from_client.get(BootstrapEntryKind::ConnectionBlob).size() ==
+             bytes_of("qp-server").size(),
+         "Client receives the server message");
+  ASSERT(from_server.get(BootstrapEntryKind::ConnectionBlob).size() ==
+             bytes_of("qp-client").size(),
+         "Server receives the client message");
+}
+
+// A transport that frames messages itself, with the peer's reply queued.
+struct framed_comm : OrderedOutBandCommBase {
+  std::vector<std::byte> sent;
+  std::vector<std::byte> reply;
+
+  void write_message(std::span<const std::byte> message) override {
+    sent.assign(message.begin(), message.end());
+  }
+
+  std::vector<std::byte> read_message() override { return reply; }
+};
+
+void test_exchange_over_message_transport() {
+  framed_comm comm;
+  comm.reply = sample_message("peer").serialize();
+  auto local = sample_message("local");
+  auto remote = bootstrap_exchange(comm, local);
+
+  ASSERT(comm.sent == local.serialize(), "Sent as one message");
+  ASSERT(remote.get(BootstrapEntryKind::ConnectionBlob).size() ==
+             bytes_of("qp-peer").size(),
+         "Reply parsed");
+}
+
+void test_parallel_exchange() {
+  constexpr int num_peers = 4;
+
+  std::vector<std::thread> servers;
+  std::array<BootstrapMessage, num_peers> received_by_servers;
+  for (int i = 0; i < num_peers; ++i) {
+    servers.emplace_back([&, i] {
+      TcpServer server(base_port + 1 + i);
+      received_by_servers[i] =
+          bootstrap_exchange(server, sample_message("peer" + std::to_string(i)));
+    });
+  }
+
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  std::vector<OrderedOutBandCommBase *> comms;
+  std::vector<BootstrapMessage> locals;
+  for (int i = 0; i < num_peers; ++i) {
+    clients.push_back(std::make_unique<TcpClient>("127.0.0.1", base_port + 1 + i));
+    comms.push_back(clients.back().get());
+    locals.push_back(sample_message("hub"));
+  }
+
+  auto remotes = bootstrap_exchange_all(comms, locals);
+  for (auto &server : servers) {
+    server.join();
+  }
+
+  ASSERT(remotes.size() == num_peers, "One reply per connection");
+  for (int i = 0; i < num_peers; ++i) {
+    auto expected = bytes_of("peer" + std::to_string(i) + "-ring-0");
+    auto got = remotes[i].get(BootstrapEntryKind::DataRingExport, 0);
+    ASSERT(std::equal(got.begin(), got.end(), expected.begin(), expected.end()),
+           "Replies are matched to their connection");
+    ASSERT(received_by_servers[i].entries().size() == locals[i].entries().size(),
+           "Every peer receives the full message");
+  }
+}
+
+int main() {
+  std::cout << "Running Bootstrap Protocol Tests\n";
+  std::cout << "================================\n\n";
+
+  try {
+    TEST_CASE(roundtrip);
+    TEST_CASE(unknown_kinds_are_kept);
+    TEST_CASE(rejects_malformed);
+    TEST_CASE(capability_negotiation);
+    TEST_CASE(loopback_exchange);
+    TEST_CASE(exchange_over_message_transport);
+    TEST_CASE(parallel_exchange);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,145 @@
+#include "oc/checksum.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+using namespace oc;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+std::vector<std::byte> pattern(std::size_t size, uint32_t seed) {
+  std::vector<std::byte> out(size);
+  uint32_t x = seed * 2654435761u + 1;
+  for (auto &b : out) {
+    x = x * 1664525u + 1013904223u;
+    b = std::byte(x >> 24);
+  }
+  return out;
+}
+
+std::span<const std::byte> bytes_of(std::string_view text) {
+  return std::as_bytes(std::span(text.data(), text.size()));
+}
+
+void test_known_values() {
+  ASSERT(crc32c(bytes_of("123456789")) == 0xe3069283, "Check value");
+  ASSERT(crc32c_software(bytes_of("123456789")) == 0xe3069283,
+         "Check value, table");
+  std::vector<std::byte> zeros(32, std::byte{0});
+  std::vector<std::byte> ones(32, std::byte{0xff});
+  ASSERT(crc32c(zeros) == 0x8a9136aa, "32 zero bytes");
+  ASSERT(crc32c(ones) == 0x62a8ab43, "32 0xff bytes");
+  ASSERT(crc32c({}) == 0, "Empty input");
+}
+
+// every length and alignment, across the interleaved block thresholds
+void test_hardware_matches_table() {
+  auto data = pattern(200000, 1);
+  for (std::size_t length : {1ul, 7ul, 8ul, 9ul, 255ul, 767ul, 768ul, 769ul,
+                             24575ul, 24576ul, 24577ul, 100000ul, 199990ul}) {
+    for (std::size_t offset = 0; offset < 8; ++offset) {
+      auto piece = std::span(data).subspan(offset, length);
+      ASSERT(crc32c(piece) == crc32c_software(piece),
+             "Length " << length << " offset " << offset);
+    }
+  }
+  std::cout << (crc32c_accelerated() ? "(crc32 instruction) "
+                                     : "(table only) ");
+}
+
+void test_chains() {
+  auto data = pattern(50000, 2);
+  auto whole = crc32c(data);
+  for (std::size_t split : {0ul, 1ul, 4096ul, 30001ul, 50000ul}) {
+    auto first = std::span(data).first(split);
+    auto second = std::span(data).subspan(split);
+    ASSERT(crc32c(second, crc32c(first)) == whole, "Split at " << split);
+  }
+}
+
+// One ring seen from both ends, as with the shared memory adapter.
+void test_chunks_across_the_wrap() {
+  std::vector<std::byte> ring(4096);
+  ChunkChecksum producer;
+  ChunkChecksum consumer;
+  uint32_t position = 0;
+  for (uint32_t i = 0; i < 100; ++i) {
+    auto bytes = 100 + i * 13;
+    auto chunk = pattern(bytes, i);
+    for (uint32_t b = 0; b < bytes; ++b) {
+      ring[(position + b) % ring.size()] = chunk[b];
+    }
+    producer.seal(ring, position, bytes);
+    ASSERT(consumer.verify(ring, position, bytes), "Chunk " << i);
+    position += bytes + producer.overhead();
+  }
+  ASSERT(producer.sealed() == 100 && consumer.verified() == 100, "Counted");
+  ASSERT(consumer.mismatches() == 0, "No mismatches");
+}
+
+void test_detects_corruption() {
+  std::vector<std::byte> ring(1024);
+  auto chunk = pattern(300, 3);
+  ChunkChecksum checksum;
+  uint32_t position = 900;
+  for (uint32_t b = 0; b < 300; ++b) {
+    ring[(position + b) % ring.size()] = chunk[b];
+  }
+  checksum.seal(ring, position, 300);
+  ASSERT(checksum.verify(ring, position, 300), "Intact");
+
+  ring[(position + 150) % ring.size()] ^= std::byte{0x10};
+  ASSERT(!checksum.verify(ring, position, 300), "A flipped bit is caught");
+  ring[(position + 150) % ring.size()] ^= std::byte{0x10};
+  ASSERT(!checksum.verify(ring, position, 299), "Misframing is caught");
+  ASSERT(checksum.mismatches() == 2, "Mismatches counted");
+  ASSERT(checksum.verified() == 1, "Only the intact chunk verified");
+}
+
+void test_switched_off() {
+  std::vector<std::byte> ring(256, std::byte{0x5a});
+  ChunkChecksum checksum(false);
+  ASSERT(checksum.overhead() == 0, "No trailer");
+  checksum.seal(ring, 0, 64);
+  ASSERT(ring[64] == std::byte{0x5a}, "Nothing written");
+  ASSERT(checksum.verify(ring, 0, 64), "Everything passes");
+  ASSERT(checksum.sealed() == 0 && checksum.verified() == 0,
+         "Nothing counted");
+}
+
+int main() {
+  std::cout << "Running Checksum Tests\n";
+  std::cout << "======================\n\n";
+
+  try {
+    TEST_CASE(known_values);
+    TEST_CASE(hardware_matches_table);
+    TEST_CASE(chains);
+    TEST_CASE(chunks_across_the_wrap);
+    TEST_CASE(detects_corruption);
+    TEST_CASE(switched_off);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,252 @@
+#include "oc/codec.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace oc;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+struct tick {
+  uint64_t timestamp_ns;
+  double price;
+  uint64_t sequence;
+  uint32_t quantity;
+  uint32_t flags;
+
+  bool operator==(const tick &) const = default;
+};
+
+struct lcg {
+  uint64_t state;
+  uint64_t next() {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state >> 11;
+  }
+};
+
+std::vector<tick> ticks(std::size_t count, uint64_t seed) {
+  std::vector<tick> out(count);
+  lcg rng{seed};
+  uint64_t now = 1'700'000'000'000'000'000ull;
+  double price = 101.25;
+  for (std::size_t i = 0; i < count; ++i) {
+    now += 900 + rng.next() % 200;
+    price += (static_cast<double>(rng.next() % 5) - 2) * 0.25;
+    out[i] = {now, price, 5000 + i, static_cast<uint32_t>(rng.next() % 100),
+              0x10};
+  }
+  return out;
+}
+
+std::vector<tick> roundtrip(const std::vector<tick> &in, codec_stats &stats) {
+  RecordEncoder<tick> encoder;
+  RecordDecoder<tick> decoder;
+  std::vector<tick> out(in.size());
+  std::size_t done = 0;
+  while (done < in.size()) {
+    auto block = encoder.encode_block(std::span(in).subspan(done));
+    done += decoder.decode_block(block, std::span(out).subspan(done));
+  }
+  stats = encoder.stats();
+  return out;
+}
+
+void test_pack_every_width() {
+  lcg rng{7};
+  for (unsigned bits = 0; bits <= 64; ++bits) {
+    uint64_t in[64];
+    uint64_t packed[64] = {};
+    uint64_t out[64];
+    auto mask = bits == 64 ? ~0ull : (1ull << bits) - 1;
+    for (auto &value : in) {
+      value = (rng.next() << 11 ^ rng.next()) & mask;
+    }
+    detail::pack_kernels[bits](in, packed);
+    detail::unpack_kernels[bits](packed, out);
+    ASSERT(std::memcmp(in, out, sizeof(in)) == 0, "Width " << bits);
+    for (unsigned word = bits; word < 64; ++word) {
+      ASSERT(packed[word] == 0, "Only `bits` words are written");
+    }
+  }
+}
+
+void test_numeric_stream_compresses() {
+  auto in = ticks(10000, 1);
+  codec_stats stats;
+  auto out = roundtrip(in, stats);
+  ASSERT(out == in, "Lossless");
+  ASSERT(stats.records == in.size(), "Every record counted");
+  ASSERT(stats.raw_bytes == in.size() * sizeof(tick), "Raw bytes counted");
+  ASSERT(stats.ratio() > 3, "Neighbouring records share most bits, got "
+                                << stats.ratio());
+  ASSERT(stats.columns[static_cast<int>(column_coding::delta)] > 0,
+         "Timestamps and sequences use deltas");
+}
+
+void test_random_data_barely_grows() {
+  std::vector<tick> in(1000);
+  lcg rng{3};
+  for (auto &record : in) {
+    uint64_t words[4];
+    for (auto &word : words) {
+      word = rng.next() << 11 ^ rng.next();
+    }
+    std::memcpy(&record, words, sizeof(words));
+  }
+  codec_stats stats;
+  auto out = roundtrip(in, stats);
+  ASSERT(std::memcmp(out.data(), in.data(), in.size() * sizeof(tick)) == 0,
+         "Lossless");
+  ASSERT(stats.ratio() > 0.95, "Headers are the only overhead");
+}
+
+void test_partial_and_constant_blocks() {
+  std::vector<tick> in(77, tick{42, 1.5, 9, 3, 1});
+  codec_stats stats;
+  auto out = roundtrip(in, stats);
+  ASSERT(out == in, "Lossless");
+  ASSERT(stats.blocks == 1, "One short block");
+  ASSERT(stats.encoded_bytes == sizeof(CodecBlockHeader) +
+                                    4 * sizeof(CodecColumnHeader),
+         "Constant columns pack to nothing");
+}
+
+struct sample {
+  uint32_t id;
+  uint32_t value;
+  bool operator==(const sample &) const = default;
+};
+
+// The last column packs into no words, so its kernels sit at the end of the
+// block and must not touch it; codec-tests runs under ASan to catch that.
+void test_constant_last_column() {
+  std::vector<sample> in(200);
+  for (uint32_t i = 0; i < in.size(); ++i) {
+    in[i] = {i * 2654435761u, 7};
+  }
+  RecordEncoder<sample, uint32_t> encoder;
+  RecordDecoder<sample, uint32_t> decoder;
+  std::vector<sample> out(in.size());
+  std::size_t done = 0;
+  while (done < in.size()) {
+    auto block = encoder.encode_block(std::span(in).subspan(done));
+    std::vector<std::byte> exact(block.begin(), block.end());
+    done += decoder.decode_block(exact, std::span(out).subspan(done));
+  }
+  ASSERT(out == in, "Lossless");
+}
+
+void test_32_bit_words() {
+  std::vector<sample> in(1000);
+  for (uint32_t i = 0; i < in.size(); ++i) {
+    in[i] = {i, 0xfffffff0u + i % 32};
+  }
+  RecordEncoder<sample, uint32_t> encoder(128);
+  RecordDecoder<sample, uint32_t> decoder;
+  std::vector<sample> out(in.size());
+  std::size_t done = 0;
+  while (done < in.size()) {
+    auto block = encoder.encode_block(std::span(in).subspan(done));
+    done += decoder.decode_block(block, std::span(out).subspan(done));
+  }
+  ASSERT(out == in, "Lossless, including wrapping deltas");
+  ASSERT(encoder.stats().ratio() > 4, "Narrow residuals");
+}
+
+// Records through a pipe-sized ring, as RecordEncoder and RecordDecoder
+// stages on both ends of a pipe would see them.
+void test_through_a_ring() {
+  auto in = ticks(50000, 2);
+  rb::PodRingBuffer<tick> source(4096);
+  rb::PodRingBuffer<tick> destination(4096);
+  std::vector<std::byte> ring(16 << 10);
+  uint32_t head = 0;
+  uint32_t tail = 0;
+
+  RecordEncoder<tick> encoder;
+  RecordDecoder<tick> decoder;
+  std::vector<tick> out;
+  std::size_t offered = 0;
+  while (out.size() < in.size()) {
+    offered += source.try_push_bulk(std::span(in).subspan(offered));
+    encoder.pump(source, ring, head, tail);
+    decoder.poll(ring, head, tail, destination);
+    while (auto record = destination.try_pop()) {
+      out.push_back(*record);
+    }
+  }
+  ASSERT(out == in, "Every record arrives in order");
+  ASSERT(encoder.stats().encoded_bytes * 3 < encoder.stats().raw_bytes,
+         "Fewer bytes cross the ring");
+}
+
+void test_rejects_bad_blocks() {
+  auto in = ticks(64, 4);
+  RecordEncoder<tick> encoder;
+  auto block = encoder.encode_block(in);
+  std::vector<std::byte> copy(block.begin(), block.end());
+  std::vector<tick> out(64);
+
+  auto rejects = [&](auto &&decoder, std::span<const std::byte> bytes) {
+    try {
+      decoder.decode_block(bytes, out);
+    } catch (const std::runtime_error &) {
+      return true;
+    }
+    return false;
+  };
+  ASSERT(rejects(RecordDecoder<tick>{}, std::span(copy).first(100)),
+         "Truncated block");
+  ASSERT(rejects(RecordDecoder<tick, uint32_t>{}, copy), "Wrong record type");
+  copy[0] = std::byte{0};
+  ASSERT(rejects(RecordDecoder<tick>{}, copy), "Bad magic");
+
+  bool threw = false;
+  try {
+    RecordEncoder<tick> bad(100);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  ASSERT(threw, "Block size must be whole groups");
+}
+
+int main() {
+  std::cout << "Running Codec Tests\n";
+  std::cout << "===================\n\n";
+
+  try {
+    TEST_CASE(pack_every_width);
+    TEST_CASE(numeric_stream_compresses);
+    TEST_CASE(random_data_barely_grows);
+    TEST_CASE(partial_and_constant_blocks);
+    TEST_CASE(constant_last_column);
+    TEST_CASE(32_bit_words);
+    TEST_CASE(through_a_ring);
+    TEST_CASE(rejects_bad_blocks);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,202 @@
+#include "oc/rb/columnar_rb.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace oc::rb;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+struct quote {
+  uint64_t timestamp_ns;
+  double bid;
+  double ask;
+  uint32_t bid_size;
+  uint16_t venue;
+  uint8_t flags;
+  char pad[33];
+};
+
+static_assert(sizeof(quote) == 64);
+
+using quote_ring = ColumnarRingBuffer<quote, &quote::timestamp_ns, &quote::bid,
+                                      &quote::venue, &quote::flags>;
+
+quote make_quote(uint64_t i) {
+  quote q{};
+  q.timestamp_ns = 1000 + i;
+  q.bid = 100.0 + static_cast<double>(i % 100) * 0.01;
+  q.ask = q.bid + 0.01;
+  q.bid_size = static_cast<uint32_t>(i);
+  q.venue = static_cast<uint16_t>(i % 9);
+  q.flags = static_cast<uint8_t>(i);
+  return q;
+}
+
+std::vector<quote> quotes(std::size_t count, uint64_t first = 0) {
+  std::vector<quote> out(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = make_quote(first + i);
+  }
+  return out;
+}
+
+void test_columns_are_aligned() {
+  quote_ring ring(100);
+  ASSERT(ring.capacity() == 128, "Rounded up to a power of two");
+  ring.try_push_bulk(quotes(10));
+  auto check = [](const void *p) {
+    return reinterpret_cast<uintptr_t>(p) % quote_ring::column_alignment == 0;
+  };
+  ASSERT(check(ring.get_column_views<&quote::timestamp_ns>()[0].data()),
+         "timestamp column");
+  ASSERT(check(ring.get_column_views<&quote::bid>()[0].data()), "bid column");
+  ASSERT(check(ring.get_column_views<&quote::venue>()[0].data()),
+         "venue column");
+  ASSERT(check(ring.get_column_views<&quote::flags>()[0].data()),
+         "flags column");
+}
+
+void test_push_transposes() {
+  quote_ring ring(64);
+  auto in = quotes(50);
+  ASSERT(ring.try_push_bulk(in) == 50, "All taken");
+  auto bids = ring.get_column_views<&quote::bid>();
+  auto venues = ring.get_column_views<&quote::venue>();
+  ASSERT(bids[0].size() == 50 && bids[1].empty(), "One contiguous run");
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    ASSERT(bids[0][i] == in[i].bid && venues[0][i] == in[i].venue,
+           "Element " << i);
+  }
+  ASSERT(ring.get_column_views<&quote::bid>(10)[0].size() == 10,
+         "Limited view");
+
+  std::vector<quote> out(50);
+  ASSERT(ring.try_pop_bulk(out) == 50 && ring.empty(), "All read back");
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    ASSERT(out[i].timestamp_ns == in[i].timestamp_ns &&
+               out[i].bid == in[i].bid && out[i].venue == in[i].venue &&
+               out[i].flags == in[i].flags,
+           "Stored fields round trip");
+    ASSERT(out[i].ask == 0 && out[i].bid_size == 0, "Others are not stored");
+  }
+}
+
+void test_views_across_the_wrap() {
+  quote_ring ring(64);
+  ring.try_push_bulk(quotes(40));
+  ring.advance_read(40);
+  auto in = quotes(60, 40);
+  ASSERT(ring.try_push_bulk(in) == 60, "Fits after the reads");
+  ASSERT(ring.try_push(make_quote(0)), "Push one");
+  ASSERT(ring.try_push_bulk(quotes(10)) == 3, "Only the free slots");
+
+  auto stamps = ring.get_column_views<&quote::timestamp_ns>();
+  ASSERT(stamps[0].size() == 24 && stamps[1].size() == 40,
+         "Split at the wrap");
+  uint64_t expected = 1040;
+  for (auto view : stamps) {
+    for (auto stamp : view) {
+      ASSERT(stamp == expected || expected >= 1100, "In order");
+      ++expected;
+    }
+  }
+  ASSERT(ring.full(), "Full");
+  ASSERT(ring.try_push_bulk(quotes(1)) == 0, "Nothing taken when full");
+}
+
+// A scan over one column, the way a vectorized consumer reads it.
+void test_column_scan() {
+  quote_ring ring(1 << 12);
+  auto in = quotes(3000);
+  ring.try_push_bulk(in);
+  double sum = 0;
+  std::size_t venue_three = 0;
+  for (auto view : ring.get_column_views<&quote::bid>()) {
+    sum = std::accumulate(view.begin(), view.end(), sum);
+  }
+  for (auto view : ring.get_column_views<&quote::venue>()) {
+    for (auto venue : view) {
+      venue_three += venue == 3;
+    }
+  }
+  double want = 0;
+  std::size_t want_three = 0;
+  for (const auto &q : in) {
+    want += q.bid;
+    want_three += q.venue == 3;
+  }
+  ASSERT(sum == want && venue_three == want_three, "Same as over records");
+}
+
+void test_producer_consumer_threads() {
+  constexpr uint64_t total = 200000;
+  quote_ring ring(256);
+  std::thread producer([&] {
+    uint64_t sent = 0;
+    while (sent < total) {
+      auto batch = quotes(std::min<uint64_t>(37, total - sent), sent);
+      std::size_t offset = 0;
+      while (offset < batch.size()) {
+        offset += ring.try_push_bulk(std::span(batch).subspan(offset));
+      }
+      sent += batch.size();
+    }
+  });
+
+  uint64_t received = 0;
+  while (received < total) {
+    auto stamps = ring.get_column_views<&quote::timestamp_ns>();
+    auto flags = ring.get_column_views<&quote::flags>();
+    std::size_t taken = 0;
+    for (int part = 0; part < 2; ++part) {
+      for (std::size_t i = 0; i < stamps[part].size(); ++i) {
+        ASSERT(stamps[part][i] == 1000 + received + taken, "In order");
+        ASSERT(flags[part][i] == static_cast<uint8_t>(received + taken),
+               "Columns line up");
+        ++taken;
+      }
+    }
+    ring.advance_read(taken);
+    received += taken;
+  }
+  producer.join();
+  ASSERT(ring.empty(), "Drained");
+}
+
+int main() {
+  std::cout << "Running Columnar Ring Tests\n";
+  std::cout << "===========================\n\n";
+
+  try {
+    TEST_CASE(columns_are_aligned);
+    TEST_CASE(push_transposes);
+    TEST_CASE(views_across_the_wrap);
+    TEST_CASE(column_scan);
+    TEST_CASE(producer_consumer_threads);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
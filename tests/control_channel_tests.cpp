@@ -0,0 +1,262 @@
+#include "oc/io/control_channel.hpp"
+#include "oc/io/epoll_reactor.hpp"
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace oc::io;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+std::pair<int, int> make_socket_pair() {
+  int fds[2];
+  ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "socketpair failed");
+  return {fds[0], fds[1]};
+}
+
+std::vector<std::byte> bytes_of(const std::string &s) {
+  auto view = std::as_bytes(std::span(s.data(), s.size()));
+  return {view.begin(), view.end()};
+}
+
+std::string string_of(const std::vector<std::byte> &bytes) {
+  return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+// Ops that just record completion, standing in for sender operation states
+struct TestSend : ControlChannel::SendOp {
+  std::vector<std::byte> storage;
+  bool done = false;
+
+  TestSend(uint32_t ch, std::vector<std::byte> data) : storage(std::move(data)) {
+    channel = ch;
+    payload = storage;
+    complete = [](ControlChannel::SendOp *op) noexcept {
+      static_cast<TestSend *>(op)->done = true;
+    };
+  }
+};
+
+struct TestReceive : ControlChannel::ReceiveOp {
+  bool done = false;
+
+  explicit TestReceive(uint32_t ch) {
+    channel = ch;
+    complete = [](ControlChannel::ReceiveOp *op) noexcept {
+      static_cast<TestReceive *>(op)->done = true;
+    };
+  }
+};
+
+struct TestIo : AsyncSocket::IoOp {
+  bool done = false;
+
+  TestIo(std::span<std::byte> buf, bool write, bool all) {
+    data = buf.data();
+    size = buf.size();
+    is_write = write;
+    exact = all;
+    complete = [](AsyncSocket::IoOp *op) noexcept {
+      static_cast<TestIo *>(op)->done = true;
+    };
+  }
+};
+
+template <typename Pred> void run_until(EpollReactor &reactor, Pred pred) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!pred()) {
+    ASSERT(std::chrono::steady_clock::now() < deadline, "Timed out");
+    reactor.run_once(10);
+  }
+}
+
+void test_posted_ops_run_on_reactor() {
+  EpollReactor reactor;
+  std::thread::id ran_on;
+  struct Op : oc::io::ReactorOp {
+    std::thread::id *ran_on;
+  } op;
+  op.ran_on = &ran_on;
+  op.execute = [](ReactorOp *base) noexcept {
+    *static_cast<Op *>(base)->ran_on = std::this_thread::get_id();
+  };
+
+  std::thread poster([&] { reactor.post(&op); });
+  poster.join();
+  run_until(reactor, [&] { return ran_on != std::thread::id{}; });
+  ASSERT(ran_on == std::this_thread::get_id(), "Op runs on the reactor thread");
+}
+
+void test_async_socket_exact_transfer() {
+  EpollReactor reactor;
+  auto [a, b] = make_socket_pair();
+  AsyncSocket left(reactor, a);
+  AsyncSocket right(reactor, b);
+
+  // larger than the socket buffer, so the write has to wait for the reader
+  std::vector<std::byte> out(4 << 20), in(out.size());
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    out[i] = static_cast<std::byte>(i * 7);
+  }
+
+  TestIo write(out, true, true);
+  TestIo read(in, false, true);
+  left.submit(&write);
+  right.submit(&read);
+  run_until(reactor, [&] { return write.done && read.done; });
+
+  ASSERT(write.error == 0 && read.error == 0, "No errors");
+  ASSERT(read.transferred == in.size(), "Exact read fills the buffer");
+  ASSERT(in == out, "Data arrives intact");
+}
+
+void test_async_socket_eof() {
+  EpollReactor reactor;
+  auto [a, b] = make_socket_pair();
+  AsyncSocket socket(reactor, a);
+
+  std::vector<std::byte> buf(16);
+  TestIo some(buf, false, false);
+  socket.submit(&some);
+  ::close(b);
+  run_until(reactor, [&] { return some.done; });
+  ASSERT(some.error == 0 && some.transferred == 0, "EOF completes with 0");
+
+  TestIo exact(buf, false, true);
+  socket.submit(&exact);
+  run_until(reactor, [&] { return exact.done; });
+  ASSERT(exact.error == ECONNRESET, "EOF fails an exact read");
+}
+
+void test_channels_are_multiplexed() {
+  EpollReactor reactor;
+  auto [a, b] = make_socket_pair();
+  ControlChannel left(reactor, a);
+  ControlChannel right(reactor, b);
+
+  // receive on channel 2 posted before anything arrives
+  TestReceive early(2);
+  right.submit(&early);
+
+  TestSend s1(1, bytes_of("one-a"));
+  TestSend s2(2, bytes_of("two-a"));
+  TestSend s3(1, bytes_of("one-b"));
+  left.submit(&s1);
+  left.submit(&s2);
+  left.submit(&s3);
+  run_until(reactor, [&] { return s1.done && s2.done && s3.done && early.done; });
+  ASSERT(string_of(early.message) == "two-a", "Waiting receive gets its frame");
+
+  TestReceive r1(1), r2(1);
+  right.submit(&r1);
+  right.submit(&r2);
+  run_until(reactor, [&] { return r1.done && r2.done; });
+  ASSERT(string_of(r1.message) == "one-a", "Queued frames keep send order");
+  ASSERT(string_of(r2.message) == "one-b", "Queued frames keep send order");
+}
+
+void test_large_and_empty_frames() {
+  EpollReactor reactor;
+  auto [a, b] = make_socket_pair();
+  ControlChannel left(reactor, a);
+  ControlChannel right(reactor, b);
+
+  std::vector<std::byte> big(512 * 1024);
+  for (std::size_t i = 0; i < big.size(); ++i) {
+    big[i] = static_cast<std::byte>(i);
+  }
+
+  TestSend empty(7, {});
+  TestSend large(7, big);
+  TestReceive r_empty(7), r_large(7);
+  left.submit(&empty);
+  left.submit(&large);
+  right.submit(&r_empty);
+  right.submit(&r_large);
+  run_until(reactor, [&] { return large.done && r_large.done && r_empty.done; });
+
+  ASSERT(r_empty.message.empty() && r_empty.error == 0, "Empty frame");
+  ASSERT(r_large.message == big, "Frame larger than the receive buffer");
+}
+
+void test_oversized_frame_rejected() {
+  EpollReactor reactor;
+  auto [a, b] = make_socket_pair();
+  ControlChannel left(reactor, a, 16);
+  ControlChannel right(reactor, b, 16);
+
+  TestSend too_big(0, std::vector<std::byte>(17));
+  left.submit(&too_big);
+  run_until(reactor, [&] { return too_big.done; });
+  ASSERT(too_big.error == EMSGSIZE, "Sender rejects oversized frames");
+}
+
+void test_hangup_fails_pending() {
+  EpollReactor reactor;
+  auto [a, b] = make_socket_pair();
+  ControlChannel channel(reactor, a);
+
+  TestReceive pending(3);
+  channel.submit(&pending);
+  reactor.run_once(0);
+  ASSERT(!pending.done, "Nothing to receive yet");
+  ::close(b);
+  run_until(reactor, [&] { return pending.done; });
+  ASSERT(pending.error == ECONNRESET, "Hang-up fails waiting receives");
+
+  TestSend after(3, bytes_of("late"));
+  channel.submit(&after);
+  run_until(reactor, [&] { return after.done; });
+  ASSERT(after.error == ECONNRESET, "Error is sticky");
+}
+
+void test_reactor_thread_stop() {
+  EpollReactor reactor;
+  std::thread loop([&] { reactor.run(); });
+  reactor.request_stop();
+  loop.join();
+  ASSERT(reactor.stop_requested(), "run() returns after request_stop()");
+}
+
+int main() {
+  std::cout << "Running Control Channel Tests\n";
+  std::cout << "=============================\n\n";
+
+  try {
+    TEST_CASE(posted_ops_run_on_reactor);
+    TEST_CASE(async_socket_exact_transfer);
+    TEST_CASE(async_socket_eof);
+    TEST_CASE(channels_are_multiplexed);
+    TEST_CASE(large_and_empty_frames);
+    TEST_CASE(oversized_frame_rejected);
+    TEST_CASE(hangup_fails_pending);
+    TEST_CASE(reactor_thread_stop);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include "oc/rb/scan.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace oc::rb;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+constexpr std::byte newline{'\n'};
+
+std::span<const std::byte> bytes_of(std::string_view text) {
+  return std::as_bytes(std::span(text.data(), text.size()));
+}
+
+ZeroCopyView<std::byte> view_of(std::string_view text) {
+  return {reinterpret_cast<const std::byte *>(text.data()), text.size()};
+}
+
+std::string text_of(const RecordPieces &record) {
+  std::string out;
+  for (auto piece : {record.first, record.second}) {
+    out.append(reinterpret_cast<const char *>(piece.data()), piece.size());
+  }
+  return out;
+}
+
+// every delimiter position on both sides of the 16 and 32 byte strides
+void test_find_every_position() {
+  for (std::size_t length : {0ul, 1ul, 15ul, 16ul, 17ul, 31ul, 32ul, 33ul,
+                             63ul, 64ul, 100ul}) {
+    std::string text(length, 'x');
+    ASSERT(find_delimiter(view_of(text), newline) == length,
+           "Not found in " << length);
+    for (std::size_t at = 0; at < length; ++at) {
+      text[at] = '\n';
+      ASSERT(find_delimiter(view_of(text), newline) == at,
+             "At " << at << " of " << length);
+      ASSERT(find_delimiter(view_of(text), newline, at + 1) == length,
+             "Nothing after " << at);
+      text[at] = 'x';
+    }
+  }
+}
+
+void test_count_records() {
+  std::string text;
+  std::size_t expected = 0;
+  for (int i = 0; i < 1000; ++i) {
+    text.append(static_cast<std::size_t>(i % 41), 'a');
+    if (i % 3 != 0) {
+      text.push_back('\n');
+      ++expected;
+    }
+  }
+  ASSERT(count_records(view_of(text), newline) == expected, "Single view");
+
+  auto split = text.size() / 3;
+  std::array views{view_of(std::string_view(text).substr(0, split)),
+                   view_of(std::string_view(text).substr(split))};
+  ASSERT(count_records(views, newline) == expected, "Both views");
+}
+
+void test_split_single_view() {
+  std::vector<std::string> records;
+  auto framed = split_records(view_of("alpha\n\nbeta\ngam"), newline,
+                              [&](const RecordPieces &record) {
+                                ASSERT(record.contiguous(), "No wrap");
+                                records.push_back(text_of(record));
+                              });
+  ASSERT((records == std::vector<std::string>{"alpha", "", "beta"}),
+         "Records without delimiters, empty ones included");
+  ASSERT(framed == 12, "The open record is left behind");
+}
+
+// A line feed through a small ring, so records keep straddling the wrap.
+void test_records_across_the_wrap() {
+  std::vector<std::string> lines;
+  for (int i = 0; i < 2000; ++i) {
+    lines.push_back(std::string(static_cast<std::size_t>(i * 7 % 90), 'a' + i % 26) +
+                    std::to_string(i));
+  }
+  std::string feed;
+  for (const auto &line : lines) {
+    feed += line + '\n';
+  }
+
+  PodRingBuffer<std::byte> ring(256);
+  std::vector<std::string> received;
+  std::size_t offered = 0;
+  std::size_t wrapped = 0;
+  while (received.size() < lines.size()) {
+    auto chunk = bytes_of(feed).subspan(offered);
+    offered += ring.try_push_bulk(chunk.first(std::min<std::size_t>(chunk.size(), 77)));
+    auto framed = split_records(ring.get_read_views(), newline,
+                                [&](const RecordPieces &record) {
+                                  wrapped += !record.contiguous();
+                                  received.push_back(text_of(record));
+                                });
+    ring.advance_read(framed);
+  }
+  ASSERT(received == lines, "Every line arrives whole and in order");
+  ASSERT(wrapped > 0, "Some lines straddled the wrap");
+  ASSERT(ring.empty(), "Everything consumed");
+}
+
+void test_wrap_edge_cases() {
+  auto collect = [](std::string_view first, std::string_view second) {
+    std::vector<std::string> out;
+    auto framed = split_records(std::array{view_of(first), view_of(second)},
+                                newline, [&](const RecordPieces &record) {
+                                  out.push_back(text_of(record));
+                                });
+    return std::pair{out, framed};
+  };
+  auto [on_edge, on_edge_bytes] = collect("ab\n", "cd\n");
+  ASSERT((on_edge == std::vector<std::string>{"ab", "cd"}), "Wrap on a boundary");
+  ASSERT(on_edge_bytes == 6, "All framed");
+
+  auto [straddle, straddle_bytes] = collect("ab\ncd", "ef\ngh");
+  ASSERT((straddle == std::vector<std::string>{"ab", "cdef"}), "Straddling record");
+  ASSERT(straddle_bytes == 8, "Trailing record left behind");
+
+  auto [open, open_bytes] = collect("abcd", "ef");
+  ASSERT(open.empty() && open_bytes == 0, "No delimiter, nothing framed");
+
+  ASSERT(find_delimiter(std::array{view_of("abc"), view_of("d\ne")}, newline) == 4,
+         "Found in the second view");
+}
+
+int main() {
+  std::cout << "Running Delimiter Scan Tests\n";
+  std::cout << "============================\n\n";
+
+  try {
+    TEST_CASE(find_every_position);
+    TEST_CASE(count_records);
+    TEST_CASE(split_single_view);
+    TEST_CASE(records_across_the_wrap);
+    TEST_CASE(wrap_edge_cases);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,267 @@
+#include "oc/filter.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace oc;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+struct order {
+  uint64_t id;
+  double price;
+  int32_t quantity;
+  uint16_t venue;
+  uint16_t flags;
+  uint64_t timestamp_ns;
+
+  bool operator==(const order &) const = default;
+};
+
+struct fill {
+  uint64_t id;
+  double price;
+
+  bool operator==(const fill &) const = default;
+};
+
+static_assert(detail::FilterField<double> && detail::FilterField<uint64_t>);
+static_assert(!detail::FilterField<long double>,
+              "Operands wider than the predicate's 8 bytes are refused");
+static_assert(!detail::FilterField<bool>);
+
+std::vector<order> orders(std::size_t count) {
+  std::vector<order> out(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = {i,
+              100.0 + static_cast<double>(i % 50) * 0.5,
+              static_cast<int32_t>(i % 200) - 100,
+              static_cast<uint16_t>(i % 7),
+              static_cast<uint16_t>(i % 16),
+              1000 * i};
+  }
+  return out;
+}
+
+template <typename Keep>
+std::vector<order> expected(const std::vector<order> &in, Keep keep) {
+  std::vector<order> out;
+  for (const auto &o : in) {
+    if (keep(o)) {
+      out.push_back(o);
+    }
+  }
+  return out;
+}
+
+std::vector<order> run(RecordFilter<order> &filter,
+                       const std::vector<order> &in) {
+  std::vector<order> out(in.size());
+  auto [consumed, written] = filter.filter(in, out);
+  ASSERT(consumed == in.size(), "Room for everything");
+  out.resize(written);
+  return out;
+}
+
+void test_each_test() {
+  auto in = orders(1000);
+  {
+    RecordFilter<order> filter;
+    filter.where(&order::venue, field_test::equal, uint16_t{3});
+    ASSERT(run(filter, in) ==
+               expected(in, [](const order &o) { return o.venue == 3; }),
+           "equal");
+  }
+  {
+    RecordFilter<order> filter;
+    filter.where(&order::venue, field_test::not_equal, uint16_t{3});
+    ASSERT(run(filter, in) ==
+               expected(in, [](const order &o) { return o.venue != 3; }),
+           "not_equal");
+  }
+  {
+    RecordFilter<order> filter;
+    filter.where(&order::quantity, field_test::less, -20);
+    ASSERT(run(filter, in) ==
+               expected(in, [](const order &o) { return o.quantity < -20; }),
+           "less, signed");
+  }
+  {
+    RecordFilter<order> filter;
+    filter.where(&order::price, field_test::greater, 120.0);
+    ASSERT(run(filter, in) ==
+               expected(in, [](const order &o) { return o.price > 120.0; }),
+           "greater, floating point");
+  }
+  {
+    RecordFilter<order> filter;
+    filter.where(&order::timestamp_ns, field_test::between, uint64_t{5000},
+                 uint64_t{9000});
+    ASSERT(run(filter, in) == expected(in,
+                                       [](const order &o) {
+                                         return o.timestamp_ns >= 5000 &&
+                                                o.timestamp_ns <= 9000;
+                                       }),
+           "between, inclusive");
+  }
+  {
+    RecordFilter<order> filter;
+    filter.where(&order::flags, field_test::all_bits, uint16_t{0b0110});
+    ASSERT(run(filter, in) == expected(in,
+                                       [](const order &o) {
+                                         return (o.flags & 0b0110) == 0b0110;
+                                       }),
+           "all_bits");
+  }
+  {
+    RecordFilter<order> filter;
+    filter.where(&order::flags, field_test::any_bits, uint16_t{0b1001});
+    ASSERT(run(filter, in) ==
+               expected(in, [](const order &o) { return o.flags & 0b1001; }),
+           "any_bits");
+  }
+}
+
+void test_predicates_combine() {
+  auto in = orders(5000);
+  RecordFilter<order> filter;
+  filter.where(&order::venue, field_test::equal, uint16_t{2})
+      .where(&order::quantity, field_test::greater, 0)
+      .where(&order::flags, field_test::any_bits, uint16_t{1});
+  auto want = expected(in, [](const order &o) {
+    return o.venue == 2 && o.quantity > 0 && (o.flags & 1);
+  });
+  ASSERT(run(filter, in) == want, "ANDed");
+  ASSERT(filter.stats().examined == in.size(), "Everything examined");
+  ASSERT(filter.stats().passed == want.size(), "Survivors counted");
+  ASSERT(filter.stats().selectivity() < 0.1, "Few survive");
+}
+
+void test_projection() {
+  auto in = orders(700);
+  RecordFilter<order, fill> filter;
+  filter.where(&order::quantity, field_test::greater, 50)
+      .project(&order::id, &fill::id)
+      .project(&order::price, &fill::price);
+  std::vector<fill> out(in.size());
+  auto [consumed, written] = filter.filter(in, out);
+  ASSERT(consumed == in.size(), "All consumed");
+  std::vector<fill> want;
+  for (const auto &o : in) {
+    if (o.quantity > 50) {
+      want.push_back({o.id, o.price});
+    }
+  }
+  out.resize(written);
+  ASSERT(out == want, "Projected survivors");
+
+  RecordFilter<order> trimmed;
+  trimmed.project(&order::id, &order::id);
+  std::vector<order> same(3);
+  trimmed.filter(std::span(in).first(3), same);
+  ASSERT(same[2].id == 2 && same[2].price == 0 && same[2].timestamp_ns == 0,
+         "Unprojected fields are zero");
+}
+
+// Takes only what the output could hold if everything passed, and keeps
+// going while the output has room.
+void test_limited_output() {
+  auto in = orders(1000);
+  RecordFilter<order> filter;
+  filter.where(&order::venue, field_test::equal, uint16_t{0});
+  std::vector<order> out(20);
+  auto [consumed, written] = filter.filter(in, out);
+  ASSERT(consumed > out.size() && consumed < in.size(),
+         "Runs past the first batch, got " << consumed);
+  ASSERT(written <= out.size(), "Never overflows");
+  out.resize(written);
+  ASSERT(out == expected(std::vector(in.begin(),
+                                     in.begin() + static_cast<std::ptrdiff_t>(
+                                                      consumed)),
+                         [](const order &o) { return o.venue == 0; }),
+         "Survivors of what was consumed");
+}
+
+void test_pump_across_the_wrap() {
+  auto in = orders(20000);
+  rb::PodRingBuffer<order> source(1024);
+  rb::PodRingBuffer<order> destination(256);
+  RecordFilter<order> filter;
+  filter.where(&order::price, field_test::between, 110.0, 112.0);
+
+  std::vector<order> out;
+  std::size_t offered = 0;
+  while (offered < in.size() || !source.empty()) {
+    offered += source.try_push_bulk(
+        std::span(in).subspan(offered, std::min<std::size_t>(
+                                           in.size() - offered, 300)));
+    filter.pump(source, destination);
+    while (auto record = destination.try_pop()) {
+      out.push_back(*record);
+    }
+  }
+  ASSERT(out == expected(in,
+                         [](const order &o) {
+                           return o.price >= 110.0 && o.price <= 112.0;
+                         }),
+         "Survivors arrive in order");
+}
+
+void test_rejects_bad_setups() {
+  bool threw = false;
+  try {
+    RecordFilter<order> filter;
+    filter.where(&order::price, field_test::any_bits, 1.0);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  ASSERT(threw, "Bitmask on a floating point field");
+
+  threw = false;
+  try {
+    RecordFilter<order, fill> filter;
+    std::vector<order> in(1);
+    std::vector<fill> out(1);
+    filter.filter(in, out);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  ASSERT(threw, "Another record type without a projection");
+}
+
+int main() {
+  std::cout << "Running Filter Tests\n";
+  std::cout << "====================\n\n";
+
+  try {
+    TEST_CASE(each_test);
+    TEST_CASE(predicates_combine);
+    TEST_CASE(projection);
+    TEST_CASE(limited_output);
+    TEST_CASE(pump_across_the_wrap);
+    TEST_CASE(rejects_bad_setups);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,294 @@
+#include "oc/flight_recorder.hpp"
+#include "oc/metadata_page.hpp"
+#include "oc/oc_adapters/copy_adapter.hpp"
+#include "oc/pipe.hpp"
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exec/single_thread_context.hpp>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace oc;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+std::string temp_path(const char *name) {
+  return "/tmp/oc-flight-test-" + std::to_string(::getpid()) + "-" + name;
+}
+
+std::string dump_to_string(const FlightRecorder &recorder, const char *name) {
+  auto path = temp_path(name);
+  recorder.dump(path.c_str());
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  ::unlink(path.c_str());
+  return text.str();
+}
+
+std::size_t count(const std::string &text, const std::string &needle) {
+  std::size_t found = 0;
+  for (auto at = text.find(needle); at != std::string::npos;
+       at = text.find(needle, at + 1)) {
+    ++found;
+  }
+  return found;
+}
+
+void test_records_and_exports() {
+  FlightRecorder recorder(64);
+  recorder.begin(flight_event::round, 0);
+  recorder.begin(flight_event::transfer, 0, 4096);
+  recorder.end(flight_event::transfer, 0);
+  recorder.instant(flight_event::stall, 1,
+                   static_cast<uint64_t>(flight_stall::destination_full));
+  recorder.end(flight_event::round, 0);
+  ASSERT(recorder.recorded() == 5, "Every event is counted");
+
+  auto json = dump_to_string(recorder, "export");
+  ASSERT(json.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["),
+         "Chrome trace object");
+  ASSERT(json.ends_with("]}\n"), "Trace is closed");
+  ASSERT(count(json, "\"name\":\"round\"") == 2, "Round begin and end");
+  ASSERT(count(json, "\"ph\":\"B\"") == 2 && count(json, "\"ph\":\"E\"") == 2,
+         "Spans are begin/end pairs");
+  ASSERT(count(json, "\"bytes\":4096") == 1, "Transfer size is an argument");
+  ASSERT(count(json, "\"reason\":\"destination_full\"") == 1,
+         "Stall reason is named");
+  ASSERT(count(json, "\"name\":\"pipe 0\"") == 1 &&
+             count(json, "\"name\":\"pipe 1\"") == 1,
+         "One named process per pipe");
+}
+
+void test_keeps_the_latest_events() {
+  FlightRecorder recorder(8);
+  ASSERT(recorder.events_per_thread() == 8, "Power-of-two ring");
+  for (uint64_t i = 0; i < 100; ++i) {
+    recorder.begin(flight_event::metadata_sync, 0, i);
+  }
+  auto json = dump_to_string(recorder, "latest");
+  ASSERT(count(json, "\"name\":\"metadata_sync\"") == 6,
+         "The ring's worth survives, less the slots the writer may be on");
+  ASSERT(count(json, "\"counter\":99") == 1 &&
+             count(json, "\"counter\":94") == 1 &&
+             count(json, "\"counter\":93") == 0 &&
+             count(json, "\"counter\":92") == 0,
+         "The oldest events were overwritten or may be");
+}
+
+void test_timestamps_are_ordered() {
+  FlightRecorder recorder(16);
+  recorder.instant(flight_event::round, 0, 0, 1000);
+  recorder.instant(flight_event::round, 0, 0,
+                   1000 + static_cast<uint64_t>(
+                              1e6 / utils::tsc_clock::ns_per_tick()));
+  auto json = dump_to_string(recorder, "ts");
+  auto first = json.find("\"ts\":");
+  auto second = json.find("\"ts\":", first + 1);
+  auto a = std::stod(json.substr(first + 5));
+  auto b = std::stod(json.substr(second + 5));
+  ASSERT(b - a > 990 && b - a < 1010, "Ticks convert to microseconds");
+}
+
+void test_one_ring_per_thread() {
+  FlightRecorder recorder(1024);
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&recorder, t] {
+      for (int i = 0; i < 100; ++i) {
+        recorder.begin(flight_event::round, t);
+        recorder.end(flight_event::round, t);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT(recorder.recorded() == 800, "No event lost");
+  auto json = dump_to_string(recorder, "threads");
+  ASSERT(count(json, "\"name\":\"round\"") == 800, "Every ring is exported");
+}
+
+void test_thread_limit() {
+  FlightRecorder recorder(16, 1);
+  recorder.instant(flight_event::round, 0);
+  std::thread([&] { recorder.instant(flight_event::round, 0); }).join();
+  ASSERT(recorder.recorded() == 1 && recorder.untracked() == 1,
+         "Threads past the limit are counted, not recorded");
+}
+
+// Dump concurrently with a writer lapping the ring: output stays well formed.
+void test_dump_while_recording() {
+  FlightRecorder recorder(64);
+  std::atomic<bool> stop{false};
+  std::thread writer([&] {
+    uint64_t i = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+      recorder.begin(flight_event::transfer, 0, ++i);
+    }
+  });
+  while (recorder.recorded() < 10000) {
+  }
+  for (int i = 0; i < 20; ++i) {
+    auto json = dump_to_string(recorder, "concurrent");
+    ASSERT(json.ends_with("]}\n"), "Trace is complete");
+    ASSERT(count(json, "\"name\":\"transfer\"") <= 64, "At most one ring");
+  }
+  stop = true;
+  writer.join();
+}
+
+void test_dumps_on_fatal_signal() {
+  auto path = temp_path("fatal");
+  auto child = ::fork();
+  if (child == 0) {
+    FlightRecorder recorder(16);
+    recorder.dump_on_fatal_signal(path.c_str());
+    recorder.instant(flight_event::stall, 3,
+                     static_cast<uint64_t>(flight_stall::metadata));
+    std::abort();
+  }
+  int status = 0;
+  ::waitpid(child, &status, 0);
+  ASSERT(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT,
+         "The signal still takes its course");
+
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  ::unlink(path.c_str());
+  ASSERT(count(text.str(), "\"reason\":\"metadata\"") == 1,
+         "The handler dumped the ring");
+}
+
+// Copies like copy_adapter, but completes on a worker thread, so a pipe has
+// to wait for every metadata store made with it.
+struct deferred_adapter {
+  using local_buf_t = std::span<const std::byte>;
+  using remote_buf_t = std::span<std::byte>;
+
+  struct copy_fn {
+    local_buf_t src;
+    remote_buf_t dst;
+
+    void operator()() const {
+      std::memcpy(dst.data(), src.data(),
+                  std::min(src.size_bytes(), dst.size_bytes()));
+    }
+  };
+
+  using scheduler_type =
+      decltype(std::declval<exec::single_thread_context &>().get_scheduler());
+  using transfer_type = decltype(ex::then(
+      ex::schedule(std::declval<scheduler_type>()), std::declval<copy_fn>()));
+
+  exec::single_thread_context *worker;
+
+  static local_buf_t slice_local(const local_buf_t &buf, std::size_t offset,
+                                 std::size_t len) {
+    return buf.subspan(offset, len);
+  }
+
+  static remote_buf_t slice_remote(const remote_buf_t &buf, std::size_t offset,
+                                   std::size_t len) {
+    return buf.subspan(offset, len);
+  }
+
+  transfer_type transfer(local_buf_t src, remote_buf_t dst) {
+    return ex::then(ex::schedule(worker->get_scheduler()), copy_fn{src, dst});
+  }
+};
+
+// A live pipe records both of its metadata stores as spans and marks each
+// one it had to wait for as a metadata stall.
+void test_records_pipe_metadata_stores() {
+  using copy_bytes = oc_adapters::copy_adapter<std::byte>;
+  MetadataPageLayout layout(1);
+  alignas(rb::cache_line_size) std::array<std::byte, 128> pages[4]{};
+  MetadataPage prev_upstream(pages[0], layout);
+  MetadataPage prev_downstream(pages[1], layout);
+  MetadataPage next_upstream(pages[2], layout);
+  MetadataPage next_downstream(pages[3], layout);
+
+  exec::single_thread_context worker;
+  deferred_adapter metadata{&worker};
+  std::vector<std::byte> src(4096), dst(4096);
+  auto pipe = std::make_shared<Pipe<copy_bytes, deferred_adapter,
+                                    deferred_adapter>>(
+      copy_bytes(), std::span<const std::byte>(src), std::span<std::byte>(dst));
+  pipe->set_prev_metadata(make_backward_metadata(
+      metadata, std::span<const std::byte>(prev_downstream.bytes()),
+      prev_upstream.bytes(), layout, 0));
+  pipe->set_next_metadata(make_forward_metadata(
+      metadata, std::span<const std::byte>(next_upstream.bytes()),
+      next_downstream.bytes(), layout, 0));
+
+  FlightRecorder recorder(256);
+  pipe->record_flight(recorder, 0);
+
+  prev_downstream.forward(0).tail.store(700); // produced
+  stdexec::sync_wait(pipe->transfer());
+  next_upstream.backward(0).head.store(700); // consumed
+  stdexec::sync_wait(pipe->transfer());
+  ASSERT(next_downstream.forward(0).tail.load() == 700 &&
+             prev_upstream.backward(0).head.load() == 700,
+         "Tail and head were stored");
+
+  auto json = dump_to_string(recorder, "pipe");
+  ASSERT(count(json, "\"name\":\"metadata_sync\"") == 4,
+         "A span around each store");
+  ASSERT(count(json, "\"counter\":700") == 2, "Stored counters are arguments");
+  ASSERT(count(json, "\"reason\":\"metadata\"") == 2,
+         "Each deferred store is a metadata stall");
+  ASSERT(pipe->stats.stall_metadata == 2, "Stalls are counted too");
+}
+
+int main() {
+  std::cout << "Running FlightRecorder Tests\n";
+  std::cout << "============================\n\n";
+
+  try {
+    TEST_CASE(records_and_exports);
+    TEST_CASE(keeps_the_latest_events);
+    TEST_CASE(timestamps_are_ordered);
+    TEST_CASE(one_ring_per_thread);
+    TEST_CASE(thread_limit);
+    TEST_CASE(dump_while_recording);
+    TEST_CASE(dumps_on_fatal_signal);
+    TEST_CASE(records_pipe_metadata_stores);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
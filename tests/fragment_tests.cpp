@@ -0,0 +1,195 @@
+#include "oc/fragment.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace oc;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+std::vector<std::byte> pattern(std::size_t size, uint32_t seed) {
+  std::vector<std::byte> out(size);
+  uint32_t x = seed * 2654435761u + 1;
+  for (auto &b : out) {
+    x = x * 1664525u + 1013904223u;
+    b = std::byte(x >> 24);
+  }
+  return out;
+}
+
+// One ring seen from both ends, as with the shared memory adapter: the
+// fragmenter advances tail, the reassembler advances head.
+struct loopback {
+  explicit loopback(std::size_t bytes) : ring(bytes) {}
+
+  std::vector<std::byte> ring;
+  uint32_t head = 0;
+  uint32_t tail = 0;
+};
+
+void test_blob_larger_than_ring() {
+  loopback link(64 << 10);
+  Fragmenter fragmenter(16 << 10);
+  Reassembler reassembler;
+
+  auto blob = pattern(100 << 20, 1);
+  std::vector<std::byte> received;
+  uint64_t delivered_id = ~0ull;
+  auto id = fragmenter.push(blob);
+
+  while (delivered_id != id) {
+    fragmenter.pump(link.ring, link.head, link.tail);
+    reassembler.poll(
+        link.ring, link.head, link.tail,
+        [&](uint64_t, uint64_t bytes) {
+          received.resize(bytes);
+          return std::span<std::byte>(received);
+        },
+        [&](uint64_t message, std::span<const std::byte> data) {
+          ASSERT(data.data() == received.data(), "Assembled in our buffer");
+          delivered_id = message;
+        });
+  }
+  ASSERT(received == blob, "100 MB through a 64 KiB ring intact");
+  ASSERT(fragmenter.idle() && fragmenter.sent() == id + 1, "All sent");
+  ASSERT(fragmenter.fragments() >= blob.size() / (16 << 10),
+         "Cut into ring-sized fragments");
+  ASSERT(reassembler.partial() == 0, "Nothing left half-assembled");
+}
+
+void test_small_messages_in_place() {
+  loopback link(4096);
+  Fragmenter fragmenter(1024);
+  Reassembler reassembler;
+
+  std::vector<std::vector<std::byte>> messages;
+  for (uint32_t i = 0; i < 200; ++i) {
+    messages.push_back(pattern(i % 300, i));
+  }
+
+  std::size_t next = 0;
+  std::size_t allocations = 0;
+  std::vector<std::byte> scratch;
+  std::size_t pushed = 0;
+  while (next < messages.size()) {
+    while (pushed < messages.size() && pushed < next + 8) {
+      fragmenter.push(messages[pushed++]);
+    }
+    fragmenter.pump(link.ring, link.head, link.tail);
+    reassembler.poll(
+        link.ring, link.head, link.tail,
+        [&](uint64_t, uint64_t bytes) {
+          ++allocations;
+          scratch.resize(bytes);
+          return std::span<std::byte>(scratch);
+        },
+        [&](uint64_t id, std::span<const std::byte> data) {
+          ASSERT(id == next, "In order");
+          ASSERT(data.size() == messages[next].size() &&
+                     std::memcmp(data.data(), messages[next].data(),
+                                 data.size()) == 0,
+                 "Intact");
+          ++next;
+        });
+  }
+  ASSERT(reassembler.delivered_in_place() + allocations == messages.size(),
+         "Each message either in place or assembled once");
+  ASSERT(reassembler.delivered_in_place() > messages.size() / 2,
+         "Most single-fragment messages skip the copy");
+}
+
+void test_discard_and_small_buffer() {
+  loopback link(8192);
+  Fragmenter fragmenter(512);
+  Reassembler reassembler;
+
+  auto big = pattern(3000, 7);
+  auto small = pattern(10, 8);
+  fragmenter.push(big);
+  fragmenter.push(small);
+  fragmenter.pump(link.ring, link.head, link.tail);
+
+  std::vector<uint64_t> seen;
+  reassembler.poll(
+      link.ring, link.head, link.tail,
+      [](uint64_t, uint64_t) { return std::span<std::byte>(); },
+      [&](uint64_t id, std::span<const std::byte>) { seen.push_back(id); });
+  ASSERT(seen.size() == 1 && seen[0] == 1, "Only the small message arrives");
+  ASSERT(reassembler.discarded() == 1, "The declined one is counted");
+  ASSERT(reassembler.partial() == 0, "Its fragments are skipped");
+
+  fragmenter.push(big);
+  fragmenter.pump(link.ring, link.head, link.tail);
+  std::vector<std::byte> tiny(100);
+  bool threw = false;
+  try {
+    reassembler.poll(
+        link.ring, link.head, link.tail,
+        [&](uint64_t, uint64_t) { return std::span<std::byte>(tiny); },
+        [](uint64_t, std::span<const std::byte>) {});
+  } catch (const std::length_error &) {
+    threw = true;
+  }
+  ASSERT(threw, "A buffer smaller than the message is an error");
+}
+
+void test_wrapped_single_fragment_is_copied() {
+  loopback link(1024);
+  link.head = link.tail = 1024 - 64; // next fragment straddles the end
+  Fragmenter fragmenter(1024);
+  Reassembler reassembler;
+
+  auto message = pattern(200, 3);
+  fragmenter.push(message);
+  fragmenter.pump(link.ring, link.head, link.tail);
+
+  std::vector<std::byte> buffer;
+  bool ok = false;
+  reassembler.poll(
+      link.ring, link.head, link.tail,
+      [&](uint64_t, uint64_t bytes) {
+        buffer.resize(bytes);
+        return std::span<std::byte>(buffer);
+      },
+      [&](uint64_t, std::span<const std::byte> data) {
+        ok = data.data() == buffer.data() && buffer == message;
+      });
+  ASSERT(ok, "A wrapped fragment is joined into the caller's buffer");
+  ASSERT(reassembler.delivered_in_place() == 0, "Not handed out in place");
+}
+
+int main() {
+  std::cout << "Running Fragment Tests\n";
+  std::cout << "======================\n\n";
+
+  try {
+    TEST_CASE(blob_larger_than_ring);
+    TEST_CASE(small_messages_in_place);
+    TEST_CASE(discard_and_small_buffer);
+    TEST_CASE(wrapped_single_fragment_is_copied);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
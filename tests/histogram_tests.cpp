@@ -0,0 +1,215 @@
+#include "utils/histogram.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace oc::utils;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+using layout = Histogram::layout;
+
+void test_layout_roundtrip() {
+  ASSERT(layout::index_of(0) == 0, "Zero in first bucket");
+  ASSERT(layout::index_of(127) == 127, "Linear range is exact");
+  ASSERT(layout::index_of(UINT64_MAX) == layout::bucket_count - 1,
+         "Largest value in last bucket");
+
+  std::mt19937_64 rng(11);
+  for (int i = 0; i < 100000; ++i) {
+    auto value = rng() >> (rng() % 64);
+    auto index = layout::index_of(value);
+    ASSERT(layout::lower_bound(index) <= value, "Value above lower bound");
+    ASSERT(layout::upper_bound(index) >= value, "Value below upper bound");
+    auto error = static_cast<double>(layout::upper_bound(index) -
+                                     layout::lower_bound(index));
+    ASSERT(value < 128 || error / static_cast<double>(value) < 1.0 / 64,
+           "Relative bucket width within precision");
+  }
+
+  for (std::size_t i = 1; i < layout::bucket_count; ++i) {
+    ASSERT(layout::lower_bound(i) == layout::upper_bound(i - 1) + 1,
+           "Buckets are contiguous");
+  }
+}
+
+void test_percentiles() {
+  Histogram h;
+  for (uint64_t v = 1; v <= 10000; ++v) {
+    h.record(v);
+  }
+  ASSERT(h.count() == 10000, "Count");
+  auto near = [](uint64_t got, double want) {
+    return std::abs(static_cast<double>(got) - want) / want < 0.02;
+  };
+  ASSERT(near(h.percentile(50), 5000), "p50");
+  ASSERT(near(h.percentile(99), 9900), "p99");
+  ASSERT(near(h.percentile(99.9), 9990), "p99.9");
+  ASSERT(near(h.percentile(100), 10000), "p100");
+  ASSERT(h.min() == 1, "Min");
+  ASSERT(near(h.max(), 10000), "Max");
+  ASSERT(near(static_cast<uint64_t>(h.mean()), 5000), "Mean");
+
+  Histogram empty;
+  ASSERT(empty.percentile(50) == 0 && empty.max() == 0, "Empty histogram");
+}
+
+// Values below 128 have buckets of their own, so small counts are exact.
+void test_small_count_percentiles() {
+  Histogram three;
+  for (uint64_t v : {10, 20, 30}) {
+    three.record(v);
+  }
+  ASSERT(three.percentile(0) == 10, "p0 is the minimum");
+  ASSERT(three.percentile(33) == 10, "One of three is 33.3%");
+  ASSERT(three.percentile(50) == 20, "p50 covers two of three");
+  ASSERT(three.percentile(100) == 30, "p100 is the maximum");
+
+  Histogram hundred;
+  for (uint64_t v = 1; v <= 100; ++v) {
+    hundred.record(v);
+  }
+  ASSERT(hundred.percentile(50) == 50, "p50 of 1..100");
+  ASSERT(hundred.percentile(99) == 99, "p99 of 1..100");
+  ASSERT(hundred.percentile(99.5) == 100, "Rounded up, never down");
+}
+
+void test_merge_and_since() {
+  Histogram a, b;
+  a.record(10, 5);
+  b.record(1000, 5);
+  auto before = a;
+  a.merge(b);
+  ASSERT(a.count() == 10, "Merged count");
+  ASSERT(a.percentile(50) == 10, "Lower half from a");
+  ASSERT(a.percentile(100) >= 990, "Upper half from b");
+
+  auto delta = a.since(before);
+  ASSERT(delta.count() == 5 && delta.min() >= 990, "Delta holds only b");
+}
+
+void test_serialization() {
+  Histogram h;
+  std::mt19937_64 rng(3);
+  for (int i = 0; i < 50000; ++i) {
+    h.record(rng() % 1000000);
+  }
+  auto bytes = h.serialize();
+  auto copy = Histogram::deserialize(bytes);
+  ASSERT(copy.count() == h.count(), "Count survives");
+  for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+    ASSERT(copy.bucket(i) == h.bucket(i), "Buckets survive");
+  }
+  ASSERT(bytes.size() < layout::bucket_count * 4, "Encoding is compact");
+
+  bool rejected = false;
+  try {
+    bytes.pop_back();
+    Histogram::deserialize(bytes);
+  } catch (const std::invalid_argument &) {
+    rejected = true;
+  }
+  ASSERT(rejected, "Truncated input rejected");
+
+  auto text = h.to_text();
+  ASSERT(text.starts_with("value percentile count\n"), "Text header");
+  ASSERT(text.find(" 100.000000 50000\n") != std::string::npos,
+         "Text ends at 100%");
+}
+
+void test_concurrent_recording() {
+  ConcurrentHistogram histogram;
+  constexpr int threads = 4;
+  constexpr uint64_t per_thread = 200000;
+  std::atomic<bool> stop{false};
+
+  // a reader merging continuously must never block or see more than written
+  std::thread reader([&] {
+    while (!stop.load()) {
+      auto snapshot = histogram.snapshot();
+      ASSERT(snapshot.count() <= threads * per_thread, "No phantom samples");
+    }
+  });
+
+  std::vector<std::thread> writers;
+  for (int t = 0; t < threads; ++t) {
+    writers.emplace_back([&, t] {
+      auto recorder = histogram.recorder();
+      for (uint64_t i = 0; i < per_thread; ++i) {
+        recorder.record(static_cast<uint64_t>(t + 1) * 100);
+      }
+    });
+  }
+  for (auto &w : writers) {
+    w.join();
+  }
+  stop.store(true);
+  reader.join();
+
+  auto snapshot = histogram.snapshot();
+  ASSERT(snapshot.count() == threads * per_thread, "Every sample merged");
+  ASSERT(snapshot.percentile(25) == 100, "Per-thread values kept");
+
+  // released shards are recycled and keep their counts
+  {
+    auto recorder = histogram.recorder();
+    recorder.record(1);
+  }
+  ASSERT(histogram.snapshot().count() == threads * per_thread + 1,
+         "Recycled shard keeps history");
+}
+
+void test_recording_cost() {
+  ConcurrentHistogram histogram;
+  auto recorder = histogram.recorder();
+  constexpr uint64_t n = 10000000;
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < n; ++i) {
+    recorder.record(i & 0xffff);
+  }
+  auto ns = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  std::cout << "(" << ns / n << " ns/record) ";
+  ASSERT(histogram.snapshot().count() == n, "All recorded");
+}
+
+int main() {
+  std::cout << "Running Histogram Tests\n";
+  std::cout << "=======================\n\n";
+
+  try {
+    TEST_CASE(layout_roundtrip);
+    TEST_CASE(percentiles);
+    TEST_CASE(small_count_percentiles);
+    TEST_CASE(merge_and_since);
+    TEST_CASE(serialization);
+    TEST_CASE(concurrent_recording);
+    TEST_CASE(recording_cost);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include "oc/instrument.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <exec/single_thread_context.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <stdexec/execution.hpp>
+#include <vector>
+
+// Built twice, as instrument-tests and, with OC_DISABLE_INSTRUMENTATION, as
+// instrument-tests-disabled: there the probes must pass everything through
+// and observe nothing.
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+#ifdef OC_DISABLE_INSTRUMENTATION
+constexpr bool instrumented = false;
+#else
+constexpr bool instrumented = true;
+#endif
+
+struct tick_sink {
+  std::vector<uint64_t> samples;
+  void record(uint64_t ticks) { samples.push_back(ticks); }
+};
+
+void test_timed() {
+  tick_sink sink;
+  auto [value] = stdexec::sync_wait(ex::just(7) | timed(sink)).value();
+  ASSERT(value == 7, "Value passed through");
+
+  bool threw = false;
+  try {
+    stdexec::sync_wait(timed(ex::just_error(std::make_exception_ptr(
+                                 std::runtime_error("transfer failed"))),
+                             &sink));
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  ASSERT(threw, "Error passed through");
+
+  auto stopped = stdexec::sync_wait(ex::just_stopped() | timed(sink));
+  ASSERT(!stopped, "Stop passed through");
+
+  ASSERT(sink.samples.size() == (instrumented ? 3u : 0u),
+         "One sample per completion, got " << sink.samples.size());
+}
+
+void test_counted() {
+  completion_counter counter;
+  for (int i = 0; i < 3; ++i) {
+    stdexec::sync_wait(ex::just(i) | counted(counter));
+  }
+  try {
+    stdexec::sync_wait(ex::just_error(std::make_exception_ptr(
+                           std::runtime_error("transfer failed"))) |
+                       counted(counter));
+  } catch (const std::runtime_error &) {
+  }
+  stdexec::sync_wait(counted(ex::just_stopped(), &counter));
+
+  ASSERT(counter.value == (instrumented ? 3u : 0u), "Value completions");
+  ASSERT(counter.error == (instrumented ? 1u : 0u), "Error completions");
+  ASSERT(counter.stopped == (instrumented ? 1u : 0u), "Stopped completions");
+  ASSERT(counter.total() == (instrumented ? 5u : 0u), "Total");
+}
+
+void test_sampled() {
+  std::vector<int> seen;
+  auto probe = sampled(3, [&](int v) { seen.push_back(v); });
+  for (int i = 0; i < 10; ++i) {
+    auto [value] = stdexec::sync_wait(ex::just(i) | probe).value();
+    ASSERT(value == i, "Value passed through");
+  }
+  try {
+    stdexec::sync_wait(ex::just_error(std::make_exception_ptr(
+                           std::runtime_error("transfer failed"))) |
+                       probe);
+  } catch (const std::runtime_error &) {
+  }
+  auto expected = instrumented ? std::vector<int>{2, 5, 8} : std::vector<int>{};
+  ASSERT(seen == expected, "Every third value, counted across the closure");
+
+  auto throwing = sampled(1, [](int) { throw std::runtime_error("probe"); });
+  auto [value] = stdexec::sync_wait(ex::just(1) | throwing).value();
+  ASSERT(value == 1, "A failing probe does not fail the sender");
+}
+
+// On in either build.
+void test_suspended() {
+  bool waited = true;
+  stdexec::sync_wait(ex::just() | suspended(waited));
+  ASSERT(!waited, "Inline completion did not wait");
+
+  exec::single_thread_context worker;
+  stdexec::sync_wait(ex::schedule(worker.get_scheduler()) |
+                     suspended(waited));
+  ASSERT(waited, "Completion on another thread waited");
+
+  stdexec::sync_wait(suspended(ex::just(), &waited));
+  ASSERT(!waited, "Flag reset by the next completion");
+}
+
+int main() {
+  std::cout << "Running Instrumentation Tests"
+            << (instrumented ? "" : " (disabled)") << "\n";
+  std::cout << "=============================\n\n";
+
+  try {
+    TEST_CASE(timed);
+    TEST_CASE(counted);
+    TEST_CASE(sampled);
+    TEST_CASE(suspended);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,202 @@
+#include "oc/io/senders.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace oc::io;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+std::pair<int, int> make_socket_pair() {
+  int fds[2];
+  ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "socketpair failed");
+  return {fds[0], fds[1]};
+}
+
+std::vector<std::byte> bytes_of(const std::string &s) {
+  auto view = std::as_bytes(std::span(s.data(), s.size()));
+  return {view.begin(), view.end()};
+}
+
+std::string string_of(std::span<const std::byte> bytes) {
+  return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+// A reactor driven by its own thread, so sync_wait can block on senders
+// that complete there. Stop it before the sockets watched by it go away.
+struct reactor_thread {
+  EpollReactor reactor;
+  std::thread thread{[this] { reactor.run(); }};
+
+  void stop() {
+    if (thread.joinable()) {
+      reactor.request_stop();
+      thread.join();
+    }
+  }
+
+  ~reactor_thread() { stop(); }
+};
+
+// sync_wait reports an std::error_code completion as std::system_error
+template <typename Sender> std::error_code error_of(Sender &&sender) {
+  try {
+    stdexec::sync_wait(std::forward<Sender>(sender));
+  } catch (const std::system_error &e) {
+    return e.code();
+  }
+  return {};
+}
+
+void test_scheduler_completes_on_reactor() {
+  reactor_thread rt;
+  auto scheduler = get_scheduler(rt.reactor);
+
+  auto [ran_on] = stdexec::sync_wait(ex::schedule(scheduler) | ex::then([] {
+                                       return std::this_thread::get_id();
+                                     }))
+                      .value();
+  ASSERT(ran_on == rt.thread.get_id(), "schedule() completes on the reactor");
+  ASSERT(ex::get_completion_scheduler<ex::set_value_t>(
+             ex::get_env(scheduler.schedule())) == scheduler,
+         "The sender names its completion scheduler");
+  rt.stop();
+}
+
+void test_read_and_write() {
+  reactor_thread rt;
+  auto [a, b] = make_socket_pair();
+  AsyncSocket left(rt.reactor, a);
+  AsyncSocket right(rt.reactor, b);
+
+  // larger than the socket buffer, so the write has to wait for the reader
+  std::vector<std::byte> out(4 << 20), in(out.size());
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    out[i] = static_cast<std::byte>(i * 7);
+  }
+  auto [written, read] =
+      stdexec::sync_wait(ex::when_all(async_write(left, out),
+                                      async_read(right, in)))
+          .value();
+  ASSERT(written == out.size() && read == in.size(), "Exact transfers");
+  ASSERT(in == out, "Data arrives intact");
+
+  auto hello = bytes_of("hello");
+  auto [sent] = stdexec::sync_wait(async_write_some(left, hello)).value();
+  ASSERT(sent == hello.size(), "Small write goes out at once");
+  std::vector<std::byte> buf(64);
+  auto [got] = stdexec::sync_wait(async_read_some(right, buf)).value();
+  ASSERT(string_of(std::span(buf).first(got)) == "hello",
+         "Read some completes with what arrived");
+  rt.stop();
+}
+
+void test_eof() {
+  reactor_thread rt;
+  auto [a, b] = make_socket_pair();
+  AsyncSocket socket(rt.reactor, a);
+  ::close(b);
+
+  std::vector<std::byte> buf(16);
+  auto [got] = stdexec::sync_wait(async_read_some(socket, buf)).value();
+  ASSERT(got == 0, "EOF completes read some with 0");
+
+  auto error = error_of(async_read(socket, buf));
+  ASSERT(error == std::errc::connection_reset,
+         "EOF fails an exact read, got " << error.message());
+  rt.stop();
+}
+
+void test_write_error() {
+  reactor_thread rt;
+  auto [a, b] = make_socket_pair();
+  AsyncSocket socket(rt.reactor, a);
+  ::close(b);
+
+  auto out = bytes_of("nobody listens");
+  auto error = error_of(async_write(socket, out));
+  ASSERT(error == std::errc::broken_pipe,
+         "Writing to a closed peer fails, got " << error.message());
+  rt.stop();
+}
+
+void test_channel_send_and_receive() {
+  reactor_thread rt;
+  auto [a, b] = make_socket_pair();
+  ControlChannel left(rt.reactor, a);
+  ControlChannel right(rt.reactor, b);
+
+  auto [message] =
+      stdexec::sync_wait(ex::when_all(receive(right, 2),
+                                      send(left, 2, bytes_of("two"))))
+          .value();
+  ASSERT(string_of(message) == "two", "Receive waits for its frame");
+
+  stdexec::sync_wait(send(left, 1, bytes_of("one-a")));
+  stdexec::sync_wait(send(left, 1, bytes_of("one-b")));
+  auto [first] = stdexec::sync_wait(receive(right, 1)).value();
+  auto [second] = stdexec::sync_wait(receive(right, 1)).value();
+  ASSERT(string_of(first) == "one-a" && string_of(second) == "one-b",
+         "Queued frames keep send order");
+  rt.stop();
+}
+
+void test_channel_errors() {
+  reactor_thread rt;
+  auto [a, b] = make_socket_pair();
+  ControlChannel channel(rt.reactor, a);
+
+  std::vector<std::byte> oversized(ControlChannel::default_max_frame_size + 1);
+  auto error = error_of(send(channel, 1, std::move(oversized)));
+  ASSERT(error == std::errc::message_size, "Oversized frame is refused");
+
+  ::close(b);
+  error = error_of(receive(channel, 1));
+  ASSERT(error == std::errc::connection_reset,
+         "Hang-up fails a waiting receive, got " << error.message());
+  error = error_of(send(channel, 1, bytes_of("late")));
+  ASSERT(error == std::errc::connection_reset, "The error is sticky");
+  rt.stop();
+}
+
+int main() {
+  std::cout << "Running IO Sender Tests\n";
+  std::cout << "=======================\n\n";
+
+  try {
+    TEST_CASE(scheduler_completes_on_reactor);
+    TEST_CASE(read_and_write);
+    TEST_CASE(eof);
+    TEST_CASE(write_error);
+    TEST_CASE(channel_send_and_receive);
+    TEST_CASE(channel_errors);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,305 @@
+#include "oc/metadata_page.hpp"
+#include "oc/oc_adapters/copy_adapter.hpp"
+#include "oc/pipe.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exec/inline_scheduler.hpp>
+#include <exec/single_thread_context.hpp>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <stdexec/execution.hpp>
+#include <vector>
+
+using namespace oc;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+// Copies like copy_adapter, but completes on a worker thread, the way a NIC
+// completion arrives after the submitting call has returned.
+struct deferred_adapter {
+  using local_buf_t = std::span<const std::byte>;
+  using remote_buf_t = std::span<std::byte>;
+
+  struct copy_fn {
+    local_buf_t src;
+    remote_buf_t dst;
+
+    void operator()() const {
+      std::memcpy(dst.data(), src.data(),
+                  std::min(src.size_bytes(), dst.size_bytes()));
+    }
+  };
+
+  using scheduler_type =
+      decltype(std::declval<exec::single_thread_context &>().get_scheduler());
+  using transfer_type = decltype(ex::then(
+      ex::schedule(std::declval<scheduler_type>()), std::declval<copy_fn>()));
+
+  exec::single_thread_context *worker;
+
+  static local_buf_t slice_local(const local_buf_t &buf, std::size_t offset,
+                                 std::size_t len) {
+    return buf.subspan(offset, len);
+  }
+
+  static remote_buf_t slice_remote(const remote_buf_t &buf, std::size_t offset,
+                                   std::size_t len) {
+    return buf.subspan(offset, len);
+  }
+
+  transfer_type transfer(local_buf_t src, remote_buf_t dst) {
+    return ex::then(ex::schedule(worker->get_scheduler()), copy_fn{src, dst});
+  }
+};
+
+using copy_bytes = oc_adapters::copy_adapter<std::byte>;
+
+// Copies without scatter-gather, so pipes cut each round into one transfer
+// per piece.
+struct segment_adapter {
+  using local_buf_t = std::span<const std::byte>;
+  using remote_buf_t = std::span<std::byte>;
+  using transfer_type = decltype(ex::then(
+      ex::just(), std::declval<deferred_adapter::copy_fn>()));
+
+  static local_buf_t slice_local(const local_buf_t &buf, std::size_t offset,
+                                 std::size_t len) {
+    return buf.subspan(offset, len);
+  }
+
+  static remote_buf_t slice_remote(const remote_buf_t &buf, std::size_t offset,
+                                   std::size_t len) {
+    return buf.subspan(offset, len);
+  }
+
+  transfer_type transfer(local_buf_t src, remote_buf_t dst) {
+    return ex::then(ex::just(), deferred_adapter::copy_fn{src, dst});
+  }
+};
+
+// Both peers' metadata pages for one pipe.
+struct page_pair {
+  MetadataPageLayout layout{1};
+  alignas(rb::cache_line_size) std::array<std::byte, 128> upstream_memory{};
+  alignas(rb::cache_line_size) std::array<std::byte, 128> downstream_memory{};
+  MetadataPage upstream{upstream_memory, layout};
+  MetadataPage downstream{downstream_memory, layout};
+};
+
+// One pipe between a producer and a consumer peer, each reached through a
+// metadata page pair: the pipe is downstream of `prev` and upstream of
+// `next`.
+template <typename MetadataAdapter> struct hop {
+  using pipe_type = Pipe<copy_bytes, MetadataAdapter, MetadataAdapter>;
+
+  explicit hop(MetadataAdapter metadata_adapter)
+      : src(1 << 12), dst(1 << 12),
+        pipe(std::make_shared<pipe_type>(
+            copy_bytes(), std::span<const std::byte>(src),
+            std::span<std::byte>(dst))) {
+    pipe->set_prev_metadata(make_backward_metadata(
+        metadata_adapter, std::span<const std::byte>(prev.downstream.bytes()),
+        prev.upstream.bytes(), prev.layout, 0));
+    pipe->set_next_metadata(make_forward_metadata(
+        metadata_adapter, std::span<const std::byte>(next.upstream.bytes()),
+        next.downstream.bytes(), next.layout, 0));
+  }
+
+  // what the producer and consumer peers write into our pages
+  void produced(uint32_t tail) { prev.downstream.forward(0).tail.store(tail); }
+  void consumed(uint32_t head) { next.upstream.backward(0).head.store(head); }
+
+  // what we wrote into theirs
+  uint32_t published_tail() { return next.downstream.forward(0).tail.load(); }
+  uint32_t published_head() { return prev.upstream.backward(0).head.load(); }
+
+  void round() { stdexec::sync_wait(pipe->transfer()); }
+
+  page_pair prev;
+  page_pair next;
+  std::vector<std::byte> src;
+  std::vector<std::byte> dst;
+  std::shared_ptr<pipe_type> pipe;
+};
+
+// Stores that complete on another thread are waited for and counted.
+void test_metadata_stores_are_published() {
+  exec::single_thread_context worker;
+  hop<deferred_adapter> h(deferred_adapter{&worker});
+  for (std::size_t i = 0; i < h.src.size(); ++i) {
+    h.src[i] = static_cast<std::byte>(i);
+  }
+
+  h.produced(1000);
+  h.round();
+  ASSERT(h.pipe->dst_tail == 1000, "Forwarded what was produced");
+  ASSERT(std::memcmp(h.src.data(), h.dst.data(), 1000) == 0, "Data copied");
+  ASSERT(h.published_tail() == 1000, "Tail stored after the transfer");
+
+  h.consumed(600);
+  h.round();
+  ASSERT(h.pipe->src_head == 600, "Head followed the consumer");
+  ASSERT(h.published_head() == 600, "Head stored back to the producer");
+
+  ASSERT(h.pipe->stats.stall_metadata == 2,
+         "Both stores were waited for, got " << h.pipe->stats.stall_metadata);
+}
+
+// Stores that complete inline cost no wait.
+void test_inline_stores_do_not_stall() {
+  hop<copy_bytes> h(copy_bytes{});
+  h.produced(512);
+  h.round();
+  h.consumed(512);
+  h.round();
+  ASSERT(h.published_tail() == 512, "Tail published");
+  ASSERT(h.published_head() == 512, "Head published");
+  ASSERT(h.pipe->stats.stall_metadata == 0, "Nothing waited for");
+}
+
+// A scheduler numbering pipes the line does not have is refused, and one
+// configured that way later leaves the line's own pipes running.
+void test_scheduler_larger_than_the_line() {
+  std::vector<std::byte> src(1 << 12), dst(1 << 12);
+  auto pipe = std::make_shared<Pipe<copy_bytes, copy_bytes, copy_bytes>>(
+      copy_bytes(), std::span<const std::byte>(src), std::span<std::byte>(dst));
+  PipeLine line;
+  line.push_pipe(pipe);
+
+  PipeScheduler oversized;
+  oversized.configure(3, {});
+  bool threw = false;
+  try {
+    line.schedule(oversized);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  ASSERT(threw, "Scheduler for four pipes on a line of one");
+
+  PipeScheduler scheduler;
+  line.schedule(scheduler);
+  scheduler.configure(2, {});
+  pipe->src_tail = 256;
+  stdexec::sync_wait(line.progress(exec::inline_scheduler{}));
+  ASSERT(pipe->dst_tail == 256, "The one real pipe still moved its data");
+}
+
+// Lists cutting into more pieces than the adapter takes are refused up
+// front instead of overflowing its piece list.
+void test_scatter_gather_bound() {
+  std::vector<std::byte> src(160), dst(160);
+  std::vector<std::span<const std::byte>> src_segments;
+  std::vector<std::span<std::byte>> dst_segments;
+  // offset by half a segment, so every boundary of both lists cuts
+  dst_segments.push_back(std::span(dst).first(5));
+  for (std::size_t i = 0; i < 16; ++i) {
+    src_segments.push_back(std::span<const std::byte>(src).subspan(i * 10, 10));
+    dst_segments.push_back(
+        std::span(dst).subspan(5 + i * 10, i == 15 ? 5 : 10));
+  }
+  copy_bytes adapter;
+  bool threw = false;
+  try {
+    adapter.transfer_sg(src_segments, dst_segments);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  ASSERT(threw, "32 pieces for an adapter that takes "
+                    << copy_bytes::max_sg_pieces);
+
+  src[42] = std::byte{7};
+  stdexec::sync_wait(adapter.transfer_sg(
+      std::span(src_segments).first(8), std::span(dst_segments).first(9)));
+  ASSERT(dst[42] == std::byte{7}, "Within the bound the lists are copied");
+}
+
+// Without scatter-gather a round is cut into one transfer per contiguous
+// piece, and every piece has landed by the time the round completes.
+void test_segmented_transfers_complete() {
+  std::vector<std::byte> src(1 << 12), dst(1 << 12);
+  for (std::size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<std::byte>(i * 3);
+  }
+  auto pipe = std::make_shared<Pipe<segment_adapter, copy_bytes, copy_bytes>>(
+      segment_adapter(), std::span<const std::byte>(src),
+      std::span<std::byte>(dst));
+
+  pipe->src_tail = 3000;
+  stdexec::sync_wait(pipe->transfer());
+  ASSERT(pipe->dst_tail == 3000, "Forwarded what was produced");
+  ASSERT(std::memcmp(src.data(), dst.data(), 3000) == 0, "Data copied");
+
+  // wraps both rings, so the round is cut in two
+  std::fill(dst.begin(), dst.end(), std::byte{0});
+  pipe->dst_head = 3000;
+  pipe->src_tail = 6000;
+  stdexec::sync_wait(pipe->transfer());
+  ASSERT(pipe->dst_tail == 6000, "Forwarded across the wrap");
+  ASSERT(std::memcmp(src.data() + 3000, dst.data() + 3000, 1096) == 0 &&
+             std::memcmp(src.data(), dst.data(), 6000 - 4096) == 0,
+         "Both pieces copied");
+}
+
+// Slot ranges may be empty, but never reach past the page.
+void test_metadata_ranges() {
+  MetadataPageLayout layout{4};
+  ASSERT(layout.forward_range(1, 2).first == layout.forward_offset(1),
+         "Forward range starts at its first slot");
+  ASSERT(layout.backward_range(3, 1).first == layout.backward_offset(3),
+         "Backward range starts at its first slot");
+  ASSERT(layout.forward_range(0, 0).second == 0 &&
+             layout.backward_range(4, 0).second == 0,
+         "Empty ranges are allowed up to the end");
+
+  auto rejects = [&](uint32_t first, uint32_t count) {
+    try {
+      (void)layout.forward_range(first, count);
+    } catch (const std::out_of_range &) {
+      return true;
+    }
+    return false;
+  };
+  ASSERT(rejects(3, 2), "Range past the last pipe");
+  ASSERT(rejects(5, 0), "Empty range past the end");
+  ASSERT(rejects(1, UINT32_MAX), "Count that wraps first + count");
+}
+
+int main() {
+  std::cout << "Running Pipe Tests\n";
+  std::cout << "==================\n\n";
+
+  try {
+    TEST_CASE(metadata_stores_are_published);
+    TEST_CASE(inline_stores_do_not_stall);
+    TEST_CASE(scheduler_larger_than_the_line);
+    TEST_CASE(scatter_gather_bound);
+    TEST_CASE(segmented_transfers_complete);
+    TEST_CASE(metadata_ranges);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,204 @@
+#include "oc/trace.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace oc;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+void test_samples_one_in_n() {
+  PipeTracer tracer(4, 1);
+  std::vector<uint64_t> ids;
+  for (uint32_t i = 1; i <= 16; ++i) {
+    if (auto id = tracer.produced(i * 100)) {
+      ids.push_back(id);
+    }
+  }
+  ASSERT(ids.size() == 4, "One record in four is sampled");
+  ASSERT(ids.front() == 1 && ids.back() == 4, "Trace ids count up from one");
+}
+
+// Synthetic stamps make the breakdown exact: each hop waits 100 ticks and
+// transfers for (hop + 1) * 1000 ticks.
+void test_per_hop_breakdown() {
+  constexpr std::size_t hops = 3;
+  PipeTracer tracer(1, hops);
+
+  tracer.produced(64);
+  PipeTracer::ticks t = utils::tsc_clock::now();
+  for (std::size_t hop = 0; hop < hops; ++hop) {
+    t += 100;
+    tracer.arrived(hop, 64, t);
+    t += (hop + 1) * 1000;
+    tracer.departed(hop, 64, t);
+  }
+  ASSERT(tracer.consumed(64, t + 50) == 1, "The record is finished");
+
+  auto scale = utils::tsc_clock::ns_per_tick();
+  auto result = tracer.snapshot();
+  ASSERT(result.traced == 1, "One record traced");
+  ASSERT(result.wait.size() == hops && result.transfer.size() == hops,
+         "Wait and transfer per hop");
+  for (std::size_t hop = 1; hop < hops; ++hop) {
+    auto expected = static_cast<double>((hop + 1) * 1000) * scale;
+    auto measured = static_cast<double>(result.transfer[hop].max());
+    ASSERT(measured >= expected * 0.98 && measured <= expected * 1.02,
+           "Transfer time lands in its hop");
+    ASSERT(result.transfer[hop].max() > result.transfer[hop - 1].max(),
+           "Later hops are slower in this setup");
+  }
+  ASSERT(result.end_to_end.max() >= result.transfer[hops - 1].max(),
+         "End to end covers every hop");
+}
+
+void test_batch_covers_many_records() {
+  PipeTracer tracer(1, 1);
+  for (uint32_t end = 10; end <= 100; end += 10) {
+    tracer.produced(end);
+  }
+
+  // one transfer moves the first half, the next moves the rest
+  tracer.arrived(0, 50);
+  tracer.departed(0, 50);
+  ASSERT(tracer.consumed(50) == 5, "Records up to the head are finished");
+  ASSERT(tracer.consumed(55) == 0, "Partially consumed records wait");
+
+  tracer.arrived(0, 100);
+  tracer.departed(0, 100);
+  ASSERT(tracer.consumed(100) == 5, "The rest finish with the second batch");
+  ASSERT(tracer.snapshot().traced == 10, "Every record traced");
+}
+
+void test_counter_wrap() {
+  PipeTracer tracer(1, 1);
+  uint32_t start = UINT32_MAX - 100;
+  tracer.produced(start + 50);
+  tracer.produced(start + 150); // past the wrap
+  tracer.arrived(0, start + 150);
+  tracer.departed(0, start + 150);
+  ASSERT(tracer.consumed(start + 80) == 1, "Positions before the wrap");
+  ASSERT(tracer.consumed(start + 150) == 1, "Positions after the wrap");
+}
+
+void test_drops_when_full() {
+  PipeTracer tracer(1, 1, 4);
+  for (uint32_t end = 1; end <= 6; ++end) {
+    tracer.produced(end);
+  }
+  ASSERT(tracer.snapshot().dropped == 2, "Samples beyond the span ring drop");
+
+  tracer.arrived(0, 6);
+  tracer.departed(0, 6);
+  ASSERT(tracer.consumed(6) == 4, "Only tracked spans finish");
+  ASSERT(tracer.produced(7) != 0, "Retired spans are reused");
+}
+
+void test_untraced_hop_skips_record() {
+  PipeTracer tracer(1, 2);
+  tracer.produced(8);
+  tracer.arrived(0, 8);
+  tracer.departed(0, 8);
+  ASSERT(tracer.consumed(8) == 1, "The span is retired");
+  ASSERT(tracer.snapshot().traced == 0,
+         "Records missing a hop stay out of the breakdown");
+}
+
+void test_threads() {
+  constexpr uint32_t records = 200000;
+  constexpr uint32_t record_bytes = 64;
+  PipeTracer tracer(16, 2);
+  std::atomic<uint32_t> produced{0}, hop0{0}, hop1{0};
+
+  std::thread producer([&] {
+    for (uint32_t i = 1; i <= records; ++i) {
+      while (i * record_bytes - hop1.load(std::memory_order_acquire) >
+             1024 * record_bytes) {
+      }
+      tracer.produced(i * record_bytes);
+      produced.store(i * record_bytes, std::memory_order_release);
+    }
+  });
+
+  auto forward = [&](std::size_t hop, std::atomic<uint32_t> &in,
+                     std::atomic<uint32_t> &out) {
+    uint32_t done = 0;
+    while (done != records * record_bytes) {
+      auto end = in.load(std::memory_order_acquire);
+      if (end == done) {
+        continue;
+      }
+      tracer.arrived(hop, end);
+      tracer.departed(hop, end);
+      out.store(end, std::memory_order_release);
+      done = end;
+    }
+  };
+  std::thread first([&] { forward(0, produced, hop0); });
+  std::thread second([&] { forward(1, hop0, hop1); });
+
+  uint32_t head = 0;
+  while (head != records * record_bytes) {
+    head = hop1.load(std::memory_order_acquire);
+    tracer.consumed(head);
+  }
+
+  producer.join();
+  first.join();
+  second.join();
+
+  auto result = tracer.snapshot();
+  ASSERT(result.traced + result.dropped == records / 16,
+         "Every sample is traced or dropped");
+  ASSERT(result.traced > 0, "Samples made it through");
+}
+
+void test_rejects_bad_config() {
+  bool threw = false;
+  try {
+    PipeTracer tracer(0, 1);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  ASSERT(threw, "A zero sampling interval is rejected");
+}
+
+int main() {
+  std::cout << "Running PipeTracer Tests\n";
+  std::cout << "========================\n\n";
+
+  try {
+    TEST_CASE(samples_one_in_n);
+    TEST_CASE(per_hop_breakdown);
+    TEST_CASE(batch_covers_many_records);
+    TEST_CASE(counter_wrap);
+    TEST_CASE(drops_when_full);
+    TEST_CASE(untraced_hop_skips_record);
+    TEST_CASE(threads);
+    TEST_CASE(rejects_bad_config);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,206 @@
+#include "oc/pipe_tuner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+using namespace oc;
+using namespace std::chrono_literals;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+// A link where each transfer pays a fixed cost plus its bytes at the per
+// stream rate, concurrent transfers share the link rate, and every extra
+// transfer in flight adds contention, so depth has an optimum.
+struct link_plant {
+  double overhead_ns = 5'000;
+  double stream_bytes_per_ns = 2;
+  double link_bytes_per_ns = 10;
+  double contention_ns = 800;
+
+  [[nodiscard]] double round_ns(tuning t) const {
+    auto chunk = static_cast<double>(t.chunk_bytes);
+    auto depth = static_cast<double>(t.depth);
+    return overhead_ns + contention_ns * depth * depth +
+           std::max(chunk / stream_bytes_per_ns,
+                    depth * chunk / link_bytes_per_ns);
+  }
+
+  [[nodiscard]] double throughput(tuning t) const {
+    return static_cast<double>(t.round_bytes()) / round_ns(t);
+  }
+
+  [[nodiscard]] double best(const tuner_options &options) const {
+    double best = 0;
+    for (auto chunk = options.min_chunk_bytes; chunk <= options.max_chunk_bytes;
+         chunk *= 2) {
+      for (auto depth = options.min_depth; depth <= options.max_depth;
+           ++depth) {
+        best = std::max(best, throughput({chunk, depth}));
+      }
+    }
+    return best;
+  }
+};
+
+utils::tsc_clock::ticks ticks_for(double ns) {
+  return static_cast<utils::tsc_clock::ticks>(
+      ns / utils::tsc_clock::ns_per_tick() + 0.5);
+}
+
+struct harness {
+  PipeTuner tuner;
+  utils::tsc_clock::ticks now = 1;
+
+  // run saturated rounds for `ns` of simulated time; `backlog` bytes are
+  // waiting at every round start (0: always more than the limits allow)
+  void run(const link_plant &plant, double ns, uint64_t backlog = 0) {
+    auto end = now + ticks_for(ns);
+    while (now < end) {
+      auto t = tuner.current();
+      auto waiting = backlog ? backlog : uint64_t{t.round_bytes()} * 4;
+      auto bytes = std::min<uint64_t>(waiting, t.round_bytes());
+      auto transfers = (bytes + t.chunk_bytes - 1) / t.chunk_bytes;
+      auto partial = tuning{static_cast<uint32_t>(std::min<uint64_t>(
+                                bytes, t.chunk_bytes)),
+                            static_cast<uint32_t>(transfers)};
+      auto elapsed = ticks_for(plant.round_ns(partial));
+      now += elapsed;
+      tuner.observe(bytes, transfers, elapsed, waiting, now);
+    }
+  }
+};
+
+void test_converges_to_the_best_point() {
+  tuner_options options;
+  harness h{PipeTuner(options)};
+  link_plant plant;
+  h.run(plant, 2e9);
+
+  auto best = plant.best(options);
+  auto got = plant.throughput(h.tuner.current());
+  ASSERT(got >= 0.85 * best, "Within 15% of the best throughput after 2 s");
+  ASSERT(h.tuner.metrics().windows >= 90, "One decision per window");
+  ASSERT(h.tuner.metrics().throughput_bytes_per_sec > 0,
+         "Throughput is reported");
+}
+
+void test_follows_a_load_change() {
+  tuner_options options;
+  harness h{PipeTuner(options)};
+  link_plant plant;
+  h.run(plant, 2e9);
+
+  // the link gets expensive to use concurrently and slow per transfer
+  link_plant changed;
+  changed.contention_ns = 20'000;
+  changed.overhead_ns = 40'000;
+  h.run(changed, 3e9);
+
+  auto best = changed.best(options);
+  auto got = changed.throughput(h.tuner.current());
+  ASSERT(got >= 0.85 * best, "Re-converged within 3 s of the change");
+}
+
+void test_holds_when_producer_bound() {
+  tuner_options options;
+  harness h{PipeTuner(options)};
+  link_plant plant;
+  h.run(plant, 5e8, 1024); // far less waiting than one chunk
+
+  ASSERT(h.tuner.current() == options.initial, "Limits never bound");
+  ASSERT(h.tuner.metrics().steps == 0, "No adjustments");
+  ASSERT(h.tuner.metrics().last_action == tuner_action::hold, "Holding");
+}
+
+void test_backs_off_above_latency_target() {
+  tuner_options options;
+  options.latency_target = 100us;
+  options.initial = {4 << 20, 16};
+  harness h{PipeTuner(options)};
+  link_plant plant;
+  h.run(plant, 2e9);
+
+  ASSERT(h.tuner.metrics().back_offs > 0, "Started above the target");
+  auto t = h.tuner.current();
+  auto per_transfer = plant.round_ns(t) / t.depth;
+  ASSERT(per_transfer <= 2 * 100'000, "Transfers stay near the target");
+}
+
+void test_respects_bounds() {
+  tuner_options options;
+  options.min_chunk_bytes = 16 << 10;
+  options.max_chunk_bytes = 128 << 10;
+  options.max_depth = 2;
+  harness h{PipeTuner(options)};
+  link_plant plant;
+  plant.contention_ns = 0; // bigger is always better
+  h.run(plant, 1e9);
+
+  auto t = h.tuner.current();
+  ASSERT(t.chunk_bytes >= options.min_chunk_bytes &&
+             t.chunk_bytes <= options.max_chunk_bytes,
+         "Chunk within bounds");
+  ASSERT(t.depth >= options.min_depth && t.depth <= options.max_depth,
+         "Depth within bounds");
+  ASSERT(plant.throughput(t) >=
+             0.85 * plant.throughput({options.max_chunk_bytes, 2}),
+         "Pinned near the upper corner");
+
+  bool threw = false;
+  try {
+    tuner_options empty;
+    empty.min_depth = 4;
+    empty.max_depth = 2;
+    PipeTuner bad(empty);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  ASSERT(threw, "Empty bounds are rejected");
+
+  threw = false;
+  try {
+    tuner_options inverted;
+    inverted.min_chunk_bytes = 1 << 20;
+    inverted.max_chunk_bytes = 1 << 10;
+    PipeTuner bad(inverted);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  ASSERT(threw, "Inverted chunk bounds are rejected before any clamp");
+}
+
+int main() {
+  std::cout << "Running PipeTuner Tests\n";
+  std::cout << "=======================\n\n";
+
+  try {
+    TEST_CASE(converges_to_the_best_point);
+    TEST_CASE(follows_a_load_change);
+    TEST_CASE(holds_when_producer_bound);
+    TEST_CASE(backs_off_above_latency_target);
+    TEST_CASE(respects_bounds);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,213 @@
+#include "oc/sim/pipeline_sim.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace oc;
+using namespace oc::sim;
+using namespace std::chrono_literals;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+pipeline_model make_model(std::size_t hops, const char *sizes,
+                          const char *rate) {
+  pipeline_model model;
+  model.sizes = bench::size_distribution::parse(sizes);
+  model.arrivals = bench::arrival_process::parse(rate);
+  model.hops.resize(hops);
+  model.messages = 20000;
+  return model;
+}
+
+bool near(double measured, double expected, double tolerance) {
+  return measured >= expected * (1 - tolerance) &&
+         measured <= expected * (1 + tolerance);
+}
+
+void test_plan_forward() {
+  auto plan = plan_forward(100, 100, 0, 64);
+  ASSERT(plan.outcome == forward_outcome::source_empty, "Nothing produced");
+
+  plan = plan_forward(200, 100, 36, 64);
+  ASSERT(plan.outcome == forward_outcome::destination_full, "No room in dst");
+
+  plan = plan_forward(200, 100, 60, 64);
+  ASSERT(plan.outcome == forward_outcome::move && plan.bytes == 24,
+         "Bounded by dst room");
+
+  plan = plan_forward(200, 100, 100, 64, 16);
+  ASSERT(plan.bytes == 16, "Bounded by the batch limit");
+
+  plan = plan_forward(8, 0xfffffff8u, 0xfffffff0u, 64);
+  ASSERT(plan.outcome == forward_outcome::move && plan.bytes == 16,
+         "Counters wrap");
+
+  ASSERT(ring_pieces(64, 64, 60, 8) == 2, "One wrap, two pieces");
+  ASSERT(ring_pieces(64, 32, 28, 8) == 2, "Either ring's boundary cuts");
+  ASSERT(ring_pieces(64, 64, 0, 64) == 1, "Whole ring is one piece");
+
+  std::vector<std::size_t> offsets;
+  auto covered = for_each_ring_piece(
+      64, 32, 28, 40, 16, 3,
+      [&](std::size_t src_offset, std::size_t dst_offset, std::size_t len) {
+        offsets.insert(offsets.end(), {src_offset, dst_offset, len});
+      });
+  ASSERT(covered == 36, "Stops after max_pieces, got " << covered);
+  ASSERT((offsets == std::vector<std::size_t>{28, 28, 4, 32, 0, 16, 48, 16,
+                                              16}),
+         "Cut by both rings and by max_piece");
+}
+
+// One message at a time through one idle hop: round overhead, wire time and
+// latency of the data, then latency of the tail.
+void test_unloaded_latency() {
+  auto model = make_model(1, "fixed:4096", "constant:1000");
+  model.messages = 100;
+  auto result = simulate(model);
+
+  const auto &hop = model.hops[0];
+  auto expected = hop.round_overhead.count() +
+                  4096 / hop.link.bandwidth_bytes_per_ns +
+                  hop.link.latency.count() + hop.metadata_link.latency.count();
+  ASSERT(result.messages == 100, "Every message is delivered");
+  ASSERT(near(static_cast<double>(result.latency_ns.percentile(50)), expected,
+              0.02),
+         "Latency adds up the hop's costs");
+  ASSERT(result.latency_ns.max() <= result.latency_ns.percentile(50) * 1.02,
+         "No queueing at low load");
+  ASSERT(result.hops[0].stalled_source > result.hops[0].transferring,
+         "An unloaded hop mostly waits for data");
+}
+
+void test_finds_the_bottleneck() {
+  auto model = make_model(3, "fixed:4096", "max");
+  model.hops[1].link.bandwidth_bytes_per_ns = 12.5 / 4; // 25 Gbit/s
+  auto result = simulate(model);
+
+  ASSERT(result.bottleneck == 1, "The slow link is the bottleneck");
+  ASSERT(result.gbit_per_second() <= 25.0, "Capped by the slowest link");
+  ASSERT(result.hops[1].utilization(result.elapsed) >
+             result.hops[0].utilization(result.elapsed),
+         "The bottleneck is the busiest hop");
+  for (const auto &hop : result.hops) {
+    auto accounted = hop.transferring + hop.metadata + hop.overhead +
+                     hop.stalled_source + hop.stalled_destination;
+    ASSERT(near(static_cast<double>(accounted.count()),
+                static_cast<double>(result.elapsed.count()), 0.01),
+           "Every hop's time is accounted for");
+  }
+}
+
+void test_deferred_metadata_flushes_when_idle() {
+  auto eager = make_model(2, "fixed:512", "poisson:200000");
+  auto lazy = eager;
+  for (auto &hop : lazy.hops) {
+    hop.metadata = metadata_policy::parse("bytes:65536");
+  }
+
+  auto eager_result = simulate(eager);
+  auto lazy_result = simulate(lazy);
+  ASSERT(lazy_result.messages == lazy.messages,
+         "Held back counters are published before going idle");
+  ASSERT(lazy_result.hops[0].metadata_stores <=
+             eager_result.hops[0].metadata_stores,
+         "Deferring never publishes more");
+}
+
+void test_segmented_transfers() {
+  auto model = make_model(1, "fixed:3000", "max");
+  model.source_capacity = 1 << 16;
+  model.hops[0].dst_capacity = 1 << 15;
+  model.hops[0].scatter_gather = false;
+  model.hops[0].max_in_flight = 1;
+  auto segmented = simulate(model);
+
+  model.hops[0].scatter_gather = true;
+  auto gathered = simulate(model);
+
+  ASSERT(segmented.messages == gathered.messages, "Same traffic delivered");
+  ASSERT(segmented.hops[0].transfers > gathered.hops[0].transfers,
+         "Ring wraps cost extra transfers without scatter-gather");
+}
+
+void test_deterministic() {
+  auto model = make_model(2, "pareto:64:65536:1.2", "poisson:100000");
+  model.hops[0].link.jitter = 500ns;
+  auto first = simulate(model);
+  auto second = simulate(model);
+  ASSERT(first.elapsed == second.elapsed &&
+             first.latency_ns.percentile(99) ==
+                 second.latency_ns.percentile(99),
+         "Same seed, same run");
+
+  model.seed = 2;
+  auto other = simulate(model);
+  ASSERT(other.elapsed != first.elapsed, "The seed drives the run");
+}
+
+void test_runs_for_duration() {
+  auto model = make_model(1, "fixed:1024", "constant:1000000");
+  model.messages = 0;
+  model.duration = 10ms;
+  auto result = simulate(model);
+  ASSERT(near(static_cast<double>(result.messages), 10000, 0.01),
+         "One million messages per second for 10 ms");
+}
+
+void test_rejects_bad_models() {
+  auto model = make_model(1, "fixed:4096", "max");
+  model.hops[0].dst_capacity = 1024;
+  bool threw = false;
+  try {
+    simulate(model);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  ASSERT(threw, "A message larger than a ring is rejected");
+
+  threw = false;
+  try {
+    metadata_policy::parse("every:0");
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  ASSERT(threw, "A zero publication threshold is rejected");
+}
+
+int main() {
+  std::cout << "Running Pipeline Simulator Tests\n";
+  std::cout << "================================\n\n";
+
+  try {
+    TEST_CASE(plan_forward);
+    TEST_CASE(unloaded_latency);
+    TEST_CASE(finds_the_bottleneck);
+    TEST_CASE(deferred_metadata_flushes_when_idle);
+    TEST_CASE(segmented_transfers);
+    TEST_CASE(deterministic);
+    TEST_CASE(runs_for_duration);
+    TEST_CASE(rejects_bad_models);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
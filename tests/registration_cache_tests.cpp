@@ -0,0 +1,248 @@
+#include "oc/mr/registration_cache.hpp"
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <set>
+#include <vector>
+
+using namespace oc::mr;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+// Records every (de)registration instead of talking to hardware
+struct MockBackend {
+  struct Registered {
+    std::byte *data;
+    std::size_t size;
+    int id;
+  };
+  using handle_type = Registered;
+
+  int next_id = 0;
+  std::set<int> *live;
+
+  explicit MockBackend(std::set<int> *live) : live(live) {}
+
+  handle_type register_region(std::span<std::byte> range) {
+    live->insert(next_id);
+    return {range.data(), range.size(), next_id++};
+  }
+
+  void deregister_region(handle_type &handle) {
+    ASSERT(live->erase(handle.id) == 1, "Region deregistered twice");
+  }
+};
+
+using MockCache = RegistrationCache<MockBackend>;
+
+void test_hit_within_cached_region() {
+  std::set<int> live;
+  std::vector<std::byte> memory(4096);
+  MockCache cache(MockBackend{&live});
+
+  auto whole = cache.acquire(std::span(memory));
+  auto part = cache.acquire(std::span(memory).subspan(128, 64));
+
+  ASSERT(live.size() == 1, "Sub-range should reuse the existing region");
+  ASSERT(part.handle().id == whole.handle().id, "Same handle expected");
+  ASSERT(part.offset() == 128, "Offset into the cached region");
+  ASSERT(cache.stats().hits == 1 && cache.stats().misses == 1,
+         "One hit and one miss");
+}
+
+void test_idle_regions_are_reused() {
+  std::set<int> live;
+  std::vector<std::byte> memory(4096);
+  MockCache cache(MockBackend{&live});
+
+  {
+    auto reg = cache.acquire(std::span(memory));
+  }
+  ASSERT(live.size() == 1, "Released region should stay registered");
+  ASSERT(cache.idle_regions() == 1, "Released region should be idle");
+
+  auto again = cache.acquire(std::span(memory));
+  ASSERT(cache.stats().registrations == 1, "Idle region should be reused");
+  ASSERT(cache.idle_regions() == 0, "Reacquired region is no longer idle");
+}
+
+void test_lru_eviction() {
+  std::set<int> live;
+  std::vector<std::byte> memory(4 * 4096);
+  MockCache cache(MockBackend{&live}, {.max_idle_regions = 2,
+                                       .merge_adjacent = false});
+
+  // Non-adjacent pages so nothing merges
+  auto page = [&](int i) { return std::span(memory).subspan(i * 4096, 1024); };
+
+  int first_id;
+  {
+    auto a = cache.acquire(page(0));
+    first_id = a.handle().id;
+  }
+  {
+    auto b = cache.acquire(page(1));
+  }
+  {
+    auto c = cache.acquire(page(2));
+  }
+
+  ASSERT(live.size() == 2, "Idle limit should evict one region");
+  ASSERT(live.count(first_id) == 0, "Least recently used region goes first");
+  ASSERT(cache.stats().evictions == 1, "One eviction");
+}
+
+void test_referenced_regions_are_not_evicted() {
+  std::set<int> live;
+  std::vector<std::byte> memory(4 * 4096);
+  MockCache cache(MockBackend{&live}, {.max_idle_regions = 0,
+                                       .merge_adjacent = false});
+
+  auto held = cache.acquire(std::span(memory).subspan(0, 1024));
+  {
+    auto dropped = cache.acquire(std::span(memory).subspan(8192, 1024));
+  }
+
+  ASSERT(live.size() == 1, "Only the referenced region should survive");
+  ASSERT(live.count(held.handle().id) == 1, "Referenced region kept");
+}
+
+void test_adjacent_ranges_merge() {
+  std::set<int> live;
+  std::vector<std::byte> memory(4096);
+  MockCache cache(MockBackend{&live});
+
+  {
+    auto left = cache.acquire(std::span(memory).subspan(0, 1024));
+  }
+  auto right = cache.acquire(std::span(memory).subspan(1024, 1024));
+
+  ASSERT(live.size() == 1, "Idle absorbed region should be deregistered");
+  ASSERT(right.region().data() == memory.data(), "Merged region starts left");
+  ASSERT(right.region().size() == 2048, "Merged region spans both ranges");
+  ASSERT(right.offset() == 1024, "Requested range offset in merged region");
+  ASSERT(cache.stats().merges == 1, "One merge");
+
+  auto left_again = cache.acquire(std::span(memory).subspan(0, 512));
+  ASSERT(cache.stats().registrations == 2, "Merged region serves both sides");
+}
+
+void test_merge_with_referenced_region() {
+  std::set<int> live;
+  std::vector<std::byte> memory(4096);
+  MockCache cache(MockBackend{&live});
+
+  auto left = cache.acquire(std::span(memory).subspan(0, 2048));
+  auto overlap = cache.acquire(std::span(memory).subspan(1024, 2048));
+
+  ASSERT(live.size() == 2, "Referenced region stays until released");
+  ASSERT(cache.cached_regions() == 1, "Only the merged region is indexed");
+  ASSERT(left.region().size() == 2048, "Old reference still sees old region");
+
+  left.reset();
+  ASSERT(live.size() == 1, "Superseded region goes on last release");
+}
+
+void test_flush_and_destruction() {
+  std::set<int> live;
+  std::vector<std::byte> memory(4 * 4096);
+  {
+    MockCache cache(MockBackend{&live}, {.merge_adjacent = false});
+    {
+      auto a = cache.acquire(std::span(memory).subspan(0, 1024));
+      auto b = cache.acquire(std::span(memory).subspan(8192, 1024));
+    }
+    auto kept = cache.acquire(std::span(memory).subspan(4096, 1024));
+
+    cache.flush();
+    ASSERT(live.size() == 1, "Flush should drop only idle regions");
+
+    kept.reset();
+  }
+  ASSERT(live.empty(), "Destruction should deregister everything");
+}
+
+void test_registration_move() {
+  std::set<int> live;
+  std::vector<std::byte> memory(4096);
+  MockCache cache(MockBackend{&live}, {.max_idle_regions = 0});
+
+  auto a = cache.acquire(std::span(memory));
+  auto b = std::move(a);
+  ASSERT(!a && b, "Moved-from registration should be empty");
+  ASSERT(live.size() == 1, "Move should not release");
+
+  b = MockCache::Registration{};
+  ASSERT(live.empty(), "Assigning over the last reference releases it");
+}
+
+// Freed memory must not be served from the cache again
+void test_invalidate() {
+  std::set<int> live;
+  std::vector<std::byte> memory(4 * 4096);
+  MockCache cache(MockBackend{&live}, {.merge_adjacent = false});
+  auto page = [&](int i) { return std::span(memory).subspan(i * 4096, 1024); };
+
+  {
+    auto idle = cache.acquire(page(0));
+  }
+  auto busy = cache.acquire(page(1));
+  auto untouched = cache.acquire(page(3));
+  int busy_id = busy.handle().id;
+
+  // covers the tail of page 0 and the head of page 1 only
+  cache.invalidate(std::span(memory).subspan(512, 4096));
+  ASSERT(cache.stats().invalidations == 2, "Both overlapping regions dropped");
+  ASSERT(cache.idle_regions() == 0, "Idle region deregistered");
+  ASSERT(live.size() == 2, "Referenced region lives until released");
+  ASSERT(cache.cached_regions() == 1, "Only the untouched region is indexed");
+
+  auto again = cache.acquire(page(1));
+  ASSERT(again.handle().id != busy_id, "Invalidated region is not hit again");
+  ASSERT(busy.handle().id == busy_id, "Old reference keeps its region");
+
+  busy.reset();
+  ASSERT(live.count(busy_id) == 0, "Released on the last reference");
+
+  // a range touching a region without overlapping it leaves it alone
+  cache.invalidate(std::span(memory).subspan(3 * 4096 + 1024, 1024));
+  ASSERT(cache.stats().invalidations == 2, "Adjacent region kept");
+  ASSERT(live.size() == 2, "Nothing else deregistered");
+}
+
+int main() {
+  std::cout << "Running Registration Cache Tests\n";
+  std::cout << "================================\n\n";
+
+  try {
+    TEST_CASE(hit_within_cached_region);
+    TEST_CASE(idle_regions_are_reused);
+    TEST_CASE(lru_eviction);
+    TEST_CASE(referenced_regions_are_not_evicted);
+    TEST_CASE(adjacent_ranges_merge);
+    TEST_CASE(merge_with_referenced_region);
+    TEST_CASE(flush_and_destruction);
+    TEST_CASE(registration_move);
+    TEST_CASE(invalidate);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+#include "oc/stats_page.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+
+using namespace oc;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+std::string temp_path(const char *name) {
+  return "/tmp/oc-stats-test-" + std::to_string(::getpid()) + "-" + name;
+}
+
+void test_layout() {
+  static_assert(sizeof(PipeStatsSlot) % rb::cache_line_size == 0);
+  static_assert(sizeof(StatsFileHeader) == rb::cache_line_size);
+  ASSERT(StatsFile::size_bytes(3) ==
+             sizeof(StatsFileHeader) + 3 * sizeof(PipeStatsSlot),
+         "Header followed by one slot per pipe");
+}
+
+void test_publish_and_attach() {
+  auto path = temp_path("attach");
+  auto writer = StatsFile::create(path, 2);
+
+  PipeStats stats;
+  stats.bytes_issued = 4096;
+  stats.transfers_issued = 3;
+  stats.dst_tail = 4096;
+  stats.stall_destination_full = 7;
+  writer.writer_slot(1).publish(stats);
+
+  auto reader = StatsFile::attach(path);
+  ASSERT(reader.num_pipes() == 2, "Pipe count comes from the header");
+  ASSERT(reader.header().version == StatsFileHeader::current_version,
+         "Current layout version");
+  ASSERT(reader.header().ns_per_tick > 0, "Tick conversion is recorded");
+
+  auto untouched = reader.slot(0).read();
+  ASSERT(untouched && untouched->bytes_issued == 0, "Slots start zeroed");
+  ASSERT(reader.slot(0).generation() == 0, "Nothing published to slot 0");
+
+  auto seen = reader.slot(1).read();
+  ASSERT(seen, "A quiescent slot always reads");
+  ASSERT(seen->bytes_issued == 4096 && seen->transfers_issued == 3 &&
+             seen->dst_tail == 4096 && seen->stall_destination_full == 7,
+         "Published counters are visible through the read-only mapping");
+  ASSERT(reader.slot(1).generation() == 1, "One publish");
+
+  bool threw = false;
+  try {
+    (void)reader.writer_slot(0);
+  } catch (const std::logic_error &) {
+    threw = true;
+  }
+  ASSERT(threw, "A monitor cannot write");
+
+  writer.unlink();
+}
+
+void test_rejects_foreign_files() {
+  auto path = temp_path("foreign");
+  {
+    auto writer = StatsFile::create(path, 1);
+  }
+  // corrupt the version as an older writer would have left it
+  {
+    FILE *file = std::fopen(path.c_str(), "r+b");
+    uint32_t version = StatsFileHeader::current_version + 1;
+    std::fseek(file, offsetof(StatsFileHeader, version), SEEK_SET);
+    std::fwrite(&version, sizeof(version), 1, file);
+    std::fclose(file);
+  }
+  bool threw = false;
+  try {
+    StatsFile::attach(path);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  ASSERT(threw, "A different layout version is refused");
+  ::unlink(path.c_str());
+
+  threw = false;
+  try {
+    StatsFile::attach(temp_path("missing"));
+  } catch (const std::system_error &) {
+    threw = true;
+  }
+  ASSERT(threw, "A missing file is reported");
+}
+
+// The writer keeps every counter equal; a torn read would mix two publishes.
+void test_reads_never_tear() {
+  auto path = temp_path("tear");
+  auto writer = StatsFile::create(path, 1);
+  auto reader = StatsFile::attach(path);
+
+  std::atomic<bool> done{false};
+  std::thread publisher([&] {
+    PipeStats stats;
+    for (uint64_t i = 1; i <= 200000; ++i) {
+      stats.bytes_issued = stats.transfers_issued = stats.src_tail =
+          stats.dst_head = stats.rounds = stats.round_ticks_last = i;
+      writer.writer_slot(0).publish(stats);
+    }
+    done.store(true);
+  });
+
+  uint64_t reads = 0;
+  uint64_t last = 0;
+  while (!done.load()) {
+    auto seen = reader.slot(0).read();
+    if (!seen) {
+      continue;
+    }
+    ASSERT(seen->bytes_issued == seen->transfers_issued &&
+               seen->bytes_issued == seen->src_tail &&
+               seen->bytes_issued == seen->dst_head &&
+               seen->bytes_issued == seen->rounds &&
+               seen->bytes_issued == seen->round_ticks_last,
+           "Snapshot is consistent");
+    ASSERT(seen->rounds >= last, "Snapshots never go back in time");
+    last = seen->rounds;
+    ++reads;
+  }
+  publisher.join();
+
+  auto final_stats = reader.slot(0).read();
+  ASSERT(final_stats && final_stats->rounds == 200000, "Last publish wins");
+  ASSERT(reads > 0, "The monitor made progress");
+  writer.unlink();
+}
+
+int main() {
+  std::cout << "Running StatsFile Tests\n";
+  std::cout << "=======================\n\n";
+
+  try {
+    TEST_CASE(layout);
+    TEST_CASE(publish_and_attach);
+    TEST_CASE(rejects_foreign_files);
+    TEST_CASE(reads_never_tear);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,217 @@
+#include "oc/capture.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace oc;
+using namespace std::chrono_literals;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+std::string temp_path(const char *name) {
+  return "/tmp/oc-capture-test-" + std::to_string(::getpid()) + "-" + name;
+}
+
+std::vector<std::byte> pattern(std::size_t size, uint8_t seed) {
+  std::vector<std::byte> out(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    out[i] = std::byte(static_cast<uint8_t>(seed + i));
+  }
+  return out;
+}
+
+utils::tsc_clock::ticks ticks_for(int64_t ns) {
+  return static_cast<utils::tsc_clock::ticks>(
+      static_cast<double>(ns) / utils::tsc_clock::ns_per_tick() + 0.5);
+}
+
+void test_round_trip() {
+  auto path = temp_path("round-trip");
+  {
+    StreamRecorder recorder(path);
+    auto base = utils::tsc_clock::now();
+    for (int i = 0; i < 100; ++i) {
+      auto data = pattern(static_cast<std::size_t>(i * 37 % 500), uint8_t(i));
+      ASSERT(recorder.record(data, base + ticks_for(i * 1000)), "Room to stage");
+    }
+    recorder.close();
+    ASSERT(recorder.recorded() == 100 && recorder.dropped() == 0,
+           "Everything was recorded");
+  }
+
+  auto capture = StreamCapture::load(path);
+  ASSERT(capture.has_payload(), "Payloads by default");
+  ASSERT(capture.records().size() == 100, "One entry per record");
+  ASSERT(capture.dropped() == 0, "No drops");
+  for (int i = 0; i < 100; ++i) {
+    const auto &entry = capture.records()[i];
+    auto expected = pattern(static_cast<std::size_t>(i * 37 % 500), uint8_t(i));
+    ASSERT(entry.bytes == expected.size(), "Record boundary kept");
+    ASSERT(std::memcmp(entry.payload.data(), expected.data(),
+                       expected.size()) == 0,
+           "Payload kept");
+    if (i > 0) {
+      auto gap = entry.offset - capture.records()[i - 1].offset;
+      ASSERT(gap >= 990ns && gap <= 1010ns, "Inter-arrival time kept");
+    }
+  }
+  std::remove(path.c_str());
+}
+
+void test_split_record() {
+  auto path = temp_path("split");
+  auto data = pattern(300, 7);
+  std::span<const std::byte> whole(data);
+  {
+    StreamRecorder recorder(path);
+    recorder.record(whole.first(100), whole.subspan(100));
+  }
+  auto capture = StreamCapture::load(path);
+  ASSERT(capture.records().size() == 1 && capture.records()[0].bytes == 300,
+         "Two pieces make one record");
+  ASSERT(std::memcmp(capture.records()[0].payload.data(), data.data(),
+                     data.size()) == 0,
+         "Pieces are joined in order");
+  std::remove(path.c_str());
+}
+
+void test_shape_only() {
+  auto path = temp_path("shape");
+  StreamRecorder recorder(path, {.payload = false});
+  for (std::size_t i = 1; i <= 1000; ++i) {
+    recorder.record(pattern(i, 0));
+  }
+  recorder.close();
+
+  auto capture = StreamCapture::load(path);
+  ASSERT(!capture.has_payload(), "Shape-only flag");
+  ASSERT(capture.records().size() == 1000, "All boundaries kept");
+  ASSERT(capture.records()[999].bytes == 1000 &&
+             capture.records()[999].payload.empty(),
+         "Sizes without data");
+
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  auto size = static_cast<std::size_t>(file.tellg());
+  ASSERT(size < sizeof(CaptureHeader) + 1000 * 8, "A few bytes per record");
+  std::remove(path.c_str());
+}
+
+void test_drops_instead_of_stalling() {
+  auto path = temp_path("drops");
+  StreamRecorder recorder(path, {.staging_bytes = 4096,
+                                 .idle_flush = std::chrono::milliseconds(50)});
+  auto big = pattern(1000, 1);
+  int accepted = 0;
+  for (int i = 0; i < 64; ++i) {
+    accepted += recorder.record(big);
+  }
+  ASSERT(recorder.dropped() > 0, "A full staging ring drops");
+  ASSERT(recorder.recorded() == uint64_t(accepted), "Counts agree");
+
+  std::this_thread::sleep_for(150ms);
+  ASSERT(recorder.record(big), "Room again once the writer drained");
+  recorder.close();
+
+  auto capture = StreamCapture::load(path);
+  ASSERT(capture.records().size() == recorder.recorded(),
+         "Accepted records are on disk");
+  ASSERT(capture.dropped() == recorder.dropped(),
+         "Drops are marked in the stream");
+  std::remove(path.c_str());
+}
+
+void test_replay_speeds() {
+  auto path = temp_path("replay");
+  {
+    StreamRecorder recorder(path, {.payload = false});
+    auto base = utils::tsc_clock::now();
+    for (int i = 0; i < 10; ++i) {
+      recorder.record(pattern(64, 0),
+                      base + ticks_for(i * 1'000'000));
+    }
+  }
+  auto capture = StreamCapture::load(path);
+  using clock = std::chrono::steady_clock;
+  auto start = clock::time_point{};
+
+  replay_source<clock> original(capture, 1.0, start);
+  replay_source<clock> doubled(capture, 2.0, start);
+  replay_source<clock> max(capture, 0, start);
+  for (int i = 0; i < 9; ++i) {
+    original.pop();
+    doubled.pop();
+    max.pop();
+  }
+  auto first = capture.records()[0].offset;
+  ASSERT(original.peek().due - start == capture.records()[9].offset,
+         "Original pace");
+  auto halved = (capture.records()[9].offset - first) / 2;
+  auto got = doubled.peek().due - start - first / 2;
+  ASSERT(got > halved - 1us && got < halved + 1us, "Scaled pace");
+  ASSERT(!original.ready(start), "Not due yet");
+  ASSERT(max.ready(start), "Max speed is always ready");
+  ASSERT(max.peek().bytes == 64, "Sizes replayed");
+  max.pop();
+  ASSERT(max.done() && !max.ready(start), "Ends with the capture");
+  std::remove(path.c_str());
+}
+
+void test_rejects_foreign_files() {
+  auto path = temp_path("foreign");
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << std::string(64, 'x');
+  }
+  bool threw = false;
+  try {
+    (void)StreamCapture::load(path);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  ASSERT(threw, "Magic is checked");
+  std::remove(path.c_str());
+}
+
+int main() {
+  std::cout << "Running StreamCapture Tests\n";
+  std::cout << "===========================\n\n";
+
+  try {
+    TEST_CASE(round_trip);
+    TEST_CASE(split_record);
+    TEST_CASE(shape_only);
+    TEST_CASE(drops_instead_of_stalling);
+    TEST_CASE(replay_speeds);
+    TEST_CASE(rejects_foreign_files);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include "oc/bench/traffic_generator.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+using namespace oc::bench;
+using namespace std::chrono_literals;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+using clock_type = std::chrono::steady_clock;
+
+bool rejects_size(const std::string &spec) {
+  try {
+    size_distribution::parse(spec);
+  } catch (const std::invalid_argument &) {
+    return true;
+  }
+  return false;
+}
+
+bool rejects_rate(const std::string &spec) {
+  try {
+    arrival_process::parse(spec);
+  } catch (const std::invalid_argument &) {
+    return true;
+  }
+  return false;
+}
+
+void test_parse_specs() {
+  auto fixed = size_distribution::parse("fixed:4096");
+  ASSERT(fixed.type == size_distribution::kind::fixed, "Fixed kind");
+  ASSERT(fixed.min_bytes == 4096 && fixed.max_bytes == 4096, "Fixed size");
+
+  auto pareto = size_distribution::parse("pareto:64:65536:1.5");
+  ASSERT(pareto.type == size_distribution::kind::pareto, "Pareto kind");
+  ASSERT(pareto.alpha == 1.5, "Pareto alpha");
+
+  auto bursty = arrival_process::parse("bursty:1e6:100:300");
+  ASSERT(bursty.type == arrival_process::kind::bursty, "Bursty kind");
+  ASSERT(bursty.on_period == 100us && bursty.off_period == 300us,
+         "Burst periods in microseconds");
+  ASSERT(bursty.mean_rate() == 250000, "Mean rate accounts for OFF time");
+
+  ASSERT(rejects_size("fixed"), "Missing size");
+  ASSERT(rejects_size("uniform:10:5"), "Inverted range");
+  ASSERT(rejects_size("fixed:12abc"), "Trailing garbage");
+  ASSERT(rejects_size("lognormal:1:2"), "Unknown distribution");
+  ASSERT(rejects_rate("constant:0"), "Zero rate");
+  ASSERT(rejects_rate("poisson"), "Missing rate");
+  ASSERT(rejects_rate("max:5"), "Max takes no rate");
+}
+
+void test_sizes_stay_in_range() {
+  std::mt19937_64 rng(7);
+  auto uniform = size_distribution::parse("uniform:100:200");
+  auto pareto = size_distribution::parse("pareto:64:1048576:1.1");
+
+  std::size_t small = 0;
+  std::size_t large = 0;
+  for (int i = 0; i < 100000; ++i) {
+    auto u = uniform(rng);
+    ASSERT(u >= 100 && u <= 200, "Uniform size in range");
+    auto p = pareto(rng);
+    ASSERT(p >= 64 && p <= 1048576, "Pareto size in range");
+    small += p < 256;
+    large += p >= 65536;
+  }
+  // heavy tail: mostly small messages, but a non-trivial share of huge ones
+  ASSERT(small > 70000, "Pareto mass concentrated near the minimum");
+  ASSERT(large > 0 && large < 5000, "Pareto has a bounded heavy tail");
+}
+
+void test_constant_rate() {
+  auto start = clock_type::time_point{};
+  traffic_generator<clock_type> gen(size_distribution::parse("fixed:64"),
+                                    arrival_process::parse("constant:1e6"),
+                                    start);
+  ASSERT(gen.peek().due == start, "First message due at start");
+  ASSERT(gen.ready(start), "First message ready at start");
+  gen.pop();
+  ASSERT(gen.peek().due == start + 1us, "1 MHz means 1us spacing");
+  ASSERT(!gen.ready(start), "Second message not ready early");
+  ASSERT(gen.peek().bytes == 64, "Fixed size");
+}
+
+void test_poisson_mean() {
+  auto start = clock_type::time_point{};
+  traffic_generator<clock_type> gen(size_distribution::parse("fixed:64"),
+                                    arrival_process::parse("poisson:1e6"),
+                                    start, 3);
+  constexpr int n = 200000;
+  for (int i = 0; i < n; ++i) {
+    gen.pop();
+  }
+  auto mean_gap = static_cast<double>((gen.peek().due - start).count()) / n;
+  ASSERT(mean_gap > 950 && mean_gap < 1050, "Poisson mean gap close to 1us");
+}
+
+void test_bursty_respects_off_period() {
+  auto start = clock_type::time_point{};
+  traffic_generator<clock_type> gen(
+      size_distribution::parse("fixed:64"),
+      arrival_process::parse("bursty:1e7:10:30"), start, 5);
+  for (int i = 0; i < 10000; ++i) {
+    gen.pop();
+    auto phase = (gen.peek().due - start) % 40us;
+    ASSERT(phase < 10us, "No arrivals during OFF periods");
+  }
+}
+
+void test_max_rate_always_ready() {
+  auto start = clock_type::time_point{};
+  traffic_generator<clock_type> gen(size_distribution::parse("fixed:64"),
+                                    arrival_process::parse("max"), start);
+  gen.pop();
+  gen.pop();
+  ASSERT(gen.ready(start), "Max rate never waits");
+}
+
+int main() {
+  std::cout << "Running Traffic Generator Tests\n";
+  std::cout << "===============================\n\n";
+
+  try {
+    TEST_CASE(parse_specs);
+    TEST_CASE(sizes_stay_in_range);
+    TEST_CASE(constant_rate);
+    TEST_CASE(poisson_mean);
+    TEST_CASE(bursty_respects_off_period);
+    TEST_CASE(max_rate_always_ready);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
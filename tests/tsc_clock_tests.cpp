@@ -0,0 +1,105 @@
+#include "utils/histogram.hpp"
+#include "utils/tsc_clock.hpp"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+using namespace oc::utils;
+
+// Test helper macros
+#define ASSERT(condition, message)                                             \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << "ASSERTION FAILED: " << message << " at " << __FILE__       \
+                << ":" << __LINE__ << "\n";                                    \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CASE(name)                                                        \
+  std::cout << "Running test: " << #name << "... ";                            \
+  test_##name();                                                               \
+  std::cout << "PASSED\n"
+
+void test_monotonic() {
+  auto previous = tsc_clock::now();
+  for (int i = 0; i < 100000; ++i) {
+    auto current = tsc_clock::now_ordered();
+    ASSERT(current >= previous, "Ticks never go backwards on one thread");
+    previous = current;
+  }
+}
+
+void test_conversion_matches_steady_clock() {
+  auto steady_start = std::chrono::steady_clock::now();
+  auto tick_start = tsc_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto ticks = tsc_clock::now() - tick_start;
+  auto steady = std::chrono::steady_clock::now() - steady_start;
+
+  auto measured = static_cast<double>(tsc_clock::to_nanoseconds(ticks));
+  auto expected = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(steady).count());
+  ASSERT(std::abs(measured - expected) / expected < 0.02,
+         "Calibrated ticks agree with steady_clock within 2%");
+}
+
+void test_monotonic_mapping() {
+  timespec ts;
+  auto stamp = tsc_clock::now();
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  auto mono = static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  auto mapped = tsc_clock::to_monotonic_ns(stamp);
+  ASSERT(std::abs(mono - mapped) < 1000000,
+         "Tick stamps map onto CLOCK_MONOTONIC within 1ms");
+}
+
+void test_histogram_in_ticks() {
+  Histogram ticks;
+  for (int i = 0; i < 1000; ++i) {
+    auto start = tsc_clock::now();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    ticks.record(tsc_clock::now() - start);
+  }
+  auto ns = ticks.rescaled(tsc_clock::ns_per_tick());
+  ASSERT(ns.count() == 1000, "Rescaling keeps the count");
+  ASSERT(ns.percentile(50) >= 100000, "Sleeps last at least 100us");
+}
+
+void test_cost() {
+  constexpr int n = 10000000;
+  uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; ++i) {
+    sink += tsc_clock::now();
+  }
+  auto ns = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  std::cout << "(" << ns / n << " ns/now, source "
+            << static_cast<int>(tsc_clock::current_calibration().origin)
+            << ") ";
+  ASSERT(sink != 0, "Keep the loop");
+}
+
+int main() {
+  std::cout << "Running TSC Clock Tests\n";
+  std::cout << "=======================\n\n";
+
+  try {
+    TEST_CASE(monotonic);
+    TEST_CASE(conversion_matches_steady_clock);
+    TEST_CASE(monotonic_mapping);
+    TEST_CASE(histogram_in_ticks);
+    TEST_CASE(cost);
+
+    std::cout << "\n🎉 All tests passed successfully!\n";
+  } catch (const std::exception &e) {
+    std::cerr << "\n❌ Test failed with exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
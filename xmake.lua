@@ -28,6 +28,30 @@ target("oc-rdma-server-sample")
     add_files("src/bin/rdma_sample/server.cpp")
     add_deps("warp-pipe-stdexec")
 
+target("pipe-bench")
+    set_kind("binary")
+    set_default(false)
+    add_files("src/bin/pipe_bench/*.cpp")
+    add_deps("warp-pipe-stdexec")
+
+target("pipe-top")
+    set_kind("binary")
+    set_default(false)
+    add_files("src/bin/pipe_top/*.cpp", "src/oc/stats_page.cpp")
+    add_includedirs("src")
+
+target("pipe-sim")
+    set_kind("binary")
+    set_default(false)
+    add_files("src/bin/pipe_sim/*.cpp")
+    add_includedirs("src")
+
+target("rb-bench")
+    set_kind("binary")
+    set_default(false)
+    add_files("src/bin/rb_bench/*.cpp")
+    add_includedirs("src")
+
 target("ring-buffer-examples")
     set_kind("binary")
     set_default(false)
@@ -48,6 +72,183 @@ target("small-vector-tests")
     add_files("tests/small_vector_tests.cpp")
     add_includedirs("src")
 
+target("registration-cache-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/registration_cache_tests.cpp")
+    add_includedirs("src")
+
+target("bootstrap-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/bootstrap_tests.cpp", "src/utils/tcp.cpp")
+    add_includedirs("src")
+
+target("control-channel-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/control_channel_tests.cpp", "src/oc/io/*.cpp")
+    add_includedirs("src")
+
+target("traffic-generator-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/traffic_generator_tests.cpp")
+    add_includedirs("src")
+
+target("histogram-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/histogram_tests.cpp")
+    add_includedirs("src")
+
+target("tsc-clock-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/tsc_clock_tests.cpp")
+    add_includedirs("src")
+
+target("pipe-tracer-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/pipe_tracer_tests.cpp")
+    add_includedirs("src")
+
+target("stats-page-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/stats_page_tests.cpp", "src/oc/stats_page.cpp")
+    add_includedirs("src")
+
+target("flight-recorder-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/flight_recorder_tests.cpp")
+    add_deps("warp-pipe-stdexec")
+
+target("pipeline-sim-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/pipeline_sim_tests.cpp")
+    add_includedirs("src")
+
+target("stream-capture-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/stream_capture_tests.cpp", "src/oc/capture.cpp")
+    add_includedirs("src")
+
+target("pipe-tuner-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/pipe_tuner_tests.cpp")
+    add_includedirs("src")
+
+target("pipe-scheduler-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/pipe_scheduler_tests.cpp")
+    add_includedirs("src")
+
+target("fragment-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/fragment_tests.cpp")
+    add_includedirs("src")
+
+target("batching-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/batching_tests.cpp")
+    add_includedirs("src")
+
+target("codec-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/codec_tests.cpp")
+    add_includedirs("src")
+    set_policy("build.sanitizer.address", true)
+
+target("checksum-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/checksum_tests.cpp", "src/oc/checksum.cpp")
+    add_includedirs("src")
+
+target("delimiter-scan-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/delimiter_scan_tests.cpp")
+    add_includedirs("src")
+
+target("filter-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/filter_tests.cpp")
+    add_includedirs("src")
+
+target("aggregate-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/aggregate_tests.cpp")
+    add_includedirs("src")
+
+target("columnar-ring-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/columnar_ring_tests.cpp")
+    add_includedirs("src")
+
+target("pipe-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/pipe_tests.cpp")
+    add_deps("warp-pipe-stdexec")
+
+target("instrument-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/instrument_tests.cpp")
+    add_includedirs("src")
+
+target("instrument-tests-disabled")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/instrument_tests.cpp")
+    add_includedirs("src")
+    add_defines("OC_DISABLE_INSTRUMENTATION")
+
+target("io-senders-tests")
+    set_kind("binary")
+    set_default(false)
+    add_tests("default")
+    add_files("tests/io_senders_tests.cpp", "src/oc/io/*.cpp")
+    add_includedirs("src")
+
 --
 -- If you want to known more usage about xmake, please see https://xmake.io
 --